@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace siem::bench {
+
+/**
+ * Keep a result observable so the measured work is not optimized away
+ */
+inline void consume(size_t value) {
+    static volatile size_t sink = 0;
+    sink = sink + value;
+}
+
+/**
+ * Run fn repeatedly for at least min_time on the calling thread and print
+ * per-core throughput. Each call of fn processes `items` items / `bytes` bytes
+ */
+template <typename Fn>
+double run(const std::string& name, size_t items, size_t bytes, Fn&& fn,
+           std::chrono::milliseconds min_time = std::chrono::milliseconds(1000)) {
+    using clock = std::chrono::steady_clock;
+
+    fn(); // Warm-up
+
+    size_t iterations = 0;
+    auto start = clock::now();
+    auto elapsed = clock::duration::zero();
+    while (elapsed < min_time) {
+        fn();
+        iterations++;
+        elapsed = clock::now() - start;
+    }
+
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    double items_per_sec = static_cast<double>(items * iterations) / seconds;
+    double mb_per_sec = static_cast<double>(bytes * iterations) / seconds / 1e6;
+
+    if (bytes > 0) {
+        std::printf("%-40s %14.0f items/s %10.1f MB/s %10.1f ns/item\n",
+                    name.c_str(), items_per_sec, mb_per_sec, 1e9 / items_per_sec);
+    } else {
+        std::printf("%-40s %14.0f items/s %10.1f ns/item\n",
+                    name.c_str(), items_per_sec, 1e9 / items_per_sec);
+    }
+    return items_per_sec;
+}
+
+} // namespace siem::bench
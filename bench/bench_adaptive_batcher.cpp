@@ -0,0 +1,127 @@
+#include "bench.hpp"
+#include "core/adaptive_batcher.hpp"
+#include "core/event_pipeline.hpp"
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <thread>
+
+using namespace siem;
+using namespace siem::core;
+
+namespace {
+
+/**
+ * Stand-in for a MongoDB round-trip per batch
+ */
+void store(const std::vector<storage::Event>& events) {
+    std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    bench::consume(events.size());
+}
+
+/**
+ * Same, with a per-event cost on top, so big batches take longer
+ */
+void store_sized(const std::vector<storage::Event>& events) {
+    std::this_thread::sleep_for(std::chrono::microseconds(1000 + 20 * events.size()));
+    bench::consume(events.size());
+}
+
+void print_batching(const EventPipeline& pipeline, const AdaptiveBatcher& batcher) {
+    auto stats = batcher.stats();
+    auto stages = pipeline.stats();
+    uint64_t observed = std::max<uint64_t>(stats.on_time + stats.late, 1);
+    std::printf("%-40s %14.1f events/store call %10zu target %10.2f ms latency %6.1f%% late\n", "",
+                static_cast<double>(stages[0].events) / std::max<uint64_t>(stages[0].batches, 1),
+                stats.target,
+                stats.latency_ns / 1e6 / observed,
+                100.0 * stats.late / observed);
+}
+
+} // namespace
+
+int main() {
+    spdlog::set_level(spdlog::level::warn);
+    constexpr size_t kEvents = 50000;
+    storage::Event event;
+    event.source = Symbol("fw");
+    event.trace_id = "0123456789abcdef";
+
+    // Single-event ingest calls, e.g. one HTTP request per event
+    for (bool batching : {false, true}) {
+        std::atomic<uint64_t> stored{0};
+        EventPipeline pipeline;
+        EventPipeline::StageConfig config;
+        config.workers = 4;
+        pipeline.add_stage("store", config, [&](EventPipeline::Batch& b) {
+            store(b.events);
+            stored += b.events.size();
+        });
+
+        AdaptiveBatcher batcher(AdaptiveBatcher::Config{}, [&](EventPipeline::Batch&& batch) {
+            pipeline.push(std::move(batch));
+        });
+        pipeline.on_complete([&](size_t, std::chrono::nanoseconds latency) {
+            batcher.observe(latency, pipeline.depth());
+        });
+        pipeline.start();
+        batcher.start();
+
+        bench::run(batching ? "adaptive batcher, 1-event calls" : "pipeline only, 1-event calls", kEvents, 0, [&] {
+            uint64_t target = stored.load() + kEvents;
+            for (size_t i = 0; i < kEvents; ++i) {
+                std::vector<storage::Event> events{event};
+                if (batching) {
+                    batcher.add(events);
+                } else {
+                    pipeline.push(std::move(events));
+                }
+            }
+            // Wait for the last event so the rate is end to end
+            while (stored.load() < target) std::this_thread::yield();
+        });
+
+        batcher.stop();
+        pipeline.stop();
+        print_batching(pipeline, batcher);
+    }
+
+    // The same offered load against a store whose time grows with the
+    // batch: the SLO, not the load, decides how big batches get
+    constexpr size_t kRate = 100000;            // Events per second
+    constexpr auto kDuration = std::chrono::seconds(2);
+    for (int slo_ms : {25, 50, 100}) {
+        EventPipeline pipeline;
+        EventPipeline::StageConfig stage;
+        stage.workers = 4;
+        stage.max_events = 0;                   // Store batches as the batcher sends them
+        pipeline.add_stage("store", stage, [&](EventPipeline::Batch& b) { store_sized(b.events); });
+
+        AdaptiveBatcher::Config config;
+        config.latency_slo_ms = slo_ms;
+        config.max_linger_ms = 20;
+        AdaptiveBatcher batcher(config, [&](EventPipeline::Batch&& batch) {
+            pipeline.push(std::move(batch));
+        });
+        pipeline.on_complete([&](size_t, std::chrono::nanoseconds latency) {
+            batcher.observe(latency, pipeline.depth());
+        });
+        pipeline.start();
+        batcher.start();
+
+        // One event per add(), paced in 1 ms ticks
+        auto started = std::chrono::steady_clock::now();
+        for (auto tick = started; tick - started < kDuration; tick += std::chrono::milliseconds(1)) {
+            std::this_thread::sleep_until(tick);
+            for (size_t i = 0; i < kRate / 1000; ++i) {
+                std::vector<storage::Event> events{event};
+                batcher.add(events);
+            }
+        }
+
+        batcher.stop();
+        pipeline.stop();
+        std::printf("latency_slo_ms %d, %zu events/s\n", slo_ms, kRate);
+        print_batching(pipeline, batcher);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "bench.hpp"
+#include "core/event_normalizer.hpp"
+#include "ingest/cef_parser.hpp"
+#include <random>
+
+using namespace siem;
+using json = nlohmann::json;
+
+namespace {
+
+struct Sample {
+    std::string src, dst, user, action;
+    int sport, dport;
+    uint64_t in, out;
+};
+
+std::vector<Sample> random_samples(size_t n) {
+    std::mt19937 rng(42);
+    static constexpr const char* users[] = {"alice", "bob", "carol", "svc-backup"};
+    static constexpr const char* actions[] = {"allowed", "blocked", "dropped"};
+    std::vector<Sample> samples(n);
+    for (auto& s : samples) {
+        s.src = "10.0." + std::to_string(rng() % 64) + "." + std::to_string(rng() % 256);
+        s.dst = "192.0.2." + std::to_string(rng() % 256);
+        s.user = users[rng() % 4];
+        s.action = actions[rng() % 3];
+        s.sport = static_cast<int>(1024 + rng() % 60000);
+        s.dport = rng() % 2 ? 443 : 22;
+        s.in = rng() % 100000;
+        s.out = rng() % 10000;
+    }
+    return samples;
+}
+
+} // namespace
+
+int main() {
+    auto samples = random_samples(20000);
+    core::EventNormalizer normalizer;
+
+    std::vector<std::string> cef, leef;
+    size_t cef_bytes = 0, leef_bytes = 0;
+    for (const auto& s : samples) {
+        cef.push_back("CEF:0|Palo Alto Networks|PAN-OS|10.1|TRAFFIC|end|3|rt=1762556401250 dvchost=pa-01 src=" +
+                      s.src + " dst=" + s.dst + " spt=" + std::to_string(s.sport) + " dpt=" +
+                      std::to_string(s.dport) + " proto=TCP act=" + s.action + " suser=" + s.user +
+                      " in=" + std::to_string(s.in) + " out=" + std::to_string(s.out) +
+                      " cs1Label=Rule cs1=Internet Egress msg=session end");
+        leef.push_back("LEEF:2.0|IBM|QRadar|7.5|login|^|devTime=1762556401250^src=" + s.src + "^dst=" + s.dst +
+                       "^srcPort=" + std::to_string(s.sport) + "^dstPort=" + std::to_string(s.dport) +
+                       "^proto=6^action=" + s.action + "^usrName=" + s.user + "^srcBytes=" +
+                       std::to_string(s.in) + "^dstBytes=" + std::to_string(s.out) + "^sev=3");
+        cef_bytes += cef.back().size();
+        leef_bytes += leef.back().size();
+    }
+
+    std::vector<storage::Event> events(samples.size());
+    for (auto [name, lines, bytes] : {std::tuple{"cef", &cef, cef_bytes}, std::tuple{"leef", &leef, leef_bytes}}) {
+        bench::run(std::string(name) + " parse", lines->size(), bytes, [&] {
+            size_t fields = 0;
+            ingest::CefMessage message;
+            for (const auto& line : *lines) {
+                ingest::CefParser::parse(line, message);
+                ingest::CefParser::for_each_extension(message, [&](std::string_view, std::string_view) { fields++; });
+            }
+            bench::consume(fields);
+        });
+
+        bench::run(std::string(name) + " parse + to_event", lines->size(), bytes, [&] {
+            ingest::CefMessage message;
+            for (size_t i = 0; i < lines->size(); ++i) {
+                events[i] = storage::Event{};
+                ingest::CefParser::parse((*lines)[i], message);
+                ingest::CefParser::to_event(message, events[i]);
+            }
+            bench::consume(events.size());
+        });
+
+        bench::run(std::string(name) + " parse + to_event + finalize", lines->size(), bytes, [&] {
+            ingest::CefMessage message;
+            for (size_t i = 0; i < lines->size(); ++i) {
+                events[i] = storage::Event{};
+                ingest::CefParser::parse((*lines)[i], message);
+                ingest::CefParser::to_event(message, events[i]);
+            }
+            normalizer.finalize(events);
+            bench::consume(events.size());
+        });
+    }
+
+    // The same records as JSON through the normalizer, for comparison
+    std::vector<json> raw;
+    for (const auto& s : samples) {
+        raw.push_back({{"source", "cef"}, {"host", "pa-01"}, {"ts", 1762556401250},
+                       {"action", s.action == "allowed" ? "allow" : "deny"},
+                       {"entity", {{"ip", s.src}, {"user", s.user}}},
+                       {"object", {{"proto", "tcp"}, {"sport", s.sport}, {"dport", s.dport},
+                                   {"bytes", s.in + s.out}, {"dst_ip", s.dst}}},
+                       {"extra", {{"vendor", "Palo Alto Networks"}, {"signature", "TRAFFIC"}}}});
+    }
+    std::vector<std::string> ndjson;
+    size_t ndjson_bytes = 0;
+    for (const auto& event : raw) {
+        ndjson.push_back(event.dump());
+        ndjson_bytes += ndjson.back().size();
+    }
+    bench::run("json normalize_batch (baseline)", raw.size(), 0, [&] {
+        bench::consume(normalizer.normalize_batch(raw).size());
+    });
+    bench::run("ndjson parse + normalize_batch (baseline)", ndjson.size(), ndjson_bytes, [&] {
+        std::vector<json> parsed;
+        parsed.reserve(ndjson.size());
+        for (const auto& line : ndjson) parsed.push_back(json::parse(line));
+        bench::consume(normalizer.normalize_batch(parsed).size());
+    });
+    return 0;
+}
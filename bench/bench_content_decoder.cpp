@@ -0,0 +1,78 @@
+#include "bench.hpp"
+#include "ingest/http_ingestor.hpp"
+#include <zlib.h>
+#include <zstd.h>
+
+using namespace siem;
+using namespace siem::ingest;
+
+namespace {
+
+std::string gzip(const std::string& data) {
+    z_stream z{};
+    deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&z, static_cast<uLong>(data.size())), '\0');
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    z.avail_in = static_cast<uInt>(data.size());
+    z.next_out = reinterpret_cast<Bytef*>(out.data());
+    z.avail_out = static_cast<uInt>(out.size());
+    deflate(&z, Z_FINISH);
+    out.resize(z.total_out);
+    deflateEnd(&z);
+    return out;
+}
+
+std::string zstd(const std::string& data) {
+    std::string out(ZSTD_compressBound(data.size()), '\0');
+    out.resize(ZSTD_compress(out.data(), out.size(), data.data(), data.size(), 3));
+    return out;
+}
+
+} // namespace
+
+int main() {
+    json batch = json::array();
+    for (int i = 0; i < 5000; ++i) {
+        batch.push_back({
+            {"ts", "2025-11-07T23:00:01Z"},
+            {"source", i % 3 == 0 ? "fw" : "app"},
+            {"host", "edge-" + std::to_string(i % 16)},
+            {"entity", {{"ip", "10.0." + std::to_string(i % 256) + ".7"}, {"user", "alice"}}},
+            {"verb", "deny"},
+            {"object", {{"proto", "tcp"}, {"dport", 1024 + i % 4096}}},
+            {"outcome", "block"},
+            {"message", "connection denied by policy fw-" + std::to_string(i % 40)}
+        });
+    }
+    std::string body = batch.dump();
+    size_t count = batch.size();
+
+    HTTPIngestor::Config config;
+    config.max_body_size = body.size();
+    config.max_decoded_size = body.size();
+    config.rate_limit.max_events_per_minute = 1u << 30;
+    config.rate_limit.burst = 1u << 30;
+    HTTPIngestor ingestor(config);
+
+    for (const auto& [name, encoding, wire] : {std::tuple{"identity", ContentEncoding::Identity, body},
+                                               std::tuple{"gzip", ContentEncoding::Gzip, gzip(body)},
+                                               std::tuple{"zstd", ContentEncoding::Zstd, zstd(body)}}) {
+        std::printf("%s: %zu events, %zu bytes on the wire (%.1fx)\n", name, count, wire.size(),
+                    static_cast<double>(body.size()) / static_cast<double>(wire.size()));
+
+        bench::run(std::string("decode only, ") + name, count, body.size(), [&] {
+            ContentDecoder decoder(encoding, wire, body.size());
+            char buffer[16384];
+            size_t n = 0;
+            while (auto got = decoder.sgetn(buffer, sizeof(buffer))) n += static_cast<size_t>(got);
+            bench::consume(n);
+        });
+
+        bench::run(std::string("verify + parse_ingest_request, ") + name, count, body.size(), [&] {
+            size_t n = ingestor.verify_signature(wire, HTTPIngestor::compute_hmac(config.hmac_secret, wire));
+            ingestor.parse_ingest_request(wire, encoding, [&](json&&) { n++; });
+            bench::consume(n);
+        });
+    }
+    return 0;
+}
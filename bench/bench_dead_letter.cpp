@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "ingest/dead_letter_spool.hpp"
+#include "core/event_normalizer.hpp"
+#include <spdlog/spdlog.h>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace siem;
+using namespace siem::ingest;
+namespace fs = std::filesystem;
+
+int main() {
+    // normalization_failed warnings would dominate the timings
+    spdlog::set_level(spdlog::level::err);
+    auto dir = fs::temp_directory_path() / ("siem_bench_dlq_" + std::to_string(::getpid()));
+
+    DeadLetterSpool::Config config;
+    config.dir = dir.string();
+    config.max_queue = 1 << 20;
+    DeadLetterSpool dead_letters(config);
+    dead_letters.start();
+
+    // What the ingest thread pays per failed event: a dump and a queue push
+    json raw = {{"source", "fw"}, {"host", "edge-01"}, {"verb", "deny"},
+                {"object", {{"proto", "tcp"}, {"dport", 22}}}, {"note", std::string(200, 'x')}};
+    std::invalid_argument error("Event is not a JSON object");
+    bench::run("add (json, exception)", 1000, 0, [&] {
+        for (int i = 0; i < 1000; ++i) dead_letters.add(raw, error);
+    });
+
+    // Mostly good batches with a few bad events, with and without the hook
+    std::vector<json> batch(1000, raw);
+    for (size_t i = 0; i < batch.size(); i += 100) batch[i] = json::array({i});
+    core::EventNormalizer::Config normalizer_config;
+    normalizer_config.parallel_min_batch = 0;
+    core::EventNormalizer plain(normalizer_config);
+    core::EventNormalizer hooked(normalizer_config);
+    hooked.on_failure([&](const json& event, const std::exception& e) { dead_letters.add(event, e); });
+
+    bench::run("normalize_batch, 1% bad", batch.size(), 0, [&] {
+        bench::consume(plain.normalize_batch(batch).size());
+    });
+    bench::run("normalize_batch, 1% bad, dead-lettered", batch.size(), 0, [&] {
+        bench::consume(hooked.normalize_batch(batch).size());
+    });
+
+    dead_letters.stop();
+    auto stats = dead_letters.stats();
+    std::printf("written %llu, dropped %llu, %llu files, %llu bytes\n",
+                static_cast<unsigned long long>(stats.written), static_cast<unsigned long long>(stats.dropped),
+                static_cast<unsigned long long>(stats.files), static_cast<unsigned long long>(stats.bytes));
+
+    fs::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "bench.hpp"
+#include "core/event_normalizer.hpp"
+#include "core/incident_clusterer.hpp"
+#include "core/correlation.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace siem;
+using json = nlohmann::json;
+
+// Live heap bytes, for per-event footprint
+static std::atomic<int64_t> g_live_bytes{0};
+
+void* operator new(std::size_t size) {
+    auto* p = static_cast<std::size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+    if (!p) throw std::bad_alloc();
+    *p = size;
+    g_live_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    return reinterpret_cast<char*>(p) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    auto* p = reinterpret_cast<std::size_t*>(static_cast<char*>(ptr) - sizeof(std::max_align_t));
+    g_live_bytes.fetch_sub(static_cast<int64_t>(*p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    operator delete(ptr);
+}
+
+int main() {
+    std::vector<json> raw;
+    for (int i = 0; i < 10000; ++i) {
+        raw.push_back({
+            {"ts", 1762556401 + i},
+            {"source", i % 3 == 0 ? "fw" : "ids"},
+            {"host", "edge-" + std::to_string(i % 16)},
+            {"entity", {{"ip", "10.0." + std::to_string(i % 64) + ".7"}, {"user", "svc"}}},
+            {"verb", i % 5 == 0 ? "auth" : "deny"},
+            {"object", {{"proto", "tcp"}, {"dport", 22}, {"sport", 40000 + i % 1000}}},
+            {"outcome", i % 5 == 0 ? "fail" : "block"}
+        });
+    }
+
+    core::EventNormalizer normalizer;
+
+    int64_t before = g_live_bytes.load();
+    auto events = normalizer.normalize_batch(raw);
+    int64_t heap = g_live_bytes.load() - before;
+    std::printf("sizeof(Event) %zu bytes, heap %.1f bytes/event, total %.1f bytes/event\n",
+                sizeof(storage::Event),
+                static_cast<double>(heap) / events.size(),
+                static_cast<double>(heap) / events.size() + sizeof(storage::Event));
+
+    bench::run("normalize_batch", raw.size(), 0, [&] {
+        bench::consume(normalizer.normalize_batch(raw).size());
+    });
+
+    core::IncidentClusterer clusterer({});
+    core::CorrelationEngine correlator({});
+    bench::run("assign_clusters + correlate_events", events.size(), 0, [&] {
+        std::map<std::string, storage::Incident> incidents;
+        clusterer.assign_clusters(events);
+        bench::consume(correlator.correlate_events(events, incidents).size());
+    });
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+#include "core/event_pipeline.hpp"
+#include "core/event_normalizer.hpp"
+#include "core/incident_clusterer.hpp"
+#include "core/correlation.hpp"
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace siem;
+using namespace siem::core;
+
+namespace {
+
+std::vector<storage::Event> make_batch(size_t count) {
+    EventNormalizer normalizer;
+    std::vector<storage::Event> events;
+    for (size_t i = 0; i < count; ++i) {
+        events.push_back(normalizer.normalize({
+            {"source", "fw"},
+            {"host", "edge-" + std::to_string(i % 8)},
+            {"verb", i % 3 ? "deny" : "allow"},
+            {"object", {{"proto", "tcp"}, {"dport", 22 + i % 4}}},
+            {"entity", {{"ip", "10.0.0." + std::to_string(i % 32)}}},
+        }));
+    }
+    return events;
+}
+
+/**
+ * Stand-in for a MongoDB round-trip per batch
+ */
+void store(const std::vector<storage::Event>& events) {
+    std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    bench::consume(events.size());
+}
+
+} // namespace
+
+int main() {
+    spdlog::set_level(spdlog::level::warn);
+    auto batch = make_batch(100);
+
+    IncidentClusterer clusterer(IncidentClusterer::Config{});
+    CorrelationEngine correlator(CorrelationEngine::Config{});
+    std::map<std::string, storage::Incident> incidents;
+    std::mutex mutex;
+
+    auto analyze = [&](std::vector<storage::Event>& events) {
+        std::lock_guard<std::mutex> lock(mutex);
+        clusterer.assign_clusters(events);
+        return correlator.correlate_events(events, incidents);
+    };
+
+    // What every ingest thread did before: the whole chain inline
+    bench::run("inline, 100-event batches", batch.size() * 50, 0, [&] {
+        for (int i = 0; i < 50; ++i) {
+            auto events = batch;
+            analyze(events);
+            store(events);
+        }
+    });
+
+    for (size_t store_workers : {1, 4, 16}) {
+        std::atomic<uint64_t> stored{0};
+        EventPipeline pipeline;
+        EventPipeline::StageConfig config;
+        pipeline.add_stage("analyze", config, [&](EventPipeline::Batch& b) { b.incident_ids = analyze(b.events); });
+        config.workers = store_workers;
+        pipeline.add_stage("store", config, [&](EventPipeline::Batch& b) {
+            store(b.events);
+            stored += b.events.size();
+        });
+        pipeline.start();
+
+        bench::run("pipeline, " + std::to_string(store_workers) + " store workers", batch.size() * 50, 0, [&] {
+            uint64_t target = stored.load() + batch.size() * 50;
+            for (int i = 0; i < 50; ++i) {
+                auto events = batch;
+                pipeline.push(std::move(events));
+            }
+            // Wait for the last batch so the rate is end to end
+            while (stored.load() < target) std::this_thread::yield();
+        });
+
+        pipeline.stop();
+        auto stats = pipeline.stats();
+        for (const auto& stage : stats) {
+            std::printf("%-40s %14.1f events/call %10.1f us wait %10.1f us service\n",
+                        ("  " + stage.name).c_str(),
+                        static_cast<double>(stage.events) / std::max<uint64_t>(stage.batches, 1),
+                        stage.wait_ns / 1e3 / std::max<uint64_t>(stage.batches, 1),
+                        stage.service_ns / 1e3 / std::max<uint64_t>(stage.batches, 1));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench.hpp"
+#include "ingest/file_ingestor.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sys/resource.h>
+
+using namespace siem;
+using json = nlohmann::json;
+
+namespace {
+
+long peak_rss_kb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+} // namespace
+
+// Usage: bench_file_ingest [events]; writes a temporary NDJSON file
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500000;
+    auto path = (std::filesystem::temp_directory_path() / "siem_bench_events.ndjson").string();
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        for (size_t i = 0; i < count; ++i) {
+            out << json{
+                {"ts", "2025-11-07T23:00:01Z"},
+                {"source", i % 3 == 0 ? "fw" : "ids"},
+                {"host", "edge-" + std::to_string(i % 16)},
+                {"entity", {{"ip", "10.0." + std::to_string(i % 256) + ".7"}}},
+                {"verb", "deny"},
+                {"object", {{"proto", "tcp"}, {"dport", 22}, {"bytes", 184 + i}}},
+                {"outcome", "block"}
+            }.dump() << '\n';
+        }
+    }
+
+    size_t bytes = std::filesystem::file_size(path);
+    std::printf("file: %zu events, %.1f MB; peak RSS before: %.1f MB\n",
+                count, bytes / 1e6, peak_rss_kb() / 1e3);
+
+    ingest::FileIngestor ingestor;
+    bench::run("ndjson ingest_file (mmap)", count, bytes, [&] {
+        size_t events = 0;
+        ingestor.ingest_file(path, [&](const std::vector<json>& batch) { events += batch.size(); });
+        bench::consume(events);
+    });
+
+    std::printf("peak RSS after: %.1f MB\n", peak_rss_kb() / 1e3);
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "bench.hpp"
+#include "core/event_normalizer.hpp"
+#include "ingest/flow_collector.hpp"
+#include "ingest/flow_encoder.hpp"
+#include <atomic>
+#include <random>
+#include <thread>
+
+using namespace siem;
+using json = nlohmann::json;
+
+namespace {
+
+std::vector<ingest::FlowRecord> random_flows(size_t n, int64_t now_ms) {
+    std::mt19937 rng(42);
+    std::vector<ingest::FlowRecord> flows(n);
+    for (auto& flow : flows) {
+        flow.src_ip = "10.0." + std::to_string(rng() % 64) + "." + std::to_string(rng() % 256);
+        flow.dst_ip = "192.0.2." + std::to_string(rng() % 256);
+        flow.sport = static_cast<uint16_t>(1024 + rng() % 60000);
+        static constexpr uint16_t ports[] = {22, 53, 80, 443, 3389, 8080};
+        flow.dport = ports[rng() % 6];
+        flow.proto = flow.dport == 53 ? 17 : 6;
+        flow.bytes = rng() % 100000;
+        flow.packets = 1 + flow.bytes / 1000;
+        flow.end_ms = now_ms - static_cast<int64_t>(rng() % 1000);
+        flow.start_ms = flow.end_ms - static_cast<int64_t>(rng() % 60000);
+    }
+    return flows;
+}
+
+/**
+ * Export packets of MTU size, as a router would send them
+ */
+std::vector<std::string> export_packets(ingest::FlowEncoder& encoder, const std::vector<ingest::FlowRecord>& flows,
+                                        int64_t now_ms) {
+    std::vector<std::string> packets;
+    size_t per_packet = encoder.records_per_packet();
+    for (size_t i = 0; i < flows.size(); i += per_packet) {
+        std::vector<ingest::FlowRecord> chunk(flows.begin() + i, flows.begin() + std::min(flows.size(), i + per_packet));
+        packets.push_back(encoder.data(chunk, now_ms));
+    }
+    return packets;
+}
+
+} // namespace
+
+int main() {
+    const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto flows = random_flows(20000, now);
+    core::EventNormalizer normalizer;
+    std::string_view exporter = "198.51.100.1";
+
+    for (auto version : {ingest::FlowEncoder::Version::NetflowV9, ingest::FlowEncoder::Version::Ipfix}) {
+        const char* name = version == ingest::FlowEncoder::Version::Ipfix ? "ipfix" : "v9";
+        ingest::FlowEncoder encoder(ingest::FlowEncoder::Config{version, 1, 256, now - 86400000});
+        auto packets = export_packets(encoder, flows, now);
+        size_t bytes = 0;
+        for (const auto& p : packets) bytes += p.size();
+        std::printf("%s: %zu packets, %zu records, %zu bytes\n", name, packets.size(), flows.size(), bytes);
+
+        ingest::FlowDecoder decoder;
+        std::vector<storage::Event> events;
+        decoder.decode(encoder.templates(now), exporter, events);
+        events.reserve(flows.size());
+
+        bench::run(std::string(name) + " decode", flows.size(), bytes, [&] {
+            events.clear();
+            for (const auto& p : packets) decoder.decode(p, exporter, events);
+            bench::consume(events.size());
+        });
+
+        bench::run(std::string(name) + " decode + finalize", flows.size(), bytes, [&] {
+            events.clear();
+            for (const auto& p : packets) decoder.decode(p, exporter, events);
+            normalizer.finalize(events);
+            bench::consume(events.size());
+        });
+    }
+
+    // The same flows as JSON through the normalizer, for comparison
+    std::vector<json> raw;
+    for (const auto& flow : flows) {
+        raw.push_back({{"source", "netflow"}, {"host", "198.51.100.1"}, {"ts", flow.end_ms},
+                       {"entity", {{"ip", flow.src_ip}}},
+                       {"object", {{"proto", flow.proto == 17 ? "udp" : "tcp"}, {"dport", flow.dport},
+                                   {"sport", flow.sport}, {"bytes", flow.bytes}, {"packets", flow.packets},
+                                   {"dst_ip", flow.dst_ip}}}});
+    }
+    bench::run("json normalize_batch (baseline)", raw.size(), 0, [&] {
+        bench::consume(normalizer.normalize_batch(raw).size());
+    });
+
+    // End to end over loopback: sender thread -> collector io thread -> callback
+    ingest::FlowCollector::Config config;
+    config.bind_address = "127.0.0.1";
+    config.port = 0;
+    ingest::FlowCollector collector(config);
+    std::atomic<size_t> delivered{0};
+    collector.start([&](std::vector<storage::Event>& batch) { delivered += batch.size(); });
+
+    ingest::FlowEncoder encoder;
+    auto packets = export_packets(encoder, flows, now);
+    net::io_context ioc;
+    udp::socket sender(ioc, udp::v4());
+    udp::endpoint target(net::ip::make_address("127.0.0.1"), collector.port());
+    sender.send_to(net::buffer(encoder.templates(now)), target);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const int rounds = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto& p : packets) sender.send_to(net::buffer(p), target);
+        // Pace rounds so loopback drops measure the collector, not the socket buffer
+        while (delivered.load() + collector.stats().missing_template < (round + 1) * flows.size() * 9 / 10 &&
+               std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+            std::this_thread::yield();
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - 0.3;
+    collector.stop();
+
+    auto stats = collector.stats();
+    std::printf("%-40s %14.0f records/s (%zu of %zu delivered, %lu packets)\n", "loopback udp end to end",
+                static_cast<double>(delivered.load()) / seconds, delivered.load(), rounds * flows.size(),
+                static_cast<unsigned long>(stats.packets));
+    return 0;
+}
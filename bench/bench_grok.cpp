@@ -0,0 +1,145 @@
+#include "bench.hpp"
+#include "ingest/grok_matcher.hpp"
+#include <random>
+#include <regex>
+
+using namespace siem;
+using json = nlohmann::json;
+
+namespace {
+
+// Typical app / daemon log shapes; the last pattern gets most of the lines
+const std::vector<ingest::GrokMatcher::Pattern> kPatterns = {
+    {"sshd_auth", "%{WORD:outcome} (?:password|publickey) for (?:invalid user )?%{USERNAME:entity.user} from "
+                  "%{IP:entity.ip} port %{INT:object.sport:int} ssh2", "sshd"},
+    {"sshd_disconnect", "Disconnected from (?:invalid user )?%{USERNAME:entity.user} %{IP:entity.ip} port "
+                        "%{INT:object.sport:int}(?: \\[preauth\\])?", "sshd"},
+    {"sudo", "%{USERNAME:entity.user} : TTY=%{NOTSPACE:tty} ; PWD=%{NOTSPACE:pwd} ; USER=%{USERNAME:object.user} ; "
+             "COMMAND=%{GREEDYDATA:command}", "sudo"},
+    {"access", "%{IPORHOST:entity.ip} - %{NOTSPACE:entity.user} \\[%{HTTPDATE:ts}\\] \"%{WORD:verb} "
+               "%{URIPATHPARAM:object.path} HTTP/%{NUMBER:object.http:float}\" %{INT:object.status:int} "
+               "(?:%{INT:object.bytes:int}|-)", "nginx"},
+    {"kv", "%{TIMESTAMP_ISO8601:ts} %{LOGLEVEL:level} \\[%{NOTSPACE:service}\\] user=%{USERNAME:entity.user} "
+           "ip=%{IP:entity.ip} action=%{WORD:verb} %{GREEDYDATA:text}", "app"},
+    {"app", "%{TIMESTAMP_ISO8601:ts} +%{LOGLEVEL:level} \\[%{NOTSPACE:service}\\] %{GREEDYDATA:text}", "app"},
+};
+
+std::vector<std::string> sample_lines(size_t n) {
+    std::mt19937 rng(42);
+    static constexpr const char* users[] = {"alice", "bob", "carol", "svc-backup"};
+    std::vector<std::string> lines;
+    for (size_t i = 0; i < n; ++i) {
+        std::string ip = "10.0." + std::to_string(rng() % 64) + "." + std::to_string(rng() % 256);
+        std::string user = users[rng() % 4];
+        switch (rng() % 8) {
+            case 0:
+                lines.push_back("Failed password for " + user + " from " + ip + " port " +
+                                std::to_string(1024 + rng() % 60000) + " ssh2");
+                break;
+            case 1:
+                lines.push_back(ip + " - " + user + " [07/Nov/2025:23:00:01 +0000] \"GET /api/v1/items?id=" +
+                                std::to_string(rng() % 1000) + " HTTP/1.1\" 200 " + std::to_string(rng() % 5000));
+                break;
+            case 2:
+                lines.push_back("2025-11-07T23:00:01.003Z INFO [billing] user=" + user + " ip=" + ip +
+                                " action=login took 12ms");
+                break;
+            default:
+                lines.push_back("2025-11-07T23:00:01.003Z WARN [orders-" + std::to_string(rng() % 10) +
+                                "] queue depth " + std::to_string(rng() % 100000) + " above threshold");
+        }
+    }
+    return lines;
+}
+
+/**
+ * Grok syntax to std::regex ECMAScript, for the one-regex-after-another baseline
+ */
+std::string to_ecmascript(std::string pattern, const std::map<std::string, std::string>& definitions) {
+    static const std::regex reference(R"(%\{(\w+)(?::[\w.]+(?::\w+)?)?\})");
+    static const std::regex named(R"(\(\?<[\w.]+>)");
+    for (int depth = 0; depth < 16; ++depth) {
+        std::smatch m;
+        std::string out;
+        auto begin = pattern.cbegin();
+        bool changed = false;
+        while (std::regex_search(begin, pattern.cend(), m, reference)) {
+            out.append(begin, m[0].first);
+            bool capture = m[0].str().find(':') != std::string::npos;
+            out += (capture ? "(" : "(?:") + definitions.at(m[1].str()) + ")";
+            begin = m[0].second;
+            changed = true;
+        }
+        out.append(begin, pattern.cend());
+        pattern = std::move(out);
+        if (!changed) break;
+    }
+    return std::regex_replace(pattern, named, "(");
+}
+
+} // namespace
+
+int main() {
+    auto lines = sample_lines(20000);
+    size_t bytes = 0;
+    for (const auto& line : lines) bytes += line.size();
+
+    ingest::GrokMatcher::Config config;
+    config.patterns = kPatterns;
+    ingest::GrokMatcher grok(config);
+    config.timing = false;
+    ingest::GrokMatcher untimed(config);
+
+    bench::run("grok find (DFA only)", lines.size(), bytes, [&] {
+        size_t hits = 0;
+        for (const auto& line : lines) hits += grok.find(line) >= 0;
+        bench::consume(hits);
+    });
+
+    bench::run("grok match -> json", lines.size(), bytes, [&] {
+        size_t hits = 0;
+        for (const auto& line : lines) {
+            json event = json::object();
+            hits += grok.match(line, event);
+        }
+        bench::consume(hits);
+    });
+
+    bench::run("grok match -> json (no timing)", lines.size(), bytes, [&] {
+        size_t hits = 0;
+        for (const auto& line : lines) {
+            json event = json::object();
+            hits += untimed.match(line, event);
+        }
+        bench::consume(hits);
+    });
+
+    // What a pattern list costs when every regex is tried in turn
+    std::vector<std::regex> regexes;
+    for (const auto& pattern : kPatterns) {
+        regexes.emplace_back(to_ecmascript(pattern.match, ingest::GrokMatcher::builtin_definitions()),
+                             std::regex::ECMAScript | std::regex::optimize);
+    }
+    std::vector<std::string> sample(lines.begin(), lines.begin() + 2000);
+    size_t sample_bytes = 0;
+    for (const auto& line : sample) sample_bytes += line.size();
+    bench::run("std::regex one after another (baseline)", sample.size(), sample_bytes, [&] {
+        size_t hits = 0;
+        std::smatch m;
+        for (const auto& line : sample) {
+            for (const auto& re : regexes) {
+                if (std::regex_match(line, m, re)) {
+                    hits++;
+                    break;
+                }
+            }
+        }
+        bench::consume(hits);
+    });
+
+    for (const auto& pattern : grok.stats().patterns) {
+        std::printf("  %-16s %10lu hits %8.0f ns mean %8.0f ns p99\n", pattern.name.c_str(),
+                    static_cast<unsigned long>(pattern.hits), pattern.mean_ns(), pattern.percentile_ns(0.99));
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "bench.hpp"
+#include "core/event_normalizer.hpp"
+#include "ingest/binary_ingest_server.hpp"
+#include <boost/asio/connect.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace siem;
+using namespace siem::ingest;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = net::ip::tcp;
+
+namespace {
+
+constexpr size_t kEventsPerRun = 5000;
+
+json make_batch(size_t first, size_t size) {
+    json batch = json::array();
+    for (size_t i = first; i < first + size; ++i) {
+        batch.push_back({
+            {"source", "agent"},
+            {"host", "web-" + std::to_string(i % 8)},
+            {"ts", "2025-11-07T23:00:01.003Z"},
+            {"message", "GET /api/v1/orders/" + std::to_string(i) + " 200 1834"},
+            {"features", {{"status", 200}, {"bytes", 1834}, {"latency_ms", 12.5}, {"user", "alice"}}}
+        });
+    }
+    return batch;
+}
+
+/**
+ * Stand-in for RESTServer's POST /ingest (which needs MongoDB): same
+ * signature check and streaming parse, one request per connection like the
+ * real server, or keep-alive for a kinder baseline
+ */
+class HttpBaseline {
+public:
+    HttpBaseline(HTTPIngestor& policy, bool keep_alive, core::EventNormalizer* normalizer)
+        : policy_(policy), keep_alive_(keep_alive), normalizer_(normalizer),
+          acceptor_(ioc_, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0)) {
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~HttpBaseline() {
+        stopping_ = true;
+        boost::system::error_code ec;
+        tcp::socket wake(ioc_);
+        wake.connect(acceptor_.local_endpoint(), ec);
+        thread_.join();
+    }
+
+    unsigned short port() const { return acceptor_.local_endpoint().port(); }
+
+private:
+    HTTPIngestor& policy_;
+    bool keep_alive_;
+    core::EventNormalizer* normalizer_;
+    net::io_context ioc_;
+    tcp::acceptor acceptor_;
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+
+    void serve() {
+        while (!stopping_) {
+            tcp::socket socket(ioc_);
+            boost::system::error_code ec;
+            acceptor_.accept(socket, ec);
+            if (ec || stopping_) continue;
+
+            beast::flat_buffer buffer;
+            do {
+                http::request<http::string_body> req;
+                http::read(socket, buffer, req, ec);
+                if (ec) break;
+
+                http::response<http::string_body> res{http::status::ok, req.version()};
+                if (!policy_.verify_signature(req.body(), std::string(req["X-Signature"]))) {
+                    res.result(http::status::unauthorized);
+                } else {
+                    std::vector<json> raw;
+                    auto stats = policy_.parse_ingest_request(req.body(), [&](json&& event) {
+                        raw.push_back(std::move(event));
+                    });
+                    size_t stored = normalizer_ ? normalizer_->normalize_batch(raw).size() : raw.size();
+                    json response;
+                    response["accepted"] = stored;
+                    response["rejected"] = stats.rate_limited + raw.size() - stored;
+                    res.body() = response.dump();
+                }
+                res.keep_alive(keep_alive_);
+                res.prepare_payload();
+                http::write(socket, res, ec);
+            } while (keep_alive_ && !ec);
+            socket.shutdown(tcp::socket::shutdown_both, ec);
+        }
+    }
+};
+
+double run_http(const std::string& name, unsigned short port, bool keep_alive,
+                const std::vector<std::string>& bodies, const std::vector<std::string>& signatures) {
+    net::io_context ioc;
+    tcp::endpoint target(net::ip::make_address("127.0.0.1"), port);
+    std::unique_ptr<tcp::socket> socket;
+    beast::flat_buffer buffer;
+
+    return bench::run(name, kEventsPerRun, 0, [&] {
+        size_t accepted = 0;
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            if (!socket || !keep_alive) {
+                socket = std::make_unique<tcp::socket>(ioc);
+                socket->connect(target);
+                buffer.clear();
+            }
+            http::request<http::string_body> req{http::verb::post, "/ingest", 11};
+            req.set(http::field::host, "127.0.0.1");
+            req.set(http::field::content_type, "application/json");
+            req.set("X-Signature", signatures[i]);
+            req.keep_alive(keep_alive);
+            req.body() = bodies[i];
+            req.prepare_payload();
+            http::write(*socket, req);
+
+            http::response<http::string_body> res;
+            http::read(*socket, buffer, res);
+            accepted += json::parse(res.body())["accepted"].get<size_t>();
+        }
+        bench::consume(accepted);
+    });
+}
+
+double run_binary(const std::string& name, unsigned short port, IngestProtocol::Encoding encoding,
+                  const std::vector<json>& batches) {
+    std::vector<std::string> payloads;
+    for (const auto& batch : batches) payloads.push_back(IngestProtocol::encode_events(batch, encoding));
+
+    IngestClient client({"bench-secret", encoding});
+    client.connect("127.0.0.1", port);
+    return bench::run(name, kEventsPerRun, 0, [&] {
+        for (const auto& payload : payloads) client.send_encoded(payload);
+        bench::consume(client.flush().accepted);
+    });
+}
+
+} // namespace
+
+int main() {
+    HTTPIngestor::Config policy_config;
+    policy_config.hmac_secret = "bench-secret";
+    policy_config.rate_limit.enabled = false;
+    HTTPIngestor policy(policy_config);
+    core::EventNormalizer normalizer;
+
+    // Client and server share the loopback (and, here, the core); each line
+    // is one connection, or one per request for the first HTTP line
+    for (size_t batch_size : {100, 10}) {
+        std::vector<json> batches;
+        std::vector<std::string> bodies, signatures;
+        for (size_t first = 0; first < kEventsPerRun; first += batch_size) {
+            batches.push_back(make_batch(first, batch_size));
+            bodies.push_back(batches.back().dump());
+            signatures.push_back(HTTPIngestor::compute_hmac(policy_config.hmac_secret, bodies.back()));
+        }
+        std::printf("== %zu events per batch: %zu JSON / %zu MessagePack bytes\n", batch_size, bodies[0].size(),
+                    IngestProtocol::encode_events(batches[0], IngestProtocol::Encoding::MessagePack).size());
+
+        for (bool normalize : {false, true}) {
+            std::printf("%s\n", normalize ? "-- with normalize_batch" : "-- ingest layer only");
+            core::EventNormalizer* norm = normalize ? &normalizer : nullptr;
+
+            double http_close, http_keep_alive;
+            {
+                HttpBaseline server(policy, false, norm);
+                http_close = run_http("HTTP, connection per request", server.port(), false, bodies, signatures);
+            }
+            {
+                HttpBaseline server(policy, true, norm);
+                http_keep_alive = run_http("HTTP keep-alive", server.port(), true, bodies, signatures);
+            }
+
+            BinaryIngestServer::Config config;
+            config.port = 0;
+            BinaryIngestServer server(config, policy);
+            server.start([&](const std::vector<json>& events) {
+                return norm ? norm->normalize_batch(events).size() : events.size();
+            });
+            double msgpack = run_binary("binary MessagePack", server.port(), IngestProtocol::Encoding::MessagePack, batches);
+            double cbor = run_binary("binary CBOR", server.port(), IngestProtocol::Encoding::Cbor, batches);
+            server.stop();
+
+            std::printf("%-40s %14.1fx vs per-request HTTP, %.1fx vs keep-alive\n", "MessagePack speedup",
+                        msgpack / http_close, msgpack / http_keep_alive);
+            std::printf("%-40s %14.1fx vs per-request HTTP, %.1fx vs keep-alive\n", "CBOR speedup",
+                        cbor / http_close, cbor / http_keep_alive);
+        }
+    }
+    return 0;
+}
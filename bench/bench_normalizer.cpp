@@ -0,0 +1,54 @@
+#include "bench.hpp"
+#include "core/event_normalizer.hpp"
+#include "core/simd_normalizer.hpp"
+#include "ingest/event_stream.hpp"
+
+using namespace siem;
+using json = nlohmann::json;
+
+int main() {
+    json batch = json::array();
+    for (int i = 0; i < 10000; ++i) {
+        batch.push_back({
+            {"ts", "2025-11-07T23:00:01Z"},
+            {"source", i % 3 == 0 ? "fw" : "ids"},
+            {"host", "edge-" + std::to_string(i % 16)},
+            {"entity", {{"ip", "10.0." + std::to_string(i % 256) + ".7"}}},
+            {"verb", "deny"},
+            {"object", {{"proto", "tcp"}, {"dport", 22}, {"bytes", 184 + i}}},
+            {"outcome", "block"},
+            {"message", "connection denied by policy edge-in"}
+        });
+    }
+    std::string body = batch.dump();
+    size_t count = batch.size();
+
+    core::EventNormalizer normalizer;
+    core::SimdEventNormalizer simd_normalizer;
+
+    std::printf("batch: %zu events, %zu bytes\n", count, body.size());
+
+    bench::run("json::parse + normalize_batch", count, body.size(), [&] {
+        std::vector<json> raw;
+        for (const auto& item : json::parse(body)) raw.push_back(item);
+        bench::consume(normalizer.normalize_batch(raw).size());
+    });
+
+    bench::run("EventStreamParser + normalize", count, body.size(), [&] {
+        size_t n = 0;
+        ingest::EventStreamParser::parse(body, [&](json&& raw) {
+            n += normalizer.normalize(raw).fingerprint & 1;
+        });
+        bench::consume(n);
+    });
+
+    bench::run("SimdEventNormalizer::normalize_array", count, body.size(), [&] {
+        size_t n = 0;
+        simd_normalizer.normalize_array(body, [&](storage::Event&& e) {
+            n += e.fingerprint & 1;
+        });
+        bench::consume(n);
+    });
+
+    return 0;
+}
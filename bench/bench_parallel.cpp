@@ -0,0 +1,48 @@
+#include "bench.hpp"
+#include "core/event_normalizer.hpp"
+#include "core/worker_pool.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+using namespace siem;
+using json = nlohmann::json;
+
+// Usage: bench_parallel [max_threads]; defaults to hardware concurrency
+int main(int argc, char** argv) {
+    std::vector<json> raw;
+    for (int i = 0; i < 10000; ++i) {
+        raw.push_back({
+            {"ts", "2025-11-07T23:00:01Z"},
+            {"source", i % 3 == 0 ? "fw" : "ids"},
+            {"host", "edge-" + std::to_string(i % 16)},
+            {"entity", {{"ip", "10.0." + std::to_string(i % 256) + ".7"}}},
+            {"verb", "deny"},
+            {"object", {{"proto", "tcp"}, {"dport", 22}, {"bytes", 184 + i}}},
+            {"outcome", "block"}
+        });
+    }
+
+    size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                  : std::max(1u, std::thread::hardware_concurrency());
+    std::printf("batch: %zu events, hardware threads: %u\n",
+                raw.size(), std::thread::hardware_concurrency());
+
+    core::EventNormalizer::Config config;
+    config.parallel_min_batch = 1;
+
+    double single = 0.0;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        // The calling thread is one of the `threads` workers
+        core::WorkerPool pool(threads - 1);
+        core::EventNormalizer normalizer(config, pool);
+
+        double rate = bench::run("normalize_batch x" + std::to_string(threads), raw.size(), 0, [&] {
+            bench::consume(normalizer.normalize_batch(raw).size());
+        });
+        if (threads == 1) single = rate;
+        std::printf("%-40s %14.2fx\n", "  speedup", rate / single);
+    }
+
+    return 0;
+}
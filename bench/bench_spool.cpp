@@ -0,0 +1,96 @@
+#include "bench.hpp"
+#include "ingest/spool_ingestor.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+using namespace siem;
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+
+size_t write_spool(const fs::path& dir, size_t files, size_t events_per_file) {
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    size_t bytes = 0;
+    for (size_t f = 0; f < files; ++f) {
+        std::string content;
+        for (size_t i = 0; i < events_per_file; ++i) {
+            content += json{
+                {"ts", "2025-11-07T23:00:01Z"},
+                {"source", "fw"},
+                {"host", "edge-" + std::to_string(f % 16)},
+                {"entity", {{"ip", "10.0." + std::to_string(i % 256) + ".7"}}},
+                {"verb", "deny"},
+                {"object", {{"proto", "tcp"}, {"dport", 22}}}
+            }.dump() + "\n";
+        }
+        char name[32];
+        std::snprintf(name, sizeof(name), "%06zu.ndjson", f);
+        std::ofstream(dir / name, std::ios::binary) << content;
+        bytes += content.size();
+    }
+    return bytes;
+}
+
+void report(const char* name, size_t files, size_t bytes, std::chrono::steady_clock::duration elapsed) {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    std::printf("%-40s %14.0f files/s %10.1f MB/s\n", name, files / seconds, bytes / seconds / 1e6);
+}
+
+} // namespace
+
+// Usage: bench_spool [files] [events_per_file]
+int main(int argc, char** argv) {
+    spdlog::set_level(spdlog::level::warn);
+
+    size_t files = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    size_t per_file = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20;
+    auto dir = fs::temp_directory_path() / "siem_bench_spool";
+    using clock = std::chrono::steady_clock;
+
+    size_t bytes = write_spool(dir, files, per_file);
+    std::printf("spool: %zu files x %zu events, %.1f MB\n", files, per_file, bytes / 1e6);
+
+    {
+        // Baseline: one file at a time through ingest_file, then moved
+        ingest::FileIngestor ingestor;
+        fs::create_directories(dir / "done");
+        std::vector<fs::path> paths;
+        for (const auto& entry : fs::directory_iterator(dir)) {
+            if (entry.is_regular_file()) paths.push_back(entry.path());
+        }
+
+        size_t events = 0;
+        auto start = clock::now();
+        for (const auto& path : paths) {
+            ingestor.ingest_file(path.string(), [&](const std::vector<json>& batch) { events += batch.size(); });
+            fs::rename(path, dir / "done" / path.filename());
+        }
+        report("sequential ingest_file + move", files, bytes, clock::now() - start);
+        bench::consume(events);
+    }
+
+    for (size_t threads : {size_t{0}, core::WorkerPool::default_threads()}) {
+        write_spool(dir, files, per_file);
+        core::WorkerPool pool(threads);
+        ingest::SpoolIngestor::Config config;
+        config.dir = dir.string();
+        ingest::SpoolIngestor spool(config, pool);
+        fs::create_directories(dir / "done");
+        fs::create_directories(dir / "failed");
+
+        size_t events = 0;
+        auto start = clock::now();
+        while (spool.scan([&](const std::vector<json>& batch) { events += batch.size(); }) > 0) {}
+        std::string name = "spool scan + move (" + std::to_string(pool.size() + 1) + " readers)";
+        report(name.c_str(), files, bytes, clock::now() - start);
+        bench::consume(events);
+    }
+
+    fs::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include "bench.hpp"
+#include "ingest/syslog_parser.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace siem;
+
+// Count heap allocations so the parser's zero-allocation claim is checked
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    std::vector<std::string> messages;
+    for (int i = 0; i < 10000; ++i) {
+        std::string host = "edge-" + std::to_string(i % 16);
+        if (i % 2 == 0) {
+            messages.push_back("<165>1 2025-11-07T23:00:01.003Z " + host + " sshd " + std::to_string(4000 + i) +
+                               R"( AUTH [origin ip="10.0.)" + std::to_string(i % 256) + R"(.7"][auth@32473 user="alice"])"
+                               " Failed password for alice from 10.0.0.7 port 52144 ssh2");
+        } else {
+            messages.push_back("<34>Nov  7 23:00:01 " + host + " su[" + std::to_string(i) +
+                               "]: 'su root' failed for lonvick on /dev/pts/8");
+        }
+    }
+
+    size_t bytes = 0;
+    for (const auto& m : messages) bytes += m.size();
+    std::printf("messages: %zu, %zu bytes\n", messages.size(), bytes);
+
+    size_t parse_allocations = 0;
+    double rate = bench::run("parse (5424 + 3164 mix)", messages.size(), bytes, [&] {
+        size_t before = allocations.load();
+        size_t n = 0;
+        ingest::SyslogMessage message;
+        for (const auto& m : messages) n += ingest::SyslogParser::parse(m, message) ? message.msg.size() : 0;
+        parse_allocations += allocations.load() - before;
+        bench::consume(n);
+    });
+    std::printf("%-40s %14zu heap allocations while parsing\n", "", parse_allocations);
+
+    bench::run("parse + to_event", messages.size(), bytes, [&] {
+        size_t n = 0;
+        ingest::SyslogMessage message;
+        for (const auto& m : messages) {
+            if (ingest::SyslogParser::parse(m, message)) {
+                n += ingest::SyslogParser::to_event(message, "syslog").size();
+            }
+        }
+        bench::consume(n);
+    });
+
+    std::printf("parser at %.0f msgs/s: %.1f%% of one core for 200k msgs/s\n", rate, 100.0 * 200000.0 / rate);
+    return parse_allocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+#include "bench.hpp"
+#include "core/timestamp.hpp"
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+using namespace siem;
+
+namespace {
+
+// Previous EventNormalizer path, kept for comparison
+storage::timestamp_t parse_with_get_time(const std::string& ts_str) {
+    std::tm tm = {};
+    std::istringstream ss(ts_str);
+    ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+}
+
+size_t ticks(const storage::timestamp_t& ts) {
+    return static_cast<size_t>(ts.time_since_epoch().count());
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> inputs;
+    size_t bytes = 0;
+    for (int i = 0; i < 1000; ++i) {
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "2025-11-%02dT%02d:%02d:%02d.%03dZ",
+                      1 + i % 28, i % 24, i % 60, (i * 7) % 60, i % 1000);
+        inputs.emplace_back(buf);
+        bytes += inputs.back().size();
+    }
+
+    bench::run("istringstream + get_time + mktime", inputs.size(), bytes, [&] {
+        size_t sum = 0;
+        for (const auto& s : inputs) sum += ticks(parse_with_get_time(s));
+        bench::consume(sum);
+    });
+
+    bench::run("TimestampParser::parse (RFC 3339)", inputs.size(), bytes, [&] {
+        size_t sum = 0;
+        for (const auto& s : inputs) sum += ticks(*core::TimestampParser::parse(s));
+        bench::consume(sum);
+    });
+
+    bench::run("TimestampParser::from_epoch (millis)", inputs.size(), inputs.size() * 8, [&] {
+        size_t sum = 0;
+        for (int64_t i = 0; i < static_cast<int64_t>(inputs.size()); ++i) {
+            sum += ticks(*core::TimestampParser::from_epoch(int64_t{1762556401000LL} + i));
+        }
+        bench::consume(sum);
+    });
+
+    return 0;
+}
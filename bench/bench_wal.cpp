@@ -0,0 +1,79 @@
+#include "bench.hpp"
+#include "storage/wal.hpp"
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+
+using namespace siem;
+using namespace siem::storage;
+namespace fs = std::filesystem;
+
+namespace {
+
+std::vector<Event> make_batch(size_t count) {
+    std::vector<Event> events(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& event = events[i];
+        event.ts = std::chrono::system_clock::now();
+        event.source = Symbol("fw");
+        event.host = Symbol("edge-" + std::to_string(i % 16));
+        event.trace_id = "tr_" + std::to_string(100000 + i);
+        event.fingerprint = 0x9e3779b97f4a7c15ULL * (i + 1);
+        event.features.set_string("verb", "deny");
+        event.features.set_string("outcome", "block");
+        event.features.set_string("proto", "tcp");
+        event.features.set("dport", static_cast<int>(1024 + i % 4096));
+        event.features.set_string("ip", "10.0." + std::to_string(i % 256) + ".7");
+        event.features.set_string("user", "alice");
+    }
+    return events;
+}
+
+} // namespace
+
+int main() {
+    // Where the log would live; the temp dir may be tmpfs, where syncs are free
+    auto dir = fs::path(std::getenv("SIEM_WAL_BENCH_DIR") ? std::getenv("SIEM_WAL_BENCH_DIR") : "bench_wal_data") /
+               std::to_string(::getpid());
+    std::printf("wal dir: %s\n", dir.string().c_str());
+
+    auto batch = make_batch(100);
+    std::string payload;
+    WriteAheadLog::encode_events(batch, payload);
+    std::printf("record: %zu events, %zu bytes\n", batch.size(), payload.size());
+
+    bench::run("encode", batch.size(), payload.size(), [&] {
+        payload.clear();
+        WriteAheadLog::encode_events(batch, payload);
+        bench::consume(payload.size());
+    });
+    bench::run("decode", batch.size(), payload.size(), [&] {
+        bench::consume(WriteAheadLog::decode_events(payload).size());
+    });
+
+    WriteAheadLog::Config config;
+    config.dir = dir.string();
+    WriteAheadLog wal(config);
+    wal.start([](std::vector<Event>& events) { bench::consume(events.size()); });
+
+    for (size_t threads : {1, 4, 16}) {
+        auto before = wal.stats();
+        bench::run("append + fdatasync, " + std::to_string(threads) + " threads", batch.size() * threads * 20, 0, [&] {
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&] {
+                    for (int i = 0; i < 20; ++i) wal.append(batch);
+                });
+            }
+            for (auto& worker : workers) worker.join();
+        });
+        auto after = wal.stats();
+        std::printf("%-40s %14.2f appends per fdatasync\n", "",
+                    static_cast<double>(after.appended_records - before.appended_records) /
+                    static_cast<double>(std::max<uint64_t>(after.syncs - before.syncs, 1)));
+    }
+
+    wal.stop();
+    fs::remove_all(dir);
+    return 0;
+}
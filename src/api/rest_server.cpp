@@ -7,10 +7,12 @@ namespace siem::api {
 RESTServer::RESTServer(
     Config config,
     storage::MongoStorage& storage,
-    ingest::HTTPIngestor& http_ingestor)
+    ingest::HTTPIngestor& http_ingestor,
+    core::EventNormalizer& normalizer)
     : config_(config)
     , storage_(storage)
     , http_ingestor_(http_ingestor)
+    , normalizer_(normalizer)
     , ioc_(std::make_unique<net::io_context>()) {}
 
 RESTServer::~RESTServer() {
@@ -73,8 +75,10 @@ void RESTServer::do_accept() {
 void RESTServer::handle_request(tcp::socket socket) {
     try {
         beast::flat_buffer buffer;
-        http::request<http::string_body> req;
-        http::read(socket, buffer, req);
+        http::request_parser<http::string_body> parser;
+        parser.body_limit(http_ingestor_.max_body_size());
+        http::read(socket, buffer, parser);
+        http::request<http::string_body> req = parser.release();
         
         http::response<http::string_body> res;
         
@@ -103,7 +107,7 @@ void RESTServer::handle_request(tcp::socket socket) {
         // Add CORS headers
         res.set(http::field::access_control_allow_origin, "*");
         res.set(http::field::access_control_allow_methods, "GET, POST, OPTIONS");
-        res.set(http::field::access_control_allow_headers, "Content-Type, X-Signature");
+        res.set(http::field::access_control_allow_headers, "Content-Type, Content-Encoding, X-Signature");
         
         http::write(socket, res);
         socket.shutdown(tcp::socket::shutdown_send);
@@ -134,6 +138,14 @@ http::response<http::string_body> RESTServer::handle_ingest(
                                R"({"error":"Missing X-Signature header"})");
         }
         
+        auto coding = req[http::field::content_encoding];
+        auto encoding = ingest::parse_content_encoding(std::string_view(coding.data(), coding.size()));
+        if (!encoding) {
+            return make_response(http::status::unsupported_media_type,
+                               R"({"error":"Unsupported Content-Encoding"})");
+        }
+        
+        // Signed as sent, i.e. over the compressed bytes
         std::string signature = std::string(sig_it->value());
         if (!http_ingestor_.verify_signature(req.body(), signature)) {
             spdlog::warn(R"({{"msg":"invalid_signature"}})");
@@ -141,19 +153,69 @@ http::response<http::string_body> RESTServer::handle_ingest(
                                R"({"error":"Invalid signature"})");
         }
         
-        // Parse events
-        auto events = http_ingestor_.parse_ingest_request(req.body());
+        // Normalize and hand off a chunk at a time as the parser emits
+        // events, so only one chunk's DOM is alive at once
+        size_t chunk = normalizer_.chunk_size();
+        size_t accepted = 0;            // Handed off, so kept whatever happens next
+        size_t failed = 0;
+        bool refused = false;           // The callback (e.g. a full WAL) threw
+        std::vector<json> raw_events;
+        raw_events.reserve(chunk);
+        auto flush = [&] {
+            auto events = normalizer_.normalize_batch(raw_events);
+            failed += raw_events.size() - events.size();
+            raw_events.clear();
+            
+            // Invoke callback; it may take the events
+            size_t count = events.size();
+            if (ingest_callback_ && !events.empty()) {
+                try {
+                    ingest_callback_(events);
+                } catch (...) {
+                    refused = true;
+                    throw;
+                }
+            }
+            accepted += count;
+        };
         
-        // Invoke callback
-        if (ingest_callback_) {
-            ingest_callback_(events);
+        ingest::HTTPIngestor::IngestStats stats;
+        try {
+            http_ingestor_.parse_ingest_request(req.body(), *encoding, [&](json&& raw) {
+                raw_events.push_back(std::move(raw));
+                if (raw_events.size() >= chunk) flush();
+            }, stats);
+            if (!raw_events.empty()) flush();
+        } catch (const std::exception& e) {
+            if (accepted == 0 && refused) {
+                // Nothing kept and the body itself is fine: the client
+                // should send it again later, not drop it
+                spdlog::warn(R"({{"msg":"ingest_refused","error":"{}"}})", e.what());
+                json response;
+                response["error"] = e.what();
+                auto res = make_response(http::status::service_unavailable, response.dump());
+                res.set(http::field::retry_after, std::to_string(config_.retry_after_seconds));
+                return res;
+            }
+            if (accepted == 0) throw;
+            
+            // Earlier chunks are already kept; a 400 would have the client
+            // send them again, so report what was kept alongside the error
+            spdlog::warn(R"({{"msg":"ingest_partial","accepted":{},"rate_limited":{},"failed":{},"error":"{}"}})",
+                        accepted, stats.rate_limited, failed, e.what());
+            json response;
+            response["accepted"] = accepted;
+            response["rejected"] = stats.rate_limited + failed;
+            response["error"] = e.what();
+            return make_response(http::status::multi_status, response.dump());
         }
         
         json response;
-        response["accepted"] = events.size();
-        response["rejected"] = 0;
+        response["accepted"] = accepted;
+        response["rejected"] = stats.rate_limited + failed;
         
-        spdlog::info(R"({{"msg":"ingested","count":{}}})", events.size());
+        spdlog::info(R"({{"msg":"ingested","count":{},"rate_limited":{},"failed":{},"redacted":{}}})",
+                    accepted, stats.rate_limited, failed, stats.redacted);
         
         return make_response(http::status::ok, response.dump());
         
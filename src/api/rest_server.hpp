@@ -1,6 +1,7 @@
 #pragma once
 
 #include "storage/mongo.hpp"
+#include "core/event_normalizer.hpp"
 #include "ingest/http_ingestor.hpp"
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
@@ -23,17 +24,19 @@ namespace siem::api {
  */
 class RESTServer {
 public:
-    using IngestCallback = std::function<void(const std::vector<json>&)>;
+    using IngestCallback = std::function<void(std::vector<storage::Event>&)>;
 
     struct Config {
         unsigned short port = 8080;
         std::string bind_address = "0.0.0.0";
+        int retry_after_seconds = 5;      // Sent with 503 when the pipeline refuses a body
     };
 
     explicit RESTServer(
         Config config,
         storage::MongoStorage& storage,
-        ingest::HTTPIngestor& http_ingestor);
+        ingest::HTTPIngestor& http_ingestor,
+        core::EventNormalizer& normalizer);
     
     ~RESTServer();
 
@@ -58,6 +61,7 @@ private:
     Config config_;
     storage::MongoStorage& storage_;
     ingest::HTTPIngestor& http_ingestor_;
+    core::EventNormalizer& normalizer_;
     IngestCallback ingest_callback_;
     
     std::unique_ptr<net::io_context> ioc_;
@@ -0,0 +1,151 @@
+#include "core/adaptive_batcher.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <iterator>
+
+namespace siem::core {
+
+AdaptiveBatcher::AdaptiveBatcher(Config config, Sink sink)
+    : config_(config)
+    , sink_(std::move(sink))
+    , target_(std::max<size_t>(config.min_batch, 1)) {
+    config_.min_batch = target_.load();
+    config_.max_batch = std::max(config_.max_batch, config_.min_batch);
+}
+
+AdaptiveBatcher::~AdaptiveBatcher() {
+    stop();
+}
+
+void AdaptiveBatcher::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&AdaptiveBatcher::linger_loop, this);
+
+    spdlog::info(R"({{"msg":"batcher_started","slo_ms":{},"linger_ms":{},"min_batch":{},"max_batch":{}}})",
+                config_.latency_slo_ms, config_.max_linger_ms, config_.min_batch, config_.max_batch);
+}
+
+void AdaptiveBatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_ && thread_->joinable()) thread_->join();
+    thread_.reset();
+
+    // Also what add() buffered without a timer running
+    EventPipeline::Batch rest;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::swap(rest, buffer_);
+    }
+    if (!rest.events.empty()) {
+        try {
+            send(std::move(rest));
+        } catch (const std::exception& e) {
+            spdlog::error(R"({{"msg":"batcher_flush_failed","error":"{}"}})", e.what());
+        }
+    }
+}
+
+void AdaptiveBatcher::add(std::vector<storage::Event>& events, uint64_t lsn) {
+    if (events.empty()) return;
+
+    EventPipeline::Batch full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (buffer_.events.empty()) {
+            if (events.size() >= target()) {
+                // Big enough on its own; skip the copy into the buffer
+                full.events.swap(events);
+                if (lsn != 0) full.lsns.push_back(lsn);
+            } else {
+                oldest_ = clock::now();
+                cv_.notify_one();           // Arm the linger timer
+            }
+        }
+        if (full.events.empty()) {
+            buffer_.events.insert(buffer_.events.end(), std::make_move_iterator(events.begin()),
+                                  std::make_move_iterator(events.end()));
+            events.clear();
+            if (lsn != 0) buffer_.lsns.push_back(lsn);
+            if (buffer_.events.size() >= target()) std::swap(full, buffer_);
+        }
+    }
+
+    if (!full.events.empty()) {
+        size_flushes_.fetch_add(1, std::memory_order_relaxed);
+        send(std::move(full));
+    }
+}
+
+void AdaptiveBatcher::observe(std::chrono::nanoseconds latency, size_t depth) {
+    latency_ns_.fetch_add(static_cast<uint64_t>(latency.count()), std::memory_order_relaxed);
+
+    // Lingering in the buffer comes out of the same budget
+    auto budget = std::chrono::milliseconds(std::max(config_.latency_slo_ms - config_.max_linger_ms, 1));
+    bool on_time = latency <= budget;
+    bool grow = on_time || depth > config_.backlog_depth;
+    (on_time ? on_time_ : late_).fetch_add(1, std::memory_order_relaxed);
+
+    size_t current = target_.load(std::memory_order_relaxed);
+    size_t next;
+    do {
+        next = grow ? current + config_.additive_step
+                    : static_cast<size_t>(static_cast<double>(current) * config_.decrease_factor);
+        next = std::clamp(next, config_.min_batch, config_.max_batch);
+    } while (!target_.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+AdaptiveBatcher::Stats AdaptiveBatcher::stats() const {
+    Stats stats;
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.events = events_.load(std::memory_order_relaxed);
+    stats.size_flushes = size_flushes_.load(std::memory_order_relaxed);
+    stats.linger_flushes = linger_flushes_.load(std::memory_order_relaxed);
+    stats.on_time = on_time_.load(std::memory_order_relaxed);
+    stats.late = late_.load(std::memory_order_relaxed);
+    stats.latency_ns = latency_ns_.load(std::memory_order_relaxed);
+    stats.target = target();
+    return stats;
+}
+
+void AdaptiveBatcher::linger_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        if (buffer_.events.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+
+        auto deadline = oldest_ + std::chrono::milliseconds(config_.max_linger_ms);
+        if (clock::now() < deadline) {
+            cv_.wait_until(lock, deadline);
+            continue;
+        }
+
+        EventPipeline::Batch batch;
+        std::swap(batch, buffer_);
+        lock.unlock();
+
+        size_t count = batch.events.size();
+        linger_flushes_.fetch_add(1, std::memory_order_relaxed);
+        try {
+            send(std::move(batch));
+        } catch (const std::exception& e) {
+            spdlog::error(R"({{"msg":"batcher_flush_failed","events":{},"error":"{}"}})", count, e.what());
+        }
+        lock.lock();
+    }
+}
+
+void AdaptiveBatcher::send(EventPipeline::Batch&& batch) {
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    events_.fetch_add(batch.events.size(), std::memory_order_relaxed);
+    sink_(std::move(batch));
+}
+
+} // namespace siem::core
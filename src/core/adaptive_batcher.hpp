@@ -0,0 +1,116 @@
+#pragma once
+
+#include "core/event_pipeline.hpp"
+#include "storage/schemas.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace siem::core {
+
+/**
+ * Micro-batching in front of the event pipeline
+ * Events from any number of ingest calls collect in one buffer that goes
+ * to the sink once it holds target() events or its oldest event has waited
+ * max_linger_ms, whichever comes first. The target is adjusted by AIMD
+ * from what the pipeline reports back through observe():
+ * - a batch done within its budget, latency_slo_ms less max_linger_ms,
+ *   grows the target by additive_step;
+ * - a late batch with little queued downstream means batches themselves
+ *   are too slow, and the target is multiplied by decrease_factor;
+ * - a late batch behind a backlog (depth above backlog_depth) grows the
+ *   target instead, since smaller batches would only drain it slower.
+ * The target stays within [min_batch, max_batch]. Write-ahead log LSNs
+ * given to add() go out with the batch holding their events.
+ */
+class AdaptiveBatcher {
+public:
+    using Sink = std::function<void(EventPipeline::Batch&&)>;
+
+    struct Config {
+        int latency_slo_ms = 250;           // add() to stored, including the linger
+        int max_linger_ms = 20;             // Longest an event waits for company
+        size_t min_batch = 16;
+        size_t max_batch = 8192;
+        size_t additive_step = 32;          // Events added to the target per on-time batch
+        double decrease_factor = 0.5;       // Target multiplier per late batch
+        size_t backlog_depth = 4;           // Downstream batches that count as a backlog
+    };
+
+    struct Stats {
+        uint64_t batches = 0;
+        uint64_t events = 0;
+        uint64_t size_flushes = 0;          // Sent because the buffer reached the target
+        uint64_t linger_flushes = 0;        // Sent because max_linger_ms ran out
+        uint64_t on_time = 0;               // Observed batches within the SLO
+        uint64_t late = 0;
+        uint64_t latency_ns = 0;            // Summed over observed batches
+        size_t target = 0;
+    };
+
+    AdaptiveBatcher(Config config, Sink sink);
+    ~AdaptiveBatcher();
+
+    AdaptiveBatcher(const AdaptiveBatcher&) = delete;
+    AdaptiveBatcher& operator=(const AdaptiveBatcher&) = delete;
+
+    /**
+     * Start the linger timer
+     */
+    void start();
+
+    /**
+     * Send what is buffered and stop the timer
+     */
+    void stop();
+
+    /**
+     * Take the events, and the write-ahead log batch they came from unless
+     * lsn is 0; sends the buffer on this thread when it reaches the target.
+     * Exceptions from the sink propagate to the caller.
+     */
+    void add(std::vector<storage::Event>& events, uint64_t lsn = 0);
+
+    /**
+     * Feedback for one finished batch: its push-to-done latency and the
+     * number of batches still queued downstream
+     */
+    void observe(std::chrono::nanoseconds latency, size_t depth);
+
+    size_t target() const { return target_.load(std::memory_order_relaxed); }
+
+    Stats stats() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    Config config_;
+    Sink sink_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    EventPipeline::Batch buffer_;
+    clock::time_point oldest_;              // When the first buffered event arrived
+    bool running_ = false;
+    std::unique_ptr<std::thread> thread_;
+
+    std::atomic<size_t> target_;
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> size_flushes_{0};
+    std::atomic<uint64_t> linger_flushes_{0};
+    std::atomic<uint64_t> on_time_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> latency_ns_{0};
+
+    void linger_loop();
+    void send(EventPipeline::Batch&& batch);
+};
+
+} // namespace siem::core
@@ -0,0 +1,56 @@
+#include "core/batch_tickets.hpp"
+#include <stdexcept>
+
+namespace siem::core {
+
+uint64_t BatchTickets::issue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t ticket = next_++;
+    tickets_.emplace(ticket, Outcome{});
+    return ticket;
+}
+
+void BatchTickets::complete(const std::vector<uint64_t>& tickets) {
+    resolve(tickets, nullptr);
+}
+
+void BatchTickets::fail(const std::vector<uint64_t>& tickets, const std::string& error) {
+    resolve(tickets, &error);
+}
+
+void BatchTickets::resolve(const std::vector<uint64_t>& tickets, const std::string* error) {
+    if (tickets.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (uint64_t ticket : tickets) {
+            auto it = tickets_.find(ticket);
+            if (it == tickets_.end() || it->second.done) continue;
+            it->second.done = true;
+            if (error) it->second.error = error->empty() ? "batch failed" : *error;
+        }
+    }
+    // Waiters on other tickets go back to sleep
+    cv_.notify_all();
+}
+
+void BatchTickets::wait(uint64_t ticket) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = tickets_.find(ticket);
+    if (it == tickets_.end()) {
+        throw std::invalid_argument("Unknown batch ticket");
+    }
+    // References survive rehashing by issue(), iterators do not
+    Outcome& outcome = it->second;
+    cv_.wait(lock, [&] { return outcome.done; });
+
+    std::string error = std::move(outcome.error);
+    tickets_.erase(ticket);
+    if (!error.empty()) throw std::runtime_error(error);
+}
+
+size_t BatchTickets::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tickets_.size();
+}
+
+} // namespace siem::core
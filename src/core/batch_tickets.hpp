@@ -0,0 +1,59 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace siem::core {
+
+/**
+ * Lets an ingest call wait until the pipeline is done with its events
+ * issue() hands out a ticket that rides in EventPipeline::Batch::lsns in
+ * place of a write-ahead log LSN (merged batches carry all of theirs). The
+ * last stage complete()s the tickets of what it stored, the failure
+ * callback fail()s them, and wait() returns or throws accordingly. Only
+ * the first outcome for a ticket counts. Tickets are never 0, which
+ * AdaptiveBatcher::add() reads as "none".
+ */
+class BatchTickets {
+public:
+    BatchTickets() = default;
+
+    BatchTickets(const BatchTickets&) = delete;
+    BatchTickets& operator=(const BatchTickets&) = delete;
+
+    uint64_t issue();
+
+    void complete(const std::vector<uint64_t>& tickets);
+    void fail(const std::vector<uint64_t>& tickets, const std::string& error);
+
+    /**
+     * Block until the ticket has an outcome and release it; throws
+     * std::runtime_error with the error it failed with
+     */
+    void wait(uint64_t ticket);
+
+    /**
+     * Tickets issued and not yet waited for
+     */
+    size_t pending() const;
+
+private:
+    struct Outcome {
+        bool done = false;
+        std::string error;
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    uint64_t next_ = 1;
+    std::unordered_map<uint64_t, Outcome> tickets_;
+
+    void resolve(const std::vector<uint64_t>& tickets, const std::string* error);
+};
+
+} // namespace siem::core
@@ -3,6 +3,7 @@
 #include <spdlog/spdlog.h>
 #include <algorithm>
 #include <set>
+#include <unordered_map>
 
 namespace siem::core {
 
@@ -14,11 +15,14 @@ std::vector<std::string> CorrelationEngine::correlate_events(
     
     std::vector<std::string> affected_incident_ids;
     
-    // Group events by entity
-    std::map<std::string, std::vector<storage::Event>> entity_groups;
+    // Group events by entity, in order of first appearance
+    std::vector<std::pair<storage::Symbol, std::vector<storage::Event>>> entity_groups;
+    std::unordered_map<storage::Symbol, size_t> group_index;
     for (const auto& event : events) {
-        std::string entity_key = extract_entity_key(event);
-        entity_groups[entity_key].push_back(event);
+        storage::Symbol entity_key = extract_entity_key(event);
+        auto [it, inserted] = group_index.try_emplace(entity_key, entity_groups.size());
+        if (inserted) entity_groups.emplace_back(entity_key, std::vector<storage::Event>{});
+        entity_groups[it->second].second.push_back(event);
     }
     
     auto now = std::chrono::system_clock::now();
@@ -42,19 +46,10 @@ std::vector<std::string> CorrelationEngine::correlate_events(
         // Look for existing open incident for this entity
         if (!found) {
             for (auto& [iid, inc] : incidents) {
-                if (inc.status == storage::IncidentStatus::Open) {
-                    std::string inc_entity_key;
-                    if (inc.entity.contains("ip")) {
-                        inc_entity_key = inc.entity["ip"].get<std::string>();
-                    } else if (inc.entity.contains("host")) {
-                        inc_entity_key = inc.entity["host"].get<std::string>();
-                    }
-                    
-                    if (inc_entity_key == entity_key) {
-                        incident_id = iid;
-                        found = true;
-                        break;
-                    }
+                if (inc.status == storage::IncidentStatus::Open && inc.entity_key == entity_key) {
+                    incident_id = iid;
+                    found = true;
+                    break;
                 }
             }
         }
@@ -73,10 +68,11 @@ std::vector<std::string> CorrelationEngine::correlate_events(
             new_incident.last_event_ts = entity_events.back().ts;
             
             // Set entity from events
-            if (entity_events[0].features.contains("ip")) {
-                new_incident.entity["ip"] = entity_events[0].features["ip"];
+            if (!entity_events[0].features.ip.empty()) {
+                new_incident.entity["ip"] = entity_events[0].features.ip.str();
             }
-            new_incident.entity["host"] = entity_events[0].host;
+            new_incident.entity["host"] = entity_events[0].host.str();
+            new_incident.entity_key = entity_key;
             
             // Collect cluster IDs
             std::set<std::string> cluster_set;
@@ -117,9 +113,9 @@ std::vector<std::string> CorrelationEngine::correlate_events(
     return affected_incident_ids;
 }
 
-std::string CorrelationEngine::extract_entity_key(const storage::Event& event) const {
-    if (event.features.contains("ip")) {
-        return event.features["ip"].get<std::string>();
+storage::Symbol CorrelationEngine::extract_entity_key(const storage::Event& event) const {
+    if (!event.features.ip.empty()) {
+        return event.features.ip;
     }
     return event.host;
 }
@@ -133,16 +129,18 @@ storage::Severity CorrelationEngine::determine_severity(
     bool has_malware = false;
     
     for (const auto& evt : related_events) {
-        if (evt.features.contains("outcome")) {
-            std::string outcome = evt.features["outcome"].get<std::string>();
-            if (outcome == "deny" || outcome == "block") deny_count++;
-            if (outcome == "fail") fail_count++;
+        switch (evt.features.outcome) {
+            case storage::Outcome::Deny:
+            case storage::Outcome::Block: deny_count++; break;
+            case storage::Outcome::Fail: fail_count++; break;
+            default: break;
         }
         
-        if (evt.features.contains("verb")) {
-            std::string verb = evt.features["verb"].get<std::string>();
-            if (verb == "exfil" || verb == "upload") has_exfil = true;
-            if (verb == "malware") has_malware = true;
+        switch (evt.features.verb) {
+            case storage::Verb::Exfil:
+            case storage::Verb::Upload: has_exfil = true; break;
+            case storage::Verb::Malware: has_malware = true; break;
+            default: break;
         }
     }
     
@@ -167,16 +165,14 @@ storage::Severity CorrelationEngine::determine_severity(
 std::string CorrelationEngine::generate_title(const std::vector<storage::Event>& events) {
     if (events.empty()) return "Unknown incident";
     
-    std::map<std::string, int> verb_counts;
+    std::map<std::string_view, int> verb_counts;
     for (const auto& evt : events) {
-        if (evt.features.contains("verb")) {
-            std::string verb = evt.features["verb"].get<std::string>();
-            verb_counts[verb]++;
-        }
+        std::string_view verb = evt.features.verb_name();
+        if (!verb.empty()) verb_counts[verb]++;
     }
     
     // Find most common verb
-    std::string most_common_verb = "activity";
+    std::string_view most_common_verb = "activity";
     int max_count = 0;
     for (const auto& [verb, count] : verb_counts) {
         if (count > max_count) {
@@ -185,7 +181,7 @@ std::string CorrelationEngine::generate_title(const std::vector<storage::Event>&
         }
     }
     
-    std::string source = events[0].source;
+    std::string source = events[0].source.str();
     
     if (most_common_verb == "auth" && max_count >= 5) {
         return "SSH brute force attempt";
@@ -195,7 +191,7 @@ std::string CorrelationEngine::generate_title(const std::vector<storage::Event>&
         return "Data exfiltration detected";
     }
     
-    return most_common_verb + " on " + source;
+    return std::string(most_common_verb) + " on " + source;
 }
 
 } // namespace siem::core
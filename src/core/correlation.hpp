@@ -41,7 +41,7 @@ public:
 private:
     Config config_;
 
-    std::string extract_entity_key(const storage::Event& event) const;
+    storage::Symbol extract_entity_key(const storage::Event& event) const;
 };
 
 } // namespace siem::core
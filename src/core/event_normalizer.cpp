@@ -1,158 +1,152 @@
 #include "core/event_normalizer.hpp"
+#include "core/hash.hpp"
 #include "core/ids.hpp"
+#include "core/timestamp.hpp"
 #include <spdlog/spdlog.h>
-#include <sstream>
-#include <iomanip>
-#include <openssl/sha.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace siem::core {
 
-EventNormalizer::EventNormalizer() {
-    allowed_fields_ = {
-        "ts", "source", "host", "entity", "verb", "object", "outcome",
-        "proto", "dport", "sport", "bytes", "user", "ip"
-    };
-    
-    secret_fields_ = {
-        "password", "token", "api_key", "secret", "credential"
-    };
+EventNormalizer::EventNormalizer() : EventNormalizer(Config{}) {}
+
+EventNormalizer::EventNormalizer(Config config, WorkerPool& pool) : EventNormalizer(config) {
+    pool_ = &pool;
+}
+
+EventNormalizer::EventNormalizer(Config config)
+    : config_(config)
+    , redactor_(config_.redaction) {
+    // Compiled once; bad pointers fail at startup, not per event
+    for (const auto& [source, spec] : config_.profiles) {
+        plans_.emplace(storage::Symbol(source), FieldPlan::compile(spec));
+    }
 }
 
 std::vector<storage::Event> EventNormalizer::normalize_batch(const std::vector<json>& raw_events) {
     std::vector<storage::Event> events;
     events.reserve(raw_events.size());
     
+    // Pool is resolved lazily so small-batch users never start its threads
+    if (config_.parallel_min_batch > 0 && raw_events.size() >= config_.parallel_min_batch) {
+        WorkerPool& pool = pool_ ? *pool_ : WorkerPool::shared();
+        if (pool.size() > 0) {
+            // Each event lands in its own slot, so order survives the split
+            std::vector<std::optional<storage::Event>> slots(raw_events.size());
+            pool.parallel_for(raw_events.size(), config_.parallel_chunk, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    try {
+                        slots[i] = normalize(raw_events[i]);
+                    } catch (const std::exception& e) {
+                        failed(raw_events[i], e);
+                    }
+                }
+            });
+            
+            for (auto& slot : slots) {
+                if (slot) events.push_back(std::move(*slot));
+            }
+            return events;
+        }
+    }
+    
     for (const auto& raw : raw_events) {
         try {
             events.push_back(normalize(raw));
         } catch (const std::exception& e) {
-            spdlog::warn(R"({{"msg":"normalization_failed","error":"{}"}})", e.what());
+            failed(raw, e);
         }
     }
     
     return events;
 }
 
-storage::Event EventNormalizer::normalize(const json& raw_event) {
-    storage::Event event;
-    
-    // Parse timestamp
-    if (raw_event.contains("ts") && raw_event["ts"].is_string()) {
-        std::string ts_str = raw_event["ts"];
-        std::tm tm = {};
-        std::istringstream ss(ts_str);
-        ss >> std::get_time(&tm, "%Y-%m-%dT%H:%M:%S");
-        auto tp = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-        event.ts = tp;
-    } else {
-        event.ts = std::chrono::system_clock::now();
+size_t EventNormalizer::chunk_size() const {
+    if (config_.parallel_min_batch == 0) return std::max<size_t>(config_.parallel_chunk, 1);
+    size_t workers = (pool_ ? *pool_ : WorkerPool::shared()).size();
+    return std::max(config_.parallel_min_batch, config_.parallel_chunk * std::max<size_t>(workers, 1));
+}
+
+void EventNormalizer::failed(const json& raw_event, const std::exception& error) const {
+    spdlog::warn(R"({{"msg":"normalization_failed","error":"{}"}})", error.what());
+    if (!on_failure_) return;
+    try {
+        on_failure_(raw_event, error);
+    } catch (const std::exception& e) {
+        spdlog::error(R"({{"msg":"normalization_failure_handler_error","error":"{}"}})", e.what());
     }
-    
-    // Required fields
-    event.source = get_string_or_default(raw_event, "source", "unknown");
-    event.host = get_string_or_default(raw_event, "host", "unknown");
-    event.trace_id = IDGenerator::generate_trace_id();
-    
-    // Build features
-    json features;
-    if (raw_event.contains("verb")) features["verb"] = raw_event["verb"];
-    if (raw_event.contains("outcome")) features["outcome"] = raw_event["outcome"];
-    
-    if (raw_event.contains("object") && raw_event["object"].is_object()) {
-        const auto& obj = raw_event["object"];
-        if (obj.contains("proto")) features["proto"] = obj["proto"];
-        if (obj.contains("dport")) features["dport"] = obj["dport"];
-        if (obj.contains("sport")) features["sport"] = obj["sport"];
-        if (obj.contains("user")) features["user"] = obj["user"];
+}
+
+storage::Event EventNormalizer::normalize(const json& raw_event) {
+    static const storage::Symbol unknown("unknown");
+    if (!raw_event.is_object()) {
+        throw std::invalid_argument("Event is not a JSON object");
     }
     
-    if (raw_event.contains("entity") && raw_event["entity"].is_object()) {
-        const auto& entity = raw_event["entity"];
-        if (entity.contains("ip")) features["ip"] = entity["ip"];
-        if (entity.contains("user")) features["user"] = entity["user"];
-    }
+    storage::Event event;
+    event.source = symbol_or_default(raw_event, "source", unknown);
+    event.host = unknown;
     
-    redact_secrets(features);
-    event.features = features;
+    auto plan = plans_.find(event.source);
+    const FieldPlan& fields = plan != plans_.end() ? plan->second : FieldPlan::default_plan();
     
-    // Compute fingerprint
-    event.fingerprint = compute_fingerprint(event);
+    // Timestamp (RFC 3339 or epoch seconds/millis) falls back to now
+    std::optional<storage::timestamp_t> ts;
+    fields.execute(raw_event, event, ts);
+    event.ts = ts.value_or(std::chrono::system_clock::now());
+    finalize(event);
     
     return event;
 }
 
-std::string EventNormalizer::compute_fingerprint(const storage::Event& event) const {
-    std::ostringstream oss;
-    oss << event.source << ":"
-        << event.host << ":";
-    
-    if (event.features.contains("ip")) {
-        oss << event.features["ip"].get<std::string>();
-    } else {
-        oss << "none";
-    }
-    oss << ":";
-    
-    if (event.features.contains("proto")) {
-        oss << event.features["proto"].get<std::string>();
-    } else {
-        oss << "none";
-    }
-    oss << ":";
-    
-    if (event.features.contains("dport")) {
-        oss << event.features["dport"].get<int>();
-    } else {
-        oss << "0";
-    }
-    
-    std::string raw = oss.str();
-    
-    // SHA256 hash
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256(reinterpret_cast<const unsigned char*>(raw.c_str()), raw.size(), hash);
-    
-    std::ostringstream hex;
-    for (int i = 0; i < 8; ++i) {
-        hex << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
-    }
-    
-    return hex.str();
+void EventNormalizer::finalize(storage::Event& event) const {
+    event.trace_id = IDGenerator::generate_trace_id();
+    redact_secrets(event.features.extra);
+    event.fingerprint = compute_fingerprint(event);
+}
+
+void EventNormalizer::finalize(std::vector<storage::Event>& events) const {
+    for (auto& event : events) finalize(event);
+}
+
+uint64_t EventNormalizer::compute_fingerprint(const storage::Event& event) const {
+    static const uint64_t none = Hash64::hash("none");
+    std::string_view proto = event.features.proto_name();
+    
+    // Chains the interner's cached content hashes, so the result is stable
+    // across processes even though symbol ids are not
+    return Hash64()
+        .update(event.source.content_hash())
+        .update(event.host.content_hash())
+        .update(event.features.ip.empty() ? none : event.features.ip.content_hash())
+        .update(proto.empty() ? none : Hash64::hash(proto))
+        .update(static_cast<uint64_t>(event.features.dport.value_or(0)))
+        .digest();
 }
 
 json EventNormalizer::extract_features(const storage::Event& event) const {
     // Return one-hot encoded features for clustering
     json features;
+    auto one_hot = [&features](const char* prefix, std::string_view name) {
+        if (!name.empty()) features[prefix + std::string(name)] = 1;
+    };
     
-    if (event.features.contains("verb")) {
-        features["verb_" + event.features["verb"].get<std::string>()] = 1;
-    }
-    if (event.features.contains("proto")) {
-        features["proto_" + event.features["proto"].get<std::string>()] = 1;
-    }
-    if (event.features.contains("outcome")) {
-        features["outcome_" + event.features["outcome"].get<std::string>()] = 1;
-    }
+    one_hot("verb_", event.features.verb_name());
+    one_hot("proto_", event.features.proto_name());
+    one_hot("outcome_", event.features.outcome_name());
     
     return features;
 }
 
-void EventNormalizer::redact_secrets(json& obj) {
-    if (!obj.is_object()) return;
-    
-    for (auto it = obj.begin(); it != obj.end(); ++it) {
-        if (secret_fields_.count(it.key())) {
-            it.value() = "***REDACTED***";
-        } else if (it.value().is_object()) {
-            redact_secrets(it.value());
-        }
-    }
+void EventNormalizer::redact_secrets(json& obj) const {
+    redactor_.redact(obj);
 }
 
-std::string EventNormalizer::get_string_or_default(
-    const json& j, const std::string& key, const std::string& default_val) const {
-    if (j.contains(key) && j[key].is_string()) {
-        return j[key].get<std::string>();
+storage::Symbol EventNormalizer::symbol_or_default(
+    const json& j, const char* key, storage::Symbol default_val) const {
+    auto it = j.find(key);
+    if (it != j.end() && it->is_string()) {
+        return storage::Symbol(it->get_ref<const std::string&>());
     }
     return default_val;
 }
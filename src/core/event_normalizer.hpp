@@ -1,10 +1,15 @@
 #pragma once
 
 #include "storage/schemas.hpp"
+#include "core/worker_pool.hpp"
+#include "core/secret_redactor.hpp"
+#include "core/field_plan.hpp"
 #include <nlohmann/json.hpp>
+#include <functional>
 #include <string>
 #include <vector>
-#include <set>
+#include <map>
+#include <unordered_map>
 
 namespace siem::core {
 
@@ -12,42 +17,89 @@ using json = nlohmann::json;
 
 /**
  * Normalizes raw security events into standard schema
- * - Drops unknown fields
+ * - Extracts fields with a per-source FieldPlan, dropping everything else
  * - Redacts secrets
  * - Computes fingerprints
  * - Extracts features for clustering
  */
 class EventNormalizer {
 public:
+    struct Config {
+        size_t parallel_min_batch = 2048;   // smaller batches stay on the caller's thread; 0 = never split
+        size_t parallel_chunk = 256;        // events per work item
+        SecretRedactor::Config redaction;
+        std::map<std::string, FieldPlan::Spec> profiles;   // source -> field layout
+    };
+
+    /**
+     * Told about every event normalize_batch drops; may run on pool threads
+     */
+    using FailureHandler = std::function<void(const json& raw_event, const std::exception& error)>;
+
     EventNormalizer();
+    explicit EventNormalizer(Config config);
+
+    /**
+     * Normalize on a specific pool instead of WorkerPool::shared()
+     */
+    EventNormalizer(Config config, WorkerPool& pool);
 
     /**
      * Normalize a batch of raw events
+     * Large batches are split across the worker pool; output keeps input order
      */
     std::vector<storage::Event> normalize_batch(const std::vector<json>& raw_events);
 
+    /**
+     * Raw events per normalize_batch call that keeps every pool worker busy;
+     * streaming callers collect this many, hand them off, then start over
+     */
+    size_t chunk_size() const;
+
+    /**
+     * Install the handler for dropped events; set before the first batch
+     */
+    void on_failure(FailureHandler handler) { on_failure_ = std::move(handler); }
+
     /**
      * Normalize single event
+     * Looks up the plan for its source, then runs the plan's steps in order.
+     * Throws std::invalid_argument if raw_event is not an object
      */
     storage::Event normalize(const json& raw_event);
 
+    /**
+     * Finish events built by a native parser (flows, CEF / LEEF): assign a
+     * trace id, redact extra and compute the fingerprint, as normalize() does
+     */
+    void finalize(storage::Event& event) const;
+    void finalize(std::vector<storage::Event>& events) const;
+
     /**
      * Compute fingerprint for event grouping
-     * Format: source:host:ip:proto:port
+     * 64-bit hash over source, host, ip, proto, dport; stable across processes
      */
-    std::string compute_fingerprint(const storage::Event& event) const;
+    uint64_t compute_fingerprint(const storage::Event& event) const;
 
     /**
      * Extract features for clustering (one-hot encoding)
      */
     json extract_features(const storage::Event& event) const;
 
+    /**
+     * Redact secret keys and secrets embedded in string values (recursively)
+     */
+    void redact_secrets(json& obj) const;
+
 private:
-    std::set<std::string> allowed_fields_;
-    std::set<std::string> secret_fields_;
+    Config config_;
+    WorkerPool* pool_ = nullptr;
+    std::unordered_map<storage::Symbol, FieldPlan> plans_;
+    SecretRedactor redactor_;
+    FailureHandler on_failure_;
 
-    void redact_secrets(json& obj);
-    std::string get_string_or_default(const json& j, const std::string& key, const std::string& default_val) const;
+    storage::Symbol symbol_or_default(const json& j, const char* key, storage::Symbol default_val) const;
+    void failed(const json& raw_event, const std::exception& error) const;
 };
 
 } // namespace siem::core
@@ -0,0 +1,232 @@
+#include "core/event_pipeline.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace siem::core {
+
+namespace {
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+template <typename Envelope>
+void merge(Envelope& into_envelope, Envelope& from_envelope) {
+    into_envelope.pushed = std::min(into_envelope.pushed, from_envelope.pushed);
+    auto& into = into_envelope.batch;
+    auto& from = from_envelope.batch;
+    into.events.insert(into.events.end(),
+                       std::make_move_iterator(from.events.begin()),
+                       std::make_move_iterator(from.events.end()));
+    for (auto& id : from.incident_ids) {
+        if (std::find(into.incident_ids.begin(), into.incident_ids.end(), id) == into.incident_ids.end()) {
+            into.incident_ids.push_back(std::move(id));
+        }
+    }
+    into.lsns.insert(into.lsns.end(), from.lsns.begin(), from.lsns.end());
+}
+
+} // namespace
+
+EventPipeline::Stage::Stage(std::string name, StageConfig config, StageFn fn)
+    : name(std::move(name))
+    , config(config)
+    , fn(std::move(fn))
+    , queue(config.queue_capacity) {}
+
+EventPipeline::~EventPipeline() {
+    stop();
+}
+
+void EventPipeline::add_stage(std::string name, StageConfig config, StageFn fn) {
+    if (running_.load()) {
+        throw std::logic_error("Pipeline stages must be added before start()");
+    }
+    config.workers = std::max<size_t>(config.workers, 1);
+    stages_.push_back(std::make_unique<Stage>(std::move(name), config, std::move(fn)));
+}
+
+void EventPipeline::on_complete(CompletionFn fn) {
+    if (running_.load()) {
+        throw std::logic_error("Pipeline completion callback must be set before start()");
+    }
+    on_complete_ = std::move(fn);
+}
+
+void EventPipeline::on_failure(FailureFn fn) {
+    if (running_.load()) {
+        throw std::logic_error("Pipeline failure callback must be set before start()");
+    }
+    on_failure_ = std::move(fn);
+}
+
+void EventPipeline::start() {
+    if (stages_.empty()) {
+        throw std::logic_error("Pipeline has no stages");
+    }
+    if (running_.exchange(true)) return;
+
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        Stage& stage = *stages_[i];
+        stage.stopping.store(false);
+        for (size_t w = 0; w < stage.config.workers; ++w) {
+            stage.threads.emplace_back(&EventPipeline::worker_loop, this, i);
+        }
+        spdlog::info(R"({{"msg":"pipeline_stage_started","stage":"{}","workers":{},"queue":{},"max_events":{}}})",
+                    stage.name, stage.config.workers, stage.queue.capacity(), stage.config.max_events);
+    }
+}
+
+void EventPipeline::push(std::vector<storage::Event>&& events) {
+    push(Batch{std::move(events), {}, {}});
+}
+
+void EventPipeline::push(Batch&& batch) {
+    // stop() waits for pushing_ to drain after clearing running_, so a batch
+    // admitted here is always seen by the first stage's workers
+    pushing_.fetch_add(1);
+    if (!running_.load()) {
+        pushing_.fetch_sub(1);
+        throw std::runtime_error("Event pipeline is not running");
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    Envelope envelope{std::move(batch), now, now};
+    enqueue(*stages_.front(), envelope);
+    pushing_.fetch_sub(1);
+}
+
+void EventPipeline::stop() {
+    if (!running_.exchange(false)) return;
+    while (pushing_.load() > 0) std::this_thread::yield();
+
+    // In order, so each stage drains into one that is still running
+    for (auto& stage : stages_) {
+        stage->stopping.store(true);
+        {
+            std::lock_guard<std::mutex> lock(stage->mutex);
+            stage->cv.notify_all();
+        }
+        for (auto& thread : stage->threads) thread.join();
+        stage->threads.clear();
+    }
+
+    spdlog::info(R"({{"msg":"pipeline_stopped"}})");
+}
+
+std::vector<EventPipeline::StageStats> EventPipeline::stats() const {
+    std::vector<StageStats> stats;
+    stats.reserve(stages_.size());
+    for (const auto& stage : stages_) {
+        StageStats s;
+        s.name = stage->name;
+        s.depth = stage->queue.size();
+        s.batches = stage->batches.load(std::memory_order_relaxed);
+        s.events = stage->events.load(std::memory_order_relaxed);
+        s.failures = stage->failures.load(std::memory_order_relaxed);
+        s.wait_ns = stage->wait_ns.load(std::memory_order_relaxed);
+        s.service_ns = stage->service_ns.load(std::memory_order_relaxed);
+        stats.push_back(std::move(s));
+    }
+    return stats;
+}
+
+size_t EventPipeline::depth() const {
+    size_t total = 0;
+    for (const auto& stage : stages_) total += stage->queue.size();
+    return total;
+}
+
+void EventPipeline::worker_loop(size_t index) {
+    Stage& stage = *stages_[index];
+    Stage* next = index + 1 < stages_.size() ? stages_[index + 1].get() : nullptr;
+
+    Envelope envelope;
+    Envelope more;
+    while (true) {
+        if (!stage.queue.try_pop(envelope)) {
+            if (stage.stopping.load() && stage.queue.empty()) return;
+            wait_for_work(stage);
+            continue;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        uint64_t waited = elapsed_ns(envelope.queued, started);
+
+        // Whatever queued up behind this batch goes in the same call
+        while (stage.config.max_events > 0 &&
+               envelope.batch.events.size() < stage.config.max_events &&
+               stage.queue.try_pop(more)) {
+            merge(envelope, more);
+        }
+        size_t count = envelope.batch.events.size();
+
+        try {
+            stage.fn(envelope.batch);
+        } catch (const std::exception& e) {
+            stage.failures.fetch_add(1, std::memory_order_relaxed);
+            spdlog::error(R"({{"msg":"pipeline_stage_failed","stage":"{}","events":{},"error":"{}"}})",
+                         stage.name, count, e.what());
+            if (on_failure_) {
+                try {
+                    on_failure_(stage.name, envelope.batch, e);
+                } catch (const std::exception& f) {
+                    spdlog::error(R"({{"msg":"pipeline_failure_handler_failed","error":"{}"}})", f.what());
+                }
+            }
+            envelope = Envelope{};
+            continue;
+        }
+
+        auto finished = std::chrono::steady_clock::now();
+        stage.batches.fetch_add(1, std::memory_order_relaxed);
+        stage.events.fetch_add(count, std::memory_order_relaxed);
+        stage.wait_ns.fetch_add(waited, std::memory_order_relaxed);
+        stage.service_ns.fetch_add(elapsed_ns(started, finished), std::memory_order_relaxed);
+
+        if (next && (!envelope.batch.events.empty() || !envelope.batch.lsns.empty())) {
+            envelope.queued = finished;
+            enqueue(*next, envelope);
+        } else if (!next && on_complete_) {
+            try {
+                on_complete_(count, finished - envelope.pushed);
+            } catch (const std::exception& e) {
+                spdlog::error(R"({{"msg":"pipeline_completion_failed","error":"{}"}})", e.what());
+            }
+        }
+        envelope = Envelope{};
+    }
+}
+
+void EventPipeline::enqueue(Stage& stage, Envelope& envelope) {
+    // A full queue means the stage is behind; wait for it rather than drop
+    for (int spins = 0; !stage.queue.try_push(envelope); ++spins) {
+        if (spins < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+    // Pairs with the fence in wait_for_work: either the worker sees the
+    // batch before sleeping or we see it asleep and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (stage.sleepers.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(stage.mutex);
+        stage.cv.notify_one();
+    }
+}
+
+void EventPipeline::wait_for_work(Stage& stage) {
+    std::unique_lock<std::mutex> lock(stage.mutex);
+    stage.sleepers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    stage.cv.wait_for(lock, std::chrono::milliseconds(100), [&] {
+        return !stage.queue.empty() || stage.stopping.load();
+    });
+    stage.sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace siem::core
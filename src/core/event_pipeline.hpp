@@ -0,0 +1,156 @@
+#pragma once
+
+#include "core/mpmc_queue.hpp"
+#include "storage/schemas.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace siem::core {
+
+/**
+ * Staged event processing: cluster → correlate → store, say, each stage
+ * with its own workers, fed through a bounded MpmcQueue
+ * - push() hands a batch to the first stage and returns; it blocks only
+ *   while that stage's queue is full, which pushes back on ingest.
+ * - A worker pops a batch and merges whatever else is already queued, up
+ *   to max_events, into one call of the stage function, then passes the
+ *   result on. Under load, stages see fewer, larger batches.
+ * - Idle workers sleep on a condition variable; producers only touch its
+ *   mutex when someone is asleep.
+ * - A stage function that throws drops its batch (counted in failures)
+ *   and hands it to the failure callback.
+ * Stages with more than one worker run batches concurrently and may pass
+ * them on out of order.
+ */
+class EventPipeline {
+public:
+    struct Batch {
+        std::vector<storage::Event> events;
+        std::vector<std::string> incident_ids;  // Set by a stage for the ones after it
+        std::vector<uint64_t> lsns;             // Write-ahead log batches (or BatchTickets) merged in, to acknowledge once stored
+    };
+
+    using StageFn = std::function<void(Batch&)>;
+
+    /**
+     * Told when the last stage finishes a call: events in it and the time
+     * since its oldest batch was pushed
+     */
+    using CompletionFn = std::function<void(size_t events, std::chrono::nanoseconds latency)>;
+
+    /**
+     * Told about a batch a stage threw on, with the stage's name
+     */
+    using FailureFn = std::function<void(const std::string& stage, Batch& batch, const std::exception& error)>;
+
+    struct StageConfig {
+        size_t workers = 1;
+        size_t queue_capacity = 1024;           // Batches; rounded up to a power of two
+        size_t max_events = 4096;               // Stop merging queued batches past this; 0 = never merge
+    };
+
+    struct StageStats {
+        std::string name;
+        size_t depth = 0;                       // Batches waiting
+        uint64_t batches = 0;                   // Stage function calls
+        uint64_t events = 0;
+        uint64_t failures = 0;
+        uint64_t wait_ns = 0;                   // Summed over calls: time the oldest merged batch waited
+        uint64_t service_ns = 0;                // Summed over calls: time in the stage function
+    };
+
+    EventPipeline() = default;
+    ~EventPipeline();
+
+    EventPipeline(const EventPipeline&) = delete;
+    EventPipeline& operator=(const EventPipeline&) = delete;
+
+    /**
+     * Append a stage; only before start()
+     */
+    void add_stage(std::string name, StageConfig config, StageFn fn);
+
+    /**
+     * Install the completion callback; only before start(). Runs on the
+     * last stage's workers
+     */
+    void on_complete(CompletionFn fn);
+
+    /**
+     * Install the failure callback; only before start(). Runs on the
+     * workers of the stage that failed
+     */
+    void on_failure(FailureFn fn);
+
+    void start();
+
+    /**
+     * Queue events for the first stage. Throws std::runtime_error when the
+     * pipeline is not running
+     */
+    void push(std::vector<storage::Event>&& events);
+    void push(Batch&& batch);
+
+    /**
+     * Stop taking batches, let every stage finish what is queued, then join
+     */
+    void stop();
+
+    bool is_running() const { return running_.load(); }
+
+    std::vector<StageStats> stats() const;
+
+    /**
+     * Batches waiting across all stages
+     */
+    size_t depth() const;
+
+private:
+    struct Envelope {
+        Batch batch;
+        std::chrono::steady_clock::time_point queued;
+        std::chrono::steady_clock::time_point pushed;   // Oldest merged push()
+    };
+
+    struct Stage {
+        std::string name;
+        StageConfig config;
+        StageFn fn;
+        MpmcQueue<Envelope> queue;
+        std::vector<std::thread> threads;
+        std::atomic<bool> stopping{false};
+
+        // Sleeping workers; producers lock only when sleepers > 0
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::atomic<uint32_t> sleepers{0};
+
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> events{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> wait_ns{0};
+        std::atomic<uint64_t> service_ns{0};
+
+        Stage(std::string name, StageConfig config, StageFn fn);
+    };
+
+    std::vector<std::unique_ptr<Stage>> stages_;
+    CompletionFn on_complete_;
+    FailureFn on_failure_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint32_t> pushing_{0};         // Producers inside push()
+
+    void worker_loop(size_t index);
+    void enqueue(Stage& stage, Envelope& envelope);
+    void wait_for_work(Stage& stage);
+};
+
+} // namespace siem::core
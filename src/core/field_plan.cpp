@@ -0,0 +1,124 @@
+#include "core/field_plan.hpp"
+#include "core/timestamp.hpp"
+#include <stdexcept>
+
+namespace siem::core {
+
+FieldPlan FieldPlan::compile(const Spec& spec) {
+    FieldPlan plan;
+
+    for (const auto& [target, pointers] : spec) {
+        if (target.empty()) {
+            throw std::invalid_argument("Field plan target must not be empty");
+        }
+
+        Target kind = target == "ts" ? Target::Timestamp
+                    : target == "host" ? Target::Host
+                    : Target::Feature;
+
+        std::string feature = kind == Target::Feature ? target : "";
+        auto slot = storage::EventFeatures::slot_of(feature);
+        for (auto it = pointers.rbegin(); it != pointers.rend(); ++it) {
+            plan.steps_.push_back(Step{parse_pointer(*it), kind, feature, slot});
+        }
+    }
+
+    return plan;
+}
+
+const FieldPlan::Spec& FieldPlan::default_spec() {
+    static const Spec spec = {
+        {"ts", {"/ts"}},
+        {"host", {"/host"}},
+        {"verb", {"/verb"}},
+        {"outcome", {"/outcome"}},
+        {"proto", {"/object/proto"}},
+        {"dport", {"/object/dport"}},
+        {"sport", {"/object/sport"}},
+        {"user", {"/entity/user", "/object/user"}},
+        {"ip", {"/entity/ip"}},
+    };
+    return spec;
+}
+
+const FieldPlan& FieldPlan::default_plan() {
+    static const FieldPlan plan = compile(default_spec());
+    return plan;
+}
+
+void FieldPlan::execute(const json& raw, storage::Event& event,
+                        std::optional<storage::timestamp_t>& ts) const {
+    for (const auto& step : steps_) {
+        const json* value = resolve(raw, step.path);
+        if (value == nullptr) continue;
+
+        switch (step.target) {
+            case Target::Timestamp:
+                if (auto parsed = TimestampParser::from_json(*value)) ts = parsed;
+                break;
+            case Target::Host:
+                if (value->is_string()) event.host = storage::Symbol(value->get_ref<const std::string&>());
+                break;
+            case Target::Feature:
+                event.features.set(step.slot, step.feature, *value);
+                break;
+        }
+    }
+}
+
+std::vector<std::string> FieldPlan::parse_pointer(const std::string& pointer) {
+    // RFC 6901; the whole document ("") is not a field
+    if (pointer.size() < 2 || pointer[0] != '/') {
+        throw std::invalid_argument("Invalid JSON pointer: '" + pointer + "'");
+    }
+
+    std::vector<std::string> tokens(1);
+    for (size_t i = 1; i < pointer.size(); ++i) {
+        char c = pointer[i];
+        if (c == '/') {
+            tokens.emplace_back();
+        } else if (c == '~') {
+            char next = i + 1 < pointer.size() ? pointer[i + 1] : '\0';
+            if (next != '0' && next != '1') {
+                throw std::invalid_argument("Invalid escape in JSON pointer: '" + pointer + "'");
+            }
+            tokens.back() += next == '0' ? '~' : '/';
+            i++;
+        } else {
+            tokens.back() += c;
+        }
+    }
+    return tokens;
+}
+
+size_t FieldPlan::array_index(std::string_view token) {
+    if (token.empty() || token.size() > 18 || (token.size() > 1 && token[0] == '0')) {
+        return std::string::npos;
+    }
+    size_t index = 0;
+    for (char c : token) {
+        if (c < '0' || c > '9') return std::string::npos;
+        index = index * 10 + static_cast<size_t>(c - '0');
+    }
+    return index;
+}
+
+const json* FieldPlan::resolve(const json& raw, const std::vector<std::string>& path) {
+    const json* current = &raw;
+    for (const auto& token : path) {
+        if (current->is_object()) {
+            auto it = current->find(token);
+            if (it == current->end()) return nullptr;
+            current = &*it;
+        } else if (current->is_array()) {
+            size_t index = array_index(token);
+            if (index >= current->size()) return nullptr;
+            current = &(*current)[index];
+        } else {
+            return nullptr;
+        }
+    }
+    return current;
+}
+
+} // namespace siem::core
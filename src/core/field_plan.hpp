@@ -0,0 +1,77 @@
+#pragma once
+
+#include "storage/schemas.hpp"
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace siem::core {
+
+using json = nlohmann::json;
+
+/**
+ * Compiled field extraction plan for one source layout
+ * A spec maps a target to JSON pointers in priority order:
+ *   ts, host        -> event timestamp / host
+ *   anything else   -> EventFeatures::set (typed slot or extra)
+ * Compilation flattens the spec into steps with their pointers split into
+ * tokens and their feature slots resolved; lower-priority pointers run
+ * first so the highest-priority present value wins. Against a json DOM
+ * each token is still a member lookup (nlohmann objects are ordered maps);
+ * SimdEventNormalizer compiles the same steps into one pass over the raw
+ * bytes instead.
+ */
+class FieldPlan {
+public:
+    using Spec = std::map<std::string, std::vector<std::string>>;
+
+    enum class Target : uint8_t { Timestamp, Host, Feature };
+
+    struct Step {
+        std::vector<std::string> path;   // unescaped reference tokens
+        Target target;
+        std::string feature;
+        storage::FeatureSlot slot = storage::FeatureSlot::Extra;
+    };
+
+    /**
+     * Throws std::invalid_argument on an empty target or a malformed pointer
+     */
+    static FieldPlan compile(const Spec& spec);
+
+    /**
+     * The built-in layout: ts, host, verb, outcome, object.{proto,dport,sport,user},
+     * entity.{ip,user}; entity.user wins over object.user
+     */
+    static const FieldPlan& default_plan();
+    static const Spec& default_spec();
+
+    /**
+     * Fill host, features and (when parseable) ts from a raw event
+     */
+    void execute(const json& raw, storage::Event& event,
+                 std::optional<storage::timestamp_t>& ts) const;
+
+    size_t size() const { return steps_.size(); }
+
+    /**
+     * Steps in execution order, for readers that resolve pointers themselves
+     */
+    const std::vector<Step>& steps() const { return steps_; }
+
+    /**
+     * A reference token as an array index (RFC 6901: digits, no leading
+     * zero); std::string::npos if it is not one
+     */
+    static size_t array_index(std::string_view token);
+
+private:
+    std::vector<Step> steps_;
+
+    static std::vector<std::string> parse_pointer(const std::string& pointer);
+    static const json* resolve(const json& raw, const std::vector<std::string>& path);
+};
+
+} // namespace siem::core
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace siem::core {
+
+/**
+ * Fast non-cryptographic 64-bit hashing (wyhash final4)
+ * Used for event fingerprints and hash-map keys, never for security
+ */
+class Hash64 {
+public:
+    static constexpr uint64_t kDefaultSeed = 0x5a5a5a5a5a5a5a5aULL;
+
+    /**
+     * One-shot hash of a byte range
+     */
+    static uint64_t hash(const void* data, size_t len, uint64_t seed = kDefaultSeed) {
+        const auto* p = static_cast<const uint8_t*>(data);
+        seed ^= mix(seed ^ kSecret[0], kSecret[1]);
+
+        uint64_t a, b;
+        if (len <= 16) {
+            if (len >= 4) {
+                a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+                b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+            } else if (len > 0) {
+                a = (uint64_t{p[0]} << 16) | (uint64_t{p[len >> 1]} << 8) | p[len - 1];
+                b = 0;
+            } else {
+                a = b = 0;
+            }
+        } else {
+            size_t i = len;
+            if (i > 48) {
+                uint64_t see1 = seed, see2 = seed;
+                do {
+                    seed = mix(read64(p) ^ kSecret[1], read64(p + 8) ^ seed);
+                    see1 = mix(read64(p + 16) ^ kSecret[2], read64(p + 24) ^ see1);
+                    see2 = mix(read64(p + 32) ^ kSecret[3], read64(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= see1 ^ see2;
+            }
+            while (i > 16) {
+                seed = mix(read64(p) ^ kSecret[1], read64(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = read64(p + i - 16);
+            b = read64(p + i - 8);
+        }
+
+        a ^= kSecret[1];
+        b ^= seed;
+        multiply(a, b);
+        return mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+    }
+
+    static uint64_t hash(std::string_view bytes, uint64_t seed = kDefaultSeed) {
+        return hash(bytes.data(), bytes.size(), seed);
+    }
+
+    explicit Hash64(uint64_t seed = kDefaultSeed) : state_(seed) {}
+
+    /**
+     * Fold a field into the running hash; field lengths are mixed in, so
+     * ("ab", "c") and ("a", "bc") hash differently
+     */
+    Hash64& update(std::string_view bytes) {
+        state_ = hash(bytes.data(), bytes.size(), state_);
+        return *this;
+    }
+
+    Hash64& update(uint64_t value) {
+        state_ = hash(&value, sizeof(value), state_);
+        return *this;
+    }
+
+    uint64_t digest() const { return state_; }
+
+private:
+    static constexpr uint64_t kSecret[4] = {
+        0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+        0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+    };
+
+    uint64_t state_;
+
+    static void multiply(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        a = static_cast<uint64_t>(r);
+        b = static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        a = _umul128(a, b, &b);
+#else
+        uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xffffffff, lb = b & 0xffffffff;
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t c = t < rl;
+        uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        a = lo;
+        b = hi;
+#endif
+    }
+
+    static uint64_t mix(uint64_t a, uint64_t b) {
+        multiply(a, b);
+        return a ^ b;
+    }
+
+    static uint64_t read64(const uint8_t* p) {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static uint64_t read32(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+};
+
+} // namespace siem::core
@@ -1,95 +1,128 @@
 #include "core/ids.hpp"
-#include <iomanip>
-#include <sstream>
 #include <cstring>
+#include <thread>
 
 namespace siem::core {
 
+namespace {
+
+constexpr char kCrockford[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+constexpr char kHex[] = "0123456789abcdef";
+
+void write_hex(char* out, uint64_t value, size_t digits) {
+    for (size_t i = digits; i-- > 0;) {
+        out[i] = kHex[value & 0xF];
+        value >>= 4;
+    }
+}
+
+int crockford_value(char c) {
+    if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+    const char* pos = std::strchr(kCrockford, c);
+    return c != '\0' && pos != nullptr ? static_cast<int>(pos - kCrockford) : -1;
+}
+
+// Per-thread monotonic state: last millisecond and its 80-bit random part
+struct UlidState {
+    uint64_t millis = 0;
+    uint16_t random_hi = 0;
+    uint64_t random_lo = 0;
+};
+
+} // namespace
+
 std::mt19937_64& IDGenerator::get_rng() {
     static thread_local std::mt19937_64 rng{
-        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())
+        std::random_device{}() ^
+        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+        std::hash<std::thread::id>{}(std::this_thread::get_id())
     };
     return rng;
 }
 
-std::string IDGenerator::base36_encode(uint64_t value) {
-    static const char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
-    if (value == 0) return "0";
-    
-    std::string result;
-    while (value > 0) {
-        result = digits[value % 36] + result;
-        value /= 36;
+IDGenerator::Ulid IDGenerator::ulid() {
+    return ulid(std::chrono::system_clock::now());
+}
+
+IDGenerator::Ulid IDGenerator::ulid(std::chrono::system_clock::time_point now) {
+    static thread_local UlidState state;
+
+    auto millis = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
+    millis &= (uint64_t{1} << 48) - 1;
+
+    if (millis > state.millis) {
+        uint64_t r1 = get_rng()();
+        uint64_t r2 = get_rng()();
+        state = {millis, static_cast<uint16_t>(r2), r1};
+    } else if (++state.random_lo == 0 && ++state.random_hi == 0) {
+        // 80-bit space exhausted within a millisecond (or the clock went
+        // back): borrow the next millisecond rather than break ordering
+        state.millis++;
+    }
+
+    Ulid out;
+    uint64_t ts = state.millis;
+    for (size_t i = 10; i-- > 0;) {
+        out[i] = kCrockford[ts & 31];
+        ts >>= 5;
     }
-    return result;
+
+    uint64_t hi = state.random_hi;
+    uint64_t lo = state.random_lo;
+    for (size_t i = kUlidLength; i-- > 10;) {
+        out[i] = kCrockford[lo & 31];
+        lo = (lo >> 5) | (hi << 59);
+        hi >>= 5;
+    }
+    return out;
 }
 
-std::string IDGenerator::generate_incident_id() {
-    auto now = std::chrono::system_clock::now();
-    auto epoch = now.time_since_epoch();
-    uint64_t timestamp = std::chrono::duration_cast<std::chrono::seconds>(epoch).count();
-    
-    std::uniform_int_distribution<uint32_t> dist(0, 0xFFFFFF);
-    uint32_t random_part = dist(get_rng());
-    
-    return "inc_" + base36_encode(timestamp) + base36_encode(random_part);
+int64_t IDGenerator::ulid_millis(std::string_view ulid) {
+    if (ulid.size() != kUlidLength) return -1;
+
+    int64_t millis = 0;
+    for (size_t i = 0; i < kUlidLength; ++i) {
+        int value = crockford_value(ulid[i]);
+        if (value < 0 || (i == 0 && value > 7)) return -1;
+        if (i < 10) millis = (millis << 5) | value;
+    }
+    return millis;
 }
 
-std::string IDGenerator::generate_cluster_id(const std::string& fingerprint) {
-    uint32_t hash = murmur3_hash(fingerprint);
-    std::ostringstream oss;
-    oss << "clu_" << std::hex << std::setw(8) << std::setfill('0') << hash;
-    return oss.str();
+IDGenerator::IncidentId IDGenerator::incident_id() {
+    IncidentId out;
+    std::memcpy(out.data(), "incu_", 5);
+    Ulid id = ulid();
+    std::memcpy(out.data() + 5, id.data(), id.size());
+    return out;
 }
 
-std::string IDGenerator::generate_trace_id() {
-    std::uniform_int_distribution<uint64_t> dist;
-    uint64_t val1 = dist(get_rng());
-    uint64_t val2 = dist(get_rng());
-    
-    std::ostringstream oss;
-    oss << std::hex << std::setw(16) << std::setfill('0') << val1;
-    return oss.str();
+std::string IDGenerator::generate_incident_id() {
+    return to_string(incident_id());
 }
 
-uint32_t IDGenerator::murmur3_hash(const std::string& key) {
-    const uint32_t c1 = 0xcc9e2d51;
-    const uint32_t c2 = 0x1b873593;
-    const uint32_t seed = 0x5a5a5a5a;
-    
-    uint32_t h1 = seed;
-    const size_t nblocks = key.size() / 4;
-    
-    const uint32_t* blocks = reinterpret_cast<const uint32_t*>(key.data());
-    for (size_t i = 0; i < nblocks; i++) {
-        uint32_t k1 = blocks[i];
-        k1 *= c1;
-        k1 = (k1 << 15) | (k1 >> 17);
-        k1 *= c2;
-        h1 ^= k1;
-        h1 = (h1 << 13) | (h1 >> 19);
-        h1 = h1 * 5 + 0xe6546b64;
-    }
-    
-    const uint8_t* tail = reinterpret_cast<const uint8_t*>(key.data() + nblocks * 4);
-    uint32_t k1 = 0;
-    switch (key.size() & 3) {
-        case 3: k1 ^= tail[2] << 16; [[fallthrough]];
-        case 2: k1 ^= tail[1] << 8; [[fallthrough]];
-        case 1: k1 ^= tail[0];
-                k1 *= c1; k1 = (k1 << 15) | (k1 >> 17); k1 *= c2; h1 ^= k1;
-    }
-    
-    h1 ^= key.size();
-    h1 ^= h1 >> 16;
-    h1 *= 0x85ebca6b;
-    h1 ^= h1 >> 13;
-    h1 *= 0xc2b2ae35;
-    h1 ^= h1 >> 16;
-    
-    return h1;
+IDGenerator::ClusterId IDGenerator::cluster_id(uint64_t fingerprint) {
+    // Fold to 32 bits; fingerprint is already a well-mixed hash
+    auto folded = static_cast<uint32_t>(fingerprint ^ (fingerprint >> 32));
+    ClusterId out;
+    std::memcpy(out.data(), "clu_", 4);
+    write_hex(out.data() + 4, folded, 8);
+    return out;
 }
 
-} // namespace siem::core
+std::string IDGenerator::generate_cluster_id(uint64_t fingerprint) {
+    return to_string(cluster_id(fingerprint));
+}
 
+IDGenerator::TraceId IDGenerator::trace_id() {
+    TraceId out;
+    write_hex(out.data(), get_rng()(), out.size());
+    return out;
+}
 
+std::string IDGenerator::generate_trace_id() {
+    return to_string(trace_id());
+}
+
+} // namespace siem::core
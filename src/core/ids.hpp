@@ -1,41 +1,75 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <random>
 #include <array>
+#include <cstdint>
 
 namespace siem::core {
 
 /**
  * ID generation utilities for incidents and clusters
+ * The array-returning variants never touch the heap; the std::string
+ * wrappers exist for schema fields that already hold strings.
  */
 class IDGenerator {
 public:
+    static constexpr size_t kUlidLength = 26;
+
+    using Ulid = std::array<char, kUlidLength>;
+    using IncidentId = std::array<char, 5 + kUlidLength>;
+    using ClusterId = std::array<char, 12>;
+    using TraceId = std::array<char, 16>;
+
+    /**
+     * ULID: 48-bit unix milliseconds + 80 random bits, Crockford base32
+     * Lexicographic order is creation order. Within one millisecond a
+     * thread increments the random part instead of redrawing it, so ids
+     * from the same thread stay strictly increasing.
+     * Example: 01JC3Z8V4W6R8Y2M5KQ7T9XB1D
+     */
+    static Ulid ulid();
+    static Ulid ulid(std::chrono::system_clock::time_point now);
+
     /**
-     * Generate incident ID: "inc_" + base36(timestamp) + random
-     * Example: inc_lx9k3m2p
+     * "incu_" + ULID; sorts by creation time so the incidents _id index
+     * stays append-only. The prefix sorts after every legacy "inc_" +
+     * base36 id ('u' > '_'), so _id $gt pagination still reaches new
+     * incidents from an old cursor, and old and new ids can share a
+     * collection without a migration.
+     * Example: incu_01JC3Z8V4W6R8Y2M5KQ7T9XB1D
      */
+    static IncidentId incident_id();
     static std::string generate_incident_id();
 
     /**
      * Generate cluster ID from fingerprint hash
      * Example: clu_9f2a8b3c
      */
-    static std::string generate_cluster_id(const std::string& fingerprint);
+    static ClusterId cluster_id(uint64_t fingerprint);
+    static std::string generate_cluster_id(uint64_t fingerprint);
 
     /**
-     * Generate trace ID for distributed tracing
+     * Generate trace ID for distributed tracing: 64 random bits as hex
      * Example: c3e1f4a2b7d8e9f0
      */
+    static TraceId trace_id();
     static std::string generate_trace_id();
 
+    /**
+     * Unix milliseconds encoded in a ULID, or -1 if it is not one
+     */
+    static int64_t ulid_millis(std::string_view ulid);
+
+    template <size_t N>
+    static std::string to_string(const std::array<char, N>& id) {
+        return std::string(id.data(), N);
+    }
+
 private:
-    static std::string base36_encode(uint64_t value);
-    static uint32_t murmur3_hash(const std::string& key);
     static std::mt19937_64& get_rng();
 };
 
 } // namespace siem::core
-
-
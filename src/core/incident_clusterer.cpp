@@ -1,7 +1,8 @@
 #include "core/incident_clusterer.hpp"
 #include "core/ids.hpp"
-#include "core/event_normalizer.hpp"
+#include "core/hash.hpp"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <cmath>
 #include <set>
 
@@ -12,64 +13,91 @@ IncidentClusterer::IncidentClusterer(Config config) : config_(config) {}
 void IncidentClusterer::assign_clusters(std::vector<storage::Event>& events) {
     cleanup_old_clusters();
     
-    EventNormalizer normalizer;
-    
     for (auto& event : events) {
-        json features = normalizer.extract_features(event);
+        FeatureKeys features = feature_keys(event.features);
         std::string cluster_id = find_or_create_cluster(event, features);
         event.cluster_id = cluster_id;
     }
 }
 
 std::string IncidentClusterer::find_or_create_cluster(
-    const storage::Event& event, const json& features) {
-    
-    double best_similarity = 0.0;
-    std::string best_cluster_id;
-    
-    // Find most similar active cluster
-    for (const auto& [cid, cluster] : active_clusters_) {
-        if (cluster.fingerprint != event.fingerprint) continue;
-        
-        double sim = jaccard_similarity(features, cluster.centroid);
-        if (sim > best_similarity) {
-            best_similarity = sim;
-            best_cluster_id = cid;
-        }
-    }
+    const storage::Event& event, const FeatureKeys& features) {
     
     // Use existing cluster if similarity exceeds threshold
-    if (best_similarity >= config_.similarity_threshold && !best_cluster_id.empty()) {
-        auto& cluster = active_clusters_[best_cluster_id];
-        cluster.event_count++;
-        cluster.last_updated = event.ts;
+    auto it = active_clusters_.find(event.fingerprint);
+    if (it != active_clusters_.end()) {
+        auto& cluster = it->second;
+        double sim = key_similarity(features, cluster.centroid);
         
-        // Update centroid (simple average)
-        for (auto& [key, val] : features.items()) {
-            if (val.is_number() && cluster.centroid.contains(key)) {
-                double old_val = cluster.centroid[key].get<double>();
-                cluster.centroid[key] = (old_val * (cluster.event_count - 1) + val.get<double>()) / cluster.event_count;
-            } else if (!cluster.centroid.contains(key)) {
-                cluster.centroid[key] = val;
+        if (sim >= config_.similarity_threshold && sim > 0.0) {
+            cluster.event_count++;
+            cluster.last_updated = event.ts;
+            
+            // Centroid is the union of member features
+            for (size_t i = 0; i < features.size; ++i) {
+                auto pos = std::lower_bound(cluster.centroid.begin(), cluster.centroid.end(), features.keys[i]);
+                if (pos == cluster.centroid.end() || *pos != features.keys[i]) {
+                    cluster.centroid.insert(pos, features.keys[i]);
+                }
             }
+            
+            return cluster.id;
         }
-        
-        return best_cluster_id;
     }
     
     // Create new cluster
-    std::string new_cluster_id = IDGenerator::generate_cluster_id(event.fingerprint);
-    
     Cluster new_cluster;
-    new_cluster.id = new_cluster_id;
+    new_cluster.id = IDGenerator::generate_cluster_id(event.fingerprint);
     new_cluster.fingerprint = event.fingerprint;
-    new_cluster.centroid = features;
+    new_cluster.centroid.assign(features.keys.begin(), features.keys.begin() + features.size);
     new_cluster.last_updated = event.ts;
     new_cluster.event_count = 1;
     
-    active_clusters_[new_cluster_id] = new_cluster;
+    auto& stored = active_clusters_[event.fingerprint] = std::move(new_cluster);
+    
+    return stored.id;
+}
+
+IncidentClusterer::FeatureKeys IncidentClusterer::feature_keys(const storage::EventFeatures& features) {
+    FeatureKeys result;
+    auto add = [&result](uint64_t dimension, std::string_view name) {
+        if (!name.empty()) {
+            result.keys[result.size++] = Hash64().update(dimension).update(name).digest();
+        }
+    };
+    
+    add(0, features.verb_name());
+    add(1, features.proto_name());
+    add(2, features.outcome_name());
+    
+    // Insertion sort; at most three keys
+    for (size_t i = 1; i < result.size; ++i) {
+        for (size_t j = i; j > 0 && result.keys[j] < result.keys[j - 1]; --j) {
+            std::swap(result.keys[j], result.keys[j - 1]);
+        }
+    }
+    return result;
+}
+
+double IncidentClusterer::key_similarity(
+    const FeatureKeys& features, const std::vector<uint64_t>& centroid) {
+    // Jaccard over sorted key sets
+    if (features.size == 0 && centroid.empty()) return 1.0;
+    
+    size_t i = 0, j = 0, common = 0;
+    while (i < features.size && j < centroid.size()) {
+        if (features.keys[i] < centroid[j]) {
+            i++;
+        } else if (centroid[j] < features.keys[i]) {
+            j++;
+        } else {
+            common++;
+            i++;
+            j++;
+        }
+    }
     
-    return new_cluster_id;
+    return static_cast<double>(common) / (features.size + centroid.size() - common);
 }
 
 void IncidentClusterer::cleanup_old_clusters() {
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "storage/schemas.hpp"
+#include <array>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <string>
 #include <chrono>
 #include <nlohmann/json.hpp>
@@ -43,18 +45,29 @@ public:
 private:
     Config config_;
     
+    // One-hot verb/proto/outcome features as sorted hashed keys
+    struct FeatureKeys {
+        std::array<uint64_t, 3> keys{};
+        size_t size = 0;
+    };
+
     struct Cluster {
         std::string id;
-        std::string fingerprint;
-        json centroid;
+        uint64_t fingerprint = 0;
+        std::vector<uint64_t> centroid;   // sorted union of member feature keys
         std::chrono::system_clock::time_point last_updated;
         int event_count = 0;
     };
 
-    std::map<std::string, Cluster> active_clusters_;
+    // Cluster IDs are derived from the fingerprint, so there is at most one
+    // active cluster per fingerprint
+    std::unordered_map<uint64_t, Cluster> active_clusters_;
 
     void cleanup_old_clusters();
-    std::string find_or_create_cluster(const storage::Event& event, const json& features);
+    std::string find_or_create_cluster(const storage::Event& event, const FeatureKeys& features);
+
+    static FeatureKeys feature_keys(const storage::EventFeatures& features);
+    static double key_similarity(const FeatureKeys& features, const std::vector<uint64_t>& centroid);
 };
 
 } // namespace siem::core
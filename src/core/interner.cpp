@@ -0,0 +1,190 @@
+#include "core/interner.hpp"
+#include "core/hash.hpp"
+#include <bit>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <mutex>
+#include <stdexcept>
+
+namespace siem::core {
+
+StringInterner::StringInterner(size_t max_strings)
+    : max_strings_(std::min(max_strings, kMaxStrings)) {
+    entry(kEmptyId) = Entry{"", 0, Hash64::hash(std::string_view())};
+}
+
+StringInterner::~StringInterner() {
+    for (auto& chunk : chunks_) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+StringInterner& StringInterner::global() {
+    // Leaked on purpose: symbols may be read by threads still running at exit
+    static auto* instance = new StringInterner();
+    return *instance;
+}
+
+uint32_t StringInterner::intern(std::string_view text) {
+    auto id = try_intern(text);
+    if (!id) {
+        throw std::overflow_error("String interner exhausted");
+    }
+    return *id;
+}
+
+std::optional<uint32_t> StringInterner::try_intern(std::string_view text) {
+    if (text.empty()) return kEmptyId;
+    if (text.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("String too long to intern");
+    }
+
+    uint64_t hash = Hash64::hash(text);
+    Shard& shard = shards_[hash >> 60];
+    static_assert(kShards == 16, "shard index uses the top 4 hash bits");
+
+    {
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.ids.find(text);
+        if (it != shard.ids.end()) return it->second;
+    }
+
+    std::unique_lock lock(shard.mutex);
+    auto it = shard.ids.find(text);
+    if (it != shard.ids.end()) return it->second;
+
+    // Reserve an id only while there is room, so a full table stays full
+    // instead of the counter running on and wrapping onto live ids
+    uint32_t id = next_id_.load(std::memory_order_relaxed);
+    do {
+        if (id > max_strings_.load(std::memory_order_relaxed)) return std::nullopt;
+    } while (!next_id_.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+
+    const char* data = store(shard, text);
+    entry(id) = Entry{data, static_cast<uint32_t>(text.size()), hash};
+    shard.ids.emplace(std::string_view(data, text.size()), id);
+    return id;
+}
+
+std::string_view StringInterner::view(uint32_t id) const {
+    const Entry& e = entry(id);
+    return std::string_view(e.data, e.size);
+}
+
+uint64_t StringInterner::content_hash(uint32_t id) const {
+    return entry(id).hash;
+}
+
+size_t StringInterner::size() const {
+    return next_id_.load(std::memory_order_relaxed) - 1;
+}
+
+size_t StringInterner::memory_bytes() const {
+    size_t bytes = arena_bytes_.load(std::memory_order_relaxed);
+    for (const auto& shard : shards_) {
+        std::shared_lock lock(shard.mutex);
+        // Bucket array plus one node (next pointer, key, id) per string
+        bytes += shard.ids.bucket_count() * sizeof(void*);
+        bytes += shard.ids.size() * (sizeof(void*) + sizeof(std::string_view) + sizeof(uint64_t));
+    }
+    return bytes;
+}
+
+void StringInterner::set_max_strings(size_t max_strings) {
+    max_strings_.store(std::min(max_strings, kMaxStrings), std::memory_order_relaxed);
+}
+
+const char* StringInterner::store(Shard& shard, std::string_view text) {
+    // Large strings get their own block so they don't waste the shared one
+    if (text.size() > kBlockSize / 4) {
+        auto& block = shard.blocks.emplace_back(new char[text.size()]);
+        arena_bytes_.fetch_add(text.size(), std::memory_order_relaxed);
+        std::memcpy(block.get(), text.data(), text.size());
+        return block.get();
+    }
+
+    if (shard.remaining < text.size()) {
+        shard.cursor = shard.blocks.emplace_back(new char[kBlockSize]).get();
+        shard.remaining = kBlockSize;
+        arena_bytes_.fetch_add(kBlockSize, std::memory_order_relaxed);
+    }
+
+    char* data = shard.cursor;
+    std::memcpy(data, text.data(), text.size());
+    shard.cursor += text.size();
+    shard.remaining -= text.size();
+    return data;
+}
+
+StringInterner::Entry& StringInterner::entry(uint32_t id) {
+    uint64_t n = uint64_t{id} + (1u << kFirstChunkBits);
+    size_t chunk_index = std::bit_width(n) - 1 - kFirstChunkBits;
+    size_t chunk_size = size_t{1} << (kFirstChunkBits + chunk_index);
+
+    Entry* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+        // Shards may race to create the same chunk; the loser frees its copy
+        auto* fresh = new Entry[chunk_size];
+        if (chunks_[chunk_index].compare_exchange_strong(chunk, fresh, std::memory_order_acq_rel)) {
+            chunk = fresh;
+            arena_bytes_.fetch_add(chunk_size * sizeof(Entry), std::memory_order_relaxed);
+        } else {
+            delete[] fresh;
+        }
+    }
+    return chunk[n - chunk_size];
+}
+
+const StringInterner::Entry& StringInterner::entry(uint32_t id) const {
+    uint64_t n = uint64_t{id} + (1u << kFirstChunkBits);
+    size_t chunk_index = std::bit_width(n) - 1 - kFirstChunkBits;
+    size_t chunk_size = size_t{1} << (kFirstChunkBits + chunk_index);
+
+    const Entry* chunk = chunks_[chunk_index].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+        throw std::out_of_range("Unknown interned id");
+    }
+    return chunk[n - chunk_size];
+}
+
+Symbol::Symbol(std::string_view text) {
+    if (auto id = StringInterner::global().try_intern(text)) {
+        bits_ = (uintptr_t{*id} << 1) | 1;
+    } else {
+        *this = copy(text);
+    }
+}
+
+Symbol Symbol::uninterned(std::string_view text) {
+    return text.empty() ? Symbol() : copy(text);
+}
+
+Symbol Symbol::copy(std::string_view text) {
+    if (text.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("String too long for a symbol");
+    }
+
+    // Owned is 8-byte aligned, which keeps the low (tag) bit clear. Never
+    // allocate less than sizeof(Owned): constructing it touches the padding
+    // behind data[1] too.
+    void* memory = ::operator new(std::max(sizeof(Owned), offsetof(Owned, data) + text.size()));
+    auto* owned = ::new (memory) Owned{{1}, static_cast<uint32_t>(text.size()), Hash64::hash(text), {}};
+    std::memcpy(owned->data, text.data(), text.size());
+    Symbol symbol;
+    symbol.bits_ = reinterpret_cast<uintptr_t>(owned);
+    return symbol;
+}
+
+void Symbol::release() {
+    if (interned()) return;
+    auto* owned = reinterpret_cast<Owned*>(bits_);
+    if (owned->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        owned->~Owned();
+        ::operator delete(owned);
+    }
+}
+
+} // namespace siem::core
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace siem::core {
+
+/**
+ * Concurrent append-only string interner
+ * - Dense 32-bit ids; id 0 is the empty string
+ * - Interned bytes never move, so views stay valid for the process lifetime
+ * - Lookups take a shared lock on one of kShards shards; id -> string is lock-free
+ * Ids are process-local; anything persisted uses the string or its content hash.
+ *
+ * Nothing is ever freed, so the table holds at most max_strings strings
+ * (about 64 bytes each plus the text). The global instance holds sources,
+ * hosts, IPs and users, some of which come from network input (syslog
+ * hostnames, CEF and grok captures), so a peer can fill it; once full it
+ * stays full, try_intern() returns nullopt for anything new and Symbol
+ * keeps such strings itself. Watch the interner_strings / interner_bytes
+ * gauges; keys chosen by a peer, such as exporter addresses, do not
+ * belong here.
+ */
+class StringInterner {
+public:
+    static constexpr uint32_t kEmptyId = 0;
+    static constexpr size_t kDefaultMaxStrings = size_t{1} << 20;
+    static constexpr size_t kMaxStrings = (size_t{1} << 31) - 1;
+
+    explicit StringInterner(size_t max_strings = kDefaultMaxStrings);
+    ~StringInterner();
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    /**
+     * Process-wide instance used by Symbol; never destroyed
+     */
+    static StringInterner& global();
+
+    /**
+     * Id of text, interning it if there is room; nullopt once the table is full
+     */
+    std::optional<uint32_t> try_intern(std::string_view text);
+
+    /**
+     * Same, but throws std::overflow_error once the table is full
+     */
+    uint32_t intern(std::string_view text);
+
+    std::string_view view(uint32_t id) const;
+
+    /**
+     * Hash64 of the string bytes, computed once at intern time
+     */
+    uint64_t content_hash(uint32_t id) const;
+
+    /**
+     * Strings interned, not counting the empty string
+     */
+    size_t size() const;
+
+    /**
+     * Arena, id table and index memory in bytes
+     */
+    size_t memory_bytes() const;
+
+    /**
+     * Caps the table; a cap below the current size just stops it growing.
+     * Symbols made while the table was full keep their copies.
+     */
+    void set_max_strings(size_t max_strings);
+
+    size_t max_strings() const { return max_strings_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        const char* data = nullptr;
+        uint32_t size = 0;
+        uint64_t hash = 0;
+    };
+
+    // Id table chunks double in size, so a fixed directory covers all ids
+    static constexpr uint32_t kFirstChunkBits = 10;
+    static constexpr size_t kMaxChunks = 32 - kFirstChunkBits + 1;
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, uint32_t> ids;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char* cursor = nullptr;
+        size_t remaining = 0;
+    };
+
+    std::array<Shard, kShards> shards_;
+    std::array<std::atomic<Entry*>, kMaxChunks> chunks_{};
+    std::atomic<uint32_t> next_id_{1};
+    std::atomic<size_t> max_strings_;
+    std::atomic<size_t> arena_bytes_{0};
+
+    const char* store(Shard& shard, std::string_view text);
+    Entry& entry(uint32_t id);
+    const Entry& entry(uint32_t id) const;
+};
+
+/**
+ * Interned string handle; compares by id and hashes by the cached content hash
+ *
+ * Strings the global interner has no room for, and per-record values that
+ * should not take a slot (see uninterned()), are kept in a reference
+ * counted copy owned by the symbols that share it; those compare by
+ * content, so they still equal an interned symbol of the same string.
+ * Either way the handle is one tagged word: an odd value is id << 1 | 1.
+ */
+class Symbol {
+public:
+    static constexpr uint32_t kUninternedId = UINT32_MAX;
+
+    Symbol() = default;
+    explicit Symbol(std::string_view text);
+
+    /**
+     * Symbol that holds its own copy rather than interning, for
+     * high-cardinality values such as per-flow addresses
+     */
+    static Symbol uninterned(std::string_view text);
+
+    Symbol(const Symbol& other) noexcept : bits_(other.bits_) { retain(); }
+    Symbol(Symbol&& other) noexcept : bits_(other.bits_) { other.bits_ = kEmptyBits; }
+    Symbol& operator=(const Symbol& other) noexcept {
+        other.retain();
+        release();
+        bits_ = other.bits_;
+        return *this;
+    }
+    Symbol& operator=(Symbol&& other) noexcept {
+        if (this != &other) {
+            release();
+            bits_ = other.bits_;
+            other.bits_ = kEmptyBits;
+        }
+        return *this;
+    }
+    ~Symbol() { release(); }
+
+    bool interned() const { return bits_ & 1; }
+
+    /**
+     * Interner id, or kUninternedId for a string kept outside the interner
+     */
+    uint32_t id() const { return interned() ? static_cast<uint32_t>(bits_ >> 1) : kUninternedId; }
+    bool empty() const { return bits_ == kEmptyBits; }
+
+    std::string_view view() const {
+        if (interned()) return StringInterner::global().view(id());
+        return std::string_view(owned()->data, owned()->size);
+    }
+    std::string str() const { return std::string(view()); }
+    uint64_t content_hash() const {
+        return interned() ? StringInterner::global().content_hash(id()) : owned()->hash;
+    }
+
+    friend bool operator==(const Symbol& a, const Symbol& b) {
+        if (a.bits_ == b.bits_) return true;
+        if (a.interned() && b.interned()) return false;
+        return a.content_hash() == b.content_hash() && a.view() == b.view();
+    }
+    friend bool operator==(const Symbol& a, std::string_view b) { return a.view() == b; }
+
+private:
+    struct Owned {
+        mutable std::atomic<uint32_t> refs;
+        uint32_t size;
+        uint64_t hash;
+        char data[1];
+    };
+
+    static constexpr uintptr_t kEmptyBits = (uintptr_t{StringInterner::kEmptyId} << 1) | 1;
+
+    uintptr_t bits_ = kEmptyBits;
+
+    const Owned* owned() const { return reinterpret_cast<const Owned*>(bits_); }
+    void retain() const {
+        if (!interned()) owned()->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void release();
+    static Symbol copy(std::string_view text);
+};
+
+} // namespace siem::core
+
+template <>
+struct std::hash<siem::core::Symbol> {
+    size_t operator()(const siem::core::Symbol& s) const noexcept { return s.content_hash(); }
+};
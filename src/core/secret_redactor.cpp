@@ -0,0 +1,428 @@
+#include "core/secret_redactor.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <deque>
+#include <regex>
+
+namespace siem::core {
+
+namespace {
+
+struct TokenRule {
+    const char* anchor;         // literal prefix, matched case-insensitively
+    const char* pattern;        // confirmed case-sensitively from the anchor
+};
+
+const TokenRule kTokenRules[] = {
+    {"AKIA", "AKIA[0-9A-Z]{16}"},
+    {"ASIA", "ASIA[0-9A-Z]{16}"},
+    {"eyJ", "eyJ[A-Za-z0-9_-]{8,}\\.[A-Za-z0-9_-]{8,}\\.[A-Za-z0-9_-]{8,}"},
+    {"ghp_", "ghp_[A-Za-z0-9]{36}"},
+    {"gho_", "gho_[A-Za-z0-9]{36}"},
+    {"ghs_", "ghs_[A-Za-z0-9]{36}"},
+    {"xoxb-", "xoxb-[A-Za-z0-9-]{10,}"},
+    {"xoxp-", "xoxp-[A-Za-z0-9-]{10,}"},
+    {"sk_live_", "sk_live_[A-Za-z0-9]{16,}"},
+};
+
+constexpr size_t kTokenRuleCount = sizeof(kTokenRules) / sizeof(kTokenRules[0]);
+
+// Regex input is bounded so one anchor cannot cost more than this
+constexpr size_t kMaxTokenBytes = 512;
+
+const std::vector<std::regex>& token_regexes() {
+    static const std::vector<std::regex> regexes = [] {
+        std::vector<std::regex> compiled;
+        for (const auto& rule : kTokenRules) {
+            compiled.emplace_back(rule.pattern, std::regex::ECMAScript | std::regex::optimize);
+        }
+        return compiled;
+    }();
+    return regexes;
+}
+
+unsigned char lower(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+bool is_value_delimiter(char c) {
+    switch (c) {
+        case '&': case ';': case ',': case ' ': case '\t': case '\r': case '\n':
+        case '"': case '\'': case '\\':
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_word_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Whether the auth scheme at `pos` follows an Authorization header name,
+// e.g. "Authorization: Bearer" or "Proxy-Authorization:Basic"
+bool after_auth_header(std::string_view text, size_t begin, size_t pos) {
+    constexpr std::string_view kHeader = "authorization";
+
+    while (pos > begin && is_space(text[pos - 1])) pos--;
+    if (pos == begin || text[pos - 1] != ':') return false;
+    pos--;
+    while (pos > begin && is_space(text[pos - 1])) pos--;
+    if (pos - begin < kHeader.size()) return false;
+
+    size_t name = pos - kHeader.size();
+    for (size_t i = 0; i < kHeader.size(); ++i) {
+        if (lower(static_cast<unsigned char>(text[name + i])) != kHeader[i]) return false;
+    }
+    return name == begin || !is_word_char(text[name - 1]);
+}
+
+// Index of the closing quote of a string whose content starts at `from`
+size_t find_string_end(std::string_view text, size_t from) {
+    while (true) {
+        size_t pos = text.find('"', from);
+        if (pos == std::string_view::npos) return pos;
+
+        size_t backslashes = 0;
+        while (pos - backslashes > from && text[pos - backslashes - 1] == '\\') backslashes++;
+        if (backslashes % 2 == 0) return pos;
+        from = pos + 1;
+    }
+}
+
+// End (exclusive) of the JSON value starting at `pos`
+size_t skip_value(std::string_view text, size_t pos) {
+    char c = text[pos];
+    if (c == '"') {
+        size_t close = find_string_end(text, pos + 1);
+        return close == std::string_view::npos ? text.size() : close + 1;
+    }
+
+    if (c == '{' || c == '[') {
+        size_t depth = 0;
+        while (pos < text.size()) {
+            char d = text[pos];
+            if (d == '"') {
+                size_t close = find_string_end(text, pos + 1);
+                if (close == std::string_view::npos) return text.size();
+                pos = close + 1;
+                continue;
+            }
+            if (d == '{' || d == '[') depth++;
+            if ((d == '}' || d == ']') && --depth == 0) return pos + 1;
+            pos++;
+        }
+        return text.size();
+    }
+
+    while (pos < text.size() && !is_space(text[pos]) &&
+           text[pos] != ',' && text[pos] != '}' && text[pos] != ']') {
+        pos++;
+    }
+    return pos;
+}
+
+} // namespace
+
+SecretRedactor::SecretRedactor() : SecretRedactor(Config{}) {}
+
+SecretRedactor::SecretRedactor(Config config) : config_(std::move(config)) {
+    token_regexes(); // Compile up front rather than on the first hit
+    build();
+}
+
+void SecretRedactor::build() {
+    std::vector<std::pair<std::string, Kind>> patterns;
+    std::vector<uint8_t> tokens;
+    auto add = [&](std::string_view pattern, Kind kind, uint8_t token) {
+        if (pattern.empty() || pattern.size() > 255) return;
+        std::string lowered(pattern);
+        for (auto& c : lowered) c = static_cast<char>(lower(static_cast<unsigned char>(c)));
+        patterns.emplace_back(std::move(lowered), kind);
+        tokens.push_back(token);
+    };
+
+    for (const auto& key : config_.secret_keys) add(key, Kind::Key, 0);
+    for (const auto& prefix : config_.value_prefixes) add(prefix, Kind::Prefix, 0);
+    for (const auto& scheme : config_.auth_schemes) add(scheme, Kind::Scheme, 0);
+    for (size_t i = 0; i < kTokenRuleCount; ++i) {
+        add(kTokenRules[i].anchor, Kind::Token, static_cast<uint8_t>(i + 1));
+    }
+
+    // Byte classes: one per distinct pattern character (case-folded), 0 for the rest
+    classes_.fill(0);
+    class_count_ = 1;
+    for (const auto& [pattern, kind] : patterns) {
+        for (unsigned char c : pattern) {
+            if (classes_[c] == 0) {
+                classes_[c] = static_cast<uint8_t>(class_count_++);
+                if (c >= 'a' && c <= 'z') classes_[c - ('a' - 'A')] = classes_[c];
+            }
+        }
+    }
+
+    // Trie over classes; -1 marks a missing edge until failure links fill it
+    std::vector<int64_t> trie(class_count_, -1);
+    std::vector<size_t> depth(1, 0);
+    outputs_.assign(1, Output{});
+    for (size_t p = 0; p < patterns.size(); ++p) {
+        const auto& [pattern, kind] = patterns[p];
+        size_t state = 0;
+        for (unsigned char c : pattern) {
+            auto& edge = trie[state * class_count_ + classes_[c]];
+            if (edge < 0) {
+                edge = static_cast<int64_t>(outputs_.size());
+                outputs_.emplace_back();
+                depth.push_back(depth[state] + 1);
+                trie.resize(trie.size() + class_count_, -1);
+            }
+            state = static_cast<size_t>(trie[state * class_count_ + classes_[c]]);
+        }
+        outputs_[state].kinds |= static_cast<uint8_t>(kind);
+        if (kind == Kind::Token) {
+            outputs_[state].token = tokens[p];
+            outputs_[state].token_length = static_cast<uint8_t>(depth[state]);
+        }
+    }
+
+    // Breadth-first failure links, folded into a dense transition table
+    size_t states = outputs_.size();
+    next_.assign(states * class_count_, 0);
+    std::vector<uint32_t> fail(states, 0);
+    std::deque<uint32_t> queue;
+
+    for (size_t c = 0; c < class_count_; ++c) {
+        if (trie[c] > 0) {
+            next_[c] = static_cast<uint32_t>(trie[c]);
+            queue.push_back(next_[c]);
+        }
+    }
+
+    while (!queue.empty()) {
+        uint32_t state = queue.front();
+        queue.pop_front();
+
+        const Output& inherited = outputs_[fail[state]];
+        outputs_[state].kinds |= inherited.kinds;
+        if (outputs_[state].token == 0) {
+            outputs_[state].token = inherited.token;
+            outputs_[state].token_length = inherited.token_length;
+        }
+
+        for (size_t c = 0; c < class_count_; ++c) {
+            int64_t child = trie[state * class_count_ + c];
+            if (child >= 0) {
+                fail[child] = next_[fail[state] * class_count_ + c];
+                next_[state * class_count_ + c] = static_cast<uint32_t>(child);
+                queue.push_back(static_cast<uint32_t>(child));
+            } else {
+                next_[state * class_count_ + c] = next_[fail[state] * class_count_ + c];
+            }
+        }
+    }
+}
+
+bool SecretRedactor::is_secret_key(std::string_view key) const {
+    uint32_t state = 0;
+    for (unsigned char c : key) {
+        state = step(state, c);
+        if (outputs_[state].kinds & static_cast<uint8_t>(Kind::Key)) return true;
+    }
+    return false;
+}
+
+void SecretRedactor::scan_value(std::string_view text, size_t begin, size_t end,
+                                std::vector<Span>& spans, size_t& token_checks, size_t& skipped) const {
+    constexpr uint8_t kValueKinds = static_cast<uint8_t>(Kind::Prefix) | static_cast<uint8_t>(Kind::Token) |
+                                    static_cast<uint8_t>(Kind::Scheme);
+    constexpr uint8_t kSchemeKind = static_cast<uint8_t>(Kind::Scheme);
+
+    uint32_t state = 0;
+    for (size_t i = begin; i < end; ++i) {
+        state = step(state, static_cast<unsigned char>(text[i]));
+        const Output& out = outputs_[state];
+        if (!(out.kinds & kValueKinds)) continue;
+
+        size_t start = i + 1;
+        size_t stop = start;
+        bool prefixed = out.kinds & static_cast<uint8_t>(Kind::Prefix);
+        if (!prefixed && (out.kinds & kSchemeKind)) {
+            // Schemes are ordinary words outside an Authorization header
+            size_t length = 0;
+            for (const auto& scheme : config_.auth_schemes) {
+                if (scheme.size() <= i + 1 - begin &&
+                    std::equal(scheme.begin(), scheme.end(), text.begin() + (i + 1 - scheme.size()),
+                               [](char a, char b) { return lower(a) == lower(b); })) {
+                    length = scheme.size();
+                    break;
+                }
+            }
+            prefixed = length > 0 && after_auth_header(text, begin, i + 1 - length);
+            if (!prefixed && !(out.kinds & static_cast<uint8_t>(Kind::Token))) continue;
+        }
+        if (prefixed) {
+            // Secret follows the prefix up to the next delimiter
+            while (stop < end && !is_value_delimiter(text[stop])) stop++;
+        } else {
+            start = i + 1 - out.token_length;
+            if (token_checks < config_.max_token_checks) {
+                token_checks++;
+                std::cmatch match;
+                const char* first = text.data() + start;
+                const char* last = text.data() + std::min(end, start + kMaxTokenBytes);
+                if (!std::regex_search(first, last, match, token_regexes()[out.token - 1],
+                                       std::regex_constants::match_continuous)) {
+                    continue;
+                }
+                stop = start + static_cast<size_t>(match.length(0));
+            } else {
+                // Over budget: left unconfirmed, and counted rather than
+                // redacting whatever follows the anchor
+                skipped++;
+                continue;
+            }
+        }
+
+        if (stop > start) spans.push_back(Span{start, stop, false});
+        i = std::max(stop, i + 1) - 1;
+        state = 0;
+    }
+}
+
+size_t SecretRedactor::redact(std::string_view raw, std::string& out) const {
+    std::vector<Span> spans;
+    std::vector<bool> in_object;    // container stack
+    bool expect_key = false;
+    bool redact_next = false;
+    size_t token_checks = 0;
+    size_t skipped = 0;
+
+    size_t i = 0;
+    while (i < raw.size()) {
+        char c = raw[i];
+
+        if (redact_next && !is_space(c) && c != ':') {
+            // Value of a secret key, whatever its type
+            size_t stop = skip_value(raw, i);
+            if (c == '"') spans.push_back(Span{i + 1, std::max(stop, i + 2) - 1, false});
+            else spans.push_back(Span{i, stop, true});
+            redact_next = false;
+            expect_key = false;
+            i = stop;
+            continue;
+        }
+
+        switch (c) {
+            case '"': {
+                size_t close = find_string_end(raw, i + 1);
+                if (close == std::string_view::npos) {
+                    // Unterminated; the parser will reject it, but the bytes
+                    // may still be kept (dead letters), so scan the rest
+                    scan_value(raw, i + 1, raw.size(), spans, token_checks, skipped);
+                    i = raw.size();
+                    continue;
+                }
+                if (expect_key && !in_object.empty() && in_object.back()) {
+                    redact_next = is_secret_key(raw.substr(i + 1, close - i - 1));
+                } else {
+                    scan_value(raw, i + 1, close, spans, token_checks, skipped);
+                }
+                i = close + 1;
+                continue;
+            }
+            case '{':
+                if (in_object.size() <= 1) token_checks = 0;   // New top-level event
+                in_object.push_back(true);
+                expect_key = true;
+                break;
+            case '[':
+                in_object.push_back(false);
+                expect_key = false;
+                break;
+            case '}':
+            case ']':
+                if (!in_object.empty()) in_object.pop_back();
+                expect_key = false;
+                break;
+            case ':':
+                expect_key = false;
+                break;
+            case ',':
+                expect_key = !in_object.empty() && in_object.back();
+                break;
+            default:
+                break;
+        }
+        i++;
+    }
+
+    count_skipped(skipped);
+    if (spans.empty()) return 0;
+    out = apply(raw, spans);
+    return spans.size();
+}
+
+size_t SecretRedactor::redact(json& value) const {
+    size_t token_checks = 0;
+    size_t skipped = 0;
+    size_t count = redact_value(value, token_checks, skipped);
+    count_skipped(skipped);
+    return count;
+}
+
+void SecretRedactor::count_skipped(size_t skipped) const {
+    if (skipped == 0) return;
+    skipped_checks_.fetch_add(skipped, std::memory_order_relaxed);
+    spdlog::warn(R"({{"msg":"redaction_checks_skipped","anchors":{},"max_token_checks":{}}})",
+                skipped, config_.max_token_checks);
+}
+
+size_t SecretRedactor::redact_value(json& value, size_t& token_checks, size_t& skipped) const {
+    size_t count = 0;
+
+    if (value.is_object()) {
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            if (is_secret_key(it.key())) {
+                it.value() = std::string(kMarker);
+                count++;
+            } else {
+                count += redact_value(it.value(), token_checks, skipped);
+            }
+        }
+    } else if (value.is_array()) {
+        for (auto& item : value) {
+            count += redact_value(item, token_checks, skipped);
+        }
+    } else if (value.is_string()) {
+        const auto& text = value.get_ref<const std::string&>();
+        std::vector<Span> spans;
+        scan_value(text, 0, text.size(), spans, token_checks, skipped);
+        if (!spans.empty()) {
+            value = apply(text, spans);
+            count += spans.size();
+        }
+    }
+
+    return count;
+}
+
+std::string SecretRedactor::apply(std::string_view text, const std::vector<Span>& spans) {
+    constexpr std::string_view kQuotedMarker = "\"***REDACTED***\"";
+
+    std::string out;
+    out.reserve(text.size());
+    size_t pos = 0;
+    for (const auto& span : spans) {
+        out.append(text.substr(pos, span.begin - pos));
+        out.append(span.quote ? kQuotedMarker : kMarker);
+        pos = span.end;
+    }
+    out.append(text.substr(pos));
+    return out;
+}
+
+} // namespace siem::core
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace siem::core {
+
+using json = nlohmann::json;
+
+/**
+ * Multi-pattern secret redaction
+ * One case-insensitive Aho-Corasick automaton matches, in a single pass:
+ * - secret key names (substring match: "db_password", "access_token")
+ * - value prefixes ("password=" in a URL); the value is redacted up to the
+ *   next delimiter
+ * - auth schemes ("Bearer ", "Basic "), redacted like a prefix but only
+ *   right after an "Authorization:" header name, so prose is left alone
+ * - token anchors ("AKIA", "eyJ", "ghp_"), confirmed by a regex compiled once
+ * Regex checks are capped per event; anchors past the cap are left as they
+ * are and counted in skipped_checks(). A value under a secret key, such as
+ * "authorization", is redacted whole regardless.
+ */
+class SecretRedactor {
+public:
+    struct Config {
+        std::vector<std::string> secret_keys = {
+            "password", "passwd", "token", "api_key", "apikey",
+            "secret", "credential", "private_key", "authorization"
+        };
+        std::vector<std::string> value_prefixes = {
+            "password=", "passwd=", "pwd=", "token=", "api_key=", "apikey=",
+            "secret=", "access_token=",
+        };
+        std::vector<std::string> auth_schemes = {"bearer ", "basic "};
+        size_t max_token_checks = 8;   // regex evaluations per event
+    };
+
+    static constexpr std::string_view kMarker = "***REDACTED***";
+
+    SecretRedactor();
+    explicit SecretRedactor(Config config);
+
+    /**
+     * Redact a raw JSON document (object, or array of events) in one pass
+     * Returns the number of redactions; `out` is only written when non-zero
+     */
+    size_t redact(std::string_view raw, std::string& out) const;
+
+    /**
+     * Redact an already-parsed value in place
+     */
+    size_t redact(json& value) const;
+
+    /**
+     * Token anchors left unconfirmed because an event ran out of regex checks
+     */
+    uint64_t skipped_checks() const { return skipped_checks_.load(std::memory_order_relaxed); }
+
+private:
+    enum class Kind : uint8_t { Key = 1, Prefix = 2, Token = 4, Scheme = 8 };
+
+    // Per automaton state: union of pattern kinds ending here, and the
+    // longest token anchor ending here
+    struct Output {
+        uint8_t kinds = 0;
+        uint8_t token = 0;          // regex index + 1
+        uint8_t token_length = 0;
+    };
+
+    struct Span {
+        size_t begin;
+        size_t end;
+        bool quote;                 // replace a whole JSON value, not string content
+    };
+
+    Config config_;
+    std::array<uint8_t, 256> classes_{};
+    size_t class_count_ = 1;
+    std::vector<uint32_t> next_;    // state * class_count_ + class -> state
+    std::vector<Output> outputs_;
+    mutable std::atomic<uint64_t> skipped_checks_{0};
+
+    void build();
+
+    uint32_t step(uint32_t state, unsigned char c) const {
+        return next_[state * class_count_ + classes_[c]];
+    }
+
+    bool is_secret_key(std::string_view key) const;
+
+    /**
+     * Collect spans to redact inside string content [begin, end) of text
+     */
+    void scan_value(std::string_view text, size_t begin, size_t end,
+                    std::vector<Span>& spans, size_t& token_checks, size_t& skipped) const;
+
+    size_t redact_value(json& value, size_t& token_checks, size_t& skipped) const;
+
+    void count_skipped(size_t skipped) const;
+
+    static std::string apply(std::string_view text, const std::vector<Span>& spans);
+};
+
+} // namespace siem::core
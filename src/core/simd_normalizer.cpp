@@ -0,0 +1,400 @@
+#include "core/simd_normalizer.hpp"
+#include "core/timestamp.hpp"
+#include <simdjson.h>
+#include <spdlog/spdlog.h>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+
+namespace siem::core {
+
+namespace {
+
+using simdjson::ondemand::json_type;
+using simdjson::ondemand::number_type;
+
+// Parser and padded input buffer are reused per thread
+simdjson::ondemand::parser& get_parser() {
+    static thread_local simdjson::ondemand::parser parser;
+    return parser;
+}
+
+simdjson::padded_string_view pad(std::string_view input) {
+    static thread_local std::string buffer;
+    buffer.resize(input.size() + simdjson::SIMDJSON_PADDING);
+    std::memcpy(buffer.data(), input.data(), input.size());
+    return simdjson::padded_string_view(buffer.data(), input.size(), buffer.size());
+}
+
+// Convert a value to json with the same number typing as json::parse
+json to_json(simdjson::ondemand::value val) {
+    switch (val.type().value()) {
+        case json_type::string:
+            return json(std::string(val.get_string().value()));
+        case json_type::boolean:
+            return json(val.get_bool().value());
+        case json_type::null:
+            return json(nullptr);
+        case json_type::number:
+            switch (val.get_number_type().value()) {
+                case number_type::signed_integer: {
+                    int64_t i = val.get_int64();
+                    return i >= 0 ? json(static_cast<uint64_t>(i)) : json(i);
+                }
+                case number_type::unsigned_integer:
+                    return json(val.get_uint64().value());
+                case number_type::floating_point_number:
+                    return json(val.get_double().value());
+                default:
+                    return json::parse(val.raw_json_token());
+            }
+        default:
+            return json::parse(val.raw_json().value());
+    }
+}
+
+// A value seen in the document; strings stay views into the parser's
+// string buffer, which lives until the next document is parsed
+struct Slot {
+    uint32_t stamp = 0;       // Present when equal to Values::stamp
+    bool is_json = false;
+    std::string_view str;
+    json value;
+
+    bool is_string() const { return !is_json || value.is_string(); }
+    std::string_view string() const {
+        return is_json ? std::string_view(value.get_ref<const std::string&>()) : str;
+    }
+};
+
+// Slots for the document being read; stamping instead of resetting keeps
+// the per-document cost independent of how many pointers the plans have
+struct Values {
+    std::vector<Slot> slots;
+    uint32_t stamp = 0;
+
+    void begin(size_t count) {
+        if (slots.size() < count) slots.resize(count);
+        if (++stamp == 0) {
+            for (auto& slot : slots) slot.stamp = 0;
+            stamp = 1;
+        }
+    }
+
+    Slot* get(uint32_t i) { return slots[i].stamp == stamp ? &slots[i] : nullptr; }
+    void clear(uint32_t i) { slots[i].stamp = 0; }
+
+    void set_string(uint32_t i, std::string_view text) {
+        slots[i].stamp = stamp;
+        slots[i].is_json = false;
+        slots[i].str = text;
+    }
+
+    void set(uint32_t i, json value) {
+        slots[i].stamp = stamp;
+        slots[i].is_json = true;
+        slots[i].value = std::move(value);
+    }
+
+    void read(uint32_t i, simdjson::ondemand::value val) {
+        if (val.type().value() == json_type::string) {
+            set_string(i, val.get_string().value());
+        } else {
+            set(i, to_json(val));
+        }
+    }
+};
+
+constexpr uint32_t kNone = UINT32_MAX;
+
+} // namespace
+
+struct SimdEventNormalizer::Layout {
+    struct Node {
+        std::string key;
+        size_t index = std::string::npos;   // key as an array index
+        std::vector<uint32_t> children;
+        uint32_t slot = kNone;
+        std::vector<uint32_t> subtree;      // Slots at or below; cleared when the key repeats
+    };
+
+    struct Step {
+        uint32_t slot;
+        FieldPlan::Target target;
+        std::string feature;
+        storage::FeatureSlot feature_slot;
+        bool last = true;                   // No later step reads the slot, so it may be moved from
+    };
+    using Plan = std::vector<Step>;
+
+    std::vector<Node> nodes{Node{}};        // nodes[0] is the document root
+    size_t slots = 0;
+    Plan default_plan;
+    std::unordered_map<storage::Symbol, Plan> plans;
+
+    Plan add(const FieldPlan& plan) {
+        Plan steps;
+        for (const auto& step : plan.steps()) {
+            uint32_t node = 0;
+            for (const auto& token : step.path) {
+                uint32_t child = find_key(node, token);
+                if (child == kNone) {
+                    child = static_cast<uint32_t>(nodes.size());
+                    Node added;
+                    added.key = token;
+                    added.index = FieldPlan::array_index(token);
+                    nodes.push_back(std::move(added));
+                    nodes[node].children.push_back(child);
+                }
+                node = child;
+            }
+            if (nodes[node].slot == kNone) nodes[node].slot = static_cast<uint32_t>(slots++);
+            for (auto& earlier : steps) {
+                if (earlier.slot == nodes[node].slot) earlier.last = false;
+            }
+            steps.push_back(Step{nodes[node].slot, step.target, step.feature, step.slot});
+        }
+        return steps;
+    }
+
+    void index_subtrees(uint32_t node) {
+        auto& subtree = nodes[node].subtree;
+        subtree.clear();
+        if (nodes[node].slot != kNone) subtree.push_back(nodes[node].slot);
+        for (uint32_t child : nodes[node].children) {
+            index_subtrees(child);
+            subtree.insert(subtree.end(), nodes[child].subtree.begin(), nodes[child].subtree.end());
+        }
+    }
+
+    uint32_t find_key(uint32_t node, std::string_view key) const {
+        for (uint32_t child : nodes[node].children) {
+            if (nodes[child].key == key) return child;
+        }
+        return kNone;
+    }
+
+    uint32_t find_index(uint32_t node, size_t index) const {
+        for (uint32_t child : nodes[node].children) {
+            if (nodes[child].index == index) return child;
+        }
+        return kNone;
+    }
+
+    void clear(uint32_t node, Values& values) const {
+        for (uint32_t slot : nodes[node].subtree) values.clear(slot);
+    }
+
+    // Fill the slots under node from a value, descending only into keys
+    // some plan points at; everything else is skipped unparsed
+    void collect(simdjson::ondemand::value val, uint32_t node, Values& values) const {
+        const Node& n = nodes[node];
+        if (n.slot != kNone && !n.children.empty()) {
+            // Both a field and a parent of fields: materialize once
+            json value = to_json(val);
+            collect_json(value, node, values);
+            values.set(n.slot, std::move(value));
+            return;
+        }
+        if (n.slot != kNone) {
+            values.read(n.slot, val);
+            return;
+        }
+
+        switch (val.type().value()) {
+            case json_type::object:
+                for (auto field : val.get_object()) {
+                    uint32_t child = find_key(node, field.unescaped_key().value());
+                    if (child == kNone) continue;
+                    clear(child, values);
+                    collect(field.value(), child, values);
+                }
+                break;
+            case json_type::array: {
+                size_t i = 0;
+                for (auto element : val.get_array()) {
+                    uint32_t child = find_index(node, i++);
+                    if (child == kNone) continue;
+                    clear(child, values);
+                    collect(element.value(), child, values);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void collect_json(const json& value, uint32_t node, Values& values) const {
+        for (uint32_t child : nodes[node].children) {
+            const json* found = nullptr;
+            if (value.is_object()) {
+                auto it = value.find(nodes[child].key);
+                if (it != value.end()) found = &*it;
+            } else if (value.is_array() && nodes[child].index < value.size()) {
+                found = &value[nodes[child].index];
+            }
+            if (found == nullptr) continue;
+            if (nodes[child].slot != kNone) values.set(nodes[child].slot, *found);
+            collect_json(*found, child, values);
+        }
+    }
+
+    storage::Event fill(simdjson::ondemand::object obj) const {
+        static const storage::Symbol unknown("unknown");
+        static thread_local Values values;
+        values.begin(slots);
+
+        storage::Event event;
+        event.source = unknown;
+        event.host = unknown;
+
+        // Single pass over top-level fields; unknown fields are skipped unparsed
+        for (auto field : obj) {
+            std::string_view key = field.unescaped_key();
+            simdjson::ondemand::value val = field.value();
+            uint32_t child = find_key(0, key);
+
+            if (key == "source") {
+                // Picks the plan; a string has no children, so only a
+                // "/source" pointer itself can also want it
+                event.source = unknown;
+                if (val.type().value() == json_type::string) {
+                    std::string_view text = val.get_string().value();
+                    event.source = storage::Symbol(text);
+                    if (child != kNone) {
+                        clear(child, values);
+                        if (nodes[child].slot != kNone) values.set_string(nodes[child].slot, text);
+                    }
+                    continue;
+                }
+            }
+            if (child == kNone) continue;
+            clear(child, values);
+            collect(val, child, values);
+        }
+
+        // Same step order as FieldPlan::execute, so the highest-priority
+        // present pointer wins
+        auto plan = plans.find(event.source);
+        const Plan& steps = plan != plans.end() ? plan->second : default_plan;
+        std::optional<storage::timestamp_t> ts;
+        for (const auto& step : steps) {
+            Slot* value = values.get(step.slot);
+            if (value == nullptr) continue;
+
+            switch (step.target) {
+                case FieldPlan::Target::Timestamp: {
+                    auto parsed = value->is_json ? TimestampParser::from_json(value->value)
+                                                 : TimestampParser::parse(value->str);
+                    if (parsed) ts = parsed;
+                    break;
+                }
+                case FieldPlan::Target::Host:
+                    if (value->is_string()) event.host = storage::Symbol(value->string());
+                    break;
+                case FieldPlan::Target::Feature:
+                    if (value->is_json && step.last) event.features.set(step.feature_slot, step.feature, std::move(value->value));
+                    else if (value->is_json) event.features.set(step.feature_slot, step.feature, value->value);
+                    else event.features.set_string(step.feature_slot, step.feature, value->str);
+                    break;
+            }
+        }
+        event.ts = ts.value_or(std::chrono::system_clock::now());
+        return event;
+    }
+};
+
+SimdEventNormalizer::SimdEventNormalizer() : SimdEventNormalizer(EventNormalizer::Config{}) {}
+
+SimdEventNormalizer::SimdEventNormalizer(EventNormalizer::Config config) : base_(config) {
+    auto layout = std::make_shared<Layout>();
+    layout->default_plan = layout->add(FieldPlan::default_plan());
+    for (const auto& [source, spec] : config.profiles) {
+        layout->plans.emplace(storage::Symbol(source), layout->add(FieldPlan::compile(spec)));
+    }
+    layout->index_subtrees(0);
+    layout_ = std::move(layout);
+}
+
+storage::Event SimdEventNormalizer::parse(std::string_view raw_event) const {
+    auto doc = get_parser().iterate(pad(raw_event));
+    auto event = layout_->fill(doc.get_object());
+    if (!doc.at_end()) {
+        throw std::runtime_error("Trailing content after event");
+    }
+    return event;
+}
+
+storage::Event SimdEventNormalizer::normalize(std::string_view raw_event) const {
+    auto event = parse(raw_event);
+    base_.finalize(event);
+    return event;
+}
+
+size_t SimdEventNormalizer::normalize_array(std::string_view body, const EventSink& sink) const {
+    auto doc = get_parser().iterate(pad(body));
+    size_t emitted = 0;
+
+    for (auto element : doc.get_array()) {
+        simdjson::ondemand::value val = element.value();
+        if (val.type().value() != json_type::object) continue;
+
+        storage::Event event;
+        try {
+            event = layout_->fill(val.get_object());
+            base_.finalize(event);
+        } catch (const simdjson::simdjson_error&) {
+            throw; // Iterator state is unusable past a parse error
+        } catch (const std::exception& e) {
+            spdlog::warn(R"({{"msg":"normalization_failed","error":"{}"}})", e.what());
+            continue;
+        }
+
+        sink(std::move(event));
+        emitted++;
+    }
+
+    if (!doc.at_end()) {
+        throw std::runtime_error("Trailing content after event array");
+    }
+
+    return emitted;
+}
+
+size_t SimdEventNormalizer::parse_document(std::string_view body, const EventSink& sink,
+                                           const SkipHandler& on_skipped) const {
+    auto doc = get_parser().iterate(pad(body));
+    size_t emitted = 0;
+    size_t skipped = 0;
+
+    if (doc.type().value() == json_type::object) {
+        sink(layout_->fill(doc.get_object()));
+        emitted++;
+    } else {
+        for (auto element : doc.get_array()) {
+            simdjson::ondemand::value val = element.value();
+            if (val.type().value() != json_type::object) {
+                if (skipped++ == 0) {
+                    spdlog::warn(R"({{"msg":"json_element_skipped","reason":"not_object"}})");
+                }
+                if (on_skipped) {
+                    std::string_view raw = val.raw_json().value();
+                    raw.remove_suffix(raw.size() - (raw.find_last_not_of(" \t\r\n") + 1));
+                    on_skipped(raw, "not_object");
+                }
+                continue;
+            }
+            sink(layout_->fill(val.get_object()));
+            emitted++;
+        }
+    }
+
+    if (!doc.at_end()) {
+        throw std::runtime_error("Trailing content after events");
+    }
+    return emitted;
+}
+
+} // namespace siem::core
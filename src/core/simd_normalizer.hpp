@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/event_normalizer.hpp"
+#include <functional>
+#include <memory>
+#include <string_view>
+
+namespace siem::core {
+
+/**
+ * simdjson on-demand fast path for event normalization
+ * - Reads raw event bytes and fills storage::Event in a single pass over
+ *   the fields, without building a json DOM for the input
+ * - Runs the same per-source FieldPlan profiles and redaction as an
+ *   EventNormalizer built from the same Config, so both produce the same events
+ * - Parsers are thread_local, so one instance can be shared across threads
+ */
+class SimdEventNormalizer {
+public:
+    using EventSink = std::function<void(storage::Event&&)>;
+    // A skipped array element's bytes and why ("not_object")
+    using SkipHandler = std::function<void(std::string_view element, const char* reason)>;
+
+    SimdEventNormalizer();
+
+    /**
+     * Throws std::invalid_argument on a malformed profile pointer
+     */
+    explicit SimdEventNormalizer(EventNormalizer::Config config);
+
+    /**
+     * Normalize a single JSON object
+     */
+    storage::Event normalize(std::string_view raw_event) const;
+
+    /**
+     * Normalize every object element of a JSON array
+     * Elements that fail normalization are skipped; malformed JSON throws.
+     * Returns number of events emitted
+     */
+    size_t normalize_array(std::string_view body, const EventSink& sink) const;
+
+    /**
+     * Extract ts, source, host and features only, like CefParser; trace id,
+     * redaction and fingerprint are left to EventNormalizer::finalize.
+     * Throws on malformed JSON or a non-object
+     */
+    storage::Event parse(std::string_view raw_event) const;
+
+    /**
+     * parse() a single object, or every object element of an array; other
+     * elements go to on_skipped, where the DOM path would fail to normalize
+     * them. Malformed JSON throws. Returns events emitted
+     */
+    size_t parse_document(std::string_view body, const EventSink& sink,
+                          const SkipHandler& on_skipped = {}) const;
+
+private:
+    struct Layout;   // Every plan's pointers merged into one key trie
+
+    EventNormalizer base_;   // Shared fingerprinting and redaction
+    std::shared_ptr<const Layout> layout_;
+};
+
+} // namespace siem::core
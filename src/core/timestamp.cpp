@@ -0,0 +1,186 @@
+#include "core/timestamp.hpp"
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+namespace siem::core {
+
+namespace {
+
+constexpr int64_t kMillisThreshold = 100'000'000'000LL; // ~year 5138 in seconds
+
+// Largest epoch millisecond value representable by timestamp_t
+constexpr int64_t kMaxMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+    storage::timestamp_t::duration::max()).count() - 1;
+
+std::optional<storage::timestamp_t> from_millis(int64_t ms) {
+    if (ms > kMaxMillis || ms < -kMaxMillis) return std::nullopt;
+    return storage::timestamp_t(std::chrono::duration_cast<storage::timestamp_t::duration>(
+        std::chrono::milliseconds(ms)));
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool read_digits(std::string_view s, size_t& pos, int count, int& out) {
+    if (pos + count > s.size()) return false;
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        char c = s[pos + i];
+        if (!is_digit(c)) return false;
+        value = value * 10 + (c - '0');
+    }
+    out = value;
+    pos += count;
+    return true;
+}
+
+bool expect(std::string_view s, size_t& pos, char c) {
+    if (pos >= s.size() || s[pos] != c) return false;
+    pos++;
+    return true;
+}
+
+} // namespace
+
+std::optional<storage::timestamp_t> TimestampParser::parse(std::string_view text) {
+    if (text.size() >= 19 && text[4] == '-') {
+        return parse_rfc3339(text);
+    }
+    return parse_numeric(text);
+}
+
+std::optional<storage::timestamp_t> TimestampParser::from_json(const json& value) {
+    switch (value.type()) {
+        case json::value_t::string:
+            return parse(std::string_view(value.get_ref<const std::string&>()));
+        case json::value_t::number_unsigned:
+            return from_epoch(value.get<uint64_t>());
+        case json::value_t::number_integer:
+            return from_epoch(value.get<int64_t>());
+        case json::value_t::number_float:
+            return from_epoch(value.get<double>());
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<storage::timestamp_t> TimestampParser::from_epoch(int64_t value) {
+    if (value >= kMillisThreshold || value <= -kMillisThreshold) {
+        return from_millis(value);
+    }
+    return from_millis(value * 1000);
+}
+
+std::optional<storage::timestamp_t> TimestampParser::from_epoch(uint64_t value) {
+    if (value > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) return std::nullopt;
+    return from_epoch(static_cast<int64_t>(value));
+}
+
+std::optional<storage::timestamp_t> TimestampParser::from_epoch(double value) {
+    if (!std::isfinite(value)) return std::nullopt;
+
+    double ms = std::fabs(value) >= static_cast<double>(kMillisThreshold) ? value : value * 1000.0;
+    ms = std::floor(ms);
+    if (ms > static_cast<double>(kMaxMillis) || ms < -static_cast<double>(kMaxMillis)) {
+        return std::nullopt;
+    }
+    return from_millis(static_cast<int64_t>(ms));
+}
+
+std::optional<storage::timestamp_t> TimestampParser::parse_rfc3339(std::string_view s) {
+    size_t pos = 0;
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+
+    if (!read_digits(s, pos, 4, year) || !expect(s, pos, '-') ||
+        !read_digits(s, pos, 2, month) || !expect(s, pos, '-') ||
+        !read_digits(s, pos, 2, day)) {
+        return std::nullopt;
+    }
+
+    if (pos >= s.size() || (s[pos] != 'T' && s[pos] != 't' && s[pos] != ' ')) {
+        return std::nullopt;
+    }
+    pos++;
+
+    if (!read_digits(s, pos, 2, hour) || !expect(s, pos, ':') ||
+        !read_digits(s, pos, 2, minute) || !expect(s, pos, ':') ||
+        !read_digits(s, pos, 2, second)) {
+        return std::nullopt;
+    }
+
+    // Fractional seconds: keep milliseconds, truncate the rest
+    int millis = 0;
+    if (pos < s.size() && (s[pos] == '.' || s[pos] == ',')) {
+        pos++;
+        int digits = 0;
+        while (pos < s.size() && is_digit(s[pos])) {
+            if (digits < 3) millis = millis * 10 + (s[pos] - '0');
+            digits++;
+            pos++;
+        }
+        if (digits == 0) return std::nullopt;
+        for (; digits < 3; ++digits) millis *= 10;
+    }
+
+    // Offset: Z, +HH:MM, -HHMM; none means UTC
+    int offset_minutes = 0;
+    if (pos < s.size()) {
+        char c = s[pos++];
+        if (c == '+' || c == '-') {
+            int off_h = 0, off_m = 0;
+            if (!read_digits(s, pos, 2, off_h)) return std::nullopt;
+            if (pos < s.size() && s[pos] == ':') pos++;
+            if (!read_digits(s, pos, 2, off_m)) return std::nullopt;
+            if (off_h > 23 || off_m > 59) return std::nullopt;
+            offset_minutes = (off_h * 60 + off_m) * (c == '-' ? -1 : 1);
+        } else if (c != 'Z' && c != 'z') {
+            return std::nullopt;
+        }
+    }
+    if (pos != s.size()) return std::nullopt;
+
+    if (hour > 23 || minute > 59 || second > 60) return std::nullopt;
+
+    std::chrono::year_month_day ymd{
+        std::chrono::year{year},
+        std::chrono::month{static_cast<unsigned>(month)},
+        std::chrono::day{static_cast<unsigned>(day)}};
+    if (!ymd.ok()) return std::nullopt;
+
+    int64_t days = std::chrono::sys_days(ymd).time_since_epoch().count();
+    int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second - offset_minutes * 60;
+
+    return from_millis(seconds * 1000 + millis);
+}
+
+std::optional<storage::timestamp_t> TimestampParser::parse_numeric(std::string_view s) {
+    if (s.empty()) return std::nullopt;
+    const char* first = s.data();
+    const char* last = s.data() + s.size();
+
+    int64_t integer = 0;
+    auto [int_end, int_ec] = std::from_chars(first, last, integer);
+    if (int_ec == std::errc() && int_end == last) {
+        return from_epoch(integer);
+    }
+
+    // Epoch text is digits, sign, point and exponent only. Anything else
+    // ("nan", "inf", prose) stops here: libstdc++'s floating-point
+    // from_chars reads such input as a C string, past the end of the view
+    for (char c : s) {
+        bool numeric = (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+        if (!numeric) return std::nullopt;
+    }
+
+    double real = 0.0;
+    auto [real_end, real_ec] = std::from_chars(first, last, real);
+    if (real_ec == std::errc() && real_end == last) {
+        return from_epoch(real);
+    }
+
+    return std::nullopt;
+}
+
+} // namespace siem::core
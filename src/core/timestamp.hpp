@@ -0,0 +1,34 @@
+#pragma once
+
+#include "storage/schemas.hpp"
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace siem::core {
+
+using json = nlohmann::json;
+
+/**
+ * Allocation-free event timestamp parsing
+ * - RFC 3339 / ISO-8601: 2025-11-07T23:00:01.123Z, +02:00 / -0500 offsets;
+ *   timestamps without an offset are taken as UTC
+ * - Epoch seconds or milliseconds (integer, float or numeric string);
+ *   magnitudes >= 1e11 are treated as milliseconds
+ * Results keep millisecond precision
+ */
+class TimestampParser {
+public:
+    static std::optional<storage::timestamp_t> parse(std::string_view text);
+    static std::optional<storage::timestamp_t> from_json(const json& value);
+
+    static std::optional<storage::timestamp_t> from_epoch(int64_t value);
+    static std::optional<storage::timestamp_t> from_epoch(uint64_t value);
+    static std::optional<storage::timestamp_t> from_epoch(double value);
+
+private:
+    static std::optional<storage::timestamp_t> parse_rfc3339(std::string_view text);
+    static std::optional<storage::timestamp_t> parse_numeric(std::string_view text);
+};
+
+} // namespace siem::core
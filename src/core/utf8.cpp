@@ -0,0 +1,103 @@
+#include "core/utf8.hpp"
+
+namespace siem::core {
+
+namespace {
+
+constexpr std::string_view kReplacement = "\xEF\xBF\xBD";
+
+/**
+ * Length of the valid sequence starting at text[i], or 0
+ */
+size_t sequence_length(std::string_view text, size_t i) {
+    auto byte = [&](size_t at) { return static_cast<unsigned char>(text[at]); };
+    unsigned char lead = byte(i);
+    if (lead < 0x80) return 1;
+
+    size_t length;
+    unsigned char min = 0x80, max = 0xBF;   // Range of the second byte
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) min = 0xA0;       // Overlong
+        if (lead == 0xED) max = 0x9F;       // Surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) min = 0x90;       // Overlong
+        if (lead == 0xF4) max = 0x8F;       // Past U+10FFFF
+    } else {
+        return 0;
+    }
+
+    if (text.size() - i < length) return 0;
+    if (byte(i + 1) < min || byte(i + 1) > max) return 0;
+    for (size_t k = 2; k < length; ++k) {
+        if ((byte(i + k) & 0xC0) != 0x80) return 0;
+    }
+    return length;
+}
+
+} // namespace
+
+size_t Utf8::valid_prefix(std::string_view text) {
+    size_t i = 0;
+    while (i < text.size()) {
+        // ASCII runs are the common case
+        if (static_cast<unsigned char>(text[i]) < 0x80) {
+            i++;
+            continue;
+        }
+        size_t length = sequence_length(text, i);
+        if (length == 0) return i;
+        i += length;
+    }
+    return i;
+}
+
+void Utf8::append(std::string& out, std::string_view text) {
+    while (!text.empty()) {
+        size_t valid = valid_prefix(text);
+        out.append(text.data(), valid);
+        if (valid == text.size()) return;
+
+        // One replacement per invalid byte, then resync on the next one
+        out.append(kReplacement);
+        text.remove_prefix(valid + 1);
+    }
+}
+
+std::string Utf8::repair(std::string_view text) {
+    size_t valid = valid_prefix(text);
+    if (valid == text.size()) return std::string(text);
+
+    std::string out;
+    out.reserve(text.size() + 8);
+    out.append(text.data(), valid);
+    append(out, text.substr(valid));
+    return out;
+}
+
+void Utf8::repair(json& value) {
+    if (value.is_string()) {
+        auto& text = value.get_ref<std::string&>();
+        if (!valid(text)) text = repair(std::string_view(text));
+    } else if (value.is_array()) {
+        for (auto& element : value) repair(element);
+    } else if (value.is_object()) {
+        bool keys_valid = true;
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            keys_valid = keys_valid && valid(it.key());
+            repair(it.value());
+        }
+        if (!keys_valid) {
+            json repaired = json::object();
+            for (auto it = value.begin(); it != value.end(); ++it) {
+                repaired[repair(std::string_view(it.key()))] = std::move(it.value());
+            }
+            value = std::move(repaired);
+        }
+    }
+}
+
+} // namespace siem::core
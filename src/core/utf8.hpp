@@ -0,0 +1,45 @@
+#pragma once
+
+#include "storage/schemas.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace siem::core {
+
+using json = nlohmann::json;
+
+/**
+ * UTF-8 checks for text that never went through a JSON parser (syslog,
+ * CEF / LEEF, grok captures, MessagePack / CBOR, shared-memory records)
+ * Storage dumps events as JSON, which rejects invalid UTF-8, so such text
+ * is repaired where it enters: each byte that does not start a valid
+ * sequence becomes U+FFFD. Valid text is checked but never copied.
+ */
+class Utf8 {
+public:
+    /**
+     * Length of the valid prefix; text.size() when all of it is valid.
+     * Overlong forms, surrogates and code points past U+10FFFF are invalid
+     */
+    static size_t valid_prefix(std::string_view text);
+
+    static bool valid(std::string_view text) { return valid_prefix(text) == text.size(); }
+
+    /**
+     * Append text to out with invalid sequences replaced
+     */
+    static void append(std::string& out, std::string_view text);
+
+    /**
+     * text itself when valid, otherwise a repaired copy
+     */
+    static std::string repair(std::string_view text);
+
+    /**
+     * Repair every string (and object key) in a json value in place
+     */
+    static void repair(json& value);
+};
+
+} // namespace siem::core
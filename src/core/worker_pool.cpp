@@ -0,0 +1,104 @@
+#include "core/worker_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace siem::core {
+
+WorkerPool::WorkerPool(size_t threads) {
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool;
+    return pool;
+}
+
+size_t WorkerPool::default_threads() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 1 ? hw - 1 : 0;
+}
+
+void WorkerPool::parallel_for(
+    size_t count, size_t chunk, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    chunk = std::max<size_t>(chunk, 1);
+    size_t chunks = (count + chunk - 1) / chunk;
+
+    if (threads_.empty() || chunks == 1) {
+        fn(0, count);
+        return;
+    }
+
+    struct Job {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::exception_ptr error;
+    };
+    auto job = std::make_shared<Job>();
+
+    // Helpers that start after every chunk is claimed exit without touching fn
+    auto run = [job, &fn, count, chunk, chunks]() {
+        for (size_t i; (i = job->next.fetch_add(1)) < chunks; ) {
+            try {
+                fn(i * chunk, std::min(count, (i + 1) * chunk));
+            } catch (...) {
+                std::lock_guard lock(job->mutex);
+                if (!job->error) job->error = std::current_exception();
+            }
+            if (job->done.fetch_add(1) + 1 == chunks) {
+                std::lock_guard lock(job->mutex);
+                job->cv.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(threads_.size(), chunks - 1);
+    {
+        std::lock_guard lock(mutex_);
+        for (size_t i = 0; i < helpers; ++i) {
+            tasks_.emplace_back(run);
+        }
+    }
+    if (helpers == 1) cv_.notify_one();
+    else cv_.notify_all();
+
+    run();
+
+    std::unique_lock lock(job->mutex);
+    job->cv.wait(lock, [&job, chunks]() { return job->done.load() == chunks; });
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+void WorkerPool::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace siem::core
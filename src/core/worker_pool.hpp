@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace siem::core {
+
+/**
+ * Fixed-size worker pool for data-parallel loops
+ * The calling thread works alongside the pool, so nested parallel_for calls
+ * cannot deadlock and a pool with zero workers runs everything inline.
+ */
+class WorkerPool {
+public:
+    explicit WorkerPool(size_t threads = default_threads());
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Process-wide pool, started on first use
+     */
+    static WorkerPool& shared();
+
+    /**
+     * Hardware threads minus one for the caller
+     */
+    static size_t default_threads();
+
+    size_t size() const { return threads_.size(); }
+
+    /**
+     * Run fn(begin, end) over [0, count) in chunks of `chunk` items
+     * Blocks until every chunk has run; rethrows the first exception
+     */
+    void parallel_for(size_t count, size_t chunk, const std::function<void(size_t, size_t)>& fn);
+
+private:
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+
+    void worker_loop();
+};
+
+} // namespace siem::core
@@ -0,0 +1,368 @@
+#include "ingest/binary_ingest_server.hpp"
+#include <spdlog/spdlog.h>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+#include <openssl/rand.h>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace siem::ingest {
+
+/**
+ * One authenticated agent session; frames are parsed straight out of the
+ * receive buffer and acks are coalesced into one write per read. While a
+ * frame is on the delivery pool the session neither parses nor reads.
+ */
+class BinaryIngestServer::Session : public std::enable_shared_from_this<Session> {
+public:
+    Session(BinaryIngestServer& server, net::generic::stream_protocol::socket socket)
+        : server_(server), socket_(std::move(socket)), auth_timer_(socket_.get_executor()) {
+        server_.connections_++;
+    }
+
+    ~Session() { server_.connections_--; }
+
+    void start() {
+        nonce_.resize(IngestProtocol::kNonceBytes);
+        if (RAND_bytes(reinterpret_cast<unsigned char*>(nonce_.data()), static_cast<int>(nonce_.size())) != 1) {
+            spdlog::error(R"({{"msg":"agent_ingest_nonce_failed"}})");
+            return;
+        }
+
+        std::string challenge;
+        challenge += static_cast<char>(IngestProtocol::kVersion);
+        challenge += nonce_;
+        IngestProtocol::append_frame(outbox_, IngestProtocol::FrameType::Challenge, challenge);
+        write();
+
+        auth_timer_.expires_after(std::chrono::milliseconds(server_.config_.auth_timeout_ms));
+        auth_timer_.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+            if (ec || self->authenticated_ || self->closing_) return;
+            self->server_.auth_failures_++;
+            self->fail("auth_timeout");
+        });
+
+        buffer_.resize(4096);
+        read();
+    }
+
+private:
+    BinaryIngestServer& server_;
+    net::generic::stream_protocol::socket socket_;
+    net::steady_timer auth_timer_;
+    std::string nonce_;
+    bool authenticated_ = false;
+    bool closing_ = false;
+    bool delivering_ = false;
+    IngestProtocol::Encoding encoding_ = IngestProtocol::Encoding::MessagePack;
+    uint32_t credit_ = 0;
+    uint64_t sequence_ = 0;
+
+    std::vector<char> buffer_;
+    size_t begin_ = 0;   // Start of the first unparsed frame
+    size_t end_ = 0;     // End of received data
+
+    std::string outbox_;     // Queued frames
+    std::string inflight_;   // Being written
+    bool writing_ = false;
+
+    void read() {
+        // Make room: compact, then grow up to the largest frame we accept
+        if (buffer_.size() - end_ < 4096 && begin_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        size_t limit = server_.config_.max_frame_bytes + IngestProtocol::kHeaderBytes;
+        if (buffer_.size() - end_ < 4096 && buffer_.size() < limit) {
+            buffer_.resize(std::min(buffer_.size() * 2, limit));
+        }
+
+        socket_.async_read_some(
+            net::buffer(buffer_.data() + end_, buffer_.size() - end_),
+            [self = shared_from_this()](boost::system::error_code ec, size_t n) {
+                if (ec) {
+                    self->auth_timer_.cancel();
+                    return;
+                }
+                self->end_ += n;
+                bool more = self->process();
+                self->write();
+                if (more) self->read();
+            });
+    }
+
+    /**
+     * Handle every complete frame; false stops reading
+     */
+    bool process() {
+        while (begin_ < end_) {
+            std::string_view data(buffer_.data() + begin_, end_ - begin_);
+            std::optional<IngestProtocol::Frame> frame;
+            try {
+                frame = IngestProtocol::next_frame(data, server_.config_.max_frame_bytes + 1);
+            } catch (const std::length_error& e) {
+                server_.protocol_errors_++;
+                return fail(e.what());
+            }
+            if (!frame) break;
+
+            if (!handle(*frame)) return false;
+            begin_ += frame->size;
+            if (delivering_) return false;
+        }
+
+        if (begin_ == end_) begin_ = end_ = 0;
+        return true;
+    }
+
+    bool handle(const IngestProtocol::Frame& frame) {
+        using FrameType = IngestProtocol::FrameType;
+
+        if (!authenticated_) {
+            if (frame.type != FrameType::Auth || frame.payload.size() < 2) {
+                server_.protocol_errors_++;
+                return fail("expected_auth");
+            }
+            return authenticate(frame.payload);
+        }
+
+        if (frame.type != FrameType::Events) {
+            server_.protocol_errors_++;
+            return fail("unexpected_frame");
+        }
+        if (credit_ == 0) {
+            server_.protocol_errors_++;
+            return fail("credit_exceeded");
+        }
+        credit_--;
+
+        json batch;
+        try {
+            batch = IngestProtocol::decode_events(frame.payload, encoding_);
+        } catch (const std::exception& e) {
+            server_.protocol_errors_++;
+            spdlog::warn(R"({{"msg":"agent_ingest_decode_failed","error":"{}"}})", e.what());
+            return fail("malformed_events");
+        }
+
+        std::vector<json> events;
+        auto stats = server_.policy_.ingest_events(std::move(batch), [&events](json&& event) {
+            events.push_back(std::move(event));
+        });
+        if (!server_.callback_ || events.empty()) {
+            // Without a callback nothing keeps the events: reject them all
+            acknowledge(events.size(), 0, stats.rate_limited);
+            return true;
+        }
+
+        // The callback may block on pipeline backpressure; run it off the io
+        // thread and resume this session once it returns
+        delivering_ = true;
+        net::post(*server_.delivery_,
+            [self = shared_from_this(), events = std::move(events), rate_limited = stats.rate_limited]() {
+                std::optional<size_t> stored;
+                try {
+                    stored = std::min(self->server_.callback_(events), events.size());
+                } catch (const std::exception& e) {
+                    spdlog::error(R"({{"msg":"agent_ingest_delivery_failed","events":{},"error":"{}"}})",
+                                 events.size(), e.what());
+                }
+                net::post(self->socket_.get_executor(),
+                    [self, delivered = events.size(), stored, rate_limited]() {
+                        self->delivering_ = false;
+                        // Not a rejection: close without an Ack so the agent
+                        // resends every frame still unacknowledged
+                        if (!stored) {
+                            self->fail("delivery_failed");
+                            return;
+                        }
+                        self->acknowledge(delivered, *stored, rate_limited);
+                        bool more = self->process();
+                        self->write();
+                        if (more) self->read();
+                    });
+            });
+        return true;
+    }
+
+    /**
+     * Queue the Ack for one Events frame and return its credit
+     */
+    void acknowledge(size_t delivered, size_t stored, size_t rate_limited) {
+        IngestProtocol::Ack ack;
+        ack.sequence = ++sequence_;
+        ack.accepted = static_cast<uint32_t>(stored);
+        ack.rejected = static_cast<uint32_t>(rate_limited + delivered - stored);
+        ack.credit = 1;
+        credit_++;
+        IngestProtocol::append_frame(outbox_, IngestProtocol::FrameType::Ack, IngestProtocol::encode_ack(ack));
+
+        server_.frames_++;
+        server_.events_ += ack.accepted;
+        server_.rejected_ += ack.rejected;
+    }
+
+    bool authenticate(std::string_view payload) {
+        auto version = static_cast<uint8_t>(payload[0]);
+        auto encoding = static_cast<IngestProtocol::Encoding>(payload[1]);
+        if (version != IngestProtocol::kVersion) {
+            server_.protocol_errors_++;
+            return fail("unsupported_version");
+        }
+        if (encoding != IngestProtocol::Encoding::MessagePack && encoding != IngestProtocol::Encoding::Cbor) {
+            server_.protocol_errors_++;
+            return fail("unsupported_encoding");
+        }
+        if (!server_.policy_.verify_signature(IngestProtocol::auth_message(nonce_), std::string(payload.substr(2)))) {
+            server_.auth_failures_++;
+            spdlog::warn(R"({{"msg":"agent_ingest_auth_failed"}})");
+            return fail("authentication_failed");
+        }
+
+        authenticated_ = true;
+        encoding_ = encoding;
+        credit_ = server_.config_.credit;
+        auth_timer_.cancel();
+
+        IngestProtocol::Ready ready{credit_, static_cast<uint32_t>(server_.config_.max_frame_bytes)};
+        IngestProtocol::append_frame(outbox_, IngestProtocol::FrameType::Ready, IngestProtocol::encode_ready(ready));
+        return true;
+    }
+
+    /**
+     * Queue an Error frame; the socket closes once it is written
+     */
+    bool fail(const char* reason) {
+        spdlog::warn(R"({{"msg":"agent_ingest_session_closed","reason":"{}"}})", reason);
+        IngestProtocol::append_frame(outbox_, IngestProtocol::FrameType::Error, reason);
+        closing_ = true;
+        auth_timer_.cancel();
+        write();
+        return false;
+    }
+
+    void write() {
+        if (writing_ || outbox_.empty()) return;
+        writing_ = true;
+        inflight_.swap(outbox_);
+        net::async_write(socket_, net::buffer(inflight_),
+            [self = shared_from_this()](boost::system::error_code ec, size_t) {
+                self->writing_ = false;
+                self->inflight_.clear();
+                if (ec) return self->close();
+                if (!self->outbox_.empty()) return self->write();
+                if (self->closing_) self->close();
+            });
+    }
+
+    void close() {
+        boost::system::error_code ec;
+        socket_.shutdown(net::socket_base::shutdown_both, ec);
+        socket_.close(ec);
+        auth_timer_.cancel();
+    }
+};
+
+BinaryIngestServer::BinaryIngestServer(Config config, HTTPIngestor& policy)
+    : config_(std::move(config)), policy_(policy) {
+    config_.credit = std::max<uint32_t>(config_.credit, 1);
+    config_.auth_timeout_ms = std::max(config_.auth_timeout_ms, 1);
+}
+
+BinaryIngestServer::~BinaryIngestServer() {
+    stop();
+}
+
+void BinaryIngestServer::start(EventCallback callback) {
+    if (thread_) {
+        spdlog::warn(R"({{"msg":"agent_ingest_already_running"}})");
+        return;
+    }
+    callback_ = std::move(callback);
+    delivery_ = std::make_unique<net::thread_pool>(std::max<size_t>(config_.delivery_threads, 1));
+
+    if (config_.tcp_enabled) {
+        auto address = net::ip::make_address(config_.bind_address);
+        tcp_acceptor_ = std::make_unique<net::ip::tcp::acceptor>(ioc_, net::ip::tcp::endpoint(address, config_.port));
+        bound_port_ = tcp_acceptor_->local_endpoint().port();
+        do_accept(*tcp_acceptor_);
+    }
+
+    if (!config_.unix_path.empty()) {
+        // A socket left behind by an earlier run would make bind fail
+        if (!remove_socket_file()) {
+            throw std::runtime_error("agent_ingest unix_path exists and is not a socket: " + config_.unix_path);
+        }
+        unix_acceptor_ = std::make_unique<net::local::stream_protocol::acceptor>(
+            ioc_, net::local::stream_protocol::endpoint(config_.unix_path));
+        do_accept(*unix_acceptor_);
+    }
+
+    thread_ = std::make_unique<std::thread>([this]() { ioc_.run(); });
+
+    spdlog::info(R"({{"msg":"agent_ingest_started","port":{},"unix_path":"{}"}})",
+                bound_port_, config_.unix_path);
+}
+
+void BinaryIngestServer::stop() {
+    if (!thread_) return;
+
+    net::post(ioc_, [this]() { ioc_.stop(); });
+    if (thread_->joinable()) thread_->join();
+    thread_.reset();
+
+    // Callbacks already running finish; their acks are dropped with the sessions
+    delivery_->join();
+    delivery_.reset();
+
+    boost::system::error_code ec;
+    if (tcp_acceptor_) tcp_acceptor_->close(ec);
+    if (unix_acceptor_) {
+        unix_acceptor_->close(ec);
+        remove_socket_file();
+    }
+
+    spdlog::info(R"({{"msg":"agent_ingest_stopped"}})");
+}
+
+BinaryIngestServer::Stats BinaryIngestServer::stats() const {
+    return Stats{connections_.load(), auth_failures_.load(), frames_.load(),
+                 events_.load(), rejected_.load(), protocol_errors_.load()};
+}
+
+bool BinaryIngestServer::remove_socket_file() const {
+    // symlink_status is lstat: a link is never followed, only refused
+    std::error_code ec;
+    auto status = std::filesystem::symlink_status(config_.unix_path, ec);
+    if (!std::filesystem::exists(status)) return true;
+    if (!std::filesystem::is_socket(status)) return false;
+    std::filesystem::remove(config_.unix_path, ec);
+    return true;
+}
+
+template <typename Acceptor>
+void BinaryIngestServer::do_accept(Acceptor& acceptor) {
+    auto socket = std::make_shared<net::generic::stream_protocol::socket>(ioc_);
+    acceptor.async_accept(*socket, [this, &acceptor, socket](boost::system::error_code ec) {
+        if (ec) return;
+
+        if (connections_.load() >= config_.max_connections) {
+            spdlog::warn(R"({{"msg":"agent_ingest_connection_rejected","max_connections":{}}})",
+                        config_.max_connections);
+            socket->close(ec);
+        } else {
+            if constexpr (std::is_same_v<Acceptor, net::ip::tcp::acceptor>) {
+                socket->set_option(net::ip::tcp::no_delay(true), ec);
+            }
+            std::make_shared<Session>(*this, std::move(*socket))->start();
+        }
+        do_accept(acceptor);
+    });
+}
+
+} // namespace siem::ingest
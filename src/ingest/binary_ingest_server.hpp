@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ingest/http_ingestor.hpp"
+#include "ingest/ingest_protocol.hpp"
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace siem::ingest {
+
+/**
+ * Persistent-session ingest for agents (see IngestProtocol)
+ * Listens on TCP and / or a Unix socket. A session authenticates once with
+ * an HMAC-SHA256 challenge / response under the HTTP ingest secret; every
+ * Events frame after that goes through the same redaction and rate limits
+ * as POST /ingest (HTTPIngestor::ingest_events), then to the callback, and
+ * is answered with an Ack. Sockets run on one io thread; the callback runs
+ * on a small delivery pool, and a session stops reading while its frame is
+ * being delivered, so a slow callback pushes back on that agent only.
+ */
+class BinaryIngestServer {
+public:
+    /**
+     * Receives the events of one frame; returns how many were stored, the
+     * rest are reported to the agent as rejected
+     */
+    using EventCallback = std::function<size_t(const std::vector<json>&)>;
+
+    struct Config {
+        std::string bind_address = "127.0.0.1";
+        bool tcp_enabled = true;
+        unsigned short port = 5515;           // 0 = ephemeral (see port())
+        std::string unix_path;                // Empty = no Unix socket
+        size_t max_frame_bytes = 4 << 20;     // Larger frames close the session
+        uint32_t credit = 16;                 // Unacknowledged frames per session
+        int auth_timeout_ms = 5000;
+        size_t max_connections = 64;
+        size_t delivery_threads = 2;          // Callbacks in flight across sessions
+    };
+
+    struct Stats {
+        uint64_t connections = 0;             // Currently open sessions
+        uint64_t auth_failures = 0;
+        uint64_t frames = 0;                  // Events frames
+        uint64_t events = 0;                  // Accepted events
+        uint64_t rejected = 0;                // Rate-limited or not stored
+        uint64_t protocol_errors = 0;
+    };
+
+    /**
+     * policy supplies the secret, redaction and rate limits; it must
+     * outlive the server
+     */
+    BinaryIngestServer(Config config, HTTPIngestor& policy);
+    ~BinaryIngestServer();
+
+    BinaryIngestServer(const BinaryIngestServer&) = delete;
+    BinaryIngestServer& operator=(const BinaryIngestServer&) = delete;
+
+    /**
+     * Bind the enabled listeners and start the io thread; throws if binding
+     * fails or unix_path exists and is not a socket. Without a callback
+     * every event is acknowledged as rejected
+     */
+    void start(EventCallback callback);
+
+    void stop();
+
+    unsigned short port() const { return bound_port_; }
+
+    Stats stats() const;
+
+private:
+    class Session;
+
+    Config config_;
+    HTTPIngestor& policy_;
+    EventCallback callback_;
+
+    std::atomic<uint64_t> connections_{0};
+    std::atomic<uint64_t> auth_failures_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> events_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> protocol_errors_{0};
+
+    // Declared after everything pending handlers may touch when destroyed
+    net::io_context ioc_;
+    std::unique_ptr<net::ip::tcp::acceptor> tcp_acceptor_;
+    std::unique_ptr<net::local::stream_protocol::acceptor> unix_acceptor_;
+    std::unique_ptr<std::thread> thread_;
+    std::unique_ptr<net::thread_pool> delivery_;
+    unsigned short bound_port_ = 0;
+
+    /**
+     * Unlink unix_path if it is a socket; false if something else is there
+     */
+    bool remove_socket_file() const;
+
+    template <typename Acceptor>
+    void do_accept(Acceptor& acceptor);
+};
+
+} // namespace siem::ingest
@@ -0,0 +1,283 @@
+#include "ingest/cef_parser.hpp"
+#include "core/utf8.hpp"
+#include "core/timestamp.hpp"
+#include <charconv>
+#include <cstdio>
+
+namespace siem::ingest {
+
+namespace {
+
+/**
+ * Start of the "CEF:" / "LEEF:" marker, at the line start or after a space
+ */
+size_t find_marker(std::string_view line, std::string_view marker) {
+    size_t pos = line.find(marker);
+    while (pos != std::string_view::npos && pos > 0 && line[pos - 1] != ' ') {
+        pos = line.find(marker, pos + 1);
+    }
+    return pos;
+}
+
+/**
+ * Split off the next '|'-terminated header field, honouring "\|"
+ */
+bool next_field(std::string_view input, size_t& pos, std::string_view& field) {
+    for (size_t i = pos; i < input.size(); ++i) {
+        if (input[i] == '\\') {
+            i++;
+        } else if (input[i] == '|') {
+            field = input.substr(pos, i - pos);
+            pos = i + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * LEEF 2.0 delimiter: a single character, or its hex code ("x09", "0x09")
+ */
+char leef_delimiter(std::string_view text) {
+    if (text.size() == 1) return text[0];
+    if (text.starts_with("0x") || text.starts_with("0X")) text.remove_prefix(2);
+    else if (text.starts_with("x") || text.starts_with("X")) text.remove_prefix(1);
+
+    unsigned code = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), code, 16);
+    if (ec != std::errc() || end != text.data() + text.size() || code == 0 || code > 0x7F) return '\t';
+    return static_cast<char>(code);
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char x = a[i] >= 'A' && a[i] <= 'Z' ? static_cast<char>(a[i] + 32) : a[i];
+        if (x != b[i]) return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool to_number(std::string_view text, T& value) {
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && end == text.data() + text.size();
+}
+
+storage::Proto proto_from_value(std::string_view value) {
+    unsigned number = 0;
+    if (to_number(value, number)) {
+        switch (number) {
+            case 6: return storage::Proto::Tcp;
+            case 17: return storage::Proto::Udp;
+            case 1:
+            case 58: return storage::Proto::Icmp;
+            default: return storage::Proto::Other;
+        }
+    }
+    static constexpr std::pair<std::string_view, storage::Proto> names[] = {
+        {"tcp", storage::Proto::Tcp}, {"udp", storage::Proto::Udp}, {"icmp", storage::Proto::Icmp},
+        {"http", storage::Proto::Http}, {"https", storage::Proto::Https}, {"dns", storage::Proto::Dns},
+        {"ssh", storage::Proto::Ssh},
+    };
+    for (const auto& [name, proto] : names) {
+        if (iequals(value, name)) return proto;
+    }
+    return storage::Proto::Other;
+}
+
+storage::Verb verb_from_action(std::string_view value) {
+    static constexpr std::string_view allow[] = {"allow", "allowed", "accept", "accepted", "permit", "permitted", "pass"};
+    static constexpr std::string_view deny[] = {"deny", "denied", "block", "blocked", "drop", "dropped", "reject", "rejected"};
+    for (auto name : allow) {
+        if (iequals(value, name)) return storage::Verb::Allow;
+    }
+    for (auto name : deny) {
+        if (iequals(value, name)) return storage::Verb::Deny;
+    }
+    return storage::Verb::Other;
+}
+
+/**
+ * Epoch milliseconds, RFC 3339, or the ArcSight "MMM dd yyyy HH:mm:ss[.SSS]"
+ * form (any trailing zone is ignored and the time taken as UTC)
+ */
+std::optional<storage::timestamp_t> parse_time(std::string_view text) {
+    if (auto ts = core::TimestampParser::parse(text)) return ts;
+    if (text.size() < 20 || text[3] != ' ' || text[6] != ' ' || text[11] != ' ') return std::nullopt;
+
+    static constexpr std::string_view months[] = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    int month = 0;
+    for (int i = 0; i < 12; ++i) {
+        if (text.substr(0, 3) == months[i]) month = i + 1;
+    }
+    if (month == 0) return std::nullopt;
+
+    // Rewrite as RFC 3339 on the stack and reuse its parser
+    std::string_view time = text.substr(12);
+    size_t time_end = time.find(' ');
+    if (time_end != std::string_view::npos) time = time.substr(0, time_end);
+    if (time.size() > 12) return std::nullopt;
+
+    char iso[40];
+    int n = std::snprintf(iso, sizeof(iso), "%.4s-%02d-%.2sT%.*sZ", text.data() + 7, month, text.data() + 4,
+                          static_cast<int>(time.size()), time.data());
+    if (n <= 0 || static_cast<size_t>(n) >= sizeof(iso)) return std::nullopt;
+    if (iso[8] == ' ') iso[8] = '0';
+    return core::TimestampParser::parse(std::string_view(iso, static_cast<size_t>(n)));
+}
+
+} // namespace
+
+bool CefParser::parse(std::string_view line, CefMessage& out) {
+    out = CefMessage{};
+
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) line.remove_suffix(1);
+
+    size_t pos = find_marker(line, "CEF:");
+    if (pos != std::string_view::npos) {
+        pos += 4;
+        if (!next_field(line, pos, out.version) || !next_field(line, pos, out.vendor) ||
+            !next_field(line, pos, out.product) || !next_field(line, pos, out.product_version) ||
+            !next_field(line, pos, out.event_id) || !next_field(line, pos, out.name) ||
+            !next_field(line, pos, out.severity)) {
+            return false;
+        }
+        out.format = CefMessage::Format::Cef;
+        out.extensions = line.substr(pos);
+        return !out.version.empty();
+    }
+
+    pos = find_marker(line, "LEEF:");
+    if (pos == std::string_view::npos) return false;
+    pos += 5;
+    if (!next_field(line, pos, out.version) || !next_field(line, pos, out.vendor) ||
+        !next_field(line, pos, out.product) || !next_field(line, pos, out.product_version) ||
+        !next_field(line, pos, out.event_id)) {
+        return false;
+    }
+    out.format = CefMessage::Format::Leef;
+    out.delimiter = '\t';
+
+    if (out.version.starts_with("2")) {
+        std::string_view delimiter;
+        if (!next_field(line, pos, delimiter)) return false;
+        if (!delimiter.empty()) out.delimiter = leef_delimiter(delimiter);
+    }
+    out.extensions = line.substr(pos);
+    return true;
+}
+
+void CefParser::unescape(std::string_view raw, std::string& out) {
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '\\' && i + 1 < raw.size()) {
+            char next = raw[i + 1];
+            if (next == '|' || next == '=' || next == '\\') {
+                out += next;
+                i++;
+                continue;
+            }
+            if (next == 'n' || next == 'r') {
+                out += next == 'n' ? '\n' : '\r';
+                i++;
+                continue;
+            }
+        }
+        out += raw[i];
+    }
+}
+
+void CefParser::to_event(const CefMessage& message, storage::Event& event, bool keep_unknown) {
+    auto& features = event.features;
+    bool leef = message.format == CefMessage::Format::Leef;
+
+    // Escapes and invalid UTF-8 are rare; only values that have one are copied
+    std::string scratch;
+    std::string unescaped;
+    auto text = [&](std::string_view raw, bool escapes = true) {
+        bool escaped = escapes && raw.find('\\') != std::string_view::npos;
+        if (!escaped && core::Utf8::valid(raw)) return raw;
+        if (escaped) {
+            unescaped.clear();
+            unescape(raw, unescaped);
+            raw = unescaped;
+        }
+        scratch.clear();
+        core::Utf8::append(scratch, raw);
+        return std::string_view(scratch);
+    };
+    auto set_extra = [&features](std::string_view key, std::string_view value) {
+        features.extra[core::Utf8::repair(key)] = value;
+    };
+    auto set_severity = [&](std::string_view value) {
+        int number = 0;
+        if (to_number(value, number)) {
+            features.extra["severity"] = number;
+        } else {
+            set_extra("severity", value);
+        }
+    };
+    auto add = [](std::optional<uint64_t>& total, std::string_view value) {
+        uint64_t number = 0;
+        if (to_number(value, number)) total = total.value_or(0) + number;
+    };
+    auto port = [](std::optional<uint16_t>& slot, std::string_view value) {
+        uint16_t number = 0;
+        if (to_number(value, number)) slot = number;
+    };
+
+    if (!message.vendor.empty()) set_extra("vendor", text(message.vendor));
+    if (!message.product.empty()) set_extra("product", text(message.product));
+    if (!message.event_id.empty()) set_extra("signature", text(message.event_id));
+    if (!message.name.empty()) set_extra("name", text(message.name));
+    if (!message.severity.empty()) set_severity(text(message.severity));
+
+    bool have_suser = false;
+    bool have_dvchost = false;
+    for_each_extension(message, [&](std::string_view key, std::string_view raw) {
+        if (raw.empty()) return;
+        std::string_view value = text(raw, !leef);
+
+        if (key == "src") {
+            features.ip = storage::Symbol(value);
+        } else if (key == "dst") {
+            features.dst_ip = storage::Symbol(value);
+        } else if (key == (leef ? "srcPort" : "spt")) {
+            port(features.sport, value);
+        } else if (key == (leef ? "dstPort" : "dpt")) {
+            port(features.dport, value);
+        } else if (key == "proto") {
+            features.proto = proto_from_value(value);
+            if (features.proto == storage::Proto::Other) set_extra("proto", value);
+        } else if (leef ? key == "usrName" : key == "suser") {
+            features.user = storage::Symbol(value);
+            have_suser = true;
+        } else if (!leef && key == "duser") {
+            if (!have_suser) features.user = storage::Symbol(value);
+        } else if (key == (leef ? "action" : "act")) {
+            features.verb = verb_from_action(value);
+            if (features.verb == storage::Verb::Other) set_extra("verb", value);
+        } else if (key == "outcome") {
+            if (iequals(value, "success")) features.outcome = storage::Outcome::Success;
+            else if (iequals(value, "failure") || iequals(value, "fail")) features.outcome = storage::Outcome::Fail;
+            else features.set_string("outcome", value);
+        } else if (leef ? key == "srcBytes" || key == "dstBytes" : key == "in" || key == "out") {
+            add(features.bytes, value);
+        } else if (leef && (key == "srcPackets" || key == "dstPackets")) {
+            add(features.packets, value);
+        } else if (leef ? key == "devTime" : key == "rt" || key == "end") {
+            if (auto ts = parse_time(value)) event.ts = *ts;
+        } else if (!leef && (key == "dvchost" || key == "dvc")) {
+            // The device hostname wins over its address
+            if (key == "dvchost" || !have_dvchost) event.host = storage::Symbol(value);
+            have_dvchost = have_dvchost || key == "dvchost";
+        } else if (leef && key == "sev") {
+            set_severity(value);
+        } else if (keep_unknown) {
+            set_extra(key, value);
+        }
+    });
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "storage/schemas.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace siem::ingest {
+
+/**
+ * One CEF or LEEF record; every view points into the parsed input with
+ * its escapes intact (see CefParser::unescape)
+ */
+struct CefMessage {
+    enum class Format : uint8_t { Cef, Leef };
+
+    Format format = Format::Cef;
+    std::string_view version;
+    std::string_view vendor;
+    std::string_view product;
+    std::string_view product_version;
+    std::string_view event_id;         // CEF Device Event Class ID / LEEF EventID
+    std::string_view name;             // CEF only
+    std::string_view severity;         // CEF only; LEEF carries "sev" as an attribute
+    std::string_view extensions;
+    char delimiter = ' ';              // LEEF attribute delimiter (tab unless LEEF 2.0 names one)
+};
+
+/**
+ * Allocation-free CEF / LEEF tokenizer
+ * - CEF:Version|Vendor|Product|Version|SignatureID|Name|Severity|k=v k=v
+ *   with "\|" and "\\" escaped in the header and "\=", "\\", "\n", "\r"
+ *   in extension values; values may contain spaces
+ * - LEEF:1.0|Vendor|Product|Version|EventID|k=v<TAB>k=v
+ * - LEEF:2.0|Vendor|Product|Version|EventID|Delimiter|k=v...
+ * The record may follow a syslog header; to_event() maps known keys onto
+ * typed event fields.
+ */
+class CefParser {
+public:
+    /**
+     * Returns false when no CEF: / LEEF: header with all its fields is found
+     */
+    static bool parse(std::string_view line, CefMessage& out);
+
+    /**
+     * Call fn(key, raw_value) for every extension / attribute in order
+     */
+    template <typename Fn>
+    static void for_each_extension(const CefMessage& message, Fn&& fn);
+
+    /**
+     * Append a raw header field or extension value to out with escapes removed
+     */
+    static void unescape(std::string_view raw, std::string& out);
+
+    /**
+     * Fill event from the record
+     * - src -> ip, dst -> dst_ip, spt/srcPort -> sport, dpt/dstPort -> dport,
+     *   proto, suser (else duser) / usrName -> user, act/action -> verb,
+     *   outcome, in + out / srcBytes + dstBytes -> bytes,
+     *   srcPackets + dstPackets -> packets
+     * - rt / end / devTime set ts and dvchost / dvc set host; both are left
+     *   alone when absent
+     * - vendor, product, signature, name and severity go to features.extra,
+     *   as do unknown keys when keep_unknown is set
+     */
+    static void to_event(const CefMessage& message, storage::Event& event, bool keep_unknown = true);
+};
+
+template <typename Fn>
+void CefParser::for_each_extension(const CefMessage& message, Fn&& fn) {
+    std::string_view ext = message.extensions;
+
+    if (message.format == CefMessage::Format::Leef) {
+        size_t pos = 0;
+        while (pos < ext.size()) {
+            size_t end = ext.find(message.delimiter, pos);
+            if (end == std::string_view::npos) end = ext.size();
+            std::string_view attribute = ext.substr(pos, end - pos);
+            pos = end + 1;
+
+            size_t eq = attribute.find('=');
+            if (eq == std::string_view::npos || eq == 0) continue;
+            fn(attribute.substr(0, eq), attribute.substr(eq + 1));
+        }
+        return;
+    }
+
+    auto key_char = [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+               c == '_' || c == '.' || c == '-' || c == '[' || c == ']';
+    };
+
+    size_t pos = ext.find_first_not_of(' ');
+    while (pos != std::string_view::npos && pos < ext.size()) {
+        size_t eq = pos;
+        while (eq < ext.size() && key_char(ext[eq])) eq++;
+        if (eq == pos || eq >= ext.size() || ext[eq] != '=') return;  // Not a key; stop
+        std::string_view key = ext.substr(pos, eq - pos);
+
+        // A value runs until the space before the next unescaped "key="; jump
+        // between '=' signs and walk back over the candidate key
+        size_t value_start = eq + 1;
+        size_t space = std::string_view::npos;
+        size_t i = value_start;
+        while ((i = ext.find('=', i)) != std::string_view::npos) {
+            size_t k = i;
+            while (k > value_start && key_char(ext[k - 1])) k--;
+            if (k < i && k > value_start && ext[k - 1] == ' ') {
+                size_t slashes = 0;
+                while (k - 1 - slashes > value_start && ext[k - 2 - slashes] == '\\') slashes++;
+                if (slashes % 2 == 0) {
+                    space = k - 1;
+                    break;
+                }
+            }
+            i++;
+        }
+        if (i == std::string_view::npos) i = ext.size();
+
+        size_t value_end = i < ext.size() ? space : ext.size();
+        std::string_view value = ext.substr(value_start, value_end - value_start);
+        while (!value.empty() && value.back() == ' ') value.remove_suffix(1);
+        fn(key, value);
+
+        pos = i < ext.size() ? space + 1 : std::string_view::npos;
+    }
+}
+
+} // namespace siem::ingest
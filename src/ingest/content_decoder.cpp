@@ -0,0 +1,145 @@
+#include "ingest/content_decoder.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <zlib.h>
+#include <zstd.h>
+
+namespace siem::ingest {
+
+namespace {
+
+constexpr size_t kWindow = 64 * 1024;
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+} // namespace
+
+std::optional<ContentEncoding> parse_content_encoding(std::string_view header) {
+    while (!header.empty() && (header.front() == ' ' || header.front() == '\t')) header.remove_prefix(1);
+    while (!header.empty() && (header.back() == ' ' || header.back() == '\t')) header.remove_suffix(1);
+
+    if (header.empty() || iequals(header, "identity")) return ContentEncoding::Identity;
+    if (iequals(header, "gzip") || iequals(header, "x-gzip")) return ContentEncoding::Gzip;
+    if (iequals(header, "zstd")) return ContentEncoding::Zstd;
+    return std::nullopt;
+}
+
+struct ContentDecoder::Inflater {
+    z_stream stream{};
+
+    explicit Inflater(std::string_view input) {
+        // 16 + MAX_WBITS: gzip wrapper only
+        if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) throw std::runtime_error("inflateInit2 failed");
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream.avail_in = static_cast<uInt>(input.size());
+    }
+
+    ~Inflater() { inflateEnd(&stream); }
+};
+
+struct ContentDecoder::Zstd {
+    ZSTD_DCtx* ctx = nullptr;
+    ZSTD_inBuffer in{};
+
+    Zstd(std::string_view input, size_t max_output) : ctx(ZSTD_createDCtx()) {
+        if (!ctx) throw std::runtime_error("ZSTD_createDCtx failed");
+        // A window larger than the whole allowed output buys nothing but
+        // lets a hostile frame make us allocate it
+        int window_log = std::clamp(static_cast<int>(std::bit_width(max_output)), 10, 27);
+        ZSTD_DCtx_setParameter(ctx, ZSTD_d_windowLogMax, window_log);
+        in = {input.data(), input.size(), 0};
+    }
+
+    ~Zstd() { ZSTD_freeDCtx(ctx); }
+};
+
+ContentDecoder::ContentDecoder(ContentEncoding encoding, std::string_view input, size_t max_output)
+    : encoding_(encoding), input_(input), max_output_(max_output) {
+    switch (encoding_) {
+    case ContentEncoding::Gzip:
+        if (input_.size() > std::numeric_limits<uInt>::max()) throw std::runtime_error("Compressed body too large");
+        gzip_ = std::make_unique<Inflater>(input_);
+        window_ = std::make_unique<char[]>(kWindow);
+        break;
+    case ContentEncoding::Zstd:
+        zstd_ = std::make_unique<Zstd>(input_, max_output_);
+        window_ = std::make_unique<char[]>(kWindow);
+        break;
+    case ContentEncoding::Identity:
+        break;
+    }
+}
+
+ContentDecoder::~ContentDecoder() = default;
+
+ContentDecoder::int_type ContentDecoder::underflow() {
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+    if (encoding_ == ContentEncoding::Identity) {
+        if (finished_ || input_.empty()) return traits_type::eof();
+        finished_ = true;
+        decoded_ = input_.size();
+        if (decoded_ > max_output_) throw std::runtime_error("Decompressed body exceeds maximum size");
+        char* begin = const_cast<char*>(input_.data());
+        setg(begin, begin, begin + input_.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+    while (!finished_) {
+        size_t produced = fill(window_.get(), kWindow);
+        if (produced == 0) continue;
+
+        decoded_ += produced;
+        if (decoded_ > max_output_) throw std::runtime_error("Decompressed body exceeds maximum size");
+        setg(window_.get(), window_.get(), window_.get() + produced);
+        return traits_type::to_int_type(*gptr());
+    }
+    return traits_type::eof();
+}
+
+size_t ContentDecoder::fill(char* out, size_t size) {
+    if (gzip_) {
+        z_stream& z = gzip_->stream;
+        z.next_out = reinterpret_cast<Bytef*>(out);
+        z.avail_out = static_cast<uInt>(size);
+
+        int rc = inflate(&z, Z_NO_FLUSH);
+        size_t produced = size - z.avail_out;
+        if (rc == Z_STREAM_END) {
+            // Another member may follow; anything else fails as bad data
+            if (z.avail_in == 0) finished_ = true;
+            else if (inflateReset(&z) != Z_OK) throw std::runtime_error("inflateReset failed");
+        } else if (rc == Z_BUF_ERROR && z.avail_in == 0) {
+            // No progress possible: the input ended inside the stream
+            throw std::runtime_error("Truncated gzip body");
+        } else if (rc != Z_OK) {
+            throw std::runtime_error(std::string("Invalid gzip body: ") + (z.msg ? z.msg : "inflate failed"));
+        }
+        return produced;
+    }
+
+    ZSTD_outBuffer output{out, size, 0};
+    size_t rc = ZSTD_decompressStream(zstd_->ctx, &output, &zstd_->in);
+    if (ZSTD_isError(rc)) {
+        throw std::runtime_error(std::string("Invalid zstd body: ") + ZSTD_getErrorName(rc));
+    }
+    bool input_done = zstd_->in.pos == zstd_->in.size;
+    if (rc == 0) {
+        // Frame complete and flushed; the next one, if any, starts fresh
+        if (input_done) finished_ = true;
+    } else if (input_done && output.pos == 0) {
+        throw std::runtime_error("Truncated zstd body");
+    }
+    return output.pos;
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string_view>
+
+namespace siem::ingest {
+
+enum class ContentEncoding {
+    Identity,
+    Gzip,
+    Zstd
+};
+
+/**
+ * Map a Content-Encoding header value ("gzip", "x-gzip", "zstd",
+ * "identity" or empty, case-insensitive) to an encoding; nullopt for
+ * anything else, including stacked codings
+ */
+std::optional<ContentEncoding> parse_content_encoding(std::string_view header);
+
+/**
+ * Decompressing stream buffer over an in-memory body
+ * - Decodes one 64 KB window at a time as the reader pulls, so the
+ *   decompressed body is never held in full
+ * - Concatenated gzip members and zstd frames are read back to back
+ * - Reads throw std::runtime_error on corrupt or truncated input, and as
+ *   soon as more than max_output bytes have come out (zip bombs stop
+ *   after at most one extra window)
+ * input must outlive the decoder.
+ */
+class ContentDecoder : public std::streambuf {
+public:
+    ContentDecoder(ContentEncoding encoding, std::string_view input, size_t max_output);
+    ~ContentDecoder() override;
+
+    ContentDecoder(const ContentDecoder&) = delete;
+    ContentDecoder& operator=(const ContentDecoder&) = delete;
+
+    /**
+     * Bytes decompressed so far
+     */
+    size_t decoded() const { return decoded_; }
+
+protected:
+    int_type underflow() override;
+
+private:
+    struct Inflater;
+    struct Zstd;
+
+    ContentEncoding encoding_;
+    std::string_view input_;
+    size_t max_output_;
+    size_t decoded_ = 0;
+    bool finished_ = false;
+
+    std::unique_ptr<Inflater> gzip_;
+    std::unique_ptr<Zstd> zstd_;
+    std::unique_ptr<char[]> window_;
+
+    size_t fill(char* out, size_t size);
+};
+
+} // namespace siem::ingest
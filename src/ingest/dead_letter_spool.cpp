@@ -0,0 +1,366 @@
+#include "ingest/dead_letter_spool.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace siem::ingest {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::string_view kSealed = ".ndjson";
+constexpr std::string_view kActive = ".active";
+
+int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * "<prefix>-<ms>-<seq>"; names sort in creation order within a process
+ */
+std::string unique_stem(const char* prefix) {
+    static std::atomic<uint32_t> seq{0};
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s-%013lld-%06u", prefix,
+                  static_cast<long long>(now_ms()), seq.fetch_add(1) % 1000000);
+    return name;
+}
+
+bool write_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        ssize_t n = ::write(fd, data.data(), data.size());
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return false;
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+}
+
+/**
+ * Write data to path.tmp, sync it and rename it over path
+ */
+void replace_file(const fs::path& path, std::string_view data) {
+    std::string tmp = path.string() + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+    if (fd < 0) throw std::system_error(errno, std::system_category(), "open " + tmp);
+    bool ok = write_all(fd, data) && ::fdatasync(fd) == 0;
+    int error = errno;
+    ::close(fd);
+    if (!ok) {
+        ::unlink(tmp.c_str());
+        throw std::system_error(error, std::system_category(), "write " + tmp);
+    }
+    fs::rename(tmp, path);
+}
+
+std::vector<fs::path> sealed_files(const fs::path& dir) {
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == kSealed) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+} // namespace
+
+DeadLetterSpool::DeadLetterSpool(Config config)
+    : config_(std::move(config)), redactor_(config_.redaction) {}
+
+DeadLetterSpool::~DeadLetterSpool() {
+    stop();
+}
+
+void DeadLetterSpool::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+
+    fs::create_directories(config_.dir);
+
+    // Files a crashed run left active hold complete records, bar perhaps a
+    // torn last line that redrive() skips
+    for (const auto& entry : fs::directory_iterator(config_.dir)) {
+        if (entry.path().extension() == kActive) {
+            fs::path sealed = entry.path();
+            fs::rename(entry.path(), sealed.replace_extension(kSealed));
+        }
+    }
+    enforce_cap();
+
+    running_ = true;
+    thread_ = std::make_unique<std::thread>(&DeadLetterSpool::run, this);
+
+    spdlog::info(R"({{"msg":"dead_letter_started","dir":"{}","files":{},"bytes":{}}})",
+                config_.dir, files_.load(), bytes_.load());
+}
+
+void DeadLetterSpool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_ && thread_->joinable()) thread_->join();
+    thread_.reset();
+
+    spdlog::info(R"({{"msg":"dead_letter_stopped","written":{},"dropped":{}}})",
+                written_.load(), dropped_.load());
+}
+
+void DeadLetterSpool::add(std::string source, std::string reason, std::string error, std::string raw,
+                          bool redrivable) {
+    // The byte scanner copes with input that is not valid JSON
+    std::string redacted;
+    if (redactor_.redact(raw, redacted) > 0) raw = std::move(redacted);
+    enqueue(Record{now_ms(), std::move(source), std::move(reason), std::move(error), std::move(raw), redrivable});
+}
+
+void DeadLetterSpool::add(const json& raw_event, const std::exception& error) {
+    std::string source = "unknown";
+    if (raw_event.is_object()) {
+        auto it = raw_event.find("source");
+        if (it != raw_event.end() && it->is_string()) source = it->get<std::string>();
+    }
+    json redacted = raw_event;
+    redactor_.redact(redacted);
+    enqueue(Record{now_ms(), std::move(source), reason_of(error), error.what(),
+                   redacted.dump(-1, ' ', false, json::error_handler_t::replace)});
+}
+
+void DeadLetterSpool::enqueue(Record record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reasons_[record.reason]++;
+    if (queue_.size() >= config_.max_queue) {
+        dropped_++;
+        return;
+    }
+    queue_.push_back(std::move(record));
+}
+
+DeadLetterSpool::Stats DeadLetterSpool::stats() const {
+    Stats stats;
+    stats.written = written_.load();
+    stats.dropped = dropped_.load();
+    stats.evicted_files = evicted_files_.load();
+    stats.bytes = bytes_.load();
+    stats.files = files_.load();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.reasons = reasons_;
+    return stats;
+}
+
+std::string DeadLetterSpool::reason_of(const std::exception& error) {
+    if (dynamic_cast<const json::exception*>(&error)) {
+        // "[json.exception.type_error.302] ..."
+        constexpr std::string_view prefix = "[json.exception.";
+        std::string_view what = error.what();
+        size_t end = what.find(']');
+        if (what.starts_with(prefix) && end != std::string_view::npos) {
+            return std::string(what.substr(prefix.size(), end - prefix.size()));
+        }
+        return "json_error";
+    }
+    if (dynamic_cast<const std::invalid_argument*>(&error)) return "invalid_argument";
+    if (dynamic_cast<const std::out_of_range*>(&error)) return "out_of_range";
+    if (dynamic_cast<const std::length_error*>(&error)) return "length_error";
+    if (dynamic_cast<const std::bad_alloc*>(&error)) return "bad_alloc";
+    if (dynamic_cast<const std::system_error*>(&error)) return "system_error";
+    if (dynamic_cast<const std::runtime_error*>(&error)) return "runtime_error";
+    return "error";
+}
+
+void DeadLetterSpool::run() {
+    while (true) {
+        std::deque<Record> records;
+        bool stopping;
+        {
+            // Wake once per flush_ms so records are written in batches
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, std::chrono::milliseconds(config_.flush_ms), [this] { return !running_; });
+            records.swap(queue_);
+            stopping = !running_;
+        }
+
+        if (!records.empty()) write(records);
+
+        if (active_fd_ >= 0 &&
+            (stopping || active_bytes_ >= config_.file_bytes ||
+             std::chrono::steady_clock::now() - active_since_ >= std::chrono::seconds(config_.seal_seconds))) {
+            seal();
+        }
+        if (stopping) break;
+    }
+}
+
+void DeadLetterSpool::write(const std::deque<Record>& records) {
+    std::string buffer;
+    for (const auto& record : records) {
+        json line = {
+            {"ts", record.ts_ms},
+            {"source", record.source},
+            {"reason", record.reason},
+            {"error", record.error},
+            {"raw", record.raw},
+        };
+        if (!record.redrivable) line["redrivable"] = false;
+        buffer += line.dump(-1, ' ', false, json::error_handler_t::replace);
+        buffer += '\n';
+    }
+
+    if (active_fd_ < 0) {
+        active_path_ = (fs::path(config_.dir) / (unique_stem("dead-letter") + std::string(kActive))).string();
+        active_fd_ = ::open(active_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0640);
+        if (active_fd_ < 0) {
+            spdlog::error(R"({{"msg":"dead_letter_open_failed","path":"{}","error":"{}"}})",
+                         active_path_, std::strerror(errno));
+            dropped_ += records.size();
+            return;
+        }
+        active_bytes_ = 0;
+        active_since_ = std::chrono::steady_clock::now();
+        files_++;
+    }
+
+    if (!write_all(active_fd_, buffer)) {
+        // A torn line is skipped by redrive(); the next batch goes to a new file
+        spdlog::error(R"({{"msg":"dead_letter_write_failed","path":"{}","error":"{}"}})",
+                     active_path_, std::strerror(errno));
+        dropped_ += records.size();
+        seal();
+        return;
+    }
+
+    active_bytes_ += buffer.size();
+    bytes_ += buffer.size();
+    written_ += records.size();
+    if (bytes_.load() > config_.max_bytes) enforce_cap();
+}
+
+void DeadLetterSpool::seal() {
+    if (active_fd_ < 0) return;
+    ::fdatasync(active_fd_);
+    ::close(active_fd_);
+    active_fd_ = -1;
+
+    fs::path sealed = active_path_;
+    std::error_code ec;
+    fs::rename(active_path_, sealed.replace_extension(kSealed), ec);
+    if (ec) {
+        spdlog::error(R"({{"msg":"dead_letter_seal_failed","path":"{}","error":"{}"}})",
+                     active_path_, ec.message());
+    }
+    enforce_cap();
+}
+
+void DeadLetterSpool::enforce_cap() {
+    // Rescanned rather than tracked: redrive() rewrites files from outside
+    std::error_code ec;
+    std::vector<std::pair<fs::path, uint64_t>> files;
+    uint64_t total = active_fd_ >= 0 ? active_bytes_ : 0;
+    for (const auto& path : sealed_files(config_.dir)) {
+        uint64_t size = fs::file_size(path, ec);
+        if (ec) continue;
+        files.emplace_back(path, size);
+        total += size;
+    }
+
+    size_t oldest = 0;
+    while (total > config_.max_bytes && oldest < files.size()) {
+        const auto& [path, size] = files[oldest++];
+        if (fs::remove(path, ec)) {
+            total -= size;
+            evicted_files_++;
+            spdlog::warn(R"({{"msg":"dead_letter_evicted","path":"{}","bytes":{}}})", path.string(), size);
+        }
+    }
+
+    bytes_ = total;
+    files_ = files.size() - oldest + (active_fd_ >= 0 ? 1 : 0);
+}
+
+size_t DeadLetterSpool::redrive(const Config& config, const std::string& spool_dir, std::string_view reason,
+                                size_t* refused) {
+    if (refused) *refused = 0;
+    if (!fs::exists(config.dir)) return 0;
+
+    struct Rewrite {
+        fs::path path;
+        std::string kept;
+    };
+    std::vector<Rewrite> rewrites;
+    std::string events;
+    size_t count = 0;
+    size_t malformed = 0;
+    size_t kept = 0;
+
+    for (const auto& path : sealed_files(config.dir)) {
+        std::ifstream in(path);
+        Rewrite rewrite{path, {}};
+        bool matched = false;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            json record = json::parse(line, nullptr, false);
+            if (!record.is_object() || !record.contains("raw") || !record["raw"].is_string()) {
+                malformed++;
+                matched = true;     // Rewritten without it
+                continue;
+            }
+            bool matches = reason.empty() || record.value("reason", "") == reason;
+            if (matches && !record.value("redrivable", true)) kept++;
+            if (!matches || !record.value("redrivable", true)) {
+                rewrite.kept += line;
+                rewrite.kept += '\n';
+                continue;
+            }
+            events += record["raw"].get_ref<const std::string&>();
+            events += '\n';
+            count++;
+            matched = true;
+        }
+        if (matched) rewrites.push_back(std::move(rewrite));
+    }
+
+    if (malformed > 0) {
+        spdlog::warn(R"({{"msg":"dead_letter_malformed_skipped","count":{}}})", malformed);
+    }
+    if (kept > 0) {
+        spdlog::warn(R"({{"msg":"dead_letter_not_redrivable","count":{}}})", kept);
+    }
+    if (refused) *refused = kept;
+
+    // Hand the events to the spool before giving up our copy
+    if (count > 0) {
+        fs::create_directories(spool_dir);
+        fs::path target = fs::path(spool_dir) / (unique_stem("redrive") + std::string(kSealed));
+        replace_file(target, events);
+        spdlog::info(R"({{"msg":"dead_letter_redriven","events":{},"file":"{}"}})", count, target.string());
+    }
+
+    for (const auto& rewrite : rewrites) {
+        if (rewrite.kept.empty()) {
+            fs::remove(rewrite.path);
+        } else {
+            replace_file(rewrite.path, rewrite.kept);
+        }
+    }
+
+    return count;
+}
+
+} // namespace siem::ingest
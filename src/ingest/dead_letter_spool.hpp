@@ -0,0 +1,150 @@
+#pragma once
+
+#include "core/secret_redactor.hpp"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace siem::ingest {
+
+using json = nlohmann::json;
+
+/**
+ * Local dead-letter store for events that could not be parsed or normalized
+ * - Raw events are redacted before they are queued, so the spool holds no
+ *   more secrets than the event store
+ * - add() only queues the record; a writer thread appends NDJSON lines
+ *   `{"ts","source","reason","error","raw"}` to the active file, so the
+ *   ingest path never waits on the disk. A full queue drops and counts.
+ * - The active file (*.active) is sealed into *.ndjson once it reaches
+ *   file_bytes or seal_seconds of age, and on stop. Oldest sealed files are
+ *   deleted to keep the directory under max_bytes.
+ * - redrive() moves sealed records back into a spool directory as one
+ *   NDJSON file of their raw events, where SpoolIngestor picks them up;
+ *   events that fail again land here again. Records added as not
+ *   redrivable (`"redrivable":false`, e.g. already normalized events a
+ *   pipeline stage failed on) are kept for inspection and never moved.
+ */
+class DeadLetterSpool {
+public:
+    struct Config {
+        std::string dir = "data/dead_letter";
+        size_t file_bytes = 16 * 1024 * 1024;      // Seal the active file past this
+        int seal_seconds = 60;                     // ... or once it is this old
+        size_t max_bytes = 256 * 1024 * 1024;      // Oldest sealed files are deleted past this
+        size_t max_queue = 10000;                  // Records waiting for the writer
+        int flush_ms = 200;
+        core::SecretRedactor::Config redaction;    // Same as the normalizer's
+    };
+
+    struct Stats {
+        uint64_t written = 0;
+        uint64_t dropped = 0;                      // Queue full or write failed
+        uint64_t evicted_files = 0;                // Deleted to stay under max_bytes
+        uint64_t bytes = 0;                        // On disk, sealed and active
+        uint64_t files = 0;
+        std::map<std::string, uint64_t> reasons;   // Records added per reason
+    };
+
+    explicit DeadLetterSpool(Config config);
+    ~DeadLetterSpool();
+
+    DeadLetterSpool(const DeadLetterSpool&) = delete;
+    DeadLetterSpool& operator=(const DeadLetterSpool&) = delete;
+
+    /**
+     * Create the directory, seal files left active by a previous run and
+     * start the writer; throws std::filesystem::filesystem_error
+     */
+    void start();
+
+    /**
+     * Write what is queued, seal the active file and stop
+     */
+    void stop();
+
+    /**
+     * Queue one record; raw is the event as compact JSON, or the input
+     * bytes when they did not parse. Thread-safe. A record that is not
+     * redrivable holds something other than raw input, which the
+     * normalizer would not read back.
+     */
+    void add(std::string source, std::string reason, std::string error, std::string raw,
+             bool redrivable = true);
+
+    /**
+     * Queue a raw event that failed with error; source comes from the
+     * event, reason from reason_of(error)
+     */
+    void add(const json& raw_event, const std::exception& error);
+
+    Stats stats() const;
+
+    /**
+     * Short stable label for an exception: the nlohmann error kind and id
+     * ("type_error.302", "parse_error.101"), the std exception type
+     * ("invalid_argument"), else "error"
+     */
+    static std::string reason_of(const std::exception& error);
+
+    /**
+     * Move sealed records whose reason matches (all when reason is empty)
+     * into spool_dir as redrive-<ms>.ndjson and remove them from config.dir.
+     * The spool file is renamed into place before anything is removed, so a
+     * crash in between re-drives twice rather than losing records. Returns
+     * the number of events moved; matching records that are not redrivable
+     * stay and are counted in refused.
+     */
+    static size_t redrive(const Config& config, const std::string& spool_dir, std::string_view reason = {},
+                          size_t* refused = nullptr);
+
+private:
+    struct Record {
+        int64_t ts_ms = 0;
+        std::string source;
+        std::string reason;
+        std::string error;
+        std::string raw;
+        bool redrivable = true;
+    };
+
+    Config config_;
+    core::SecretRedactor redactor_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Record> queue_;
+    std::map<std::string, uint64_t> reasons_;
+    bool running_ = false;
+    std::unique_ptr<std::thread> thread_;
+
+    // Writer thread state
+    int active_fd_ = -1;
+    std::string active_path_;
+    uint64_t active_bytes_ = 0;
+    std::chrono::steady_clock::time_point active_since_;
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> evicted_files_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> files_{0};
+
+    void enqueue(Record record);
+    void run();
+    void write(const std::deque<Record>& records);
+    void seal();
+    void enforce_cap();
+};
+
+} // namespace siem::ingest
@@ -0,0 +1,133 @@
+#include "ingest/event_stream.hpp"
+#include <stdexcept>
+#include <vector>
+
+namespace siem::ingest {
+
+namespace {
+
+/**
+ * SAX handler that materialises one event at a time
+ * Only the event currently being built is kept in memory
+ */
+class EventSaxHandler : public nlohmann::json_sax<json> {
+public:
+    EventSaxHandler(const EventStreamParser::EventSink& sink, EventStreamParser::Root root)
+        : sink_(sink), root_(root) {}
+
+    size_t emitted() const { return emitted_; }
+
+    bool null() override { return value(json(nullptr)); }
+    bool boolean(bool val) override { return value(json(val)); }
+    bool number_integer(number_integer_t val) override { return value(json(val)); }
+    bool number_unsigned(number_unsigned_t val) override { return value(json(val)); }
+    bool number_float(number_float_t val, const string_t&) override { return value(json(val)); }
+    bool string(string_t& val) override { return value(json(std::move(val))); }
+    bool binary(binary_t& val) override { return value(json(std::move(val))); }
+
+    bool start_object(std::size_t) override {
+        if (depth_ == 0 && root_ == EventStreamParser::Root::ArrayOnly) {
+            throw std::runtime_error("Expected JSON array");
+        }
+        if (building()) {
+            open(json::object());
+        } else if (depth_ == 0 || (depth_ == 1 && root_is_array_)) {
+            current_ = json::object();
+            stack_.push_back(&current_);
+        }
+        depth_++;
+        return true;
+    }
+
+    bool end_object() override {
+        depth_--;
+        close();
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (depth_ == 0) {
+            root_is_array_ = true;
+        } else if (building()) {
+            open(json::array());
+        }
+        depth_++;
+        return true;
+    }
+
+    bool end_array() override {
+        depth_--;
+        close();
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (building()) key_ = std::move(val);
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const json::exception& ex) override {
+        throw std::runtime_error(ex.what());
+    }
+
+private:
+    const EventStreamParser::EventSink& sink_;
+    EventStreamParser::Root root_;
+
+    size_t depth_ = 0;
+    bool root_is_array_ = false;
+    size_t emitted_ = 0;
+
+    json current_;
+    std::vector<json*> stack_;
+    std::string key_;
+
+    bool building() const { return !stack_.empty(); }
+
+    json* insert(json&& val) {
+        json* parent = stack_.back();
+        if (parent->is_object()) {
+            return &((*parent)[key_] = std::move(val));
+        }
+        parent->push_back(std::move(val));
+        return &parent->back();
+    }
+
+    void open(json&& container) {
+        stack_.push_back(insert(std::move(container)));
+    }
+
+    void close() {
+        if (!building()) return;
+        stack_.pop_back();
+        if (stack_.empty()) {
+            emitted_++;
+            sink_(std::move(current_));
+            current_ = json();
+        }
+    }
+
+    bool value(json&& val) {
+        if (depth_ == 0 && root_ == EventStreamParser::Root::ArrayOnly) {
+            throw std::runtime_error("Expected JSON array");
+        }
+        if (building()) insert(std::move(val));
+        return true;
+    }
+};
+
+} // namespace
+
+size_t EventStreamParser::parse(std::string_view input, const EventSink& sink, Root root) {
+    EventSaxHandler handler(sink, root);
+    json::sax_parse(input.begin(), input.end(), &handler);
+    return handler.emitted();
+}
+
+size_t EventStreamParser::parse(std::istream& input, const EventSink& sink, Root root) {
+    EventSaxHandler handler(sink, root);
+    json::sax_parse(input, &handler);
+    return handler.emitted();
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <istream>
+#include <string_view>
+
+namespace siem::ingest {
+
+using json = nlohmann::json;
+
+/**
+ * Streaming (SAX) parser for ingest payloads
+ * - Builds one event object at a time and hands it to the sink, so a batch
+ *   is never held as a DOM tree
+ * - Top-level array: each object element is emitted, other elements skipped
+ * - Top-level object: emitted as a single event when allowed
+ */
+class EventStreamParser {
+public:
+    using EventSink = std::function<void(json&&)>;
+
+    enum class Root {
+        ArrayOnly,
+        ArrayOrObject
+    };
+
+    /**
+     * Parse input and emit events to sink
+     * Returns number of events emitted; throws on malformed JSON or
+     * an unexpected root type
+     */
+    static size_t parse(std::string_view input, const EventSink& sink, Root root = Root::ArrayOnly);
+
+    /**
+     * Same, pulling bytes from a stream as the parser needs them
+     * (e.g. a ContentDecoder); exceptions thrown by the stream propagate
+     */
+    static size_t parse(std::istream& input, const EventSink& sink, Root root = Root::ArrayOnly);
+};
+
+} // namespace siem::ingest
@@ -0,0 +1,417 @@
+#include "ingest/file_follower.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace siem::ingest {
+
+namespace fs = std::filesystem;
+
+FileFollower::FileFollower(Config config) : config_(std::move(config)) {
+    config_.batch_size = std::max<size_t>(config_.batch_size, 1);
+    config_.read_chunk = std::max<size_t>(config_.read_chunk, 4096);
+    config_.rescan_ms = std::max(config_.rescan_ms, 10);
+}
+
+FileFollower::~FileFollower() {
+    stop();
+    for (auto& file : files_) close(file);
+}
+
+void FileFollower::start(EventCallback callback) {
+    if (running_.load()) {
+        spdlog::warn(R"({{"msg":"file_follower_already_running"}})");
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!restored_) restore();
+    }
+
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0) {
+        spdlog::warn(R"({{"msg":"inotify_unavailable","error":"{}","rescan_ms":{}}})",
+                    std::strerror(errno), config_.rescan_ms);
+    }
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    running_.store(true);
+    thread_ = std::make_unique<std::thread>([this, callback = std::move(callback)]() {
+        follow_loop(callback);
+    });
+
+    spdlog::info(R"({{"msg":"file_follower_started","files":{}}})", config_.paths.size());
+}
+
+void FileFollower::stop() {
+    if (!running_.exchange(false)) return;
+
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        [[maybe_unused]] auto n = ::write(wake_fd_, &one, sizeof(one));
+    }
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+
+    if (inotify_fd_ >= 0) ::close(inotify_fd_);
+    if (wake_fd_ >= 0) ::close(wake_fd_);
+    inotify_fd_ = wake_fd_ = -1;
+
+    spdlog::info(R"({{"msg":"file_follower_stopped"}})");
+}
+
+FileFollower::Stats FileFollower::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void FileFollower::follow_loop(EventCallback callback) {
+    while (running_.load()) {
+        watch_directories();
+
+        try {
+            scan(callback);
+        } catch (const std::exception& e) {
+            spdlog::error(R"({{"msg":"file_follow_error","error":"{}"}})", e.what());
+        }
+
+        pollfd fds[2] = {{wake_fd_, POLLIN, 0}, {inotify_fd_, POLLIN, 0}};
+        int ready = ::poll(fds, inotify_fd_ >= 0 ? 2 : 1, config_.rescan_ms);
+        if (ready > 0 && (fds[1].revents & POLLIN)) {
+            // Which file changed does not matter; every scan checks them all
+            alignas(inotify_event) char events[4096];
+            while (::read(inotify_fd_, events, sizeof(events)) > 0) {}
+        }
+    }
+}
+
+void FileFollower::watch_directories() {
+    if (inotify_fd_ < 0) return;
+
+    std::set<std::string> dirs;
+    for (const auto& path : config_.paths) {
+        auto dir = fs::path(path).parent_path();
+        dirs.insert(dir.empty() ? "." : dir.string());
+    }
+
+    // Re-adding an existing watch is a no-op, so directories created after
+    // start are picked up on the next rescan
+    for (const auto& dir : dirs) {
+        ::inotify_add_watch(inotify_fd_, dir.c_str(),
+                            IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+    }
+}
+
+void FileFollower::restore() {
+    std::map<std::string, std::pair<ino_t, off_t>> saved;
+
+    if (fs::exists(config_.checkpoint_file)) {
+        std::ifstream in(config_.checkpoint_file);
+        json j = json::parse(in, nullptr, false);
+        if (j.is_discarded() || !j.contains("files") || !j["files"].is_array()) {
+            throw std::runtime_error("Invalid follow checkpoint file: " + config_.checkpoint_file);
+        }
+        for (const auto& entry : j["files"]) {
+            saved[entry.at("path").get<std::string>()] = {
+                entry.at("inode").get<ino_t>(), entry.at("offset").get<off_t>()};
+        }
+    }
+
+    // Size of an open file, or -1
+    auto size_of = [](const Tracked& file) -> off_t {
+        struct stat st {};
+        return file.fd >= 0 && ::fstat(file.fd, &st) == 0 ? st.st_size : -1;
+    };
+
+    bool skipped_to_end = false;
+    for (const auto& path : config_.paths) {
+        Tracked current;
+        current.path = path;
+
+        auto it = saved.find(path);
+        if (it == saved.end()) {
+            open_current(current, config_.start_at_end);
+            skipped_to_end |= current.offset > 0;
+            files_.push_back(std::move(current));
+            continue;
+        }
+
+        auto [inode, offset] = it->second;
+        open_current(current, false);
+
+        if (current.fd >= 0 && current.inode == inode) {
+            // Same inode but shorter: truncated, or the inode was freed and
+            // reused by a new file while we were down
+            off_t size = size_of(current);
+            if (size >= offset) {
+                current.offset = offset;
+            } else {
+                spdlog::warn(R"({{"msg":"follow_truncated","path":"{}","offset":{},"size":{}}})",
+                            path, offset, size);
+                std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                stats_.truncations++;
+            }
+        } else {
+            // Rotated while we were down: the old inode usually still sits in
+            // the same directory under its rotated name
+            auto dir = fs::path(path).parent_path();
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(dir.empty() ? "." : dir, ec)) {
+                struct stat st {};
+                if (::stat(entry.path().c_str(), &st) != 0 || !S_ISREG(st.st_mode) || st.st_ino != inode) {
+                    continue;
+                }
+
+                // Shorter than the checkpoint means another file took the inode
+                Tracked old;
+                old.path = entry.path().string();
+                open_current(old, false);
+                if (old.fd >= 0 && old.inode == inode && size_of(old) >= offset) {
+                    spdlog::info(R"({{"msg":"follow_resume_rotated","path":"{}","rotated_path":"{}","offset":{}}})",
+                                path, old.path, offset);
+                    old.path = path;
+                    old.offset = offset;
+                    old.rotated = true;
+                    files_.push_back(std::move(old));
+                } else {
+                    close(old);
+                }
+                break;
+            }
+        }
+
+        spdlog::info(R"({{"msg":"follow_resume","path":"{}","offset":{}}})", path, current.offset);
+        files_.push_back(std::move(current));
+    }
+
+    restored_ = true;
+
+    // Otherwise a restart before the first delivery would skip again, past
+    // whatever was appended in between
+    if (skipped_to_end) save_checkpoints();
+}
+
+void FileFollower::open_current(Tracked& file, bool from_end) {
+    int fd = ::open(file.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return;
+    }
+
+    file.fd = fd;
+    file.inode = st.st_ino;
+    file.offset = from_end ? st.st_size : 0;
+    file.skipping = false;
+}
+
+void FileFollower::close(Tracked& file) {
+    if (file.fd >= 0) ::close(file.fd);
+    file.fd = -1;
+}
+
+void FileFollower::scan(const EventCallback& callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!restored_) restore();
+
+    for (auto it = files_.begin(); it != files_.end();) {
+        Tracked& file = *it;
+
+        try {
+            if (file.rotated) {
+                drain(file, callback, true);
+                close(file);
+                it = files_.erase(it);
+                save_checkpoints();
+                continue;
+            }
+
+            if (file.fd < 0) {
+                // Not there yet (or at start); new files are read from the beginning
+                open_current(file, false);
+                if (file.fd < 0) { ++it; continue; }
+            }
+
+            struct stat st {};
+            if (::fstat(file.fd, &st) == 0 && st.st_size < file.offset) {
+                spdlog::warn(R"({{"msg":"follow_truncated","path":"{}","offset":{},"size":{}}})",
+                            file.path, file.offset, st.st_size);
+                file.offset = 0;
+                file.skipping = false;
+                std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                stats_.truncations++;
+            }
+
+            drain(file, callback, false);
+
+            // Rotated: the path names a new inode. Until a new file appears
+            // the writer may still be appending to the renamed one, so keep it.
+            if (::stat(file.path.c_str(), &st) == 0 && st.st_ino != file.inode) {
+                drain(file, callback, true);
+                spdlog::info(R"({{"msg":"follow_rotated","path":"{}","offset":{}}})", file.path, file.offset);
+                close(file);
+                open_current(file, false);
+                save_checkpoints();
+                {
+                    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+                    stats_.rotations++;
+                }
+                drain(file, callback, false);
+            }
+        } catch (const std::exception& e) {
+            // Offset is only advanced after delivery, so the batch is retried
+            spdlog::error(R"({{"msg":"follow_delivery_failed","path":"{}","offset":{},"error":"{}"}})",
+                         file.path, file.offset, e.what());
+        }
+        ++it;
+    }
+}
+
+void FileFollower::drain(Tracked& file, const EventCallback& callback, bool final) {
+    if (file.fd < 0) return;
+
+    std::vector<json> batch;
+    std::string partial;            // Bytes of an unterminated line read so far
+    std::vector<char> chunk(config_.read_chunk);
+    off_t read_at = file.offset;
+    off_t consumed = file.offset;   // Just past the last line handled
+    size_t skipped = 0;
+
+    auto handle_line = [&](std::string_view line) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) return;
+        line.remove_prefix(first);
+
+        json event = json::parse(line.begin(), line.end(), nullptr, false);
+        if (event.is_object()) {
+            batch.push_back(std::move(event));
+        } else {
+            skipped++;
+            if (config_.on_skipped) config_.on_skipped(line, event.is_discarded() ? "malformed" : "not_object");
+        }
+    };
+
+    while (true) {
+        ssize_t n = ::pread(file.fd, chunk.data(), chunk.size(), read_at);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            spdlog::error(R"({{"msg":"follow_read_failed","path":"{}","error":"{}"}})",
+                         file.path, std::strerror(errno));
+            break;
+        }
+        if (n == 0) break;
+
+        std::string_view data(chunk.data(), static_cast<size_t>(n));
+        off_t base = read_at;
+        read_at += n;
+
+        size_t pos = 0;
+        while (pos < data.size()) {
+            size_t newline = data.find('\n', pos);
+            if (newline == std::string_view::npos) {
+                if (!file.skipping) {
+                    partial.append(data.substr(pos));
+                    if (partial.size() > config_.max_line_bytes) {
+                        spdlog::warn(R"({{"msg":"follow_line_too_long","path":"{}","offset":{}}})",
+                                    file.path, consumed);
+                        partial.clear();
+                        file.skipping = true;
+                        skipped++;
+                    }
+                }
+                if (file.skipping) consumed = read_at;
+                break;
+            }
+
+            if (file.skipping) {
+                file.skipping = false;
+            } else if (partial.empty()) {
+                handle_line(data.substr(pos, newline - pos));
+            } else {
+                partial.append(data.substr(pos, newline - pos));
+                handle_line(partial);
+                partial.clear();
+            }
+
+            pos = newline + 1;
+            consumed = base + static_cast<off_t>(pos);
+            if (batch.size() >= config_.batch_size) {
+                deliver(file, batch, consumed, callback);
+            }
+        }
+    }
+
+    // A rotated-away file will not grow further; its last line may lack "\n"
+    if (final && !partial.empty()) {
+        handle_line(partial);
+        consumed = read_at;
+    }
+
+    if (skipped > 0) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.skipped += skipped;
+    }
+    deliver(file, batch, consumed, callback);
+}
+
+void FileFollower::deliver(Tracked& file, std::vector<json>& batch, off_t offset,
+                           const EventCallback& callback) {
+    if (!batch.empty()) {
+        if (callback) callback(batch);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.events += batch.size();
+        }
+        batch.clear();
+    } else if (offset == file.offset) {
+        return;
+    }
+
+    file.offset = offset;
+    save_checkpoints();
+}
+
+void FileFollower::save_checkpoints() const {
+    // A rotated file still being drained comes first and stands in for its
+    // path, so a crash mid-drain resumes it rather than the new file
+    json files = json::array();
+    std::set<std::string> seen;
+    for (const auto& file : files_) {
+        if (file.inode == 0 || !seen.insert(file.path).second) continue;
+        files.push_back({{"path", file.path}, {"inode", file.inode}, {"offset", file.offset}});
+    }
+
+    // Atomic against crashes of this process; not fsynced, since a lost
+    // checkpoint only causes replay
+    std::string tmp = config_.checkpoint_file + ".tmp";
+    try {
+        auto dir = fs::path(config_.checkpoint_file).parent_path();
+        if (!dir.empty()) fs::create_directories(dir);
+
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            out << json{{"files", files}}.dump();
+            if (!out) throw std::runtime_error("write failed");
+        }
+        fs::rename(tmp, config_.checkpoint_file);
+    } catch (const std::exception& e) {
+        spdlog::warn(R"({{"msg":"follow_checkpoint_failed","path":"{}","error":"{}"}})",
+                    config_.checkpoint_file, e.what());
+    }
+}
+
+} // namespace siem::ingest
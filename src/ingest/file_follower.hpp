@@ -0,0 +1,115 @@
+#pragma once
+
+#include "ingest/file_ingestor.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+
+namespace siem::ingest {
+
+/**
+ * Follows NDJSON log files as collectors append to them (tail -F)
+ * - inotify on each file's directory wakes the reader on appends, creates
+ *   and renames; a periodic rescan covers missed events and missing dirs
+ * - Only the byte range past the last delivered line is read (pread)
+ * - Rotation (path now names a new inode) drains the old file to EOF
+ *   before switching; truncation in place restarts at offset 0
+ * - After each delivered batch the per-file (inode, offset) checkpoint is
+ *   written atomically (tmp + rename), as is the offset start_at_end skips
+ *   to. On restart a file whose inode still matches resumes at its offset,
+ *   unless it is now shorter (truncated, or the inode was reused), which
+ *   restarts at 0; if it was rotated meanwhile, the old inode is looked up
+ *   in the same directory and drained first.
+ * Delivery is at-least-once: a crash between the callback returning and
+ * the checkpoint rename replays that one batch.
+ */
+class FileFollower {
+public:
+    using EventCallback = FileIngestor::EventCallback;
+
+    struct Config {
+        std::vector<std::string> paths;
+        std::string checkpoint_file = "data/follow_checkpoints.json";
+        size_t batch_size = 1000;         // Max events per callback invocation
+        size_t read_chunk = 1 << 20;      // Bytes per pread
+        size_t max_line_bytes = 1 << 20;  // Longer lines are skipped
+        int rescan_ms = 1000;             // Poll interval when inotify is quiet
+        bool start_at_end = false;        // Files without a checkpoint: skip existing content
+        FileIngestor::SkipHandler on_skipped;  // Malformed and non-object lines, on the follow thread
+    };
+
+    struct Stats {
+        size_t events = 0;
+        size_t skipped = 0;               // Malformed, non-object or oversized lines
+        size_t rotations = 0;
+        size_t truncations = 0;
+    };
+
+    explicit FileFollower(Config config);
+    ~FileFollower();
+
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+
+    /**
+     * Restore checkpoints and start the follow thread
+     * Throws if the checkpoint file exists but cannot be parsed
+     */
+    void start(EventCallback callback);
+
+    /**
+     * Stop following; checkpoints are already persisted per batch
+     */
+    void stop();
+
+    bool is_running() const { return running_.load(); }
+
+    /**
+     * Read and deliver everything appended since the last scan, handling
+     * rotation and truncation. Called by the follow thread; callable
+     * directly (without start) for one-shot catch-up.
+     */
+    void scan(const EventCallback& callback);
+
+    Stats stats() const;
+
+private:
+    struct Tracked {
+        std::string path;
+        int fd = -1;
+        ino_t inode = 0;
+        off_t offset = 0;        // File offset just past the last consumed line
+        bool skipping = false;   // Inside an oversized line; discard to next newline
+        bool rotated = false;    // Old inode found at restore; drain to EOF, then drop
+    };
+
+    Config config_;
+    std::vector<Tracked> files_;
+    std::mutex mutex_;           // Serialises scans and checkpoint writes
+    bool restored_ = false;
+
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> thread_;
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;           // eventfd used by stop() to interrupt poll
+
+    mutable std::mutex stats_mutex_;
+    Stats stats_;
+
+    void restore();
+    void follow_loop(EventCallback callback);
+    void watch_directories();
+
+    void open_current(Tracked& file, bool from_end);
+    void close(Tracked& file);
+    void drain(Tracked& file, const EventCallback& callback, bool final);
+    void deliver(Tracked& file, std::vector<json>& batch, off_t offset, const EventCallback& callback);
+    void save_checkpoints() const;
+};
+
+} // namespace siem::ingest
@@ -1,56 +1,278 @@
 #include "ingest/file_ingestor.hpp"
+#include "ingest/mapped_file.hpp"
+#include "ingest/cef_parser.hpp"
 #include <spdlog/spdlog.h>
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
 
 namespace siem::ingest {
 
-void FileIngestor::ingest_file(const std::string& filepath, EventCallback callback) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        spdlog::error(R"({{"msg":"file_open_failed","path":"{}"}})", filepath);
-        throw std::runtime_error("Failed to open file: " + filepath);
-    }
-    
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string content = buffer.str();
-    
+FileIngestor::FileIngestor(Config config) : config_(config) {
+    config_.batch_size = std::max<size_t>(config_.batch_size, 1);
+    config_.window_bytes = std::max<size_t>(config_.window_bytes, 1);
+}
+
+FileIngestor::IngestStats FileIngestor::ingest_file(const std::string& filepath, EventCallback callback,
+                                                    ParsedCallback parsed_callback) {
+    std::vector<json> batch;
+    batch.reserve(config_.batch_size);
+    std::vector<storage::Event> parsed;
+
+    ParsedSink parsed_sink;
+    if (parsed_callback) {
+        parsed_sink = [&](storage::Event&& event) {
+            parsed.push_back(std::move(event));
+            if (parsed.size() >= config_.batch_size) {
+                parsed_callback(parsed);
+                parsed.clear();
+            }
+        };
+    }
+
+    IngestStats stats;
     try {
-        auto events = parse_json(content);
-        if (!events.empty()) {
-            process_batch(events, callback);
-            spdlog::info(R"({{"msg":"file_ingested","path":"{}","count":{}}})", 
-                        filepath, events.size());
-        }
+        stats = read_file(filepath, [&](json&& event) {
+            batch.push_back(std::move(event));
+            if (batch.size() >= config_.batch_size) {
+                process_batch(batch, callback);
+                batch.clear();
+            }
+        }, parsed_sink);
+        process_batch(batch, callback);
+        if (!parsed.empty()) parsed_callback(parsed);
     } catch (const std::exception& e) {
-        spdlog::error(R"({{"msg":"file_parse_error","path":"{}","error":"{}"}})", 
+        spdlog::error(R"({{"msg":"file_ingest_error","path":"{}","error":"{}"}})",
                      filepath, e.what());
         throw;
     }
+
+    if (stats.events > 0 || stats.skipped > 0) {
+        spdlog::info(R"({{"msg":"file_ingested","path":"{}","count":{},"skipped":{},"bytes":{}}})",
+                    filepath, stats.events, stats.skipped, stats.bytes);
+    }
+    return stats;
+}
+
+FileIngestor::IngestStats FileIngestor::read_file(const std::string& filepath,
+                                                  const EventStreamParser::EventSink& sink,
+                                                  const ParsedSink& parsed_sink) const {
+    Format format = resolve_format(filepath);
+    if (format == Format::Cef && !parsed_sink) {
+        throw std::invalid_argument("CEF / LEEF input needs a parsed-event sink");
+    }
+    if (format == Format::Text && !config_.grok) {
+        throw std::invalid_argument("Text input needs grok patterns");
+    }
+
+    MappedFile file(filepath);
+    std::string_view content = file.view();
+
+    IngestStats stats;
+    stats.bytes = content.size();
+
+    // Only when the caller finishes parsed events; otherwise it wants raw JSON
+    bool simd = config_.simd && parsed_sink;
+    if (format == Format::Json) {
+        stats.events = simd ? config_.simd->parse_document(content, parsed_sink, [&](std::string_view element, const char* reason) {
+                                  stats.skipped++;
+                                  if (config_.on_skipped) config_.on_skipped(element, reason);
+                              })
+                            : EventStreamParser::parse(content, sink, EventStreamParser::Root::ArrayOrObject);
+        return stats;
+    }
+
+    // Parse a window at a time, cut at a line boundary, and release the
+    // pages behind it once its events have been materialised
+    size_t offset = 0;
+    while (offset < content.size()) {
+        size_t end = content.size();
+        if (end - offset > config_.window_bytes) {
+            size_t newline = content.rfind('\n', offset + config_.window_bytes);
+            end = newline != std::string_view::npos && newline >= offset
+                ? newline + 1
+                : content.find('\n', offset + config_.window_bytes);
+            if (end == std::string_view::npos) end = content.size();
+        }
+
+        std::string_view lines = content.substr(offset, end - offset);
+        auto window = format == Format::Cef ? parse_cef(lines, parsed_sink)
+                    : format == Format::Text ? parse_text(lines, sink)
+                    : simd ? parse_ndjson_events(lines, parsed_sink)
+                    : parse_ndjson(lines, sink);
+        stats.events += window.events;
+        stats.skipped += window.skipped;
+
+        offset = end;
+        file.release(offset);
+    }
+    return stats;
 }
 
 std::vector<json> FileIngestor::parse_json(const std::string& json_str) {
     std::vector<json> events;
-    
+    parse_json(json_str, [&events](json&& event) {
+        events.push_back(std::move(event));
+    });
+    return events;
+}
+
+size_t FileIngestor::parse_json(std::string_view json_str, const EventStreamParser::EventSink& sink) {
     try {
-        auto parsed = json::parse(json_str);
-        
-        if (parsed.is_array()) {
-            for (const auto& item : parsed) {
-                if (item.is_object()) {
-                    events.push_back(item);
-                }
-            }
-        } else if (parsed.is_object()) {
-            events.push_back(parsed);
-        }
-    } catch (const json::exception& e) {
+        return EventStreamParser::parse(json_str, sink, EventStreamParser::Root::ArrayOrObject);
+    } catch (const std::exception& e) {
         spdlog::error(R"({{"msg":"json_parse_error","error":"{}"}})", e.what());
         throw;
     }
-    
-    return events;
+}
+
+FileIngestor::IngestStats FileIngestor::parse_ndjson(std::string_view input,
+                                                     const EventStreamParser::EventSink& sink) const {
+    IngestStats stats;
+    stats.bytes = input.size();
+
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t newline = input.find('\n', pos);
+        size_t end = newline == std::string_view::npos ? input.size() : newline;
+        std::string_view line = input.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) continue;
+        line.remove_prefix(first);
+
+        json event = json::parse(line.begin(), line.end(), nullptr, false);
+        if (!event.is_object()) {
+            const char* reason = event.is_discarded() ? "malformed" : "not_object";
+            if (stats.skipped++ == 0) {
+                spdlog::warn(R"({{"msg":"ndjson_line_skipped","reason":"{}"}})", reason);
+            }
+            if (config_.on_skipped) config_.on_skipped(line, reason);
+            continue;
+        }
+
+        sink(std::move(event));
+        stats.events++;
+    }
+
+    return stats;
+}
+
+FileIngestor::IngestStats FileIngestor::parse_ndjson_events(std::string_view input, const ParsedSink& sink) const {
+    IngestStats stats;
+    stats.bytes = input.size();
+
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t newline = input.find('\n', pos);
+        size_t end = newline == std::string_view::npos ? input.size() : newline;
+        std::string_view line = input.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos) continue;
+        line.remove_prefix(first);
+
+        storage::Event event;
+        try {
+            event = config_.simd->parse(line);
+        } catch (const std::exception& e) {
+            if (stats.skipped++ == 0) {
+                spdlog::warn(R"({{"msg":"ndjson_line_skipped","reason":"{}"}})", e.what());
+            }
+            if (config_.on_skipped) config_.on_skipped(line, line.front() == '{' ? "malformed" : "not_object");
+            continue;
+        }
+
+        sink(std::move(event));
+        stats.events++;
+    }
+
+    return stats;
+}
+
+FileIngestor::IngestStats FileIngestor::parse_cef(std::string_view input, const ParsedSink& sink) const {
+    static const storage::Symbol unknown("unknown");
+    storage::Symbol source(config_.cef_source);
+    auto now = std::chrono::system_clock::now();
+
+    IngestStats stats;
+    stats.bytes = input.size();
+
+    CefMessage message;
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t newline = input.find('\n', pos);
+        size_t end = newline == std::string_view::npos ? input.size() : newline;
+        std::string_view line = input.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
+
+        if (!CefParser::parse(line, message)) {
+            if (stats.skipped++ == 0) {
+                spdlog::warn(R"({{"msg":"cef_line_skipped","reason":"no_header"}})");
+            }
+            continue;
+        }
+
+        storage::Event event;
+        event.source = source;
+        event.host = unknown;
+        event.ts = now;
+        CefParser::to_event(message, event, config_.cef_keep_unknown);
+
+        sink(std::move(event));
+        stats.events++;
+    }
+
+    return stats;
+}
+
+FileIngestor::IngestStats FileIngestor::parse_text(std::string_view input,
+                                                   const EventStreamParser::EventSink& sink) const {
+    IngestStats stats;
+    stats.bytes = input.size();
+
+    size_t pos = 0;
+    while (pos < input.size()) {
+        size_t newline = input.find('\n', pos);
+        size_t end = newline == std::string_view::npos ? input.size() : newline;
+        std::string_view line = input.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (line.ends_with('\r')) line.remove_suffix(1);
+        if (line.find_first_not_of(" \t") == std::string_view::npos) continue;
+
+        json event = {{"source", config_.text_source}, {"message", line}};
+        if (!config_.grok->match(line, event)) {
+            if (stats.skipped++ == 0) {
+                spdlog::warn(R"({{"msg":"text_line_skipped","reason":"no_pattern"}})");
+            }
+            continue;
+        }
+
+        sink(std::move(event));
+        stats.events++;
+    }
+
+    return stats;
+}
+
+FileIngestor::Format FileIngestor::resolve_format(const std::string& filepath) const {
+    if (config_.format != Format::Auto) return config_.format;
+
+    auto dot = filepath.rfind('.');
+    if (dot != std::string::npos) {
+        std::string ext = filepath.substr(dot + 1);
+        std::transform(ext.begin(), ext.end(), ext.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (ext == "ndjson" || ext == "jsonl") return Format::Ndjson;
+        if (ext == "cef" || ext == "leef") return Format::Cef;
+        if ((ext == "log" || ext == "txt") && config_.grok) return Format::Text;
+    }
+    return Format::Json;
 }
 
 void FileIngestor::process_batch(const std::vector<json>& batch, EventCallback callback) {
@@ -60,4 +282,3 @@ void FileIngestor::process_batch(const std::vector<json>& batch, EventCallback c
 }
 
 } // namespace siem::ingest
-
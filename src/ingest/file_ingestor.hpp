@@ -1,7 +1,12 @@
 #pragma once
 
 #include "storage/schemas.hpp"
+#include "ingest/event_stream.hpp"
+#include "ingest/grok_matcher.hpp"
+#include "core/simd_normalizer.hpp"
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 
@@ -10,28 +15,115 @@ namespace siem::ingest {
 using json = nlohmann::json;
 
 /**
- * Ingests events from JSON files or streams
+ * Ingests events from JSON / NDJSON / CEF / LEEF / free-text files or streams
+ * Files are memory-mapped and parsed in place; events reach the callback
+ * in batches of batch_size, so memory stays flat regardless of file size.
+ * CEF / LEEF lines are parsed straight into events (see CefParser) and go
+ * to a separate parsed-event callback, bypassing JSON. Free-text lines
+ * become raw events through the configured grok patterns. With a simd
+ * normalizer, JSON / NDJSON files take the parsed-event route too.
  */
 class FileIngestor {
 public:
     using EventCallback = std::function<void(const std::vector<json>&)>;
+    using ParsedCallback = std::function<void(std::vector<storage::Event>&)>;
+    using ParsedSink = std::function<void(storage::Event&&)>;
+    // A skipped NDJSON line (or simd JSON array element) and why ("malformed" / "not_object")
+    using SkipHandler = std::function<void(std::string_view line, const char* reason)>;
+
+    enum class Format {
+        Auto,       // .ndjson / .jsonl -> Ndjson, .cef / .leef -> Cef, .log / .txt -> Text
+                    // when grok is set, anything else -> Json
+        Json,       // Single object or array of objects
+        Ndjson,     // One object per line
+        Cef,        // One CEF or LEEF record per line
+        Text        // One free-text line per event, parsed with grok
+    };
+
+    struct Config {
+        size_t batch_size = 1000;     // Events per callback invocation
+        Format format = Format::Auto;
+        size_t window_bytes = 16 << 20; // NDJSON / CEF pages released after each window
+        std::string cef_source = "cef"; // Event "source" for CEF / LEEF lines
+        bool cef_keep_unknown = true;   // Unmapped CEF / LEEF keys go to features.extra
+        std::shared_ptr<const GrokMatcher> grok;  // Patterns for Text lines
+        std::string text_source = "app";          // Event "source" unless the pattern sets one
+        std::shared_ptr<const core::SimdEventNormalizer> simd;  // JSON / NDJSON to parsed events, no DOM
+        SkipHandler on_skipped;       // Keeps the bytes of skipped NDJSON lines and simd array elements; may run on several threads
+    };
+
+    struct IngestStats {
+        size_t events = 0;
+        size_t skipped = 0;           // NDJSON / CEF / text lines that are malformed or match nothing, simd non-object elements
+        size_t bytes = 0;
+    };
 
     FileIngestor() = default;
+    explicit FileIngestor(Config config);
+
+    /**
+     * Ingest events from a JSON or NDJSON file
+     * Events are streamed to callback in batches of batch_size. A malformed
+     * JSON document throws; malformed NDJSON / CEF lines are skipped and
+     * counted. CEF / LEEF files need a parsed callback, text files grok.
+     */
+    IngestStats ingest_file(const std::string& filepath, EventCallback callback,
+                            ParsedCallback parsed_callback = {});
 
     /**
-     * Ingest events from JSON file
-     * Supports both single object and array of objects
+     * Parse a file, emitting one event at a time
+     * Same format rules and errors as ingest_file, without batching or
+     * logging; safe to call from several threads at once. CEF / LEEF files
+     * throw std::invalid_argument when parsed_sink is empty, text files
+     * when no grok patterns are configured.
      */
-    void ingest_file(const std::string& filepath, EventCallback callback);
+    IngestStats read_file(const std::string& filepath, const EventStreamParser::EventSink& sink,
+                          const ParsedSink& parsed_sink = {}) const;
 
     /**
      * Parse JSON string and extract events
      */
     std::vector<json> parse_json(const std::string& json_str);
 
+    /**
+     * Stream-parse JSON string, emitting one event at a time
+     * Returns number of events emitted
+     */
+    size_t parse_json(std::string_view json_str, const EventStreamParser::EventSink& sink);
+
+    /**
+     * Parse newline-delimited JSON in place, emitting one event per object line
+     * Blank lines are ignored and CRLF line endings are accepted; other
+     * lines that are not objects are counted and passed to on_skipped
+     */
+    IngestStats parse_ndjson(std::string_view input, const EventStreamParser::EventSink& sink) const;
+
+    /**
+     * parse_ndjson through the simd normalizer: object lines become events
+     * still to be finished with EventNormalizer::finalize
+     */
+    IngestStats parse_ndjson_events(std::string_view input, const ParsedSink& sink) const;
+
+    /**
+     * Parse CEF / LEEF lines in place, emitting one event per record, still
+     * to be finished with EventNormalizer::finalize; host and ts default to
+     * "unknown" and now when the record has none
+     */
+    IngestStats parse_cef(std::string_view input, const ParsedSink& sink) const;
+
+    /**
+     * Match free-text lines against the grok patterns, emitting a raw event
+     * {"source", "message", captures...} per matching line; lines no
+     * pattern matches are skipped and counted
+     */
+    IngestStats parse_text(std::string_view input, const EventStreamParser::EventSink& sink) const;
+
 private:
+    Config config_;
+
+    Format resolve_format(const std::string& filepath) const;
+
     void process_batch(const std::vector<json>& batch, EventCallback callback);
 };
 
 } // namespace siem::ingest
-
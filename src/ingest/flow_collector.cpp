@@ -0,0 +1,102 @@
+#include "ingest/flow_collector.hpp"
+#include <spdlog/spdlog.h>
+#include <boost/asio/post.hpp>
+
+namespace siem::ingest {
+
+FlowCollector::FlowCollector(Config config)
+    : config_(std::move(config)),
+      decoder_(FlowDecoder::Config{config_.source, config_.max_templates}) {
+    config_.batch_size = std::max<size_t>(config_.batch_size, 1);
+    config_.flush_ms = std::max(config_.flush_ms, 1);
+}
+
+FlowCollector::~FlowCollector() {
+    stop();
+}
+
+void FlowCollector::start(EventCallback callback) {
+    if (thread_) {
+        spdlog::warn(R"({{"msg":"netflow_already_running"}})");
+        return;
+    }
+    callback_ = std::move(callback);
+    batch_.reserve(config_.batch_size);
+
+    udp::endpoint endpoint(net::ip::make_address(config_.bind_address), config_.port);
+    UdpReceiver::Config udp_config{config_.recv_batch, 65535, config_.receive_buffer_bytes};
+    udp_ = std::make_unique<UdpReceiver>(ioc_, endpoint, udp_config,
+        [this](std::string_view packet, const sockaddr_storage& from) { handle_packet(packet, from); });
+    bound_port_ = udp_->port();
+
+    flush_timer_ = std::make_unique<net::steady_timer>(ioc_);
+    schedule_flush();
+
+    thread_ = std::make_unique<std::thread>([this]() { ioc_.run(); });
+
+    spdlog::info(R"({{"msg":"netflow_started","port":{}}})", bound_port_);
+}
+
+void FlowCollector::stop() {
+    if (!thread_) return;
+
+    net::post(ioc_, [this]() {
+        flush();
+        ioc_.stop();
+    });
+    if (thread_->joinable()) thread_->join();
+    thread_.reset();
+
+    if (udp_) udp_->close();
+
+    spdlog::info(R"({{"msg":"netflow_stopped"}})");
+}
+
+FlowCollector::Stats FlowCollector::stats() const {
+    return Stats{packets_.load(), records_.load(), malformed_.load(), missing_template_.load(), templates_.load(),
+                 evicted_templates_.load()};
+}
+
+void FlowCollector::handle_packet(std::string_view packet, const sockaddr_storage& from) {
+    packets_++;
+
+    // Not interned: the source address is whatever the sender claims
+    char address[INET6_ADDRSTRLEN];
+    std::string_view exporter = UdpReceiver::format_address(from, address);
+
+    auto result = decoder_.decode(packet, exporter, batch_);
+
+    records_ += result.records;
+    missing_template_ += result.missing_template;
+    evicted_templates_ += result.evicted;
+    templates_.store(decoder_.template_count());
+    if (result.malformed) {
+        malformed_++;
+        spdlog::debug(R"({{"msg":"netflow_malformed_packet","exporter":"{}","bytes":{}}})",
+                     exporter, packet.size());
+    }
+
+    if (batch_.size() >= config_.batch_size) flush();
+}
+
+void FlowCollector::schedule_flush() {
+    flush_timer_->expires_after(std::chrono::milliseconds(config_.flush_ms));
+    flush_timer_->async_wait([this](boost::system::error_code ec) {
+        if (ec) return;
+        flush();
+        schedule_flush();
+    });
+}
+
+void FlowCollector::flush() {
+    if (batch_.empty()) return;
+
+    try {
+        if (callback_) callback_(batch_);
+    } catch (const std::exception& e) {
+        spdlog::error(R"({{"msg":"netflow_delivery_failed","events":{},"error":"{}"}})", batch_.size(), e.what());
+    }
+    batch_.clear();
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ingest/flow_decoder.hpp"
+#include "ingest/udp_receiver.hpp"
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace siem::ingest {
+
+/**
+ * UDP NetFlow v9 / IPFIX collector
+ * Both versions share one port. Export packets are decoded straight into
+ * events (see FlowDecoder) and handed to the callback in batches of up to
+ * batch_size, or every flush_ms; the receiver finishes them with
+ * EventNormalizer::finalize. Everything runs on one io thread, including
+ * the callback.
+ */
+class FlowCollector {
+public:
+    using EventCallback = std::function<void(std::vector<storage::Event>&)>;
+
+    struct Config {
+        std::string bind_address = "0.0.0.0";
+        unsigned short port = 2055;        // 0 = ephemeral (see port())
+        std::string source = "netflow";    // Event "source"
+        size_t batch_size = 4096;
+        int flush_ms = 200;
+        size_t recv_batch = 64;            // Datagrams per recvmmsg call
+        int receive_buffer_bytes = 8 << 20;  // Absorbs export bursts; capped by net.core.rmem_max
+        size_t max_templates = 4096;
+    };
+
+    struct Stats {
+        uint64_t packets = 0;
+        uint64_t records = 0;
+        uint64_t malformed = 0;            // Packets with a bad header or set
+        uint64_t missing_template = 0;     // Data sets dropped before their template arrived
+        uint64_t templates = 0;            // Currently cached
+        uint64_t evicted_templates = 0;    // Dropped, least recently used first, to stay within max_templates
+    };
+
+    explicit FlowCollector(Config config);
+    ~FlowCollector();
+
+    FlowCollector(const FlowCollector&) = delete;
+    FlowCollector& operator=(const FlowCollector&) = delete;
+
+    /**
+     * Bind the socket and start the io thread; throws if binding fails
+     */
+    void start(EventCallback callback);
+
+    /**
+     * Deliver any pending batch, then stop
+     */
+    void stop();
+
+    unsigned short port() const { return bound_port_; }
+
+    Stats stats() const;
+
+private:
+    Config config_;
+    FlowDecoder decoder_;
+    EventCallback callback_;
+    std::vector<storage::Event> batch_;
+
+    std::atomic<uint64_t> packets_{0};
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> missing_template_{0};
+    std::atomic<uint64_t> templates_{0};
+    std::atomic<uint64_t> evicted_templates_{0};
+
+    // Declared after everything pending handlers may touch when destroyed
+    net::io_context ioc_;
+    std::unique_ptr<UdpReceiver> udp_;
+    std::unique_ptr<net::steady_timer> flush_timer_;
+    std::unique_ptr<std::thread> thread_;
+    unsigned short bound_port_ = 0;
+
+    void handle_packet(std::string_view packet, const sockaddr_storage& from);
+    void schedule_flush();
+    void flush();
+};
+
+} // namespace siem::ingest
@@ -0,0 +1,377 @@
+#include "ingest/flow_decoder.hpp"
+#include <chrono>
+#include <cstring>
+#include <optional>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+namespace siem::ingest {
+
+namespace {
+
+constexpr uint16_t kNetflowV9 = 9;
+constexpr uint16_t kIpfix = 10;
+constexpr uint16_t kFirstDataSetId = 256;
+
+// Latest end time a timestamp_t can hold (nanosecond clocks stop in 2262);
+// anything later is treated as absent rather than overflowing
+constexpr uint64_t kMaxTimestampMs = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::milliseconds>(storage::timestamp_t::duration::max()).count());
+
+uint16_t be16(std::string_view data, size_t at) {
+    auto b = reinterpret_cast<const unsigned char*>(data.data()) + at;
+    return static_cast<uint16_t>((b[0] << 8) | b[1]);
+}
+
+uint32_t be32(std::string_view data, size_t at) {
+    auto b = reinterpret_cast<const unsigned char*>(data.data()) + at;
+    return (uint32_t{b[0]} << 24) | (uint32_t{b[1]} << 16) | (uint32_t{b[2]} << 8) | b[3];
+}
+
+/**
+ * Unsigned big-endian value of 1-8 bytes (reduced-size encoding)
+ */
+uint64_t read_uint(const unsigned char* b, size_t length) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < length; ++i) value = (value << 8) | b[i];
+    return value;
+}
+
+/**
+ * Values of one flow record; absent fields stay zero / unset
+ */
+struct FlowValues {
+    std::optional<uint64_t> bytes;
+    std::optional<uint64_t> packets;
+    int proto = -1;
+    std::optional<uint16_t> sport;
+    std::optional<uint16_t> dport;
+    int src_family = AF_UNSPEC;
+    int dst_family = AF_UNSPEC;
+    unsigned char src[16];
+    unsigned char dst[16];
+    std::optional<uint32_t> end_uptime;
+    int64_t end_ms = 0;
+};
+
+/**
+ * Dotted-quad or RFC 5952 text; IPv4 is formatted by hand since
+ * inet_ntop's locale-independent path is several times slower
+ */
+std::string_view format_address(int family, const unsigned char* addr, char (&out)[INET6_ADDRSTRLEN]) {
+    if (family == AF_INET6) {
+        if (::inet_ntop(AF_INET6, addr, out, sizeof(out)) == nullptr) return {};
+        return out;
+    }
+
+    char* p = out;
+    for (int i = 0; i < 4; ++i) {
+        unsigned octet = addr[i];
+        if (octet >= 100) *p++ = static_cast<char>('0' + octet / 100);
+        if (octet >= 10) *p++ = static_cast<char>('0' + octet / 10 % 10);
+        *p++ = static_cast<char>('0' + octet % 10);
+        if (i < 3) *p++ = '.';
+    }
+    return std::string_view(out, static_cast<size_t>(p - out));
+}
+
+} // namespace
+
+size_t FlowDecoder::DomainKeyHash::operator()(const DomainKey& key) const noexcept {
+    uint64_t h = std::hash<std::string>{}(key.exporter);
+    h ^= (uint64_t{key.domain} << 16 | key.version) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h ^ (h >> 29));
+}
+
+FlowDecoder::FlowDecoder() : FlowDecoder(Config{}) {}
+
+FlowDecoder::FlowDecoder(Config config)
+    : config_(std::move(config)), source_(config_.source) {}
+
+FlowDecoder::Target FlowDecoder::target_for(uint16_t element_id, uint16_t length, bool enterprise) {
+    if (enterprise || length == kVariableLength) return Target::Skip;
+
+    bool integer = length >= 1 && length <= 8;
+    switch (element_id) {
+        case 1: return integer ? Target::Bytes : Target::Skip;      // octetDeltaCount / IN_BYTES
+        case 2: return integer ? Target::Packets : Target::Skip;    // packetDeltaCount / IN_PKTS
+        case 4: return length == 1 ? Target::Proto : Target::Skip;  // protocolIdentifier
+        case 7: return length == 2 ? Target::SrcPort : Target::Skip;
+        case 11: return length == 2 ? Target::DstPort : Target::Skip;
+        case 8: return length == 4 ? Target::SrcV4 : Target::Skip;
+        case 12: return length == 4 ? Target::DstV4 : Target::Skip;
+        case 27: return length == 16 ? Target::SrcV6 : Target::Skip;
+        case 28: return length == 16 ? Target::DstV6 : Target::Skip;
+        case 21: return length == 4 ? Target::EndUptime : Target::Skip;    // LAST_SWITCHED
+        case 151: return integer ? Target::EndSeconds : Target::Skip;      // flowEndSeconds
+        case 153: return integer ? Target::EndMillis : Target::Skip;       // flowEndMilliseconds
+        default: return Target::Skip;
+    }
+}
+
+FlowDecoder::Result FlowDecoder::decode(std::string_view packet, std::string_view exporter,
+                                        std::vector<storage::Event>& out) {
+    Result result;
+    if (packet.size() < 4) {
+        result.malformed = true;
+        return result;
+    }
+
+    Header header{be16(packet, 0), 0, 0, 0};
+    size_t pos = 0;
+    if (header.version == kNetflowV9 && packet.size() >= 20) {
+        // version, count, sysUptime, unix_secs, sequence, source id
+        header.uptime_ms = be32(packet, 4);
+        header.export_ms = int64_t{be32(packet, 8)} * 1000;
+        header.domain = be32(packet, 16);
+        pos = 20;
+    } else if (header.version == kIpfix && packet.size() >= 16 &&
+               be16(packet, 2) >= 16 && be16(packet, 2) <= packet.size()) {
+        // version, length, export time, sequence, observation domain
+        packet = packet.substr(0, be16(packet, 2));
+        header.export_ms = int64_t{be32(packet, 4)} * 1000;
+        header.domain = be32(packet, 12);
+        pos = 16;
+    } else {
+        result.malformed = true;
+        return result;
+    }
+
+    uint16_t template_set = header.version == kIpfix ? 2 : 0;
+    uint16_t options_set = header.version == kIpfix ? 3 : 1;
+
+    lookup_.exporter.assign(exporter);
+    lookup_.domain = header.domain;
+    lookup_.version = header.version;
+    auto domain = domains_.find(lookup_);
+    if (domain != domains_.end()) {
+        recent_.splice(recent_.begin(), recent_, domain->second.recent);
+    }
+
+    // v9 may pad the packet after the last flowset; a short tail is not an error
+    while (packet.size() - pos >= 4) {
+        uint16_t set_id = be16(packet, pos);
+        uint16_t set_length = be16(packet, pos + 2);
+        if (set_length < 4 || set_length > packet.size() - pos) {
+            result.malformed = true;
+            break;
+        }
+        std::string_view set = packet.substr(pos + 4, set_length - 4);
+        pos += set_length;
+
+        bool ok = true;
+        if (set_id == template_set || set_id == options_set) {
+            ok = parse_templates(set, header, domain, set_id == options_set, result);
+        } else if (set_id >= kFirstDataSetId) {
+            const Template* tmpl = find_template(domain, set_id);
+            if (tmpl == nullptr) {
+                result.missing_template++;
+            } else {
+                ok = decode_records(set, *tmpl, header, domain->second, out, result);
+            }
+        }
+        if (!ok) {
+            result.malformed = true;
+            break;
+        }
+    }
+    return result;
+}
+
+FlowDecoder::Template* FlowDecoder::find_template(Domains::iterator domain, uint16_t id) {
+    if (domain == domains_.end()) return nullptr;
+    auto it = domain->second.templates.find(id);
+    return it != domain->second.templates.end() ? &it->second : nullptr;
+}
+
+FlowDecoder::Domains::iterator FlowDecoder::add_domain() {
+    auto domain = domains_.emplace(lookup_, Domain{}).first;
+    recent_.push_front(&domain->first);
+    domain->second.recent = recent_.begin();
+    return domain;
+}
+
+void FlowDecoder::erase_domain(Domains::iterator domain) {
+    template_count_ -= domain->second.templates.size();
+    recent_.erase(domain->second.recent);
+    domains_.erase(domain);
+}
+
+void FlowDecoder::make_room(Domains::iterator keep, Result& result) {
+    // Whole domains, least recently used first; an exporter that alone
+    // fills the cache keeps what it has
+    while (template_count_ >= config_.max_templates && !recent_.empty()) {
+        auto oldest = domains_.find(*recent_.back());
+        if (oldest == keep) break;
+        result.evicted += oldest->second.templates.size();
+        erase_domain(oldest);
+    }
+}
+
+bool FlowDecoder::parse_templates(std::string_view set, const Header& header, Domains::iterator& domain,
+                                  bool options, Result& result) {
+    bool ipfix = header.version == kIpfix;
+    size_t header_bytes = options ? 6 : 4;
+    size_t pos = 0;
+
+    while (set.size() - pos >= header_bytes) {
+        uint16_t id = be16(set, pos);
+        if (id == 0) break;  // Padding
+
+        // v9 options templates give scope and option lengths in bytes
+        size_t field_count = be16(set, pos + 2);
+        if (options && !ipfix) field_count = (size_t{be16(set, pos + 2)} + be16(set, pos + 4)) / 4;
+        pos += header_bytes;
+
+        if (ipfix && field_count == 0) {
+            // Withdrawal; the set id itself withdraws every template of the domain
+            if (domain != domains_.end()) {
+                auto& templates = domain->second.templates;
+                size_t before = templates.size();
+                if (id == 2 || id == 3) {
+                    std::erase_if(templates, [&](const auto& entry) { return entry.second.options == options; });
+                } else {
+                    templates.erase(id);
+                }
+                template_count_ -= before - templates.size();
+                if (templates.empty()) {
+                    erase_domain(domain);
+                    domain = domains_.end();
+                }
+            }
+            result.templates++;
+            continue;
+        }
+        if (id < kFirstDataSetId) return false;
+
+        Template tmpl;
+        tmpl.options = options;
+        tmpl.fields.reserve(field_count);
+        for (size_t i = 0; i < field_count; ++i) {
+            if (set.size() - pos < 4) return false;
+            uint16_t element = be16(set, pos);
+            uint16_t length = be16(set, pos + 2);
+            pos += 4;
+
+            bool enterprise = ipfix && (element & 0x8000) != 0;
+            if (enterprise) {
+                if (set.size() - pos < 4) return false;
+                pos += 4;
+            }
+            if (length == kVariableLength && !ipfix) return false;
+
+            tmpl.fields.push_back(Field{length, target_for(element & 0x7FFF, length, enterprise)});
+            tmpl.min_record_bytes += length == kVariableLength ? 1 : length;
+        }
+        if (tmpl.min_record_bytes == 0) return false;
+
+        if (Template* existing = find_template(domain, id)) {
+            *existing = std::move(tmpl);
+        } else {
+            make_room(domain, result);
+            if (template_count_ < config_.max_templates) {
+                if (domain == domains_.end()) domain = add_domain();
+                domain->second.templates.emplace(id, std::move(tmpl));
+                template_count_++;
+            }
+        }
+        result.templates++;
+    }
+    return true;
+}
+
+bool FlowDecoder::decode_records(std::string_view set, const Template& tmpl, const Header& header,
+                                 Domain& domain, std::vector<storage::Event>& out, Result& result) {
+    if (tmpl.options) return true;
+    if (domain.host.empty()) domain.host = storage::Symbol(lookup_.exporter);
+
+    auto data = reinterpret_cast<const unsigned char*>(set.data());
+    size_t pos = 0;
+
+    // Trailing bytes shorter than a record are padding
+    while (set.size() - pos >= tmpl.min_record_bytes) {
+        FlowValues v;
+        for (const auto& field : tmpl.fields) {
+            size_t length = field.length;
+            if (length == kVariableLength) {
+                if (pos >= set.size()) return false;
+                length = data[pos++];
+                if (length == 255) {
+                    if (set.size() - pos < 2) return false;
+                    length = be16(set, pos);
+                    pos += 2;
+                }
+            }
+            if (set.size() - pos < length) return false;
+
+            const unsigned char* value = data + pos;
+            pos += length;
+            switch (field.target) {
+                case Target::Skip: break;
+                case Target::Bytes: v.bytes = read_uint(value, length); break;
+                case Target::Packets: v.packets = read_uint(value, length); break;
+                case Target::Proto: v.proto = value[0]; break;
+                case Target::SrcPort: v.sport = static_cast<uint16_t>(read_uint(value, 2)); break;
+                case Target::DstPort: v.dport = static_cast<uint16_t>(read_uint(value, 2)); break;
+                case Target::SrcV4: v.src_family = AF_INET; std::memcpy(v.src, value, 4); break;
+                case Target::DstV4: v.dst_family = AF_INET; std::memcpy(v.dst, value, 4); break;
+                case Target::SrcV6: v.src_family = AF_INET6; std::memcpy(v.src, value, 16); break;
+                case Target::DstV6: v.dst_family = AF_INET6; std::memcpy(v.dst, value, 16); break;
+                case Target::EndUptime: v.end_uptime = static_cast<uint32_t>(read_uint(value, 4)); break;
+                case Target::EndSeconds:
+                    if (uint64_t s = read_uint(value, length); s <= kMaxTimestampMs / 1000) {
+                        v.end_ms = static_cast<int64_t>(s) * 1000;
+                    }
+                    break;
+                case Target::EndMillis:
+                    if (uint64_t ms = read_uint(value, length); ms <= kMaxTimestampMs) {
+                        v.end_ms = static_cast<int64_t>(ms);
+                    }
+                    break;
+            }
+        }
+
+        storage::Event& event = out.emplace_back();
+        event.source = source_;
+        event.host = domain.host;
+
+        int64_t ts_ms = header.export_ms;
+        if (v.end_ms > 0) {
+            ts_ms = v.end_ms;
+        } else if (v.end_uptime) {
+            // sysUptime wraps after ~49.7 days; the flow ended before the export
+            ts_ms -= static_cast<int64_t>(static_cast<uint32_t>(header.uptime_ms - *v.end_uptime));
+        }
+        event.ts = storage::timestamp_t(std::chrono::milliseconds(ts_ms));
+
+        auto& features = event.features;
+        features.verb = storage::Verb::Connect;
+        switch (v.proto) {
+            case -1: break;
+            case 6: features.proto = storage::Proto::Tcp; break;
+            case 17: features.proto = storage::Proto::Udp; break;
+            case 1:
+            case 58: features.proto = storage::Proto::Icmp; break;
+            default: features.set_string("proto", std::to_string(v.proto)); break;
+        }
+        features.sport = v.sport;
+        features.dport = v.dport;
+
+        features.bytes = v.bytes;
+        features.packets = v.packets;
+
+        // Every record can carry new addresses, so they are not interned
+        char address[INET6_ADDRSTRLEN];
+        if (v.src_family != AF_UNSPEC) {
+            features.ip = storage::Symbol::uninterned(format_address(v.src_family, v.src, address));
+        }
+        if (v.dst_family != AF_UNSPEC) {
+            features.dst_ip = storage::Symbol::uninterned(format_address(v.dst_family, v.dst, address));
+        }
+
+        result.records++;
+    }
+    return true;
+}
+
+} // namespace siem::ingest
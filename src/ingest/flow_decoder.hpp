@@ -0,0 +1,124 @@
+#pragma once
+
+#include "storage/schemas.hpp"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace siem::ingest {
+
+/**
+ * NetFlow v9 (RFC 3954) and IPFIX (RFC 7011) export packet decoder
+ * Templates are cached per (exporter address, source id / observation
+ * domain), then template id, and data records are decoded straight into
+ * events:
+ * - features.proto / sport / dport / ip (source address) are filled like a
+ *   normalized event, so EventNormalizer::compute_fingerprint applies as is
+ * - bytes, packets and dst_ip use their typed slots; extra stays null
+ * - ts is the flow end time, else the export time
+ * The cache holds at most max_templates. A new template past that evicts
+ * the least recently used exporter domains whole, so a burst of spoofed
+ * exporters cannot lock out the ones in use. Exporter addresses stay in
+ * the cache; one is interned (as event host) only once it yields a record.
+ * trace_id and fingerprint are left to the caller. Not thread-safe.
+ */
+class FlowDecoder {
+public:
+    struct Config {
+        std::string source = "netflow";   // Event "source"
+        size_t max_templates = 4096;      // Across all exporters; least recently used domains are evicted
+    };
+
+    struct Result {
+        size_t records = 0;               // Events appended
+        size_t templates = 0;             // Template records learned or withdrawn
+        size_t missing_template = 0;      // Data sets skipped because their template is unknown
+        size_t evicted = 0;               // Templates dropped to make room
+        bool malformed = false;           // Decoding stopped at a bad header or set
+    };
+
+    FlowDecoder();
+    explicit FlowDecoder(Config config);
+
+    /**
+     * Decode one export packet from exporter (its address as text),
+     * appending an event per flow record to out; records decoded before a
+     * malformed set are kept
+     */
+    Result decode(std::string_view packet, std::string_view exporter, std::vector<storage::Event>& out);
+
+    size_t template_count() const { return template_count_; }
+
+private:
+    // What a template field is decoded into
+    enum class Target : uint8_t {
+        Skip, Bytes, Packets, Proto, SrcPort, DstPort,
+        SrcV4, DstV4, SrcV6, DstV6, EndUptime, EndSeconds, EndMillis
+    };
+
+    static constexpr uint16_t kVariableLength = 65535;
+
+    struct Field {
+        uint16_t length;                  // kVariableLength: IPFIX variable-length encoding
+        Target target;
+    };
+
+    struct Template {
+        std::vector<Field> fields;
+        size_t min_record_bytes = 0;      // Sum of fixed lengths (variable fields count 1)
+        bool options = false;             // Options records carry no flows and are skipped
+    };
+
+    struct DomainKey {
+        std::string exporter;
+        uint32_t domain;
+        uint16_t version;
+
+        bool operator==(const DomainKey&) const = default;
+    };
+
+    struct DomainKeyHash {
+        size_t operator()(const DomainKey& key) const noexcept;
+    };
+
+    // One exporter's source id / observation domain
+    struct Domain {
+        std::unordered_map<uint16_t, Template> templates;
+        storage::Symbol host;             // Interned when it first yields a record
+        std::list<const DomainKey*>::iterator recent;
+    };
+
+    using Domains = std::unordered_map<DomainKey, Domain, DomainKeyHash>;
+
+    // Export header fields the records are decoded against
+    struct Header {
+        uint16_t version;
+        uint32_t domain;
+        uint32_t uptime_ms;               // v9 only
+        int64_t export_ms;
+    };
+
+    Config config_;
+    storage::Symbol source_;
+    Domains domains_;
+    std::list<const DomainKey*> recent_;  // Most recently used first; keys live in domains_
+    size_t template_count_ = 0;
+    DomainKey lookup_;                    // Reused per packet so lookups don't allocate
+
+    static Target target_for(uint16_t element_id, uint16_t length, bool enterprise);
+
+    bool parse_templates(std::string_view set, const Header& header, Domains::iterator& domain,
+                         bool options, Result& result);
+    bool decode_records(std::string_view set, const Template& tmpl, const Header& header,
+                        Domain& domain, std::vector<storage::Event>& out, Result& result);
+
+    Template* find_template(Domains::iterator domain, uint16_t id);
+    Domains::iterator add_domain();
+    void erase_domain(Domains::iterator domain);
+    void make_room(Domains::iterator keep, Result& result);
+};
+
+} // namespace siem::ingest
@@ -0,0 +1,165 @@
+#include "ingest/flow_encoder.hpp"
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+namespace siem::ingest {
+
+namespace {
+
+struct TemplateField {
+    uint16_t element;
+    uint16_t length;
+};
+
+void put16(std::string& out, uint16_t v) {
+    out += static_cast<char>(v >> 8);
+    out += static_cast<char>(v);
+}
+
+void put32(std::string& out, uint32_t v) {
+    put16(out, static_cast<uint16_t>(v >> 16));
+    put16(out, static_cast<uint16_t>(v));
+}
+
+void put64(std::string& out, uint64_t v) {
+    put32(out, static_cast<uint32_t>(v >> 32));
+    put32(out, static_cast<uint32_t>(v));
+}
+
+void set16(std::string& out, size_t at, uint16_t v) {
+    out[at] = static_cast<char>(v >> 8);
+    out[at + 1] = static_cast<char>(v);
+}
+
+std::vector<TemplateField> template_fields(FlowEncoder::Version version, bool ipv6) {
+    std::vector<TemplateField> fields = {
+        {static_cast<uint16_t>(ipv6 ? 27 : 8), static_cast<uint16_t>(ipv6 ? 16 : 4)},
+        {static_cast<uint16_t>(ipv6 ? 28 : 12), static_cast<uint16_t>(ipv6 ? 16 : 4)},
+        {7, 2}, {11, 2}, {4, 1}, {6, 1}, {1, 8}, {2, 8},
+    };
+    if (version == FlowEncoder::Version::Ipfix) {
+        fields.push_back({152, 8});  // flowStartMilliseconds
+        fields.push_back({153, 8});  // flowEndMilliseconds
+    } else {
+        fields.push_back({22, 4});   // FIRST_SWITCHED
+        fields.push_back({21, 4});   // LAST_SWITCHED
+    }
+    return fields;
+}
+
+bool is_ipv6(const FlowRecord& record) {
+    return record.src_ip.find(':') != std::string::npos;
+}
+
+void put_address(std::string& out, const std::string& text, bool ipv6) {
+    unsigned char addr[16];
+    if (::inet_pton(ipv6 ? AF_INET6 : AF_INET, text.c_str(), addr) != 1) {
+        throw std::invalid_argument("Invalid flow address: " + text);
+    }
+    out.append(reinterpret_cast<const char*>(addr), ipv6 ? 16 : 4);
+}
+
+} // namespace
+
+FlowEncoder::FlowEncoder() : FlowEncoder(Config{}) {}
+
+FlowEncoder::FlowEncoder(Config config) : config_(config) {}
+
+size_t FlowEncoder::record_bytes(bool ipv6) const {
+    size_t bytes = 0;
+    for (const auto& field : template_fields(config_.version, ipv6)) bytes += field.length;
+    return bytes;
+}
+
+size_t FlowEncoder::records_per_packet(size_t mtu_bytes, bool ipv6) const {
+    size_t header = config_.version == Version::Ipfix ? 16 : 20;
+    size_t overhead = header + 4;
+    return mtu_bytes > overhead ? (mtu_bytes - overhead) / record_bytes(ipv6) : 0;
+}
+
+void FlowEncoder::write_header(std::string& out, int64_t now_ms, uint16_t count) const {
+    if (config_.version == Version::Ipfix) {
+        put16(out, 10);
+        put16(out, 0);  // Length, set in finish()
+        put32(out, static_cast<uint32_t>(now_ms / 1000));
+        put32(out, sequence_);
+        put32(out, config_.domain);
+    } else {
+        put16(out, 9);
+        put16(out, count);
+        put32(out, static_cast<uint32_t>(now_ms - config_.boot_ms));
+        put32(out, static_cast<uint32_t>(now_ms / 1000));
+        put32(out, sequence_);
+        put32(out, config_.domain);
+    }
+}
+
+void FlowEncoder::finish(std::string& out) const {
+    if (config_.version == Version::Ipfix) set16(out, 2, static_cast<uint16_t>(out.size()));
+}
+
+std::string FlowEncoder::templates(int64_t now_ms) {
+    std::string out;
+    write_header(out, now_ms, 2);
+
+    size_t set_start = out.size();
+    put16(out, config_.version == Version::Ipfix ? 2 : 0);
+    put16(out, 0);
+    for (bool ipv6 : {false, true}) {
+        auto fields = template_fields(config_.version, ipv6);
+        put16(out, static_cast<uint16_t>(config_.template_id + (ipv6 ? 1 : 0)));
+        put16(out, static_cast<uint16_t>(fields.size()));
+        for (const auto& field : fields) {
+            put16(out, field.element);
+            put16(out, field.length);
+        }
+    }
+    set16(out, set_start + 2, static_cast<uint16_t>(out.size() - set_start));
+
+    finish(out);
+    if (config_.version == Version::NetflowV9) sequence_++;
+    return out;
+}
+
+std::string FlowEncoder::data(const std::vector<FlowRecord>& records, int64_t now_ms) {
+    std::string out;
+    write_header(out, now_ms, static_cast<uint16_t>(records.size()));
+
+    for (bool ipv6 : {false, true}) {
+        size_t set_start = out.size();
+        put16(out, static_cast<uint16_t>(config_.template_id + (ipv6 ? 1 : 0)));
+        put16(out, 0);
+
+        for (const auto& record : records) {
+            if (is_ipv6(record) != ipv6) continue;
+            put_address(out, record.src_ip, ipv6);
+            put_address(out, record.dst_ip, ipv6);
+            put16(out, record.sport);
+            put16(out, record.dport);
+            out += static_cast<char>(record.proto);
+            out += static_cast<char>(record.tcp_flags);
+            put64(out, record.bytes);
+            put64(out, record.packets);
+            if (config_.version == Version::Ipfix) {
+                put64(out, static_cast<uint64_t>(record.start_ms));
+                put64(out, static_cast<uint64_t>(record.end_ms));
+            } else {
+                put32(out, static_cast<uint32_t>(record.start_ms - config_.boot_ms));
+                put32(out, static_cast<uint32_t>(record.end_ms - config_.boot_ms));
+            }
+        }
+
+        if (out.size() - set_start == 4) {
+            out.resize(set_start);  // No records of this family
+        } else {
+            set16(out, set_start + 2, static_cast<uint16_t>(out.size() - set_start));
+        }
+    }
+
+    finish(out);
+    sequence_ += config_.version == Version::Ipfix ? static_cast<uint32_t>(records.size()) : 1;
+    return out;
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,887 @@
+#include "ingest/grok_matcher.hpp"
+#include "core/utf8.hpp"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <stdexcept>
+
+namespace siem::ingest {
+
+namespace {
+
+// Building blocks after the Logstash grok-patterns file, rewritten without
+// lookaround, atomic groups or \b; IPV6 is lenient
+const std::map<std::string, std::string> kBuiltins = {
+    {"USERNAME", "[a-zA-Z0-9._-]+"},
+    {"USER", "%{USERNAME}"},
+    {"EMAILLOCALPART", "[a-zA-Z0-9!#$%&'*+/=?^_`{|}~-]+(?:\\.[a-zA-Z0-9!#$%&'*+/=?^_`{|}~-]+)*"},
+    {"EMAILADDRESS", "%{EMAILLOCALPART}@%{HOSTNAME}"},
+    {"INT", "[+-]?[0-9]+"},
+    {"BASE10NUM", "[+-]?(?:[0-9]+(?:\\.[0-9]*)?|\\.[0-9]+)"},
+    {"NUMBER", "%{BASE10NUM}"},
+    {"BASE16NUM", "[+-]?(?:0x)?[0-9A-Fa-f]+"},
+    {"POSINT", "[1-9][0-9]*"},
+    {"NONNEGINT", "[0-9]+"},
+    {"WORD", "\\w+"},
+    {"NOTSPACE", "\\S+"},
+    {"SPACE", "\\s*"},
+    {"DATA", ".*?"},
+    {"GREEDYDATA", ".*"},
+    {"QUOTEDSTRING", "\"(?:[^\"\\\\]|\\\\.)*\"|'(?:[^'\\\\]|\\\\.)*'"},
+    {"UUID", "[A-Fa-f0-9]{8}-(?:[A-Fa-f0-9]{4}-){3}[A-Fa-f0-9]{12}"},
+    {"MAC", "(?:[A-Fa-f0-9]{2}[:-]){5}[A-Fa-f0-9]{2}|(?:[A-Fa-f0-9]{4}\\.){2}[A-Fa-f0-9]{4}"},
+    {"IPV4", "(?:25[0-5]|2[0-4][0-9]|1[0-9]{2}|[1-9]?[0-9])(?:\\.(?:25[0-5]|2[0-4][0-9]|1[0-9]{2}|[1-9]?[0-9])){3}"},
+    {"IPV6", "[0-9A-Fa-f]{0,4}(?::[0-9A-Fa-f]{0,4}){2,7}(?:\\.[0-9]{1,3}){0,3}(?:%[0-9A-Za-z]+)?"},
+    {"IP", "%{IPV6}|%{IPV4}"},
+    {"HOSTNAME", "[0-9A-Za-z][0-9A-Za-z-]*(?:\\.[0-9A-Za-z][0-9A-Za-z-]*)*\\.?"},
+    {"IPORHOST", "%{IP}|%{HOSTNAME}"},
+    {"HOSTPORT", "%{IPORHOST}:%{POSINT}"},
+    {"UNIXPATH", "(?:/[^/\\s]*)+"},
+    {"WINPATH", "(?:[A-Za-z]+:|\\\\)(?:\\\\[^\\\\?*]*)+"},
+    {"PATH", "%{UNIXPATH}|%{WINPATH}"},
+    {"URIPROTO", "[A-Za-z][A-Za-z0-9+.-]*"},
+    {"URIHOST", "%{IPORHOST}(?::%{POSINT})?"},
+    {"URIPATH", "/[^\\s?#]*"},
+    {"URIPARAM", "\\?[^\\s#]*"},
+    {"URIPATHPARAM", "%{URIPATH}(?:%{URIPARAM})?"},
+    {"URI", "%{URIPROTO}://(?:%{USER}(?::[^@]*)?@)?%{URIHOST}?(?:%{URIPATHPARAM})?"},
+    {"MONTH", "Jan(?:uary)?|Feb(?:ruary)?|Mar(?:ch)?|Apr(?:il)?|May|June?|July?|Aug(?:ust)?|"
+              "Sep(?:tember)?|Oct(?:ober)?|Nov(?:ember)?|Dec(?:ember)?"},
+    {"MONTHNUM", "0?[1-9]|1[0-2]"},
+    {"MONTHDAY", "0[1-9]|[12][0-9]|3[01]|[1-9]"},
+    {"DAY", "Mon(?:day)?|Tue(?:sday)?|Wed(?:nesday)?|Thu(?:rsday)?|Fri(?:day)?|Sat(?:urday)?|Sun(?:day)?"},
+    {"YEAR", "[0-9]{2}(?:[0-9]{2})?"},
+    {"HOUR", "2[0-3]|[01]?[0-9]"},
+    {"MINUTE", "[0-5][0-9]"},
+    {"SECOND", "(?:[0-5]?[0-9]|60)(?:[.,][0-9]+)?"},
+    {"TIME", "%{HOUR}:%{MINUTE}:%{SECOND}"},
+    {"ISO8601_TIMEZONE", "Z|[+-]%{HOUR}(?::?%{MINUTE})?"},
+    {"TIMESTAMP_ISO8601",
+     "%{YEAR}-%{MONTHNUM}-%{MONTHDAY}[T ]%{HOUR}:?%{MINUTE}(?::?%{SECOND})?%{ISO8601_TIMEZONE}?"},
+    {"DATESTAMP", "%{MONTHDAY}[./-]%{MONTHNUM}[./-]%{YEAR} %{TIME}"},
+    {"SYSLOGTIMESTAMP", "%{MONTH} +%{MONTHDAY} %{TIME}"},
+    {"HTTPDATE", "%{MONTHDAY}/%{MONTH}/%{YEAR}:%{TIME} %{INT}"},
+    {"PROG", "[\\x21-\\x5a\\x5c\\x5e-\\x7e]+"},
+    {"LOGLEVEL", "[Tt]race|TRACE|[Dd]ebug|DEBUG|[Ii]nfo|INFO|[Nn]otice|NOTICE|[Ww]arn(?:ing)?|WARN(?:ING)?|"
+                 "[Ee]rr(?:or)?|ERR(?:OR)?|[Cc]rit(?:ical)?|CRIT(?:ICAL)?|[Ff]atal|FATAL|[Ss]evere|SEVERE|"
+                 "[Aa]lert|ALERT|[Ee]merg(?:ency)?|EMERG(?:ENCY)?"},
+};
+
+constexpr size_t kMaxDepth = 32;          // Definition nesting
+constexpr int kMaxRepeat = 1000;          // Largest {n,m} bound
+constexpr size_t kMaxNodes = 1 << 20;
+
+std::bitset<256> byte_set(unsigned char c) {
+    std::bitset<256> set;
+    set.set(c);
+    return set;
+}
+
+std::bitset<256> range_set(unsigned char lo, unsigned char hi) {
+    std::bitset<256> set;
+    for (unsigned c = lo; c <= hi; ++c) set.set(c);
+    return set;
+}
+
+std::bitset<256> digit_set() { return range_set('0', '9'); }
+
+std::bitset<256> word_set() {
+    return range_set('a', 'z') | range_set('A', 'Z') | range_set('0', '9') | byte_set('_');
+}
+
+std::bitset<256> space_set() {
+    return byte_set(' ') | byte_set('\t') | byte_set('\n') | byte_set('\r') | byte_set('\f') | byte_set('\v');
+}
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+double GrokMatcher::PatternStats::percentile_ns(double q) const {
+    uint64_t total = 0;
+    for (uint64_t count : buckets) total += count;
+    if (total == 0) return 0.0;
+
+    double target = std::clamp(q, 0.0, 1.0) * static_cast<double>(total);
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (static_cast<double>(seen) >= target && buckets[b] > 0) return static_cast<double>(uint64_t{1} << b);
+    }
+    return static_cast<double>(uint64_t{1} << (buckets.size() - 1));
+}
+
+struct GrokMatcher::Ast {
+    enum class Kind : uint8_t { Empty, Set, Concat, Alt, Repeat, Capture };
+
+    Kind kind = Kind::Empty;
+    uint32_t arg = 0;               // Set: set index; Capture: capture index
+    int min = 0;                    // Repeat bounds; max < 0 is unbounded
+    int max = 0;
+    bool greedy = true;
+    std::vector<Ast> children;
+};
+
+/**
+ * Recursive-descent parser from a pattern to its AST; expands definitions
+ * in place and registers captures and character sets with the matcher
+ */
+class GrokMatcher::Parser {
+public:
+    Parser(GrokMatcher& matcher, const std::map<std::string, std::string>& definitions,
+           std::vector<Capture>& captures, std::string context)
+        : matcher_(matcher), definitions_(definitions), captures_(captures), context_(std::move(context)) {}
+
+    Ast parse(std::string_view expression) {
+        // Patterns are anchored anyway; accept explicit anchors at the ends
+        if (expression.starts_with('^')) expression.remove_prefix(1);
+        if (expression.ends_with('$')) {
+            size_t slashes = 0;
+            while (slashes + 1 < expression.size() && expression[expression.size() - 2 - slashes] == '\\') slashes++;
+            if (slashes % 2 == 0) expression.remove_suffix(1);
+        }
+        return parse_all(expression);
+    }
+
+private:
+    struct Cursor {
+        std::string_view text;
+        size_t pos = 0;
+
+        bool done() const { return pos >= text.size(); }
+        char peek() const { return text[pos]; }
+    };
+
+    GrokMatcher& matcher_;
+    const std::map<std::string, std::string>& definitions_;
+    std::vector<Capture>& captures_;
+    std::string context_;
+    std::vector<std::string> expanding_;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::invalid_argument(context_ + ": " + message);
+    }
+
+    Ast parse_all(std::string_view text) {
+        Cursor in{text, 0};
+        Ast ast = alternation(in);
+        if (!in.done()) fail("unbalanced ')' in \"" + std::string(text) + "\"");
+        return ast;
+    }
+
+    Ast set_node(const std::bitset<256>& set) {
+        Ast ast;
+        ast.kind = Ast::Kind::Set;
+        auto it = std::find(matcher_.sets_.begin(), matcher_.sets_.end(), set);
+        ast.arg = static_cast<uint32_t>(it - matcher_.sets_.begin());
+        if (it == matcher_.sets_.end()) matcher_.sets_.push_back(set);
+        return ast;
+    }
+
+    Ast alternation(Cursor& in) {
+        Ast first = sequence(in);
+        if (in.done() || in.peek() != '|') return first;
+
+        Ast alt;
+        alt.kind = Ast::Kind::Alt;
+        alt.children.push_back(std::move(first));
+        while (!in.done() && in.peek() == '|') {
+            in.pos++;
+            alt.children.push_back(sequence(in));
+        }
+        return alt;
+    }
+
+    Ast sequence(Cursor& in) {
+        Ast seq;
+        seq.kind = Ast::Kind::Concat;
+        while (!in.done() && in.peek() != '|' && in.peek() != ')') {
+            Ast item = atom(in);
+            quantify(in, item);
+            seq.children.push_back(std::move(item));
+        }
+        if (seq.children.size() == 1) return std::move(seq.children[0]);
+        if (seq.children.empty()) seq.kind = Ast::Kind::Empty;
+        return seq;
+    }
+
+    Ast atom(Cursor& in) {
+        char c = in.text[in.pos++];
+        switch (c) {
+            case '(':
+                return group(in);
+            case '[':
+                return set_node(char_class(in));
+            case '.':
+                return set_node(~byte_set('\n'));
+            case '\\':
+                return set_node(escape(in, false));
+            case '^':
+            case '$':
+                fail(std::string("anchor '") + c + "' is only supported at the ends of a pattern");
+            case '*':
+            case '+':
+            case '?':
+                fail(std::string("nothing to repeat before '") + c + "'");
+            case '%':
+                if (!in.done() && in.peek() == '{') return reference(in);
+                [[fallthrough]];
+            default:
+                return set_node(byte_set(static_cast<unsigned char>(c)));
+        }
+    }
+
+    Ast group(Cursor& in) {
+        std::string field;
+        if (in.text.substr(in.pos).starts_with("?:")) {
+            in.pos += 2;
+        } else if (in.text.substr(in.pos).starts_with("?<") || in.text.substr(in.pos).starts_with("?P<")) {
+            in.pos += in.peek() == '?' && in.text[in.pos + 1] == 'P' ? 3 : 2;
+            if (!in.done() && (in.peek() == '=' || in.peek() == '!')) fail("lookbehind is not supported");
+            size_t close = in.text.find('>', in.pos);
+            if (close == std::string_view::npos) fail("unterminated group name");
+            field = std::string(in.text.substr(in.pos, close - in.pos));
+            in.pos = close + 1;
+        } else if (!in.done() && in.peek() == '?') {
+            fail("unsupported group \"(" + std::string(in.text.substr(in.pos, 2)) + "\"");
+        }
+
+        Ast body = alternation(in);
+        if (in.done() || in.peek() != ')') fail("missing ')'");
+        in.pos++;
+        return field.empty() ? body : capture(std::move(body), field, FieldType::String);
+    }
+
+    Ast reference(Cursor& in) {
+        size_t close = in.text.find('}', in.pos);
+        if (close == std::string_view::npos) fail("unterminated %{");
+        std::string_view spec = in.text.substr(in.pos + 1, close - in.pos - 1);
+        in.pos = close + 1;
+
+        std::string_view name = spec.substr(0, spec.find(':'));
+        std::string_view field, type;
+        if (name.size() < spec.size()) {
+            field = spec.substr(name.size() + 1);
+            size_t colon = field.find(':');
+            if (colon != std::string_view::npos) {
+                type = field.substr(colon + 1);
+                field = field.substr(0, colon);
+            }
+        }
+
+        auto it = definitions_.find(std::string(name));
+        if (it == definitions_.end()) fail("unknown definition %{" + std::string(name) + "}");
+        if (std::find(expanding_.begin(), expanding_.end(), it->first) != expanding_.end()) {
+            fail("recursive definition %{" + it->first + "}");
+        }
+        if (expanding_.size() >= kMaxDepth) fail("definitions nest too deeply");
+
+        expanding_.push_back(it->first);
+        Ast body = parse_all(it->second);
+        expanding_.pop_back();
+
+        if (field.empty()) return body;
+
+        FieldType field_type = FieldType::String;
+        if (type == "int") field_type = FieldType::Int;
+        else if (type == "float") field_type = FieldType::Float;
+        else if (!type.empty() && type != "string") fail("unknown field type \"" + std::string(type) + "\"");
+        return capture(std::move(body), field, field_type);
+    }
+
+    Ast capture(Ast body, std::string_view field, FieldType type) {
+        Capture capture;
+        capture.type = type;
+        size_t pos = 0;
+        while (pos <= field.size()) {
+            size_t dot = std::min(field.find('.', pos), field.size());
+            if (dot == pos) fail("bad field name \"" + std::string(field) + "\"");
+            capture.path.emplace_back(field.substr(pos, dot - pos));
+            pos = dot + 1;
+        }
+
+        Ast ast;
+        ast.kind = Ast::Kind::Capture;
+        ast.arg = static_cast<uint32_t>(captures_.size());
+        ast.children.push_back(std::move(body));
+        captures_.push_back(std::move(capture));
+        return ast;
+    }
+
+    void quantify(Cursor& in, Ast& item) {
+        while (!in.done()) {
+            int min = 0, max = 0;
+            char c = in.peek();
+            if (c == '*') {
+                min = 0, max = -1;
+                in.pos++;
+            } else if (c == '+') {
+                min = 1, max = -1;
+                in.pos++;
+            } else if (c == '?') {
+                min = 0, max = 1;
+                in.pos++;
+            } else if (c != '{' || !bounds(in, min, max)) {
+                return;
+            }
+
+            bool greedy = true;
+            if (!in.done() && in.peek() == '?') {
+                greedy = false;
+                in.pos++;
+            } else if (!in.done() && in.peek() == '+') {
+                fail("possessive quantifiers are not supported");
+            }
+
+            Ast repeat;
+            repeat.kind = Ast::Kind::Repeat;
+            repeat.min = min;
+            repeat.max = max;
+            repeat.greedy = greedy;
+            repeat.children.push_back(std::move(item));
+            item = std::move(repeat);
+        }
+    }
+
+    /**
+     * {n}, {n,} or {n,m}; anything else leaves '{' to be read as a literal
+     */
+    bool bounds(Cursor& in, int& min, int& max) {
+        auto number = [&](size_t& pos, int& value) {
+            const char* begin = in.text.data() + pos;
+            auto [end, ec] = std::from_chars(begin, in.text.data() + in.text.size(), value);
+            if (ec != std::errc() || end == begin) return false;
+            pos += static_cast<size_t>(end - begin);
+            return true;
+        };
+
+        size_t pos = in.pos + 1;
+        if (!number(pos, min)) return false;
+        max = min;
+        if (pos < in.text.size() && in.text[pos] == ',') {
+            pos++;
+            max = -1;
+            if (pos < in.text.size() && in.text[pos] != '}' && !number(pos, max)) return false;
+        }
+        if (pos >= in.text.size() || in.text[pos] != '}') return false;
+        if (min > kMaxRepeat || max > kMaxRepeat || (max >= 0 && max < min)) fail("bad repetition bounds");
+        in.pos = pos + 1;
+        return true;
+    }
+
+    /**
+     * The escape after a '\'; in_class allows \b as backspace
+     */
+    std::bitset<256> escape(Cursor& in, bool in_class) {
+        if (in.done()) fail("trailing '\\'");
+        char c = in.text[in.pos++];
+        switch (c) {
+            case 'd': return digit_set();
+            case 'D': return ~digit_set();
+            case 'w': return word_set();
+            case 'W': return ~word_set();
+            case 's': return space_set();
+            case 'S': return ~space_set();
+            case 't': return byte_set('\t');
+            case 'n': return byte_set('\n');
+            case 'r': return byte_set('\r');
+            case 'f': return byte_set('\f');
+            case 'v': return byte_set('\v');
+            case 'e': return byte_set(0x1B);
+            case 'x': {
+                int hi = in.pos < in.text.size() ? hex_value(in.text[in.pos]) : -1;
+                int lo = in.pos + 1 < in.text.size() ? hex_value(in.text[in.pos + 1]) : -1;
+                if (hi < 0 || lo < 0) fail("\\x needs two hex digits");
+                in.pos += 2;
+                return byte_set(static_cast<unsigned char>(hi * 16 + lo));
+            }
+            case 'b':
+                if (in_class) return byte_set('\b');
+                [[fallthrough]];
+            default:
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+                    fail(std::string("unsupported escape \\") + c);
+                }
+                return byte_set(static_cast<unsigned char>(c));
+        }
+    }
+
+    std::bitset<256> char_class(Cursor& in) {
+        std::bitset<256> set;
+        bool negate = !in.done() && in.peek() == '^';
+        if (negate) in.pos++;
+
+        bool first = true;
+        while (true) {
+            if (in.done()) fail("missing ']'");
+            char c = in.peek();
+            if (c == ']' && !first) {
+                in.pos++;
+                break;
+            }
+            first = false;
+
+            // One item: a byte, possibly the start of a range, or a class escape
+            int lo;
+            if (c == '\\') {
+                in.pos++;
+                auto item = escape(in, true);
+                if (item.count() != 1) {
+                    set |= item;
+                    continue;
+                }
+                lo = static_cast<int>(item._Find_first());
+            } else {
+                lo = static_cast<unsigned char>(c);
+                in.pos++;
+            }
+
+            if (in.pos + 1 < in.text.size() && in.peek() == '-' && in.text[in.pos + 1] != ']') {
+                in.pos++;
+                int hi;
+                if (in.peek() == '\\') {
+                    in.pos++;
+                    auto item = escape(in, true);
+                    if (item.count() != 1) fail("bad range in character class");
+                    hi = static_cast<int>(item._Find_first());
+                } else {
+                    hi = static_cast<unsigned char>(in.peek());
+                    in.pos++;
+                }
+                if (hi < lo) fail("bad range in character class");
+                set |= range_set(static_cast<unsigned char>(lo), static_cast<unsigned char>(hi));
+            } else {
+                set.set(static_cast<size_t>(lo));
+            }
+        }
+        return negate ? ~set : set;
+    }
+};
+
+GrokMatcher::GrokMatcher(Config config) : config_(std::move(config)) {
+    auto definitions = builtin_definitions();
+    for (const auto& [name, expression] : config_.definitions) definitions[name] = expression;
+
+    for (size_t i = 0; i < config_.patterns.size(); ++i) {
+        const auto& pattern = config_.patterns[i];
+        Compiled compiled;
+        compiled.first = static_cast<uint32_t>(nodes_.size());
+
+        Parser parser(*this, definitions, compiled.captures, "grok pattern '" + pattern.name + "'");
+        Ast ast = parser.parse(pattern.match);
+
+        nodes_.push_back(Node{NodeKind::Match, 0, 0, static_cast<uint32_t>(i)});
+        compiled.start = emit(ast, static_cast<uint32_t>(nodes_.size() - 1));
+        compiled.end = static_cast<uint32_t>(nodes_.size());
+        compiled_.push_back(std::move(compiled));
+    }
+
+    build_dfa();
+    counters_ = std::make_unique<Counters[]>(config_.patterns.size() + 1);
+}
+
+GrokMatcher::~GrokMatcher() = default;
+
+const std::map<std::string, std::string>& GrokMatcher::builtin_definitions() {
+    return kBuiltins;
+}
+
+/**
+ * Thompson construction, back to front: returns the entry of a fragment
+ * that continues at next
+ */
+uint32_t GrokMatcher::emit(const Ast& ast, uint32_t next) {
+    if (nodes_.size() > kMaxNodes) throw std::invalid_argument("grok patterns are too large");
+
+    auto add = [this](Node node) {
+        nodes_.push_back(node);
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    };
+
+    switch (ast.kind) {
+        case Ast::Kind::Empty:
+            return next;
+
+        case Ast::Kind::Set:
+            return add(Node{NodeKind::Set, next, 0, ast.arg});
+
+        case Ast::Kind::Concat:
+            for (auto it = ast.children.rbegin(); it != ast.children.rend(); ++it) next = emit(*it, next);
+            return next;
+
+        case Ast::Kind::Alt: {
+            uint32_t entry = emit(ast.children.back(), next);
+            for (size_t i = ast.children.size() - 1; i-- > 0;) {
+                uint32_t branch = emit(ast.children[i], next);
+                entry = add(Node{NodeKind::Split, branch, entry, 0});
+            }
+            return entry;
+        }
+
+        case Ast::Kind::Capture: {
+            uint32_t close = add(Node{NodeKind::Save, next, 0, ast.arg * 2 + 1});
+            uint32_t body = emit(ast.children[0], close);
+            return add(Node{NodeKind::Save, body, 0, ast.arg * 2});
+        }
+
+        case Ast::Kind::Repeat: {
+            const Ast& body = ast.children[0];
+            auto split = [&](uint32_t taken, uint32_t skipped) {
+                return ast.greedy ? Node{NodeKind::Split, taken, skipped, 0} : Node{NodeKind::Split, skipped, taken, 0};
+            };
+
+            uint32_t tail = next;
+            if (ast.max < 0) {
+                // Loop: the split is created first so the body can jump back to it
+                uint32_t loop = add(Node{NodeKind::Split, 0, 0, 0});
+                uint32_t entry = emit(body, loop);
+                nodes_[loop] = split(entry, next);
+                tail = loop;
+            } else {
+                // Optional copies: x{0,3} = (x(x(x)?)?)?
+                for (int i = ast.min; i < ast.max; ++i) {
+                    uint32_t entry = emit(body, tail);
+                    tail = add(split(entry, next));
+                }
+            }
+            for (int i = 0; i < ast.min; ++i) tail = emit(body, tail);
+            return tail;
+        }
+    }
+    return next;
+}
+
+/**
+ * Subset construction over byte classes, from the union of every pattern's
+ * entry; a DFA state accepts for the lowest pattern index it contains
+ */
+void GrokMatcher::build_dfa() {
+    // Bytes no set tells apart share a class
+    std::map<std::vector<bool>, uint8_t> signatures;
+    std::array<unsigned char, 256> representative{};
+    for (unsigned c = 0; c < 256; ++c) {
+        std::vector<bool> signature(sets_.size());
+        for (size_t s = 0; s < sets_.size(); ++s) signature[s] = sets_[s].test(c);
+        auto [it, inserted] = signatures.emplace(std::move(signature), static_cast<uint8_t>(signatures.size()));
+        if (inserted) representative[it->second] = static_cast<unsigned char>(c);
+        classes_[c] = it->second;
+    }
+    class_count_ = signatures.size();
+
+    std::vector<uint32_t> seen(nodes_.size(), 0);
+    uint32_t generation = 0;
+    std::vector<uint32_t> stack;
+    auto closure = [&](std::vector<uint32_t> roots) {
+        generation++;
+        std::vector<uint32_t> out;
+        stack = std::move(roots);
+        while (!stack.empty()) {
+            uint32_t id = stack.back();
+            stack.pop_back();
+            if (seen[id] == generation) continue;
+            seen[id] = generation;
+
+            const Node& node = nodes_[id];
+            switch (node.kind) {
+                case NodeKind::Set:
+                case NodeKind::Match:
+                    out.push_back(id);
+                    break;
+                case NodeKind::Split:
+                    stack.push_back(node.out1);
+                    stack.push_back(node.out);
+                    break;
+                case NodeKind::Save:
+                    stack.push_back(node.out);
+                    break;
+            }
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    };
+
+    std::map<std::vector<uint32_t>, uint32_t> ids;
+    std::vector<std::vector<uint32_t>> states;
+    auto intern = [&](std::vector<uint32_t> members) -> uint32_t {
+        if (members.empty()) return 0;
+        auto [it, inserted] = ids.emplace(members, static_cast<uint32_t>(states.size()));
+        if (inserted) {
+            if (states.size() > config_.max_dfa_states) {
+                throw std::invalid_argument("grok patterns need more than " + std::to_string(config_.max_dfa_states) +
+                                            " DFA states; simplify them or raise max_dfa_states");
+            }
+            states.push_back(std::move(members));
+        }
+        return it->second;
+    };
+
+    states.emplace_back();  // 0: dead
+    std::vector<uint32_t> roots;
+    for (const auto& compiled : compiled_) roots.push_back(compiled.start);
+    start_state_ = intern(closure(std::move(roots)));
+
+    for (uint32_t state = 0; state < states.size(); ++state) {
+        next_.resize((state + 1) * class_count_, 0);
+        int32_t accept = -1;
+        for (uint32_t id : states[state]) {
+            if (nodes_[id].kind == NodeKind::Match) {
+                int32_t pattern = static_cast<int32_t>(nodes_[id].arg);
+                accept = accept < 0 ? pattern : std::min(accept, pattern);
+            }
+        }
+        accept_.push_back(accept);
+
+        for (size_t c = 0; c < class_count_; ++c) {
+            std::vector<uint32_t> targets;
+            for (uint32_t id : states[state]) {
+                const Node& node = nodes_[id];
+                if (node.kind == NodeKind::Set && sets_[node.arg].test(representative[c])) targets.push_back(node.out);
+            }
+            uint32_t target = intern(closure(std::move(targets)));
+            next_[state * class_count_ + c] = target;
+        }
+    }
+}
+
+int GrokMatcher::find(std::string_view line) const {
+    if (line.size() > config_.max_line_bytes) return -1;
+
+    uint32_t state = start_state_;
+    for (unsigned char c : line) {
+        state = next_[state * class_count_ + classes_[c]];
+        if (state == 0) return -1;
+    }
+    return accept_[state];
+}
+
+namespace {
+
+/**
+ * (node, position) pairs seen by one extract() call. Short lines use a
+ * bitmap small enough that clearing it is cheap; past kDenseBits keys go
+ * to an open-addressing table with generation stamps, which clears in O(1)
+ * and grows with the pairs actually explored rather than nodes x line
+ */
+class VisitedSet {
+public:
+    static constexpr size_t kDenseBits = size_t{1} << 16;
+
+    /**
+     * Empty the set for keys below universe
+     */
+    void reset(size_t universe) {
+        dense_ = universe <= kDenseBits;
+        if (dense_) {
+            bits_.assign((universe + 63) / 64, 0);
+            return;
+        }
+        size_ = 0;
+        if (++generation_ == 0) {
+            std::fill(stamps_.begin(), stamps_.end(), 0);
+            generation_ = 1;
+        }
+    }
+
+    /**
+     * False if key was already there
+     */
+    bool insert(uint64_t key) {
+        if (dense_) {
+            uint64_t bit = uint64_t{1} << (key & 63);
+            if (bits_[key >> 6] & bit) return false;
+            bits_[key >> 6] |= bit;
+            return true;
+        }
+
+        if ((size_ + 1) * 2 > keys_.size()) grow();
+        size_t mask = keys_.size() - 1;
+        for (size_t i = slot(key) & mask;; i = (i + 1) & mask) {
+            if (stamps_[i] != generation_) {
+                stamps_[i] = generation_;
+                keys_[i] = key;
+                size_++;
+                return true;
+            }
+            if (keys_[i] == key) return false;
+        }
+    }
+
+private:
+    bool dense_ = true;
+    std::vector<uint64_t> bits_;
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> stamps_;
+    uint32_t generation_ = 1;
+    size_t size_ = 0;
+
+    static size_t slot(uint64_t key) {
+        key *= 0x9E3779B97F4A7C15ULL;
+        return static_cast<size_t>(key ^ (key >> 32));
+    }
+
+    void grow() {
+        std::vector<uint64_t> keys(std::max<size_t>(keys_.size() * 2, 256));
+        std::vector<uint32_t> stamps(keys.size(), 0);
+        size_t mask = keys.size() - 1;
+        for (size_t i = 0; i < keys_.size(); ++i) {
+            if (stamps_[i] != generation_) continue;
+            size_t j = slot(keys_[i]) & mask;
+            while (stamps[j] == generation_) j = (j + 1) & mask;
+            stamps[j] = generation_;
+            keys[j] = keys_[i];
+        }
+        keys_.swap(keys);
+        stamps_.swap(stamps);
+    }
+};
+
+} // namespace
+
+/**
+ * Backtrack through one pattern in priority order, visiting each (node,
+ * position) pair at most once; the first path to reach Match at the end of
+ * the line fills slots with its capture offsets
+ */
+bool GrokMatcher::extract(const Compiled& pattern, std::string_view line, std::vector<int64_t>& slots) const {
+    struct Job {
+        int64_t value;          // Branch: position; restore: old slot value
+        uint32_t node;
+        uint32_t slot;          // kBranch, or the slot to restore
+    };
+    constexpr uint32_t kBranch = UINT32_MAX;
+
+    thread_local VisitedSet visited;
+    thread_local std::vector<Job> stack;
+
+    const size_t width = line.size() + 1;
+    visited.reset((pattern.end - pattern.first) * width);
+    slots.assign(pattern.captures.size() * 2, -1);
+    stack.clear();
+    stack.push_back(Job{0, pattern.start, kBranch});
+
+    while (!stack.empty()) {
+        Job job = stack.back();
+        stack.pop_back();
+        if (job.slot != kBranch) {
+            slots[job.slot] = job.value;
+            continue;
+        }
+
+        uint32_t id = job.node;
+        size_t pos = static_cast<size_t>(job.value);
+        while (true) {
+            if (!visited.insert(uint64_t{id - pattern.first} * width + pos)) break;
+
+            const Node& node = nodes_[id];
+            if (node.kind == NodeKind::Set) {
+                if (pos >= line.size() || !sets_[node.arg].test(static_cast<unsigned char>(line[pos]))) break;
+                id = node.out;
+                pos++;
+            } else if (node.kind == NodeKind::Split) {
+                stack.push_back(Job{static_cast<int64_t>(pos), node.out1, kBranch});
+                id = node.out;
+            } else if (node.kind == NodeKind::Save) {
+                stack.push_back(Job{slots[node.arg], 0, node.arg});
+                slots[node.arg] = static_cast<int64_t>(pos);
+                id = node.out;
+            } else {
+                if (pos == line.size()) return true;
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+bool GrokMatcher::match(std::string_view line, json& event) const {
+    using clock = std::chrono::steady_clock;
+    auto begin = config_.timing ? clock::now() : clock::time_point{};
+    auto elapsed = [&] {
+        if (!config_.timing) return uint64_t{0};
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - begin).count());
+    };
+
+    thread_local std::vector<int64_t> slots;
+    int index = find(line);
+    if (index < 0 || !extract(compiled_[static_cast<size_t>(index)], line, slots)) {
+        record(config_.patterns.size(), elapsed());
+        return false;
+    }
+
+    if (!event.is_object()) event = json::object();
+    const auto& compiled = compiled_[static_cast<size_t>(index)];
+    for (size_t i = 0; i < compiled.captures.size(); ++i) {
+        int64_t from = slots[2 * i], to = slots[2 * i + 1];
+        if (from < 0 || to <= from) continue;
+        std::string_view value = line.substr(static_cast<size_t>(from), static_cast<size_t>(to - from));
+
+        const auto& capture = compiled.captures[i];
+        json* node = &event;
+        for (size_t p = 0; p + 1 < capture.path.size(); ++p) {
+            node = &(*node)[capture.path[p]];
+            if (!node->is_object()) *node = json::object();
+        }
+        json& slot = (*node)[capture.path.back()];
+
+        if (capture.type == FieldType::Int) {
+            int64_t number = 0;
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+            if (ec == std::errc() && end == value.data() + value.size()) {
+                slot = number;
+                continue;
+            }
+        } else if (capture.type == FieldType::Float) {
+            double number = 0;
+            auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), number);
+            if (ec == std::errc() && end == value.data() + value.size()) {
+                slot = number;
+                continue;
+            }
+        }
+        slot = core::Utf8::repair(value);
+    }
+
+    const auto& source = config_.patterns[static_cast<size_t>(index)].source;
+    if (!source.empty()) event["source"] = source;
+
+    record(static_cast<size_t>(index), elapsed());
+    return true;
+}
+
+void GrokMatcher::record(size_t index, uint64_t ns) const {
+    auto& counters = counters_[index];
+    counters.hits.fetch_add(1, std::memory_order_relaxed);
+    if (!config_.timing) return;
+    counters.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    size_t bucket = std::min<size_t>(static_cast<size_t>(std::bit_width(ns)), kHistogramBuckets - 1);
+    counters.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+GrokMatcher::Stats GrokMatcher::stats() const {
+    auto snapshot = [this](size_t index, std::string name) {
+        const auto& counters = counters_[index];
+        PatternStats stats;
+        stats.name = std::move(name);
+        stats.hits = counters.hits.load(std::memory_order_relaxed);
+        stats.total_ns = counters.total_ns.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < kHistogramBuckets; ++b) {
+            stats.buckets[b] = counters.buckets[b].load(std::memory_order_relaxed);
+        }
+        return stats;
+    };
+
+    Stats stats;
+    for (size_t i = 0; i < config_.patterns.size(); ++i) {
+        stats.patterns.push_back(snapshot(i, config_.patterns[i].name));
+    }
+    stats.unmatched = snapshot(config_.patterns.size(), "unmatched");
+    return stats;
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace siem::ingest {
+
+using json = nlohmann::json;
+
+/**
+ * Grok-style free-text parsing
+ * Patterns are regular expressions with named captures written as
+ * %{DEFINITION:field[:type]} or (?<field>...); definitions come from a
+ * built-in library (IP, INT, WORD, TIMESTAMP_ISO8601, ...) plus the config.
+ * All patterns are compiled once into a single byte-class DFA, so a line is
+ * scanned once to find which pattern matches it; only that pattern then runs
+ * a bounded backtracker (at most one visit per state and position) to
+ * extract its captures. A pattern must match the whole line, and when
+ * several match the first one listed wins.
+ *
+ * Supported syntax: literals and escapes, ., [classes], \d \w \s \D \W \S,
+ * \t \n \r \xHH, groups, (?:...), alternation, * + ? {n} {n,} {n,m} and their
+ * lazy forms, and ^ / $ at the ends of a pattern. Anything else (lookaround,
+ * backreferences, \b) is rejected when compiling.
+ */
+class GrokMatcher {
+public:
+    struct Pattern {
+        std::string name;               // Reported in stats
+        std::string match;              // Expression, e.g. "%{IP:entity.ip} %{WORD:action}"
+        std::string source;             // Overrides the event "source" on a match; empty keeps it
+    };
+
+    struct Config {
+        std::map<std::string, std::string> definitions;  // Added to, or replacing, the built-ins
+        std::vector<Pattern> patterns;                   // Tried in one pass; first listed wins
+        size_t max_dfa_states = 10000;                   // Compiling past this throws
+        size_t max_line_bytes = 65536;                   // Longer lines count as unmatched
+        bool timing = true;                              // Per-pattern match-time histograms
+    };
+
+    // Log2 buckets: bucket b counts matches that took [2^(b-1), 2^b) ns;
+    // the last bucket also takes everything slower
+    static constexpr size_t kHistogramBuckets = 24;
+
+    struct PatternStats {
+        std::string name;
+        uint64_t hits = 0;
+        uint64_t total_ns = 0;
+        std::array<uint64_t, kHistogramBuckets> buckets{};
+
+        double mean_ns() const { return hits ? static_cast<double>(total_ns) / static_cast<double>(hits) : 0.0; }
+
+        /**
+         * Upper bound of the bucket holding quantile q (0..1)
+         */
+        double percentile_ns(double q) const;
+    };
+
+    struct Stats {
+        std::vector<PatternStats> patterns;
+        PatternStats unmatched;         // Lines no pattern matched; time is the DFA scan
+    };
+
+    /**
+     * Throws std::invalid_argument for unknown definitions, recursive
+     * definitions, unsupported syntax, unknown field types, or a DFA larger
+     * than max_dfa_states
+     */
+    explicit GrokMatcher(Config config);
+    ~GrokMatcher();
+
+    GrokMatcher(const GrokMatcher&) = delete;
+    GrokMatcher& operator=(const GrokMatcher&) = delete;
+
+    /**
+     * Index of the pattern matching the whole line, or -1; DFA scan only
+     */
+    int find(std::string_view line) const;
+
+    /**
+     * Match a line and write its captures into event
+     * Dotted field names nest ("entity.ip" -> {"entity":{"ip":...}}); :int
+     * and :float captures become numbers when they parse, and empty
+     * captures are left out. Returns false, leaving event untouched, when
+     * no pattern matches. Safe to call from several threads at once.
+     */
+    bool match(std::string_view line, json& event) const;
+
+    const std::vector<Pattern>& patterns() const { return config_.patterns; }
+
+    Stats stats() const;
+
+    /**
+     * The built-in definition library
+     */
+    static const std::map<std::string, std::string>& builtin_definitions();
+
+private:
+    enum class FieldType : uint8_t { String, Int, Float };
+
+    struct Capture {
+        std::vector<std::string> path;  // "entity.ip" -> {"entity", "ip"}
+        FieldType type = FieldType::String;
+    };
+
+    enum class NodeKind : uint8_t { Set, Split, Save, Match };
+
+    struct Node {
+        NodeKind kind;
+        uint32_t out = 0;
+        uint32_t out1 = 0;              // Split: lower-priority branch
+        uint32_t arg = 0;               // Set: set index; Save: slot; Match: pattern
+    };
+
+    struct Compiled {
+        uint32_t start = 0;             // Entry node
+        uint32_t first = 0;             // Nodes [first, end) belong to this pattern
+        uint32_t end = 0;
+        std::vector<Capture> captures;
+    };
+
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> total_ns{0};
+        std::array<std::atomic<uint64_t>, kHistogramBuckets> buckets{};
+    };
+
+    struct Ast;
+    class Parser;
+
+    Config config_;
+    std::vector<std::bitset<256>> sets_;
+    std::vector<Node> nodes_;
+    std::vector<Compiled> compiled_;
+
+    std::array<uint8_t, 256> classes_{};
+    size_t class_count_ = 1;
+    std::vector<uint32_t> next_;        // state * class_count_ + class -> state; 0 is dead
+    std::vector<int32_t> accept_;       // state -> pattern index, or -1
+    uint32_t start_state_ = 1;
+
+    std::unique_ptr<Counters[]> counters_;   // One per pattern, then unmatched
+
+    uint32_t emit(const Ast& ast, uint32_t next);
+    void build_dfa();
+
+    bool extract(const Compiled& pattern, std::string_view line, std::vector<int64_t>& slots) const;
+    void record(size_t index, uint64_t ns) const;
+};
+
+} // namespace siem::ingest
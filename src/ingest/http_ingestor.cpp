@@ -8,10 +8,26 @@
 
 namespace siem::ingest {
 
-HTTPIngestor::HTTPIngestor(Config config) : config_(config) {}
+namespace {
+
+// Same defaults as EventNormalizer so limits apply to the stored key
+std::string_view string_field(const json& obj, const char* key) {
+    auto it = obj.find(key);
+    if (it != obj.end() && it->is_string()) {
+        return it->get_ref<const std::string&>();
+    }
+    return "unknown";
+}
+
+} // namespace
+
+HTTPIngestor::HTTPIngestor(Config config)
+    : config_(config)
+    , rate_limiter_(config_.rate_limit)
+    , redactor_(config_.redaction) {}
 
 bool HTTPIngestor::verify_signature(const std::string& body, const std::string& signature) const {
-    std::string expected = compute_hmac(body);
+    std::string expected = compute_hmac(config_.hmac_secret, body);
     
     // Constant-time comparison
     if (expected.size() != signature.size()) return false;
@@ -24,13 +40,13 @@ bool HTTPIngestor::verify_signature(const std::string& body, const std::string&
     return result == 0;
 }
 
-std::string HTTPIngestor::compute_hmac(const std::string& data) const {
+std::string HTTPIngestor::compute_hmac(const std::string& secret, const std::string& data) {
     unsigned char hash[EVP_MAX_MD_SIZE];
     unsigned int hash_len = 0;
     
     HMAC(EVP_sha256(),
-         config_.hmac_secret.c_str(),
-         config_.hmac_secret.size(),
+         secret.c_str(),
+         secret.size(),
          reinterpret_cast<const unsigned char*>(data.c_str()),
          data.size(),
          hash,
@@ -53,34 +69,86 @@ std::string HTTPIngestor::compute_hmac(const std::string& data) const {
     return result;
 }
 
-std::vector<json> HTTPIngestor::parse_ingest_request(const std::string& body) {
+HTTPIngestor::IngestStats HTTPIngestor::parse_ingest_request(
+    const std::string& body, const EventSink& sink) {
+    return parse_ingest_request(body, ContentEncoding::Identity, sink);
+}
+
+HTTPIngestor::IngestStats HTTPIngestor::parse_ingest_request(
+    const std::string& body, ContentEncoding encoding, const EventSink& sink) {
+    IngestStats stats;
+    parse_ingest_request(body, encoding, sink, stats);
+    return stats;
+}
+
+void HTTPIngestor::parse_ingest_request(
+    const std::string& body, ContentEncoding encoding, const EventSink& sink, IngestStats& stats) {
     if (body.size() > config_.max_body_size) {
         spdlog::warn(R"({{"msg":"body_too_large","size":{}}})", body.size());
         throw std::runtime_error("Request body exceeds maximum size");
     }
     
-    std::vector<json> events;
-    
     try {
-        auto parsed = json::parse(body);
-        
-        if (!parsed.is_array()) {
-            throw std::runtime_error("Expected JSON array");
+        if (encoding == ContentEncoding::Identity) {
+            // One pass over the raw bytes; the body is only copied if something matched
+            std::string redacted;
+            std::string_view input = body;
+            stats.redacted = redactor_.redact(body, redacted);
+            if (stats.redacted > 0) input = redacted;
+            
+            EventStreamParser::parse(input, [&](json&& item) {
+                if (rate_limiter_.try_acquire(string_field(item, "source"), string_field(item, "host"))) {
+                    stats.accepted++;
+                    sink(std::move(item));
+                } else {
+                    stats.rate_limited++;
+                }
+            });
+        } else {
+            // The decompressed text never exists in one piece, so redact
+            // per event instead of over the raw bytes
+            ContentDecoder decoder(encoding, body, config_.max_decoded_size);
+            std::istream input(&decoder);
+            EventStreamParser::parse(input, [&](json&& item) {
+                admit(item, stats, sink);
+            });
         }
         
-        for (const auto& item : parsed) {
-            if (item.is_object()) {
-                events.push_back(item);
-            }
+        if (stats.rate_limited > 0) {
+            spdlog::warn(R"({{"msg":"ingest_rate_limited","dropped":{}}})", stats.rate_limited);
         }
         
-    } catch (const json::exception& e) {
+    } catch (const std::exception& e) {
         spdlog::error(R"({{"msg":"ingest_parse_error","error":"{}"}})", e.what());
         throw;
     }
+}
+
+void HTTPIngestor::admit(json& item, IngestStats& stats, const EventSink& sink) {
+    if (!item.is_object()) return;
+    stats.redacted += redactor_.redact(item);
+    if (rate_limiter_.try_acquire(string_field(item, "source"), string_field(item, "host"))) {
+        stats.accepted++;
+        sink(std::move(item));
+    } else {
+        stats.rate_limited++;
+    }
+}
+
+HTTPIngestor::IngestStats HTTPIngestor::ingest_events(json&& batch, const EventSink& sink) {
+    IngestStats stats;
     
-    return events;
+    if (batch.is_array()) {
+        for (auto& item : batch) admit(item, stats, sink);
+    } else {
+        admit(batch, stats, sink);
+    }
+    
+    if (stats.rate_limited > 0) {
+        spdlog::warn(R"({{"msg":"ingest_rate_limited","dropped":{}}})", stats.rate_limited);
+    }
+    
+    return stats;
 }
 
 } // namespace siem::ingest
-
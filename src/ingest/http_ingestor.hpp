@@ -1,5 +1,9 @@
 #pragma once
 
+#include "ingest/content_decoder.hpp"
+#include "ingest/event_stream.hpp"
+#include "ingest/rate_limiter.hpp"
+#include "core/secret_redactor.hpp"
 #include <string>
 #include <vector>
 #include <nlohmann/json.hpp>
@@ -17,7 +21,18 @@ class HTTPIngestor {
 public:
     struct Config {
         std::string hmac_secret = "your-secret-key";
-        size_t max_body_size = 1048576; // 1 MB
+        size_t max_body_size = 1048576; // 1 MB, as sent (compressed)
+        size_t max_decoded_size = 16777216; // 16 MB after Content-Encoding
+        RateLimiter::Config rate_limit;
+        core::SecretRedactor::Config redaction;
+    };
+
+    using EventSink = EventStreamParser::EventSink;
+
+    struct IngestStats {
+        size_t accepted = 0;
+        size_t rate_limited = 0;
+        size_t redacted = 0;
     };
 
     explicit HTTPIngestor(Config config);
@@ -29,15 +44,54 @@ public:
     bool verify_signature(const std::string& body, const std::string& signature) const;
 
     /**
-     * Validate and parse ingest request
-     * Returns parsed events or throws
+     * Validate and stream-parse ingest request
+     * Secrets are redacted from the raw body before parsing. Each accepted
+     * event is handed to sink as soon as it is parsed; events over their
+     * (source, host) rate limit are dropped before normalization.
+     * Returns counts or throws
+     */
+    IngestStats parse_ingest_request(const std::string& body, const EventSink& sink);
+
+    /**
+     * Same for a body sent with Content-Encoding. gzip / zstd bodies are
+     * decompressed window by window straight into the parser, each event
+     * is redacted as it is emitted, and the request fails once the output
+     * passes max_decoded_size. The signature covers the body as sent.
      */
-    std::vector<json> parse_ingest_request(const std::string& body);
+    IngestStats parse_ingest_request(const std::string& body, ContentEncoding encoding, const EventSink& sink);
+
+    /**
+     * Same, counting into stats as events are admitted, so stats still
+     * holds the counts up to the failure when this throws
+     */
+    void parse_ingest_request(const std::string& body, ContentEncoding encoding, const EventSink& sink,
+                              IngestStats& stats);
+
+    /**
+     * Apply the same redaction and rate limits to already-decoded events
+     * (binary ingest). batch is an array of events or a single object;
+     * non-object elements are skipped.
+     */
+    IngestStats ingest_events(json&& batch, const EventSink& sink);
+
+    /**
+     * Base64 HMAC-SHA256 of data under secret
+     */
+    static std::string compute_hmac(const std::string& secret, const std::string& data);
+
+    /**
+     * Per-(source, host) rate limiter state
+     */
+    const RateLimiter& rate_limiter() const { return rate_limiter_; }
+
+    size_t max_body_size() const { return config_.max_body_size; }
 
 private:
     Config config_;
+    RateLimiter rate_limiter_;
+    core::SecretRedactor redactor_;
 
-    std::string compute_hmac(const std::string& data) const;
+    void admit(json& item, IngestStats& stats, const EventSink& sink);
 };
 
 } // namespace siem::ingest
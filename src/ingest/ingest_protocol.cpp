@@ -0,0 +1,477 @@
+#include "ingest/ingest_protocol.hpp"
+#include "ingest/http_ingestor.hpp"
+#include "core/utf8.hpp"
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace siem::ingest {
+
+namespace {
+
+constexpr std::string_view kAuthContext = "siem-ingest/1\n";
+
+void put_u32(std::string& out, uint32_t value) {
+    char bytes[4] = {static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+                     static_cast<char>(value >> 8), static_cast<char>(value)};
+    out.append(bytes, 4);
+}
+
+void put_u64(std::string& out, uint64_t value) {
+    put_u32(out, static_cast<uint32_t>(value >> 32));
+    put_u32(out, static_cast<uint32_t>(value));
+}
+
+uint32_t get_u32(std::string_view data, size_t at) {
+    auto byte = [&](size_t i) { return static_cast<uint32_t>(static_cast<unsigned char>(data[at + i])); };
+    return byte(0) << 24 | byte(1) << 16 | byte(2) << 8 | byte(3);
+}
+
+uint64_t get_u64(std::string_view data, size_t at) {
+    return static_cast<uint64_t>(get_u32(data, at)) << 32 | get_u32(data, at + 4);
+}
+
+// Nesting limit for decoded payloads; deeper input is rejected rather than
+// recursing without bound
+constexpr int kMaxDepth = 128;
+
+/**
+ * Direct MessagePack / CBOR -> json decoding
+ * nlohmann's binary readers go through the SAX DOM builder a byte at a
+ * time, which costs as much as parsing the JSON text; this walks the
+ * payload once and moves strings and containers straight into place.
+ * Map keys must be strings (as nlohmann requires); duplicate keys keep
+ * the last value.
+ */
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view data) : data_(data) {}
+
+    json read_msgpack_document() {
+        json value = msgpack(0);
+        if (pos_ != data_.size()) fail("trailing bytes");
+        return value;
+    }
+
+    json read_cbor_document() {
+        json value = cbor(0);
+        if (pos_ != data_.size()) fail("trailing bytes");
+        return value;
+    }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const char* what) const {
+        throw std::runtime_error(std::string("malformed payload: ") + what + " at byte " + std::to_string(pos_));
+    }
+
+    void need(uint64_t n) const {
+        if (n > data_.size() - pos_) fail("truncated");
+    }
+
+    uint8_t byte() {
+        need(1);
+        return static_cast<uint8_t>(data_[pos_++]);
+    }
+
+    uint64_t big_endian(size_t n) {
+        need(n);
+        uint64_t value = 0;
+        for (size_t i = 0; i < n; ++i) value = value << 8 | static_cast<uint8_t>(data_[pos_ + i]);
+        pos_ += n;
+        return value;
+    }
+
+    std::string_view bytes(uint64_t n) {
+        need(n);
+        auto out = data_.substr(pos_, static_cast<size_t>(n));
+        pos_ += static_cast<size_t>(n);
+        return out;
+    }
+
+    // Strings are copied out anyway, so invalid UTF-8 is repaired on the way
+    std::string text(uint64_t n) { return core::Utf8::repair(bytes(n)); }
+
+    static double as_float(uint32_t bits) {
+        float f;
+        std::memcpy(&f, &bits, sizeof(f));
+        return static_cast<double>(f);
+    }
+
+    static double as_double(uint64_t bits) {
+        double d;
+        std::memcpy(&d, &bits, sizeof(d));
+        return d;
+    }
+
+    static double half_to_double(uint16_t half) {
+        int exponent = (half >> 10) & 0x1f;
+        int mantissa = half & 0x3ff;
+        double value = exponent == 0 ? std::ldexp(mantissa, -24)
+                     : exponent != 31 ? std::ldexp(mantissa + 1024, exponent - 25)
+                     : mantissa == 0 ? std::numeric_limits<double>::infinity()
+                     : std::numeric_limits<double>::quiet_NaN();
+        return (half & 0x8000) ? -value : value;
+    }
+
+    // Containers never reserve more than the remaining bytes could hold
+    json array(uint64_t count, int depth, json (BinaryReader::*element)(int)) {
+        json out = json::array();
+        auto& items = out.get_ref<json::array_t&>();
+        items.reserve(static_cast<size_t>(std::min<uint64_t>(count, data_.size() - pos_)));
+        for (uint64_t i = 0; i < count; ++i) items.push_back((this->*element)(depth + 1));
+        return out;
+    }
+
+    // -- MessagePack
+
+    json msgpack(int depth) {
+        if (depth > kMaxDepth) fail("nesting too deep");
+        uint8_t type = byte();
+
+        if (type <= 0x7f) return static_cast<uint64_t>(type);
+        if (type >= 0xe0) return static_cast<int64_t>(static_cast<int8_t>(type));
+        if ((type & 0xe0) == 0xa0) return text(type & 0x1f);
+        if ((type & 0xf0) == 0x90) return array(type & 0x0f, depth, &BinaryReader::msgpack);
+        if ((type & 0xf0) == 0x80) return msgpack_map(type & 0x0f, depth);
+
+        switch (type) {
+            case 0xc0: return nullptr;
+            case 0xc2: return false;
+            case 0xc3: return true;
+            case 0xc4: case 0xc5: case 0xc6: {
+                auto data = bytes(big_endian(size_t{1} << (type - 0xc4)));
+                return json::binary(std::vector<uint8_t>(data.begin(), data.end()));
+            }
+            case 0xca: return as_float(static_cast<uint32_t>(big_endian(4)));
+            case 0xcb: return as_double(big_endian(8));
+            case 0xcc: return big_endian(1);
+            case 0xcd: return big_endian(2);
+            case 0xce: return big_endian(4);
+            case 0xcf: return big_endian(8);
+            case 0xd0: return static_cast<int64_t>(static_cast<int8_t>(big_endian(1)));
+            case 0xd1: return static_cast<int64_t>(static_cast<int16_t>(big_endian(2)));
+            case 0xd2: return static_cast<int64_t>(static_cast<int32_t>(big_endian(4)));
+            case 0xd3: return static_cast<int64_t>(big_endian(8));
+            case 0xd9: return text(big_endian(1));
+            case 0xda: return text(big_endian(2));
+            case 0xdb: return text(big_endian(4));
+            case 0xdc: return array(big_endian(2), depth, &BinaryReader::msgpack);
+            case 0xdd: return array(big_endian(4), depth, &BinaryReader::msgpack);
+            case 0xde: return msgpack_map(big_endian(2), depth);
+            case 0xdf: return msgpack_map(big_endian(4), depth);
+        }
+        fail("unsupported MessagePack type");
+    }
+
+    std::string_view msgpack_key() {
+        uint8_t type = byte();
+        if ((type & 0xe0) == 0xa0) return bytes(type & 0x1f);
+        if (type == 0xd9) return bytes(big_endian(1));
+        if (type == 0xda) return bytes(big_endian(2));
+        if (type == 0xdb) return bytes(big_endian(4));
+        fail("map key is not a string");
+    }
+
+    json msgpack_map(uint64_t count, int depth) {
+        json out = json::object();
+        auto& fields = out.get_ref<json::object_t&>();
+        for (uint64_t i = 0; i < count; ++i) {
+            // Encoders usually write keys sorted, so hinting at the end is O(1)
+            auto it = fields.try_emplace(fields.end(), core::Utf8::repair(msgpack_key()));
+            it->second = msgpack(depth + 1);
+        }
+        return out;
+    }
+
+    // -- CBOR (definite and indefinite lengths; tags are rejected)
+
+    static constexpr uint64_t kIndefinite = ~uint64_t{0};
+
+    uint64_t cbor_argument(uint8_t info) {
+        if (info < 24) return info;
+        if (info <= 27) return big_endian(size_t{1} << (info - 24));
+        if (info == 31) return kIndefinite;
+        fail("reserved CBOR length");
+    }
+
+    bool cbor_break() {
+        need(1);
+        if (static_cast<uint8_t>(data_[pos_]) != 0xff) return false;
+        pos_++;
+        return true;
+    }
+
+    std::string cbor_text(uint8_t major, uint64_t length) {
+        std::string out;
+        if (length != kIndefinite) {
+            out = bytes(length);
+        } else {
+            // Indefinite: definite-length chunks of the same major type
+            while (!cbor_break()) {
+                uint8_t chunk = byte();
+                uint64_t chunk_length = cbor_argument(chunk & 0x1f);
+                if ((chunk >> 5) != major || chunk_length == kIndefinite) fail("bad string chunk");
+                out.append(bytes(chunk_length));
+            }
+        }
+        // Byte strings (major 2) are binary; text strings must be UTF-8
+        if (major == 3 && !core::Utf8::valid(out)) out = core::Utf8::repair(out);
+        return out;
+    }
+
+    json cbor(int depth) {
+        if (depth > kMaxDepth) fail("nesting too deep");
+        uint8_t initial = byte();
+        uint8_t major = initial >> 5;
+        uint8_t info = initial & 0x1f;
+
+        if (major == 7) {
+            switch (info) {
+                case 20: return false;
+                case 21: return true;
+                case 22: return nullptr;
+                case 25: return half_to_double(static_cast<uint16_t>(big_endian(2)));
+                case 26: return as_float(static_cast<uint32_t>(big_endian(4)));
+                case 27: return as_double(big_endian(8));
+            }
+            fail("unsupported CBOR simple value");
+        }
+
+        uint64_t argument = cbor_argument(info);
+        switch (major) {
+            case 0:
+                if (argument == kIndefinite) break;
+                return argument;
+            case 1:
+                if (argument == kIndefinite) break;
+                return static_cast<int64_t>(-1 - static_cast<int64_t>(argument));
+            case 2: {
+                std::string data = cbor_text(major, argument);
+                return json::binary(std::vector<uint8_t>(data.begin(), data.end()));
+            }
+            case 3:
+                return cbor_text(major, argument);
+            case 4: {
+                if (argument != kIndefinite) return array(argument, depth, &BinaryReader::cbor);
+                json out = json::array();
+                while (!cbor_break()) out.push_back(cbor(depth + 1));
+                return out;
+            }
+            case 5: {
+                json out = json::object();
+                auto& fields = out.get_ref<json::object_t&>();
+                for (uint64_t i = 0; argument == kIndefinite ? !cbor_break() : i < argument; ++i) {
+                    uint8_t key = byte();
+                    if ((key >> 5) != 3) fail("map key is not a string");
+                    auto it = fields.try_emplace(fields.end(), cbor_text(3, cbor_argument(key & 0x1f)));
+                    it->second = cbor(depth + 1);
+                }
+                return out;
+            }
+            case 6:
+                fail("CBOR tags are not supported");
+        }
+        fail("bad CBOR length");
+    }
+};
+
+} // namespace
+
+void IngestProtocol::append_frame(std::string& out, FrameType type, std::string_view payload) {
+    put_u32(out, static_cast<uint32_t>(payload.size() + 1));
+    out += static_cast<char>(type);
+    out.append(payload);
+}
+
+std::optional<IngestProtocol::Frame> IngestProtocol::next_frame(std::string_view data, size_t max_frame_bytes) {
+    if (data.size() < 4) return std::nullopt;
+    uint32_t length = get_u32(data, 0);
+    if (length == 0) throw std::length_error("empty frame");
+    if (length > max_frame_bytes) throw std::length_error("frame too large");
+    if (data.size() < 4 + length) return std::nullopt;
+    return Frame{static_cast<FrameType>(data[4]), data.substr(kHeaderBytes, length - 1), 4 + length};
+}
+
+std::string IngestProtocol::auth_message(std::string_view nonce) {
+    std::string message(kAuthContext);
+    message.append(nonce);
+    return message;
+}
+
+std::string IngestProtocol::encode_events(const json& events, Encoding encoding) {
+    std::string out;
+    if (encoding == Encoding::Cbor) {
+        json::to_cbor(events, out);
+    } else {
+        json::to_msgpack(events, out);
+    }
+    return out;
+}
+
+json IngestProtocol::decode_events(std::string_view payload, Encoding encoding) {
+    switch (encoding) {
+        case Encoding::MessagePack:
+            return BinaryReader(payload).read_msgpack_document();
+        case Encoding::Cbor:
+            return BinaryReader(payload).read_cbor_document();
+    }
+    throw std::invalid_argument("unknown encoding");
+}
+
+std::string IngestProtocol::encode_ready(const Ready& ready) {
+    std::string out;
+    put_u32(out, ready.credit);
+    put_u32(out, ready.max_frame_bytes);
+    return out;
+}
+
+std::string IngestProtocol::encode_ack(const Ack& ack) {
+    std::string out;
+    put_u64(out, ack.sequence);
+    put_u32(out, ack.accepted);
+    put_u32(out, ack.rejected);
+    put_u32(out, ack.credit);
+    return out;
+}
+
+IngestProtocol::Ready IngestProtocol::decode_ready(std::string_view payload) {
+    if (payload.size() < 8) throw std::runtime_error("short Ready frame");
+    return Ready{get_u32(payload, 0), get_u32(payload, 4)};
+}
+
+IngestProtocol::Ack IngestProtocol::decode_ack(std::string_view payload) {
+    if (payload.size() < 20) throw std::runtime_error("short Ack frame");
+    return Ack{get_u64(payload, 0), get_u32(payload, 8), get_u32(payload, 12), get_u32(payload, 16)};
+}
+
+IngestClient::IngestClient(Config config) : config_(std::move(config)), socket_(ioc_) {}
+
+IngestClient::~IngestClient() {
+    close();
+}
+
+void IngestClient::connect(const std::string& host, unsigned short port) {
+    net::ip::tcp::resolver resolver(ioc_);
+    auto endpoints = resolver.resolve(host, std::to_string(port));
+    net::ip::tcp::socket tcp_socket(ioc_);
+    net::connect(tcp_socket, endpoints);
+    tcp_socket.set_option(net::ip::tcp::no_delay(true));
+
+    auto protocol = tcp_socket.local_endpoint().protocol();
+    socket_ = net::generic::stream_protocol::socket(ioc_, protocol, tcp_socket.release());
+    handshake();
+}
+
+void IngestClient::connect_unix(const std::string& path) {
+    socket_ = net::generic::stream_protocol::socket(ioc_);
+    socket_.connect(net::local::stream_protocol::endpoint(path));
+    handshake();
+}
+
+void IngestClient::handshake() {
+    buffer_.clear();
+    sent_ = 0;
+    totals_ = Totals{};
+
+    auto challenge = read_frame();
+    if (challenge.type != IngestProtocol::FrameType::Challenge || challenge.payload.size() != 1 + IngestProtocol::kNonceBytes) {
+        throw std::runtime_error("expected Challenge frame");
+    }
+    std::string nonce(challenge.payload.substr(1));
+    consume(challenge);
+
+    std::string payload;
+    payload += static_cast<char>(IngestProtocol::kVersion);
+    payload += static_cast<char>(config_.encoding);
+    payload += HTTPIngestor::compute_hmac(config_.secret, IngestProtocol::auth_message(nonce));
+    out_.clear();
+    IngestProtocol::append_frame(out_, IngestProtocol::FrameType::Auth, payload);
+    net::write(socket_, net::buffer(out_));
+
+    auto ready = read_frame();
+    if (ready.type == IngestProtocol::FrameType::Error) {
+        throw std::runtime_error("ingest session refused: " + std::string(ready.payload));
+    }
+    if (ready.type != IngestProtocol::FrameType::Ready) throw std::runtime_error("expected Ready frame");
+    auto granted = IngestProtocol::decode_ready(ready.payload);
+    credit_ = granted.credit;
+    max_frame_bytes_ = granted.max_frame_bytes;
+    consume(ready);
+}
+
+void IngestClient::send(const json& events) {
+    send_encoded(IngestProtocol::encode_events(events, config_.encoding));
+}
+
+void IngestClient::send_encoded(std::string_view payload) {
+    if (payload.size() > max_frame_bytes_) throw std::length_error("batch exceeds the server's frame limit");
+
+    while (credit_ == 0) {
+        auto frame = read_frame();
+        if (frame.type == IngestProtocol::FrameType::Ack) {
+            handle_ack(frame.payload);
+        } else if (frame.type == IngestProtocol::FrameType::Error) {
+            throw std::runtime_error("ingest session closed: " + std::string(frame.payload));
+        }
+        consume(frame);
+    }
+
+    out_.clear();
+    IngestProtocol::append_frame(out_, IngestProtocol::FrameType::Events, payload);
+    net::write(socket_, net::buffer(out_));
+    credit_--;
+    sent_++;
+}
+
+IngestClient::Totals IngestClient::flush() {
+    while (totals_.frames < sent_) {
+        auto frame = read_frame();
+        if (frame.type == IngestProtocol::FrameType::Ack) {
+            handle_ack(frame.payload);
+        } else if (frame.type == IngestProtocol::FrameType::Error) {
+            throw std::runtime_error("ingest session closed: " + std::string(frame.payload));
+        }
+        consume(frame);
+    }
+    return totals_;
+}
+
+void IngestClient::close() {
+    boost::system::error_code ec;
+    socket_.shutdown(net::socket_base::shutdown_both, ec);
+    socket_.close(ec);
+}
+
+IngestProtocol::Frame IngestClient::read_frame() {
+    // Frames from the server are small; anything in the buffer is read first
+    while (true) {
+        if (auto frame = IngestProtocol::next_frame(buffer_, 1 << 20)) return *frame;
+
+        char chunk[4096];
+        size_t n = socket_.read_some(net::buffer(chunk));
+        buffer_.append(chunk, n);
+    }
+}
+
+void IngestClient::consume(const IngestProtocol::Frame& frame) {
+    buffer_.erase(0, frame.size);
+}
+
+void IngestClient::handle_ack(std::string_view payload) {
+    auto ack = IngestProtocol::decode_ack(payload);
+    totals_.frames++;
+    totals_.accepted += ack.accepted;
+    totals_.rejected += ack.rejected;
+    credit_ += ack.credit;
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <boost/asio/generic/stream_protocol.hpp>
+#include <boost/asio/io_context.hpp>
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace net = boost::asio;
+
+namespace siem::ingest {
+
+using json = nlohmann::json;
+
+/**
+ * Binary ingest protocol for co-located agents (TCP or Unix socket)
+ * Every frame is a 4-byte big-endian length, then a type byte and the
+ * payload; the length covers type and payload.
+ *
+ *   server  Challenge  version, 32-byte nonce
+ *   client  Auth       version, encoding, base64 HMAC-SHA256 of
+ *                      auth_message(nonce) under the ingest secret
+ *   server  Ready      initial credit (u32), max frame bytes (u32)
+ *   client  Events     MessagePack / CBOR array of events (or one event)
+ *   server  Ack        sequence (u64), accepted, rejected, credit (u32 each)
+ *   server  Error      UTF-8 reason; the server closes after sending it
+ *
+ * Authentication happens once per session. Each Events frame uses one
+ * credit, and each Ack returns the credit it carries (normally 1). An agent
+ * keeps at most `credit` frames unacknowledged and can resend those if the
+ * session drops; a frame the server could not hand on is never acked, the
+ * session closes with an Error instead. Integers are big-endian.
+ */
+class IngestProtocol {
+public:
+    static constexpr uint8_t kVersion = 1;
+    static constexpr size_t kHeaderBytes = 5;
+    static constexpr size_t kNonceBytes = 32;
+
+    enum class FrameType : uint8_t { Challenge = 1, Auth = 2, Ready = 3, Events = 4, Ack = 5, Error = 6 };
+    enum class Encoding : uint8_t { MessagePack = 1, Cbor = 2 };
+
+    struct Frame {
+        FrameType type;
+        std::string_view payload;
+        size_t size;                  // Header included
+    };
+
+    struct Ready {
+        uint32_t credit = 0;
+        uint32_t max_frame_bytes = 0;
+    };
+
+    struct Ack {
+        uint64_t sequence = 0;        // Events frames processed on this session
+        uint32_t accepted = 0;
+        uint32_t rejected = 0;
+        uint32_t credit = 0;
+    };
+
+    /**
+     * Append one frame to out
+     */
+    static void append_frame(std::string& out, FrameType type, std::string_view payload);
+
+    /**
+     * The first complete frame in data, or nullopt when more bytes are
+     * needed; throws std::length_error past max_frame_bytes
+     */
+    static std::optional<Frame> next_frame(std::string_view data, size_t max_frame_bytes);
+
+    /**
+     * Bytes the client signs: a fixed context label followed by the nonce,
+     * so an HTTP body signature can never double as a session login
+     */
+    static std::string auth_message(std::string_view nonce);
+
+    static std::string encode_events(const json& events, Encoding encoding);
+
+    /**
+     * Throws on malformed payloads or an unknown encoding
+     */
+    static json decode_events(std::string_view payload, Encoding encoding);
+
+    static std::string encode_ready(const Ready& ready);
+    static std::string encode_ack(const Ack& ack);
+
+    /**
+     * Throw std::runtime_error on short payloads
+     */
+    static Ready decode_ready(std::string_view payload);
+    static Ack decode_ack(std::string_view payload);
+};
+
+/**
+ * Blocking agent-side client
+ * send() waits for credit before writing, so at most `credit` frames are
+ * unacknowledged; acks are read as they arrive and summed.
+ */
+class IngestClient {
+public:
+    struct Config {
+        std::string secret;
+        IngestProtocol::Encoding encoding = IngestProtocol::Encoding::MessagePack;
+    };
+
+    struct Totals {
+        uint64_t frames = 0;          // Acknowledged Events frames
+        uint64_t accepted = 0;
+        uint64_t rejected = 0;
+    };
+
+    explicit IngestClient(Config config);
+    ~IngestClient();
+
+    IngestClient(const IngestClient&) = delete;
+    IngestClient& operator=(const IngestClient&) = delete;
+
+    /**
+     * Connect and authenticate; throws on network errors or an Error frame
+     */
+    void connect(const std::string& host, unsigned short port);
+    void connect_unix(const std::string& path);
+
+    /**
+     * Encode and send one batch (array of event objects)
+     */
+    void send(const json& events);
+
+    /**
+     * Send an already encoded Events payload
+     */
+    void send_encoded(std::string_view payload);
+
+    /**
+     * Wait until every sent frame is acknowledged
+     */
+    Totals flush();
+
+    Totals totals() const { return totals_; }
+    uint32_t credit() const { return credit_; }
+
+    void close();
+
+private:
+    Config config_;
+    net::io_context ioc_;
+    net::generic::stream_protocol::socket socket_;
+    std::string buffer_;              // Received, not yet parsed
+    std::string out_;
+    uint32_t credit_ = 0;
+    uint32_t max_frame_bytes_ = 0;
+    uint64_t sent_ = 0;
+    Totals totals_;
+
+    void handshake();
+    IngestProtocol::Frame read_frame();
+    void consume(const IngestProtocol::Frame& frame);
+    void handle_ack(std::string_view payload);
+};
+
+} // namespace siem::ingest
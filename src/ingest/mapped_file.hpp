@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace siem::ingest {
+
+/**
+ * Read-only memory mapping of a whole file
+ * - Mapped with madvise(MADV_SEQUENTIAL) so the kernel reads ahead
+ *   aggressively and drops pages behind the reader
+ * - release() hands consumed pages back, keeping resident memory bounded
+ *   by the read-ahead window rather than the file size
+ * Empty files map to an empty view.
+ */
+class MappedFile {
+public:
+    /**
+     * Throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view view() const {
+        return {static_cast<const char*>(data_), size_};
+    }
+
+    size_t size() const { return size_; }
+
+    /**
+     * Drop resident pages wholly before offset; the data stays readable
+     * and is faulted back in from the file if touched again
+     */
+    void release(size_t offset);
+
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    size_t released_ = 0;
+};
+
+} // namespace siem::ingest
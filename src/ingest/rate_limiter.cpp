@@ -0,0 +1,127 @@
+#include "ingest/rate_limiter.hpp"
+#include "core/hash.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+namespace siem::ingest {
+
+RateLimiter::RateLimiter(Config config)
+    : config_(config)
+    , next_sweep_ns_(std::numeric_limits<int64_t>::min()) {
+    auto per_minute = static_cast<int64_t>(std::max<size_t>(config_.max_events_per_minute, 1));
+    auto burst = static_cast<int64_t>(std::max<size_t>(config_.burst, 1));
+
+    interval_ns_ = std::max<int64_t>(60'000'000'000LL / per_minute, 1);
+    tolerance_ns_ = interval_ns_ * (burst - 1);
+    idle_ns_ = std::max<int64_t>(config_.idle_seconds, 0) * 1'000'000'000LL;
+
+    overflow_.source = "*";
+    overflow_.host = "*";
+}
+
+bool RateLimiter::try_acquire(std::string_view source, std::string_view host) {
+    return try_acquire(source, host, clock::now());
+}
+
+bool RateLimiter::try_acquire(std::string_view source, std::string_view host, clock::time_point now) {
+    if (!config_.enabled) return true;
+
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        now.time_since_epoch()).count();
+    KeyView key{source, host};
+
+    // Buckets are only freed under the exclusive lock, so the token is
+    // taken while still holding whichever lock found the bucket
+    {
+        std::shared_lock lock(mutex_);
+        auto it = buckets_.find(key);
+        if (it != buckets_.end()) return take(*it->second, now_ns);
+    }
+
+    std::unique_lock lock(mutex_);
+    return take(get_bucket(key, now_ns), now_ns);
+}
+
+bool RateLimiter::take(Bucket& bucket, int64_t now_ns) {
+    int64_t tat = bucket.tat_ns.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t base = std::max(tat, now_ns);
+        if (base - now_ns > tolerance_ns_) {
+            bucket.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (bucket.tat_ns.compare_exchange_weak(tat, base + interval_ns_,
+                                                std::memory_order_relaxed)) {
+            bucket.accepted.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+std::vector<RateLimiter::KeyStats> RateLimiter::snapshot() const {
+    std::vector<KeyStats> stats;
+
+    auto add = [&stats](const Bucket& b) {
+        KeyStats s;
+        s.source = b.source;
+        s.host = b.host;
+        s.accepted = b.accepted.load(std::memory_order_relaxed);
+        s.dropped = b.dropped.load(std::memory_order_relaxed);
+        stats.push_back(std::move(s));
+    };
+
+    std::shared_lock lock(mutex_);
+    stats.reserve(buckets_.size() + 1);
+    for (const auto& [key, bucket] : buckets_) {
+        add(*bucket);
+    }
+    if (overflow_.accepted.load(std::memory_order_relaxed) > 0 ||
+        overflow_.dropped.load(std::memory_order_relaxed) > 0) {
+        add(overflow_);
+    }
+
+    return stats;
+}
+
+size_t RateLimiter::KeyHash::operator()(const KeyView& key) const noexcept {
+    return core::Hash64::hash(key.host, core::Hash64::hash(key.source));
+}
+
+RateLimiter::Bucket& RateLimiter::get_bucket(KeyView key, int64_t now_ns) {
+    auto it = buckets_.find(key);
+    if (it != buckets_.end()) return *it->second;
+
+    if (buckets_.size() >= config_.max_keys && now_ns >= next_sweep_ns_) {
+        next_sweep_ns_ = now_ns + 1'000'000'000LL;
+        if (evict_idle(now_ns) == 0) {
+            spdlog::warn(R"({{"msg":"rate_limit_keys_exhausted","max_keys":{}}})", config_.max_keys);
+        }
+    }
+    if (buckets_.size() >= config_.max_keys) {
+        return overflow_;
+    }
+
+    auto bucket = std::make_unique<Bucket>();
+    bucket->source = std::string(key.source);
+    bucket->host = std::string(key.host);
+    auto& ref = *bucket;
+    buckets_.emplace(KeyView{ref.source, ref.host}, std::move(bucket));
+    return ref;
+}
+
+size_t RateLimiter::evict_idle(int64_t now_ns) {
+    // A bucket whose theoretical arrival time is in the past is full again,
+    // the same state a new bucket starts in
+    size_t evicted = std::erase_if(buckets_, [&](const auto& entry) {
+        return entry.second->tat_ns.load(std::memory_order_relaxed) <= now_ns - idle_ns_;
+    });
+    if (evicted > 0) {
+        spdlog::info(R"({{"msg":"rate_limit_keys_evicted","count":{},"remaining":{}}})",
+                    evicted, buckets_.size());
+    }
+    return evicted;
+}
+
+} // namespace siem::ingest
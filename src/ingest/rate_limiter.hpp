@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace siem::ingest {
+
+/**
+ * Per-(source, host) token bucket rate limiter
+ * - Each bucket is a single atomic (GCRA form of the token bucket), so
+ *   acquiring a token never takes a lock
+ * - The key table is read-mostly and only locked exclusively on first sight
+ *   of a new key; lookups hash the (source, host) views without copying them
+ * - Once max_keys are tracked, buckets idle for idle_seconds (full again,
+ *   so forgetting them changes no limit) are evicted to make room, at most
+ *   one sweep per second; their counters restart if the key comes back
+ * - Keys beyond max_keys with nothing idle share one overflow bucket ("*", "*")
+ */
+class RateLimiter {
+public:
+    using clock = std::chrono::steady_clock;
+
+    struct Config {
+        bool enabled = true;
+        size_t max_events_per_minute = 10000; // Sustained rate per key
+        size_t burst = 1000;                  // Bucket capacity
+        size_t max_keys = 10000;
+        int idle_seconds = 60;                // Untouched this long, a bucket may be evicted
+    };
+
+    struct KeyStats {
+        std::string source;
+        std::string host;
+        uint64_t accepted = 0;
+        uint64_t dropped = 0;
+    };
+
+    explicit RateLimiter(Config config);
+
+    /**
+     * Take one token from the (source, host) bucket
+     * Returns false if the event should be dropped
+     */
+    bool try_acquire(std::string_view source, std::string_view host);
+    bool try_acquire(std::string_view source, std::string_view host, clock::time_point now);
+
+    /**
+     * Per-key accepted/dropped counters
+     */
+    std::vector<KeyStats> snapshot() const;
+
+private:
+    struct Bucket {
+        std::string source;
+        std::string host;
+        std::atomic<int64_t> tat_ns{0};   // Theoretical arrival time
+        std::atomic<uint64_t> accepted{0};
+        std::atomic<uint64_t> dropped{0};
+    };
+
+    /**
+     * Table key; stored keys view the bucket's own strings
+     */
+    struct KeyView {
+        std::string_view source;
+        std::string_view host;
+        bool operator==(const KeyView&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const KeyView& key) const noexcept;
+    };
+
+    Config config_;
+    int64_t interval_ns_;
+    int64_t tolerance_ns_;
+    int64_t idle_ns_;
+
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<KeyView, std::unique_ptr<Bucket>, KeyHash> buckets_;
+    Bucket overflow_;
+    int64_t next_sweep_ns_;               // Guarded by the exclusive lock
+
+    bool take(Bucket& bucket, int64_t now_ns);
+    Bucket& get_bucket(KeyView key, int64_t now_ns);
+    size_t evict_idle(int64_t now_ns);
+};
+
+} // namespace siem::ingest
@@ -0,0 +1,278 @@
+#include "ingest/shm_ingestor.hpp"
+#include "core/utf8.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace siem::ingest {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::system_category(), what);
+}
+
+template <typename Enum>
+Enum enum_or_none(uint8_t value, Enum last) {
+    // Other stands for text kept in extra, which a record cannot carry
+    if (value > static_cast<uint8_t>(last) || value == static_cast<uint8_t>(Enum::Other)) return Enum::None;
+    return static_cast<Enum>(value);
+}
+
+} // namespace
+
+ShmIngestor::ShmIngestor(Config config) : config_(std::move(config)), source_(config_.source) {
+    config_.batch_size = std::max<size_t>(config_.batch_size, 1);
+}
+
+ShmIngestor::~ShmIngestor() {
+    stop();
+}
+
+void ShmIngestor::start(EventCallback callback) {
+    if (thread_) {
+        spdlog::warn(R"({{"msg":"shm_ingest_already_running"}})");
+        return;
+    }
+    callback_ = std::move(callback);
+
+    try {
+        ring_ = ShmRing::create(config_.capacity);
+        head_ = 0;
+
+        doorbell_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (doorbell_ < 0) throw_errno("eventfd");
+        stop_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (stop_fd_ < 0) throw_errno("eventfd");
+
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (config_.control_path.size() >= sizeof(addr.sun_path)) {
+            throw std::invalid_argument("control socket path too long");
+        }
+        std::memcpy(addr.sun_path, config_.control_path.data(), config_.control_path.size());
+
+        // A socket left behind by an earlier run would make bind fail; never
+        // unlink anything else a misconfigured path points at
+        std::error_code ec;
+        auto status = std::filesystem::symlink_status(config_.control_path, ec);
+        if (std::filesystem::exists(status)) {
+            if (!std::filesystem::is_socket(status)) {
+                throw std::runtime_error("shm_ingest control_path exists and is not a socket: " +
+                                         config_.control_path);
+            }
+            std::filesystem::remove(config_.control_path, ec);
+        }
+
+        control_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (control_fd_ < 0) throw_errno("socket");
+        if (::bind(control_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) throw_errno("bind");
+        if (::chmod(config_.control_path.c_str(), config_.socket_mode) != 0) throw_errno("chmod");
+        if (::listen(control_fd_, 16) != 0) throw_errno("listen");
+    } catch (...) {
+        close_fds();
+        throw;
+    }
+
+    batch_.reserve(config_.batch_size);
+    stopping_ = false;
+    thread_ = std::make_unique<std::thread>([this]() { run(); });
+
+    spdlog::info(R"({{"msg":"shm_ingest_started","control_path":"{}","capacity":{}}})",
+                config_.control_path, ring_.capacity());
+}
+
+void ShmIngestor::stop() {
+    if (!thread_) return;
+
+    stopping_ = true;
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = ::write(stop_fd_, &one, sizeof(one));
+    if (thread_->joinable()) thread_->join();
+    thread_.reset();
+
+    close_fds();
+    std::error_code ec;
+    if (std::filesystem::is_socket(std::filesystem::symlink_status(config_.control_path, ec))) {
+        std::filesystem::remove(config_.control_path, ec);
+    }
+
+    spdlog::info(R"({{"msg":"shm_ingest_stopped","records":{}}})", records_.load());
+}
+
+ShmIngestor::Stats ShmIngestor::stats() const {
+    uint64_t full = ring_.fd() >= 0 ? ring_.full_count() : 0;
+    return Stats{records_.load(), batches_.load(), full, producers_.load(), rejected_.load(), wakeups_.load()};
+}
+
+void ShmIngestor::close_fds() {
+    for (int* fd : {&doorbell_, &stop_fd_, &control_fd_}) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+    }
+}
+
+void ShmIngestor::run() {
+    auto& waiting = ring_.consumer_waiting();
+
+    while (!stopping_.load(std::memory_order_relaxed)) {
+        if (drain() == config_.batch_size) continue;
+
+        // Ring is empty: raise the flag, then look once more so a record
+        // committed before the producer could see the flag is not missed
+        waiting.store(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring_.peek(head_)) {
+            waiting.store(0, std::memory_order_relaxed);
+            continue;
+        }
+
+        pollfd fds[3] = {{doorbell_, POLLIN, 0}, {control_fd_, POLLIN, 0}, {stop_fd_, POLLIN, 0}};
+        int ready = ::poll(fds, 3, -1);
+        waiting.store(0, std::memory_order_relaxed);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            spdlog::error(R"({{"msg":"shm_ingest_poll_failed","error":"{}"}})", std::strerror(errno));
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            uint64_t count;
+            if (::read(doorbell_, &count, sizeof(count)) == sizeof(count)) wakeups_++;
+        }
+        if (fds[1].revents & POLLIN) accept_producers();
+        if (fds[2].revents & POLLIN) break;
+    }
+
+    // Whatever producers committed before stop
+    while (drain() == config_.batch_size) {}
+}
+
+size_t ShmIngestor::drain() {
+    size_t count = 0;
+    while (count < config_.batch_size) {
+        const ShmRecord* record = ring_.peek(head_);
+        if (!record) break;
+        if (!(record->flags & ShmRecord::kSkip)) {
+            to_event(*record, batch_.emplace_back());
+            if (batch_.back().source.empty()) batch_.back().source = source_;
+        }
+        ring_.release(head_);
+        head_++;
+        count++;
+    }
+    if (batch_.empty()) return count;
+
+    records_ += batch_.size();
+    batches_++;
+    try {
+        callback_(batch_);
+    } catch (const std::exception& e) {
+        spdlog::error(R"({{"msg":"shm_ingest_delivery_failed","events":{},"error":"{}"}})", batch_.size(), e.what());
+    }
+    batch_.clear();
+    return count;
+}
+
+void ShmIngestor::to_event(const ShmRecord& record, storage::Event& event) {
+    static const storage::Symbol unknown("unknown");
+
+    // Read each field once: the producer may still be scribbling on a slot
+    // it has already committed
+    int64_t ts_ms = record.ts_ms;
+    event.ts = ts_ms > 0 ? storage::timestamp_t(std::chrono::milliseconds(ts_ms)) : std::chrono::system_clock::now();
+
+    // Strings are copied before they are checked for UTF-8, and set() may
+    // have truncated one in the middle of a character
+    std::string scratch;
+    auto text = [&scratch](std::string_view field) {
+        scratch.assign(field);
+        if (!core::Utf8::valid(scratch)) scratch = core::Utf8::repair(scratch);
+        return std::string_view(scratch);
+    };
+
+    auto source = text(ShmRecord::get(record.source));
+    event.source = source.empty() ? storage::Symbol() : storage::Symbol(source);
+    auto host = text(ShmRecord::get(record.host));
+    event.host = host.empty() ? unknown : storage::Symbol(host);
+
+    auto& features = event.features;
+    features.verb = enum_or_none(record.verb, storage::Verb::Scan);
+    features.outcome = enum_or_none(record.outcome, storage::Outcome::Alert);
+    features.proto = enum_or_none(record.proto, storage::Proto::Ssh);
+
+    uint32_t flags = record.flags;
+    if (flags & ShmRecord::kDport) features.dport = record.dport;
+    if (flags & ShmRecord::kSport) features.sport = record.sport;
+    if (flags & ShmRecord::kBytes) features.bytes = record.bytes;
+    if (flags & ShmRecord::kPackets) features.packets = record.packets;
+
+    if (auto ip = text(ShmRecord::get(record.ip)); !ip.empty()) features.ip = storage::Symbol(ip);
+    if (auto dst_ip = text(ShmRecord::get(record.dst_ip)); !dst_ip.empty()) features.dst_ip = storage::Symbol(dst_ip);
+    if (auto user = text(ShmRecord::get(record.user)); !user.empty()) features.user = storage::Symbol(user);
+}
+
+bool ShmIngestor::allowed(uint32_t uid, uint32_t gid) const {
+    if (config_.allowed_uids.empty() && config_.allowed_gids.empty()) return uid == ::geteuid();
+    auto listed = [](const std::vector<uint32_t>& ids, uint32_t id) {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    };
+    return listed(config_.allowed_uids, uid) || listed(config_.allowed_gids, gid);
+}
+
+void ShmIngestor::accept_producers() {
+    while (true) {
+        int conn = ::accept4(control_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conn < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                spdlog::warn(R"({{"msg":"shm_ingest_accept_failed","error":"{}"}})", std::strerror(errno));
+            }
+            return;
+        }
+
+        ucred peer{};
+        socklen_t peer_len = sizeof(peer);
+        if (::getsockopt(conn, SOL_SOCKET, SO_PEERCRED, &peer, &peer_len) != 0 || !allowed(peer.uid, peer.gid)) {
+            // Closed without the fds; the producer sees no ring
+            rejected_++;
+            spdlog::warn(R"({{"msg":"shm_ingest_producer_rejected","pid":{},"uid":{},"gid":{}}})",
+                        peer.pid, peer.uid, peer.gid);
+            ::close(conn);
+            continue;
+        }
+
+        char byte = 'R';
+        iovec iov{&byte, 1};
+        int fds[2] = {ring_.fd(), doorbell_};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))] = {};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(fds));
+        std::memcpy(CMSG_DATA(c), fds, sizeof(fds));
+
+        if (::sendmsg(conn, &msg, MSG_NOSIGNAL) == 1) {
+            producers_++;
+            spdlog::info(R"({{"msg":"shm_ingest_producer_attached","pid":{},"uid":{}}})", peer.pid, peer.uid);
+        } else {
+            spdlog::warn(R"({{"msg":"shm_ingest_attach_failed","error":"{}"}})", std::strerror(errno));
+        }
+        ::close(conn);
+    }
+}
+
+} // namespace siem::ingest
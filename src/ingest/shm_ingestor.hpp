@@ -0,0 +1,100 @@
+#pragma once
+
+#include "ingest/shm_ring.hpp"
+#include "storage/schemas.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace siem::ingest {
+
+/**
+ * Shared-memory ingest for collectors on the same host
+ * Owns one ShmRing and serves it on a Unix control socket: a producer
+ * connects, receives the ring memfd and the eventfd doorbell (SCM_RIGHTS)
+ * and from then on writes ShmRecords without talking to us. One thread
+ * drains the ring, turns records straight into events and hands them to
+ * the callback in batches of up to batch_size; the receiver finishes them
+ * with EventNormalizer::finalize. While records keep arriving the drain
+ * loop makes no syscalls; once the ring is empty it sleeps on the doorbell.
+ * An attached producer can write, or stall, any slot, so the ring is only
+ * handed to peers whose SO_PEERCRED uid or gid is on the allow-list.
+ */
+class ShmIngestor {
+public:
+    using EventCallback = std::function<void(std::vector<storage::Event>&)>;
+
+    struct Config {
+        std::string control_path = "/run/siem/ingest.sock";
+        size_t capacity = 16384;           // Records; rounded up to a power of two
+        size_t batch_size = 1024;
+        std::string source = "sensor";     // For records that leave source empty
+        unsigned socket_mode = 0660;       // Who may connect; see the allow-lists for who may attach
+        std::vector<uint32_t> allowed_uids;  // Peers that get the ring; both lists empty = our own uid only
+        std::vector<uint32_t> allowed_gids;
+    };
+
+    struct Stats {
+        uint64_t records = 0;
+        uint64_t batches = 0;
+        uint64_t full = 0;                 // Writes producers could not make because the ring was full
+        uint64_t producers = 0;            // Attachments handed out
+        uint64_t rejected = 0;             // Peers refused by the allow-lists
+        uint64_t wakeups = 0;              // Doorbell rings
+    };
+
+    explicit ShmIngestor(Config config);
+    ~ShmIngestor();
+
+    ShmIngestor(const ShmIngestor&) = delete;
+    ShmIngestor& operator=(const ShmIngestor&) = delete;
+
+    /**
+     * Create the ring, bind the control socket and start draining; throws
+     * std::system_error if either fails
+     */
+    void start(EventCallback callback);
+
+    /**
+     * Deliver whatever is committed, then stop
+     */
+    void stop();
+
+    Stats stats() const;
+
+    /**
+     * Map one record onto an event; out-of-range enum values become None
+     */
+    static void to_event(const ShmRecord& record, storage::Event& event);
+
+private:
+    Config config_;
+    storage::Symbol source_;
+    EventCallback callback_;
+    ShmRing ring_;
+    uint64_t head_ = 0;                    // Next position to read
+    std::vector<storage::Event> batch_;
+
+    int doorbell_ = -1;
+    int stop_fd_ = -1;
+    int control_fd_ = -1;
+    std::atomic<bool> stopping_{false};
+    std::unique_ptr<std::thread> thread_;
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> producers_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> wakeups_{0};
+
+    void run();
+    size_t drain();
+    void accept_producers();
+    bool allowed(uint32_t uid, uint32_t gid) const;
+    void close_fds();
+};
+
+} // namespace siem::ingest
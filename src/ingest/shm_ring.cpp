@@ -0,0 +1,257 @@
+#include "ingest/shm_ring.hpp"
+#include <bit>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace siem::ingest {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring atomics must be lock-free across processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring atomics must be lock-free across processes");
+
+struct ShmRing::Header {
+    uint64_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t record_size = sizeof(ShmRecord);
+    uint64_t capacity = 0;
+
+    // Each written by a different side; kept on separate cache lines
+    alignas(64) std::atomic<uint64_t> tail{0};              // Next position producers claim
+    alignas(64) std::atomic<uint32_t> consumer_waiting{0};
+    alignas(64) std::atomic<uint64_t> full{0};
+};
+
+struct ShmRing::Slot {
+    std::atomic<uint64_t> sequence{0};  // == position: free; position + 1: committed
+    alignas(64) ShmRecord record;
+};
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::system_category(), what);
+}
+
+} // namespace
+
+size_t ShmRing::bytes_for(size_t capacity) {
+    return sizeof(Header) + capacity * sizeof(Slot);
+}
+
+ShmRing ShmRing::create(size_t capacity) {
+    if (capacity == 0 || capacity > kMaxCapacity) {
+        throw std::invalid_argument("ring capacity must be between 1 and " + std::to_string(kMaxCapacity));
+    }
+    capacity = std::bit_ceil(capacity);
+
+    int fd = ::memfd_create("siem-ingest-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) throw_errno("memfd_create");
+
+    ShmRing ring;
+    ring.fd_ = fd;
+    size_t bytes = bytes_for(capacity);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) throw_errno("ftruncate");
+
+    // Producers can then neither shrink the file under our mapping (SIGBUS)
+    // nor grow it
+    if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) throw_errno("F_ADD_SEALS");
+
+    ring.map(fd, bytes);
+    ring.header_ = new (ring.base_) Header{};
+    ring.header_->capacity = capacity;
+    ring.mask_ = capacity - 1;
+    ring.slots_ = reinterpret_cast<Slot*>(static_cast<char*>(ring.base_) + sizeof(Header));
+    for (size_t i = 0; i < capacity; ++i) {
+        new (&ring.slots_[i]) Slot{};
+        ring.slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    return ring;
+}
+
+ShmRing ShmRing::attach(int fd) {
+    ShmRing ring;
+    ring.fd_ = fd;
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) throw_errno("fstat");
+    auto bytes = static_cast<size_t>(st.st_size);
+    if (bytes < sizeof(Header)) throw std::runtime_error("ingest ring is too small");
+
+    ring.map(fd, bytes);
+    auto* header = static_cast<Header*>(ring.base_);
+    if (header->magic != kMagic || header->version != kVersion || header->record_size != sizeof(ShmRecord)) {
+        throw std::runtime_error("ingest ring has an unknown layout");
+    }
+    uint64_t capacity = header->capacity;
+    if (capacity == 0 || capacity > kMaxCapacity || !std::has_single_bit(capacity) ||
+        bytes_for(static_cast<size_t>(capacity)) != bytes) {
+        throw std::runtime_error("ingest ring size does not match its header");
+    }
+
+    ring.header_ = header;
+    ring.mask_ = capacity - 1;
+    ring.slots_ = reinterpret_cast<Slot*>(static_cast<char*>(ring.base_) + sizeof(Header));
+    return ring;
+}
+
+void ShmRing::map(int fd, size_t bytes) {
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) throw_errno("mmap");
+    base_ = base;
+    bytes_ = bytes;
+}
+
+ShmRing::ShmRing(ShmRing&& other) noexcept {
+    *this = std::move(other);
+}
+
+ShmRing& ShmRing::operator=(ShmRing&& other) noexcept {
+    if (this != &other) {
+        reset();
+        fd_ = std::exchange(other.fd_, -1);
+        base_ = std::exchange(other.base_, nullptr);
+        bytes_ = std::exchange(other.bytes_, 0);
+        header_ = std::exchange(other.header_, nullptr);
+        slots_ = std::exchange(other.slots_, nullptr);
+        mask_ = std::exchange(other.mask_, 0);
+    }
+    return *this;
+}
+
+ShmRing::~ShmRing() {
+    reset();
+}
+
+void ShmRing::reset() {
+    if (base_) ::munmap(base_, bytes_);
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+    base_ = nullptr;
+    header_ = nullptr;
+    slots_ = nullptr;
+}
+
+ShmRecord* ShmRing::try_claim(uint64_t& position) {
+    uint64_t pos = header_->tail.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = slots_[pos & mask_];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<int64_t>(sequence - pos);
+        if (diff == 0) {
+            if (header_->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                position = pos;
+                return &slot.record;
+            }
+        } else if (diff < 0) {
+            // The consumer has not released this slot from the previous lap
+            header_->full.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            pos = header_->tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void ShmRing::commit(uint64_t position) {
+    slots_[position & mask_].sequence.store(position + 1, std::memory_order_release);
+}
+
+const ShmRecord* ShmRing::peek(uint64_t position) const {
+    const Slot& slot = slots_[position & mask_];
+    return slot.sequence.load(std::memory_order_acquire) == position + 1 ? &slot.record : nullptr;
+}
+
+void ShmRing::release(uint64_t position) {
+    slots_[position & mask_].sequence.store(position + mask_ + 1, std::memory_order_release);
+}
+
+std::atomic<uint32_t>& ShmRing::consumer_waiting() {
+    return header_->consumer_waiting;
+}
+
+uint64_t ShmRing::full_count() const {
+    return header_->full.load(std::memory_order_relaxed);
+}
+
+ShmRingProducer::ShmRingProducer(const std::string& control_path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (control_path.size() >= sizeof(addr.sun_path)) throw std::invalid_argument("control socket path too long");
+    std::memcpy(addr.sun_path, control_path.data(), control_path.size());
+
+    int sock = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (sock < 0) throw_errno("socket");
+    if (::connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        int error = errno;
+        ::close(sock);
+        throw std::system_error(error, std::system_category(), "connect " + control_path);
+    }
+
+    // The consumer answers with one byte carrying [ring memfd, doorbell eventfd]
+    char byte = 0;
+    iovec iov{&byte, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))];
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    ssize_t n = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+    int error = errno;
+    ::close(sock);
+    if (n < 0) throw std::system_error(error, std::system_category(), "recvmsg");
+
+    int fds[2] = {-1, -1};
+    size_t count = 0;
+    for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SCM_RIGHTS) continue;
+        size_t received = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+        for (size_t i = 0; i < received; ++i) {
+            int fd;
+            std::memcpy(&fd, CMSG_DATA(c) + i * sizeof(int), sizeof(int));
+            if (count < 2) fds[count] = fd;
+            else ::close(fd);
+            count++;
+        }
+    }
+    if (count != 2 || (msg.msg_flags & MSG_CTRUNC)) {
+        for (int fd : fds) if (fd >= 0) ::close(fd);
+        throw std::runtime_error("ingest control socket did not hand out a ring");
+    }
+
+    // A constructor that throws never runs the destructor, so the doorbell
+    // is only handed to doorbell_ once attach() has succeeded (the ring fd
+    // is already owned by the ShmRing attach() builds)
+    struct FdGuard {
+        int fd;
+        ~FdGuard() { if (fd >= 0) ::close(fd); }
+    } doorbell{fds[1]};
+    ring_ = ShmRing::attach(fds[0]);
+    doorbell_ = std::exchange(doorbell.fd, -1);
+}
+
+ShmRingProducer::~ShmRingProducer() {
+    if (doorbell_ >= 0) ::close(doorbell_);
+}
+
+void ShmRingProducer::publish(uint64_t position) {
+    ring_.commit(position);
+
+    // Pairs with the consumer's store-then-recheck: either it sees this
+    // record before sleeping, or we see its flag and ring
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto& waiting = ring_.consumer_waiting();
+    if (waiting.load(std::memory_order_relaxed) && waiting.exchange(0, std::memory_order_acq_rel)) {
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t n = ::write(doorbell_, &one, sizeof(one));
+    }
+}
+
+} // namespace siem::ingest
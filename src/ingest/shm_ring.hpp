@@ -0,0 +1,201 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace siem::ingest {
+
+/**
+ * One event as written by a co-located producer: 256 bytes, fixed layout
+ * Strings are NUL-padded and need no terminator when they fill the field;
+ * verb / outcome / proto hold storage::Verb / Outcome / Proto values. The
+ * layout is shared with producer processes, so fields only ever move into
+ * reserved space.
+ */
+struct ShmRecord {
+    enum Flags : uint32_t {
+        kDport = 1, kSport = 2, kBytes = 4, kPackets = 8,
+        kSkip = 0x80000000          // Abandoned by its producer; consumed without an event
+    };
+
+    int64_t ts_ms = 0;              // Unix ms; 0 = time of consumption
+    uint32_t flags = 0;             // Which optional numbers are present
+    uint8_t verb = 0;
+    uint8_t outcome = 0;
+    uint8_t proto = 0;
+    uint8_t reserved0 = 0;
+    uint16_t dport = 0;
+    uint16_t sport = 0;
+    uint32_t reserved1 = 0;
+    uint64_t bytes = 0;
+    uint64_t packets = 0;
+    char source[24] = {};           // Empty = the consumer's default source
+    char host[64] = {};
+    char ip[46] = {};
+    char dst_ip[46] = {};
+    char user[36] = {};
+
+    /**
+     * Copy value into a string field, truncating to its size
+     */
+    template <size_t N>
+    static void set(char (&field)[N], std::string_view value) {
+        size_t n = std::min(value.size(), N);
+        std::memcpy(field, value.data(), n);
+        std::memset(field + n, 0, N - n);
+    }
+
+    template <size_t N>
+    static std::string_view get(const char (&field)[N]) {
+        return std::string_view(field, ::strnlen(field, N));
+    }
+};
+
+static_assert(sizeof(ShmRecord) == 256, "ShmRecord layout is shared with producers");
+
+/**
+ * Bounded multi-producer / single-consumer ring in a memfd
+ * Each slot carries a sequence number (Vyukov's bounded queue): producers
+ * claim a position with one CAS on the shared tail, write the record in
+ * place and publish it by bumping the slot's sequence; the consumer reads
+ * records in place and hands the slot back the same way. Neither side
+ * makes a syscall while the consumer keeps up. When the consumer runs dry
+ * it raises a waiting flag and sleeps on an eventfd, and the next producer
+ * to publish rings it (see ShmRingProducer).
+ *
+ * A producer that dies between claim and commit stalls the ring at its
+ * slot; producers should fill records before they can fail. (An exception
+ * in ShmRingProducer::try_write commits a kSkip record instead.)
+ */
+class ShmRing {
+public:
+    static constexpr uint64_t kMagic = 0x474e49524d454953ULL;   // "SIEMRING" in memory
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kMaxCapacity = size_t{1} << 22;
+
+    /**
+     * New ring in a sealed memfd; capacity is rounded up to a power of two.
+     * Throws std::invalid_argument past kMaxCapacity, std::system_error on
+     * memfd / mmap failures
+     */
+    static ShmRing create(size_t capacity);
+
+    /**
+     * Map a ring received from the consumer, taking ownership of fd; throws
+     * std::runtime_error when the header or size does not match
+     */
+    static ShmRing attach(int fd);
+
+    ShmRing() = default;
+    ShmRing(ShmRing&& other) noexcept;
+    ShmRing& operator=(ShmRing&& other) noexcept;
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    int fd() const { return fd_; }
+    size_t capacity() const { return static_cast<size_t>(mask_ + 1); }
+
+    // Producer side; any number of threads and processes
+
+    /**
+     * Reserve the next slot, or nullptr when the ring is full
+     */
+    ShmRecord* try_claim(uint64_t& position);
+    void commit(uint64_t position);
+
+    // Consumer side; one thread
+
+    /**
+     * The record at position, or nullptr until it is committed
+     */
+    const ShmRecord* peek(uint64_t position) const;
+    void release(uint64_t position);
+
+    /**
+     * Doorbell handshake flag; see ShmIngestor and ShmRingProducer
+     */
+    std::atomic<uint32_t>& consumer_waiting();
+
+    /**
+     * Claims refused because the ring was full, across all producers
+     */
+    uint64_t full_count() const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t bytes_ = 0;
+    Header* header_ = nullptr;
+    Slot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+
+    static size_t bytes_for(size_t capacity);
+    void map(int fd, size_t bytes);
+    void reset();
+};
+
+/**
+ * Producer-side client for ShmIngestor
+ * Connects to the consumer's control socket, receives the ring memfd and
+ * eventfd doorbell, and maps the ring. try_write never blocks: a full ring
+ * returns false and the caller decides whether to retry, buffer or drop.
+ * One instance may be shared by several threads.
+ */
+class ShmRingProducer {
+public:
+    /**
+     * Throws std::system_error if the control socket cannot be reached,
+     * std::runtime_error if the reply carries no usable ring
+     */
+    explicit ShmRingProducer(const std::string& control_path);
+    ~ShmRingProducer();
+
+    ShmRingProducer(const ShmRingProducer&) = delete;
+    ShmRingProducer& operator=(const ShmRingProducer&) = delete;
+
+    /**
+     * Fill a record in place: fill(ShmRecord&) runs on the claimed slot,
+     * which starts zeroed. If fill throws, the slot is still committed, as
+     * a kSkip record, so the ring does not stall behind it
+     */
+    template <typename Fill>
+    bool try_write(Fill&& fill) {
+        uint64_t position;
+        ShmRecord* record = ring_.try_claim(position);
+        if (!record) return false;
+        *record = ShmRecord{};
+        try {
+            fill(*record);
+        } catch (...) {
+            *record = ShmRecord{};
+            record->flags = ShmRecord::kSkip;
+            publish(position);
+            throw;
+        }
+        publish(position);
+        return true;
+    }
+
+    bool try_write(const ShmRecord& record) {
+        return try_write([&](ShmRecord& slot) { slot = record; });
+    }
+
+    size_t capacity() const { return ring_.capacity(); }
+
+private:
+    ShmRing ring_;
+    int doorbell_ = -1;
+
+    void publish(uint64_t position);
+};
+
+} // namespace siem::ingest
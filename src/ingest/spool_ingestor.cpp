@@ -0,0 +1,271 @@
+#include "ingest/spool_ingestor.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+
+namespace siem::ingest {
+
+namespace fs = std::filesystem;
+
+SpoolIngestor::SpoolIngestor(Config config, core::WorkerPool& pool)
+    : config_(std::move(config))
+    , pool_(pool)
+    , reader_(config_.format) {
+    config_.batch_size = std::max<size_t>(config_.batch_size, 1);
+    config_.max_files_per_scan = std::max<size_t>(config_.max_files_per_scan, 1);
+    config_.max_window_bytes = std::max<size_t>(config_.max_window_bytes, 1);
+    if (config_.done_dir.empty()) config_.done_dir = (fs::path(config_.dir) / "done").string();
+    if (config_.failed_dir.empty()) config_.failed_dir = (fs::path(config_.dir) / "failed").string();
+}
+
+SpoolIngestor::~SpoolIngestor() {
+    stop();
+}
+
+void SpoolIngestor::start(EventCallback callback, ParsedCallback parsed_callback) {
+    if (running_.load()) {
+        spdlog::warn(R"({{"msg":"spool_already_running"}})");
+        return;
+    }
+
+    fs::create_directories(config_.dir);
+    fs::create_directories(config_.done_dir);
+    fs::create_directories(config_.failed_dir);
+
+    running_.store(true);
+    thread_ = std::make_unique<std::thread>([this, callback = std::move(callback),
+                                             parsed_callback = std::move(parsed_callback)]() {
+        while (running_.load()) {
+            size_t handled = 0;
+            try {
+                handled = scan(callback, parsed_callback);
+            } catch (const std::exception& e) {
+                spdlog::error(R"({{"msg":"spool_scan_error","error":"{}"}})", e.what());
+            }
+
+            // Keep draining a backlog; only wait when the spool was empty
+            if (handled == 0) {
+                std::unique_lock<std::mutex> lock(wait_mutex_);
+                wait_cv_.wait_for(lock, std::chrono::milliseconds(config_.poll_ms),
+                                  [this] { return !running_.load(); });
+            }
+        }
+    });
+
+    spdlog::info(R"({{"msg":"spool_started","dir":"{}"}})", config_.dir);
+}
+
+void SpoolIngestor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        if (!running_.exchange(false)) return;
+    }
+    wait_cv_.notify_all();
+
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+
+    spdlog::info(R"({{"msg":"spool_stopped"}})");
+}
+
+SpoolIngestor::Stats SpoolIngestor::stats() const {
+    return Stats{files_done_.load(), files_failed_.load(), bytes_.load(), events_.load()};
+}
+
+std::vector<std::string> SpoolIngestor::list_files() const {
+    std::vector<std::string> files;
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(config_.dir, ec)) {
+        std::error_code type_ec;
+        if (!entry.is_regular_file(type_ec)) continue;
+
+        std::string name = entry.path().filename().string();
+        if (name.starts_with('.') || name.ends_with(".tmp") || name.ends_with(".part")) continue;
+
+        files.push_back(entry.path().string());
+    }
+    if (ec) {
+        spdlog::warn(R"({{"msg":"spool_list_failed","dir":"{}","error":"{}"}})", config_.dir, ec.message());
+    }
+
+    std::sort(files.begin(), files.end());
+    if (files.size() > config_.max_files_per_scan) {
+        files.resize(config_.max_files_per_scan);
+    }
+    return files;
+}
+
+size_t SpoolIngestor::scan(const EventCallback& callback, const ParsedCallback& parsed_callback) {
+    auto files = list_files();
+    if (files.empty()) return 0;
+
+    // Deliver in file order; a file is finished once the batch holding its
+    // last event has been accepted by the callback
+    std::vector<json> batch;
+    batch.reserve(config_.batch_size);
+    std::vector<storage::Event> parsed_batch;
+    std::vector<std::pair<size_t, uint64_t>> complete;  // File index, bytes
+
+    auto flush = [&] {
+        // Counted first: callbacks may move the events out
+        size_t count = batch.size() + parsed_batch.size();
+        if (!batch.empty() && callback) callback(batch);
+        if (!parsed_batch.empty()) parsed_callback(parsed_batch);
+        events_ += count;
+        batch.clear();
+        parsed_batch.clear();
+        for (auto [i, bytes] : complete) {
+            finish(files[i], true);
+            bytes_ += bytes;
+        }
+        complete.clear();
+    };
+    auto add = [&](json&& event) {
+        batch.push_back(std::move(event));
+        if (batch.size() >= config_.batch_size) flush();
+    };
+    auto add_parsed = [&](storage::Event&& event) {
+        parsed_batch.push_back(std::move(event));
+        if (parsed_batch.size() >= config_.batch_size) flush();
+    };
+    auto failed = [&](size_t i, const std::string& error, size_t delivered) {
+        std::error_code ec;
+        if (!fs::exists(files[i], ec)) return;  // Removed by someone else since listing
+        spdlog::warn(R"({{"msg":"spool_file_failed","path":"{}","error":"{}","delivered":{}}})",
+                    files[i], error, delivered);
+        finish(files[i], false);
+    };
+
+    struct Parsed {
+        std::vector<json> events;
+        std::vector<storage::Event> parsed_events;
+        FileIngestor::IngestStats stats;
+        std::string error;
+    };
+    std::vector<Parsed> parsed;
+    size_t window_files = 2 * (pool_.size() + 1);
+
+    for (size_t first = 0; first < files.size();) {
+        // Consecutive files up to max_window_bytes in all, at least one
+        size_t last = first;
+        uint64_t window_bytes = 0;
+        while (last < files.size() && last - first < window_files) {
+            std::error_code ec;
+            uint64_t size = fs::file_size(files[last], ec);
+            if (ec) size = 0;  // Reading it reports the error
+            if (last > first && window_bytes + size > config_.max_window_bytes) break;
+            window_bytes += size;
+            ++last;
+        }
+
+        if (window_bytes > config_.max_window_bytes) {
+            // Too large to hold parsed: deliver batches while reading it.
+            // Earlier files go out first so only this file's tail is dropped
+            // if it fails part way
+            flush();
+            size_t before = events_.load();
+            // A callback refusing a batch is not the file's fault: let it
+            // propagate like the windowed path and leave the file in the
+            // spool for the next scan
+            std::exception_ptr delivery_error;
+            auto deliver = [&](auto& sink) {
+                return [&](auto&& event) {
+                    try {
+                        sink(std::move(event));
+                    } catch (...) {
+                        delivery_error = std::current_exception();
+                        throw;
+                    }
+                };
+            };
+            try {
+                FileIngestor::ParsedSink parsed_sink;
+                if (parsed_callback) parsed_sink = deliver(add_parsed);
+                auto stats = reader_.read_file(files[first], deliver(add), parsed_sink);
+                complete.emplace_back(first, stats.bytes);
+            } catch (const std::exception& e) {
+                if (delivery_error) std::rethrow_exception(delivery_error);
+                batch.clear();
+                parsed_batch.clear();
+                failed(first, e.what(), events_.load() - before);
+            }
+            first = last;
+            continue;
+        }
+
+        // One file per work item: reading and parsing both happen on the pool
+        parsed.assign(last - first, Parsed{});
+        pool_.parallel_for(parsed.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                try {
+                    FileIngestor::ParsedSink parsed_sink;
+                    if (parsed_callback) {
+                        parsed_sink = [&events = parsed[i].parsed_events](storage::Event&& event) {
+                            events.push_back(std::move(event));
+                        };
+                    }
+                    parsed[i].stats = reader_.read_file(files[first + i], [&events = parsed[i].events](json&& event) {
+                        events.push_back(std::move(event));
+                    }, parsed_sink);
+                } catch (const std::exception& e) {
+                    parsed[i].events.clear();
+                    parsed[i].parsed_events.clear();
+                    parsed[i].error = e.what();
+                }
+            }
+        });
+
+        for (size_t i = 0; i < parsed.size(); ++i) {
+            if (!parsed[i].error.empty()) {
+                failed(first + i, parsed[i].error, 0);
+                continue;
+            }
+            for (auto& event : parsed[i].events) add(std::move(event));
+            for (auto& event : parsed[i].parsed_events) add_parsed(std::move(event));
+            parsed[i].events = {};
+            parsed[i].parsed_events = {};
+            complete.emplace_back(first + i, parsed[i].stats.bytes);
+        }
+        first = last;
+    }
+    flush();
+
+    return files.size();
+}
+
+void SpoolIngestor::finish(const std::string& path, bool ok) {
+    fs::path dir(ok ? config_.done_dir : config_.failed_dir);
+    fs::path name = fs::path(path).filename();
+    fs::path target = dir / name;
+
+    // A hard link never replaces an existing file, so a shipper reusing a
+    // name cannot overwrite an earlier file in done / failed: take the
+    // next free name.1.ext, name.2.ext, ... instead
+    std::error_code ec;
+    for (int n = 1;; ++n) {
+        fs::create_hard_link(path, target, ec);
+        if (ec != std::errc::file_exists) break;
+        target = dir / (name.stem().string() + "." + std::to_string(n) + name.extension().string());
+    }
+    if (!ec) {
+        fs::remove(path, ec);
+    } else if (std::error_code exists_ec; !fs::exists(target, exists_ec)) {
+        // No hard links on this filesystem; the name was free a moment ago
+        ec.clear();
+        fs::rename(path, target, ec);
+    }
+    if (ec) {
+        spdlog::error(R"({{"msg":"spool_move_failed","path":"{}","target":"{}","error":"{}"}})",
+                     path, target.string(), ec.message());
+        // A delivered file left in place would be ingested again; a failed
+        // one is kept so it can be inspected
+        if (ok) fs::remove(path, ec);
+    }
+
+    (ok ? files_done_ : files_failed_)++;
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ingest/file_ingestor.hpp"
+#include "core/worker_pool.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace siem::ingest {
+
+/**
+ * Ingests files that shippers drop into a spool directory
+ * - Each scan picks up to max_files_per_scan regular files, oldest name
+ *   first; dotfiles and *.tmp / *.part (still being written) are ignored
+ * - Files are mapped and parsed concurrently on the worker pool, a window
+ *   at a time: a few files per worker and at most max_window_bytes, so the
+ *   parsed events held before delivery stay bounded however large the
+ *   backlog. A file larger than that is parsed on its own and delivered
+ *   batch by batch as it is read
+ * - Events are fed to the callback in file order, in batches of batch_size;
+ *   CEF / LEEF files go to the parsed callback instead (see FileIngestor)
+ * - Once all of a file's events have been delivered it is moved into
+ *   done_dir; files that fail to open or parse go to failed_dir. A name
+ *   already taken there gets a numbered suffix (a.json -> a.1.json)
+ * Shippers should write elsewhere (or under a temporary name) and rename
+ * into the spool, so a file is never read while incomplete.
+ */
+class SpoolIngestor {
+public:
+    using EventCallback = FileIngestor::EventCallback;
+    using ParsedCallback = FileIngestor::ParsedCallback;
+
+    struct Config {
+        std::string dir = "spool";
+        std::string done_dir;            // Default: <dir>/done
+        std::string failed_dir;          // Default: <dir>/failed
+        size_t batch_size = 1000;        // Max events per callback invocation
+        size_t max_files_per_scan = 256;
+        size_t max_window_bytes = 64 << 20;  // File bytes parsed concurrently before delivery
+        int poll_ms = 200;               // Idle wait between scans of an empty spool
+        FileIngestor::Config format;     // Per-file format detection and NDJSON windows
+    };
+
+    struct Stats {
+        uint64_t files_done = 0;
+        uint64_t files_failed = 0;
+        uint64_t bytes = 0;
+        uint64_t events = 0;
+    };
+
+    SpoolIngestor(Config config, core::WorkerPool& pool);
+    ~SpoolIngestor();
+
+    SpoolIngestor(const SpoolIngestor&) = delete;
+    SpoolIngestor& operator=(const SpoolIngestor&) = delete;
+
+    /**
+     * Create the spool, done and failed directories and start scanning
+     */
+    void start(EventCallback callback, ParsedCallback parsed_callback = {});
+    void stop();
+
+    bool is_running() const { return running_.load(); }
+
+    /**
+     * Ingest one round of spooled files; returns the number of files
+     * moved to done or failed. Used by the scan thread and by tests.
+     */
+    size_t scan(const EventCallback& callback, const ParsedCallback& parsed_callback = {});
+
+    Stats stats() const;
+
+private:
+    Config config_;
+    core::WorkerPool& pool_;
+    FileIngestor reader_;
+
+    std::atomic<bool> running_{false};
+    std::unique_ptr<std::thread> thread_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+
+    std::atomic<uint64_t> files_done_{0};
+    std::atomic<uint64_t> files_failed_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> events_{0};
+
+    std::vector<std::string> list_files() const;
+    void finish(const std::string& path, bool ok);
+};
+
+} // namespace siem::ingest
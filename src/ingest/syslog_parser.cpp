@@ -0,0 +1,251 @@
+#include "ingest/syslog_parser.hpp"
+#include "core/utf8.hpp"
+#include <chrono>
+
+namespace siem::ingest {
+
+namespace {
+
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+/**
+ * Next space-delimited header field; "-" (NILVALUE) becomes empty
+ */
+bool next_field(std::string_view input, size_t& pos, std::string_view& field) {
+    size_t end = input.find(' ', pos);
+    if (end == std::string_view::npos || end == pos) return false;
+    field = input.substr(pos, end - pos);
+    if (field == "-") field = {};
+    pos = end + 1;
+    return true;
+}
+
+/**
+ * End of the SD-ELEMENT sequence starting at pos, or npos if malformed
+ */
+size_t skip_structured_data(std::string_view input, size_t pos) {
+    while (pos < input.size() && input[pos] == '[') {
+        bool quoted = false;
+        for (pos++; pos < input.size(); pos++) {
+            char c = input[pos];
+            if (quoted && c == '\\') {
+                pos++;
+            } else if (c == '"') {
+                quoted = !quoted;
+            } else if (c == ']' && !quoted) {
+                break;
+            }
+        }
+        if (pos >= input.size()) return std::string_view::npos;
+        pos++;
+    }
+    return pos;
+}
+
+int month_index(std::string_view name) {
+    static constexpr std::string_view months[] = {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    for (int i = 0; i < 12; ++i) {
+        if (name == months[i]) return i + 1;
+    }
+    return 0;
+}
+
+// Howard Hinnant's days_from_civil
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+bool parse_rfc3164_header(std::string_view input, size_t& pos, SyslogMessage& out) {
+    // "Mmm dd hh:mm:ss " with a space-padded day
+    std::string_view rest = input.substr(pos);
+    if (rest.size() >= 16 && month_index(rest.substr(0, 3)) != 0 && rest[3] == ' ' &&
+        rest[6] == ' ' && rest[9] == ':' && rest[12] == ':' && rest[15] == ' ') {
+        out.timestamp = rest.substr(0, 15);
+        pos += 16;
+
+        // HOSTNAME only follows a timestamp; a trailing ':' means it was a TAG
+        size_t end = input.find(' ', pos);
+        if (end != std::string_view::npos && end > pos && input[end - 1] != ':') {
+            out.hostname = input.substr(pos, end - pos);
+            pos = end + 1;
+        }
+    }
+
+    // TAG[pid]: up to 32 alphanumeric (plus -_./) characters
+    size_t tag_end = pos;
+    while (tag_end < input.size() && tag_end - pos < 32) {
+        char c = input[tag_end];
+        bool tag_char = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || is_digit(c) ||
+                        c == '-' || c == '_' || c == '.' || c == '/';
+        if (!tag_char) break;
+        tag_end++;
+    }
+    if (tag_end == pos || tag_end >= input.size()) return true;
+
+    size_t after = tag_end;
+    std::string_view procid;
+    if (input[after] == '[') {
+        size_t close = input.find(']', after);
+        if (close == std::string_view::npos) return true;
+        procid = input.substr(after + 1, close - after - 1);
+        after = close + 1;
+    }
+    if (after >= input.size() || input[after] != ':') return true;
+
+    out.app_name = input.substr(pos, tag_end - pos);
+    out.procid = procid;
+    pos = after + 1;
+    if (pos < input.size() && input[pos] == ' ') pos++;
+    return true;
+}
+
+} // namespace
+
+bool SyslogParser::parse(std::string_view input, SyslogMessage& out) {
+    out = SyslogMessage{};
+
+    while (!input.empty() && (input.back() == '\n' || input.back() == '\r' || input.back() == '\0')) {
+        input.remove_suffix(1);
+    }
+    if (input.empty()) return false;
+
+    size_t pos = 0;
+    if (input[0] == '<') {
+        unsigned pri = 0;
+        size_t i = 1;
+        while (i < input.size() && i <= 3 && is_digit(input[i])) {
+            pri = pri * 10 + static_cast<unsigned>(input[i] - '0');
+            i++;
+        }
+        if (i > 1 && i < input.size() && input[i] == '>' && pri <= 191) {
+            out.facility = static_cast<uint8_t>(pri / 8);
+            out.severity = static_cast<uint8_t>(pri % 8);
+            pos = i + 1;
+        }
+    }
+
+    if (pos > 0 && input.size() > pos + 1 && input[pos] == '1' && input[pos + 1] == ' ') {
+        out.format = SyslogMessage::Format::Rfc5424;
+        pos += 2;
+
+        if (!next_field(input, pos, out.timestamp) || !next_field(input, pos, out.hostname) ||
+            !next_field(input, pos, out.app_name) || !next_field(input, pos, out.procid) ||
+            !next_field(input, pos, out.msgid) || pos >= input.size()) {
+            return false;
+        }
+
+        if (input[pos] == '-') {
+            pos++;
+        } else {
+            size_t end = skip_structured_data(input, pos);
+            if (end == std::string_view::npos || end == pos) return false;
+            out.structured_data = input.substr(pos, end - pos);
+            pos = end;
+        }
+
+        if (pos < input.size()) {
+            if (input[pos] != ' ') return false;
+            pos++;
+        }
+        out.msg = input.substr(pos);
+        if (out.msg.starts_with("\xEF\xBB\xBF")) out.msg.remove_prefix(3);
+        return true;
+    }
+
+    if (pos > 0) parse_rfc3164_header(input, pos, out);
+    out.msg = input.substr(pos);
+    return true;
+}
+
+void SyslogParser::unescape(std::string_view raw, std::string& out) {
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '\\' && i + 1 < raw.size() &&
+            (raw[i + 1] == '"' || raw[i + 1] == '\\' || raw[i + 1] == ']')) {
+            i++;
+        }
+        out += raw[i];
+    }
+}
+
+std::optional<int64_t> SyslogParser::bsd_timestamp_ms(std::string_view text, int64_t now_ms) {
+    if (text.size() != 15) return std::nullopt;
+
+    int month = month_index(text.substr(0, 3));
+    auto two = [&](size_t at) -> int {
+        char hi = text[at] == ' ' ? '0' : text[at];
+        if (!is_digit(hi) || !is_digit(text[at + 1])) return -1;
+        return (hi - '0') * 10 + (text[at + 1] - '0');
+    };
+    int day = two(4), hour = two(7), minute = two(10), second = two(13);
+    if (month == 0 || day < 1 || day > 31 || hour < 0 || hour > 23 ||
+        minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return std::nullopt;
+    }
+
+    int64_t now_days = now_ms / 86400000;
+    int64_t year = 1970 + now_days / 365;
+    while (days_from_civil(year, 1, 1) > now_days) year--;
+    while (days_from_civil(year + 1, 1, 1) <= now_days) year++;
+
+    auto at_year = [&](int64_t y) {
+        int64_t days = days_from_civil(y, static_cast<unsigned>(month), static_cast<unsigned>(day));
+        return ((days * 24 + hour) * 60 + minute) * 60000 + second * 1000;
+    };
+
+    // Messages from late December read in early January belong to last year
+    int64_t ms = at_year(year);
+    if (ms > now_ms + 86400000) ms = at_year(year - 1);
+    return ms;
+}
+
+json SyslogParser::to_event(const SyslogMessage& message, std::string_view source, std::string_view peer) {
+    json event = json::object();
+    event["source"] = source;
+
+    if (!message.hostname.empty()) {
+        event["host"] = message.hostname;
+    } else if (!peer.empty()) {
+        event["host"] = peer;
+    }
+
+    if (message.format == SyslogMessage::Format::Rfc5424) {
+        if (!message.timestamp.empty()) event["ts"] = message.timestamp;
+    } else if (!message.timestamp.empty()) {
+        auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        if (auto ms = bsd_timestamp_ms(message.timestamp, now)) event["ts"] = *ms;
+    }
+
+    json syslog = {{"facility", message.facility}, {"severity", message.severity}};
+    if (!message.app_name.empty()) syslog["app"] = message.app_name;
+    if (!message.procid.empty()) syslog["procid"] = message.procid;
+    if (!message.msgid.empty()) syslog["msgid"] = message.msgid;
+    event["syslog"] = std::move(syslog);
+
+    if (!message.structured_data.empty()) {
+        json sd = json::object();
+        for_each_param(message.structured_data, [&](std::string_view id, std::string_view name, std::string_view raw) {
+            std::string value;
+            unescape(raw, value);
+            json& element = sd[std::string(id)];
+            if (id == "origin" && name == "ip" && !event.contains("entity")) {
+                event["entity"] = {{"ip", value}};
+            }
+            element[std::string(name)] = std::move(value);
+        });
+        event["sd"] = std::move(sd);
+    }
+
+    event["message"] = message.msg;
+    // RFC 3164 senders are free to send Latin-1 or worse in any field
+    core::Utf8::repair(event);
+    return event;
+}
+
+} // namespace siem::ingest
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace siem::ingest {
+
+using json = nlohmann::json;
+
+/**
+ * One syslog message; every view points into the parsed input
+ * Nil / absent fields are empty views.
+ */
+struct SyslogMessage {
+    enum class Format : uint8_t { Rfc5424, Rfc3164 };
+
+    Format format = Format::Rfc3164;
+    uint8_t facility = 1;              // user
+    uint8_t severity = 5;              // notice
+    std::string_view timestamp;
+    std::string_view hostname;
+    std::string_view app_name;         // RFC 3164: TAG
+    std::string_view procid;
+    std::string_view msgid;
+    std::string_view structured_data;  // "[id k=\"v\"]..." with escapes intact
+    std::string_view msg;
+};
+
+/**
+ * Allocation-free syslog parsing
+ * - RFC 5424: <PRI>1 TIMESTAMP HOST APP PROCID MSGID [SD] MSG
+ * - RFC 3164: <PRI>Mmm dd hh:mm:ss HOST TAG[pid]: MSG, parsed leniently;
+ *   a message without a valid PRI is kept whole as user.notice
+ * to_event() builds the raw event handed to EventNormalizer.
+ */
+class SyslogParser {
+public:
+    /**
+     * Returns false for empty input and malformed RFC 5424 headers or
+     * structured data
+     */
+    static bool parse(std::string_view input, SyslogMessage& out);
+
+    /**
+     * Call fn(sd_id, name, raw_value) for every SD-PARAM; raw_value still
+     * has its \" \\ \] escapes. Returns false on malformed structured data.
+     */
+    template <typename Fn>
+    static bool for_each_param(std::string_view sd, Fn&& fn);
+
+    /**
+     * Append a raw SD-PARAM value to out with escapes removed
+     */
+    static void unescape(std::string_view raw, std::string& out);
+
+    /**
+     * RFC 3164 "Mmm dd hh:mm:ss" as UTC epoch milliseconds, in the year
+     * that puts it closest to (and not more than a day after) now_ms
+     */
+    static std::optional<int64_t> bsd_timestamp_ms(std::string_view text, int64_t now_ms);
+
+    /**
+     * Raw event: source, host (hostname, else peer), ts, message,
+     * syslog.{facility,severity,app,procid,msgid}, sd.<id>.<param>;
+     * RFC 5424 origin ip becomes entity.ip
+     */
+    static json to_event(const SyslogMessage& message, std::string_view source,
+                         std::string_view peer = {});
+};
+
+template <typename Fn>
+bool SyslogParser::for_each_param(std::string_view sd, Fn&& fn) {
+    size_t pos = 0;
+    while (pos < sd.size()) {
+        if (sd[pos] != '[') return false;
+        size_t id_start = ++pos;
+        while (pos < sd.size() && sd[pos] != ' ' && sd[pos] != ']') pos++;
+        if (pos >= sd.size() || pos == id_start) return false;
+        std::string_view id = sd.substr(id_start, pos - id_start);
+
+        while (pos < sd.size() && sd[pos] == ' ') {
+            size_t name_start = ++pos;
+            while (pos < sd.size() && sd[pos] != '=' && sd[pos] != ' ' && sd[pos] != ']') pos++;
+            if (pos + 1 >= sd.size() || sd[pos] != '=' || sd[pos + 1] != '"' || pos == name_start) {
+                return false;
+            }
+            std::string_view name = sd.substr(name_start, pos - name_start);
+
+            size_t value_start = pos += 2;
+            while (pos < sd.size() && sd[pos] != '"') {
+                pos += sd[pos] == '\\' ? 2 : 1;
+            }
+            if (pos >= sd.size()) return false;
+            fn(id, name, sd.substr(value_start, pos - value_start));
+            pos++;
+        }
+
+        if (pos >= sd.size() || sd[pos] != ']') return false;
+        pos++;
+    }
+    return true;
+}
+
+} // namespace siem::ingest
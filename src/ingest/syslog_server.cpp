@@ -0,0 +1,293 @@
+#include "ingest/syslog_server.hpp"
+#include "core/timestamp.hpp"
+#include <spdlog/spdlog.h>
+#include <boost/asio/post.hpp>
+#include <cstring>
+
+namespace siem::ingest {
+
+namespace {
+
+// Longest octet count we accept before the space: 9 digits (< 1 GB)
+constexpr size_t kMaxCountDigits = 9;
+
+} // namespace
+
+/**
+ * One TCP sender; frames are parsed straight out of the receive buffer
+ */
+class SyslogServer::Connection : public std::enable_shared_from_this<Connection> {
+public:
+    Connection(SyslogServer& server, tcp::socket socket)
+        : server_(server), socket_(std::move(socket)) {
+        server_.connections_++;
+    }
+
+    ~Connection() { server_.connections_--; }
+
+    void start() {
+        boost::system::error_code ec;
+        auto endpoint = socket_.remote_endpoint(ec);
+        if (!ec) peer_ = endpoint.address().to_string();
+        buffer_.resize(std::min<size_t>(server_.config_.max_message_bytes + kMaxCountDigits + 1, 65536));
+        read();
+    }
+
+private:
+    SyslogServer& server_;
+    tcp::socket socket_;
+    std::string peer_;
+    std::vector<char> buffer_;
+    size_t begin_ = 0;   // Start of the first unparsed frame
+    size_t end_ = 0;     // End of received data
+
+    void read() {
+        // Make room: compact, then grow up to the largest frame we accept
+        if (buffer_.size() - end_ < 4096 && begin_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        size_t limit = server_.config_.max_message_bytes + kMaxCountDigits + 1;
+        if (buffer_.size() - end_ < 4096 && buffer_.size() < limit) {
+            buffer_.resize(std::min(buffer_.size() * 2, limit));
+        }
+
+        socket_.async_read_some(
+            net::buffer(buffer_.data() + end_, buffer_.size() - end_),
+            [self = shared_from_this()](boost::system::error_code ec, size_t n) {
+                if (ec) return;
+                self->end_ += n;
+                if (self->process()) self->read();
+            });
+    }
+
+    /**
+     * Parse every complete frame; false closes the connection
+     */
+    bool process() {
+        size_t max = server_.config_.max_message_bytes;
+
+        while (begin_ < end_) {
+            std::string_view data(buffer_.data() + begin_, end_ - begin_);
+
+            if (data[0] >= '0' && data[0] <= '9') {
+                // Octet counting: MSG-LEN SP SYSLOG-MSG
+                size_t length = 0, i = 0;
+                while (i < data.size() && i < kMaxCountDigits && data[i] >= '0' && data[i] <= '9') {
+                    length = length * 10 + static_cast<size_t>(data[i] - '0');
+                    i++;
+                }
+                if (i == data.size()) return true;  // Count not complete yet
+                if (data[i] != ' ') return reject("bad_octet_count");
+                if (length > max) {
+                    server_.oversized_++;
+                    return reject("frame_too_large");
+                }
+                if (data.size() < i + 1 + length) break;
+
+                server_.handle_message(data.substr(i + 1, length), peer_);
+                begin_ += i + 1 + length;
+            } else {
+                // Non-transparent framing: one message per line
+                size_t newline = data.find('\n');
+                if (newline == std::string_view::npos) {
+                    if (data.size() > max) {
+                        server_.oversized_++;
+                        return reject("frame_too_large");
+                    }
+                    break;
+                }
+                server_.handle_message(data.substr(0, newline), peer_);
+                begin_ += newline + 1;
+            }
+        }
+
+        if (begin_ == end_) begin_ = end_ = 0;
+        return true;
+    }
+
+    bool reject(const char* reason) {
+        spdlog::warn(R"({{"msg":"syslog_connection_closed","peer":"{}","reason":"{}"}})", peer_, reason);
+        boost::system::error_code ec;
+        socket_.close(ec);
+        return false;
+    }
+};
+
+SyslogServer::SyslogServer(Config config) : config_(std::move(config)), source_(config_.source) {
+    config_.batch_size = std::max<size_t>(config_.batch_size, 1);
+    config_.recv_batch = std::max<size_t>(config_.recv_batch, 1);
+    config_.flush_ms = std::max(config_.flush_ms, 1);
+}
+
+SyslogServer::~SyslogServer() {
+    stop();
+}
+
+void SyslogServer::start(EventCallback callback, ParsedCallback parsed_callback) {
+    if (thread_) {
+        spdlog::warn(R"({{"msg":"syslog_already_running"}})");
+        return;
+    }
+    callback_ = std::move(callback);
+    parsed_callback_ = std::move(parsed_callback);
+
+    auto address = net::ip::make_address(config_.bind_address);
+
+    if (config_.udp_enabled) {
+        UdpReceiver::Config udp_config{config_.recv_batch, config_.max_message_bytes, 0};
+        udp_ = std::make_unique<UdpReceiver>(ioc_, udp::endpoint(address, config_.udp_port), udp_config,
+            [this](std::string_view data, const sockaddr_storage& from) {
+                SyslogMessage message;
+                if (!parse(data, message)) return;
+
+                // The sender address only matters when the message names no host
+                char peer[INET6_ADDRSTRLEN];
+                emit(message, message.hostname.empty() ? UdpReceiver::format_address(from, peer) : std::string_view{});
+            });
+        bound_udp_port_ = udp_->port();
+    }
+
+    if (config_.tcp_enabled) {
+        acceptor_ = std::make_unique<tcp::acceptor>(ioc_, tcp::endpoint(address, config_.tcp_port));
+        bound_tcp_port_ = acceptor_->local_endpoint().port();
+        do_accept();
+    }
+
+    flush_timer_ = std::make_unique<net::steady_timer>(ioc_);
+    schedule_flush();
+
+    thread_ = std::make_unique<std::thread>([this]() { ioc_.run(); });
+
+    spdlog::info(R"({{"msg":"syslog_started","udp_port":{},"tcp_port":{}}})",
+                bound_udp_port_, bound_tcp_port_);
+}
+
+void SyslogServer::stop() {
+    if (!thread_) return;
+
+    net::post(ioc_, [this]() {
+        flush();
+        ioc_.stop();
+    });
+    if (thread_->joinable()) thread_->join();
+    thread_.reset();
+
+    boost::system::error_code ec;
+    if (udp_) udp_->close();
+    if (acceptor_) acceptor_->close(ec);
+
+    spdlog::info(R"({{"msg":"syslog_stopped"}})");
+}
+
+SyslogServer::Stats SyslogServer::stats() const {
+    uint64_t truncated = udp_ ? udp_->truncated() : 0;
+    return Stats{received_.load(), malformed_.load(), oversized_.load() + truncated, connections_.load(), cef_.load()};
+}
+
+void SyslogServer::do_accept() {
+    acceptor_->async_accept([this](boost::system::error_code ec, tcp::socket socket) {
+        if (ec) return;
+
+        if (connections_.load() >= config_.max_connections) {
+            spdlog::warn(R"({{"msg":"syslog_connection_rejected","max_connections":{}}})",
+                        config_.max_connections);
+            socket.close(ec);
+        } else {
+            std::make_shared<Connection>(*this, std::move(socket))->start();
+        }
+        do_accept();
+    });
+}
+
+void SyslogServer::schedule_flush() {
+    flush_timer_->expires_after(std::chrono::milliseconds(config_.flush_ms));
+    flush_timer_->async_wait([this](boost::system::error_code ec) {
+        if (ec) return;
+        flush();
+        schedule_flush();
+    });
+}
+
+bool SyslogServer::parse(std::string_view data, SyslogMessage& message) {
+    received_++;
+    if (!SyslogParser::parse(data, message)) {
+        malformed_++;
+        return false;
+    }
+    return true;
+}
+
+void SyslogServer::handle_message(std::string_view data, std::string_view peer) {
+    SyslogMessage message;
+    if (parse(data, message)) emit(message, peer);
+}
+
+void SyslogServer::emit(const SyslogMessage& message, std::string_view peer) {
+    if (parsed_callback_ && emit_cef(message, peer)) return;
+
+    batch_.push_back(SyslogParser::to_event(message, config_.source, peer));
+    if (config_.grok) config_.grok->match(message.msg, batch_.back());
+    if (batch_.size() >= config_.batch_size) flush();
+}
+
+bool SyslogServer::emit_cef(const SyslogMessage& message, std::string_view peer) {
+    // Lenient RFC 3164 parsing reads "CEF:" / "LEEF:" as a TAG; rejoin it
+    // with the message (both views point into the same datagram)
+    std::string_view payload = message.msg;
+    if (message.app_name == "CEF" || message.app_name == "LEEF") {
+        payload = std::string_view(message.app_name.data(),
+            static_cast<size_t>(message.msg.data() + message.msg.size() - message.app_name.data()));
+    }
+    if (!payload.starts_with("CEF:") && !payload.starts_with("LEEF:")) return false;
+
+    CefMessage cef;
+    if (!CefParser::parse(payload, cef)) return false;
+
+    static const storage::Symbol unknown("unknown");
+    storage::Event event;
+    event.source = source_;
+    event.host = !message.hostname.empty() ? storage::Symbol(message.hostname)
+               : !peer.empty() ? storage::Symbol(peer) : unknown;
+
+    auto now = std::chrono::system_clock::now();
+    event.ts = now;
+    if (message.format == SyslogMessage::Format::Rfc5424) {
+        if (auto ts = core::TimestampParser::parse(message.timestamp)) event.ts = *ts;
+    } else if (!message.timestamp.empty()) {
+        auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+        if (auto ms = SyslogParser::bsd_timestamp_ms(message.timestamp, now_ms)) {
+            event.ts = storage::timestamp_t(std::chrono::milliseconds(*ms));
+        }
+    }
+
+    CefParser::to_event(cef, event, config_.cef_keep_unknown);
+    parsed_batch_.push_back(std::move(event));
+    cef_++;
+    if (parsed_batch_.size() >= config_.batch_size) flush();
+    return true;
+}
+
+void SyslogServer::flush() {
+    if (!batch_.empty()) {
+        try {
+            if (callback_) callback_(batch_);
+        } catch (const std::exception& e) {
+            spdlog::error(R"({{"msg":"syslog_delivery_failed","events":{},"error":"{}"}})", batch_.size(), e.what());
+        }
+        batch_.clear();
+    }
+
+    if (!parsed_batch_.empty()) {
+        try {
+            parsed_callback_(parsed_batch_);
+        } catch (const std::exception& e) {
+            spdlog::error(R"({{"msg":"syslog_delivery_failed","events":{},"error":"{}"}})",
+                         parsed_batch_.size(), e.what());
+        }
+        parsed_batch_.clear();
+    }
+}
+
+} // namespace siem::ingest
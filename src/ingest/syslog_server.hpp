@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ingest/cef_parser.hpp"
+#include "ingest/file_ingestor.hpp"
+#include "ingest/syslog_parser.hpp"
+#include "ingest/udp_receiver.hpp"
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using tcp = net::ip::tcp;
+
+namespace siem::ingest {
+
+/**
+ * Native syslog listener (RFC 5424 / RFC 3164)
+ * - UDP: one datagram per message, received in batches of recv_batch
+ *   (see UdpReceiver)
+ * - TCP: RFC 6587 octet-counted framing ("LEN SP MSG"), falling back to
+ *   newline-delimited framing for senders that start frames with '<'
+ * Parsed messages become raw events (see SyslogParser::to_event) and are
+ * handed to the callback in batches of up to batch_size, or every
+ * flush_ms. With a parsed callback, CEF / LEEF payloads skip JSON and are
+ * delivered as events (see CefParser::to_event) instead. With grok
+ * patterns, captures from the message text are merged into the raw event.
+ * Everything runs on one io thread, including the callbacks.
+ */
+class SyslogServer {
+public:
+    using EventCallback = FileIngestor::EventCallback;
+    using ParsedCallback = FileIngestor::ParsedCallback;
+
+    struct Config {
+        std::string bind_address = "0.0.0.0";
+        bool udp_enabled = true;
+        unsigned short udp_port = 5514;   // 0 = ephemeral (see udp_port())
+        bool tcp_enabled = true;
+        unsigned short tcp_port = 5514;
+        std::string source = "syslog";    // Event "source"; pick a profile by this name
+        size_t batch_size = 1000;
+        int flush_ms = 100;
+        size_t recv_batch = 64;           // Datagrams per recvmmsg call
+        size_t max_message_bytes = 65536; // Larger datagrams / frames are dropped
+        size_t max_connections = 256;
+        bool cef_keep_unknown = true;     // Unmapped CEF / LEEF keys go to features.extra
+        std::shared_ptr<const GrokMatcher> grok;  // Matched against the message text
+    };
+
+    struct Stats {
+        uint64_t received = 0;
+        uint64_t malformed = 0;
+        uint64_t oversized = 0;
+        uint64_t connections = 0;         // Currently open TCP connections
+        uint64_t cef = 0;                 // Delivered as parsed CEF / LEEF events
+    };
+
+    explicit SyslogServer(Config config);
+    ~SyslogServer();
+
+    SyslogServer(const SyslogServer&) = delete;
+    SyslogServer& operator=(const SyslogServer&) = delete;
+
+    /**
+     * Bind the enabled sockets and start the io thread; throws if binding fails
+     */
+    void start(EventCallback callback, ParsedCallback parsed_callback = {});
+
+    /**
+     * Deliver any pending batch, then stop
+     */
+    void stop();
+
+    unsigned short udp_port() const { return bound_udp_port_; }
+    unsigned short tcp_port() const { return bound_tcp_port_; }
+
+    Stats stats() const;
+
+private:
+    class Connection;
+
+    Config config_;
+    storage::Symbol source_;
+    EventCallback callback_;
+    ParsedCallback parsed_callback_;
+    std::vector<json> batch_;
+    std::vector<storage::Event> parsed_batch_;
+
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> malformed_{0};
+    std::atomic<uint64_t> oversized_{0};
+    std::atomic<uint64_t> connections_{0};
+    std::atomic<uint64_t> cef_{0};
+
+    // Declared after everything pending handlers may touch when destroyed
+    net::io_context ioc_;
+    std::unique_ptr<UdpReceiver> udp_;
+    std::unique_ptr<tcp::acceptor> acceptor_;
+    std::unique_ptr<net::steady_timer> flush_timer_;
+    std::unique_ptr<std::thread> thread_;
+    unsigned short bound_udp_port_ = 0;
+    unsigned short bound_tcp_port_ = 0;
+
+    void do_accept();
+    void schedule_flush();
+
+    bool parse(std::string_view data, SyslogMessage& message);
+    void handle_message(std::string_view data, std::string_view peer);
+    void emit(const SyslogMessage& message, std::string_view peer);
+    bool emit_cef(const SyslogMessage& message, std::string_view peer);
+    void flush();
+};
+
+} // namespace siem::ingest
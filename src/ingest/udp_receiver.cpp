@@ -0,0 +1,78 @@
+#include "ingest/udp_receiver.hpp"
+#include <arpa/inet.h>
+
+namespace siem::ingest {
+
+UdpReceiver::UdpReceiver(net::io_context& ioc, const udp::endpoint& endpoint, Config config, Handler handler)
+    : socket_(ioc, endpoint), handler_(std::move(handler)) {
+    socket_.non_blocking(true);
+    if (config.receive_buffer_bytes > 0) {
+        socket_.set_option(net::socket_base::receive_buffer_size(config.receive_buffer_bytes));
+    }
+    port_ = socket_.local_endpoint().port();
+
+    // Datagrams are capped at 64 KiB by the protocol
+    size_t slots = std::max<size_t>(config.batch, 1);
+    slot_bytes_ = std::min<size_t>(std::max<size_t>(config.max_datagram, 1), 65535);
+    buffers_.resize(slots * slot_bytes_);
+    headers_.resize(slots);
+    iovecs_.resize(slots);
+    addresses_.resize(slots);
+    wait();
+}
+
+void UdpReceiver::close() {
+    boost::system::error_code ec;
+    socket_.close(ec);
+}
+
+std::string_view UdpReceiver::format_address(const sockaddr_storage& address, char (&out)[INET6_ADDRSTRLEN]) {
+    const void* addr = address.ss_family == AF_INET6
+        ? static_cast<const void*>(&reinterpret_cast<const sockaddr_in6&>(address).sin6_addr)
+        : static_cast<const void*>(&reinterpret_cast<const sockaddr_in&>(address).sin_addr);
+    if (::inet_ntop(address.ss_family, addr, out, sizeof(out)) == nullptr) return {};
+    return out;
+}
+
+void UdpReceiver::wait() {
+    socket_.async_wait(udp::socket::wait_read, [this](boost::system::error_code ec) {
+        if (ec) return;
+        drain();
+        wait();
+    });
+}
+
+void UdpReceiver::drain() {
+    int fd = socket_.native_handle();
+    size_t slots = headers_.size();
+
+    // Bounded so a flood cannot starve the other handlers on the io thread
+    for (int round = 0; round < 16; ++round) {
+        for (size_t i = 0; i < slots; ++i) {
+            iovecs_[i] = {buffers_.data() + i * slot_bytes_, slot_bytes_};
+            auto& header = headers_[i].msg_hdr;
+            header = {};
+            header.msg_name = &addresses_[i];
+            header.msg_namelen = sizeof(sockaddr_storage);
+            header.msg_iov = &iovecs_[i];
+            header.msg_iovlen = 1;
+        }
+
+        int received = ::recvmmsg(fd, headers_.data(), static_cast<unsigned>(slots), MSG_DONTWAIT, nullptr);
+        if (received <= 0) break;
+
+        for (int i = 0; i < received; ++i) {
+            const auto& header = headers_[i];
+            if (header.msg_hdr.msg_flags & MSG_TRUNC) {
+                truncated_++;
+                continue;
+            }
+            handler_(std::string_view(static_cast<const char*>(iovecs_[i].iov_base), header.msg_len),
+                     addresses_[i]);
+        }
+
+        if (static_cast<size_t>(received) < slots) break;
+    }
+}
+
+} // namespace siem::ingest
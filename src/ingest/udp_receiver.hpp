@@ -0,0 +1,68 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <atomic>
+#include <functional>
+#include <string_view>
+#include <vector>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace net = boost::asio;
+using udp = net::ip::udp;
+
+namespace siem::ingest {
+
+/**
+ * Batched UDP receive loop shared by the datagram listeners
+ * Each time the socket becomes readable it is drained with recvmmsg into
+ * preallocated slots, and the handler sees every complete datagram on the
+ * io thread. Truncated datagrams are counted and dropped.
+ */
+class UdpReceiver {
+public:
+    using Handler = std::function<void(std::string_view datagram, const sockaddr_storage& from)>;
+
+    struct Config {
+        size_t batch = 64;                // Datagrams per recvmmsg call
+        size_t max_datagram = 65535;      // Larger datagrams are dropped
+        int receive_buffer_bytes = 0;     // SO_RCVBUF; 0 = system default
+    };
+
+    /**
+     * Bind and start waiting for datagrams; throws if binding fails
+     */
+    UdpReceiver(net::io_context& ioc, const udp::endpoint& endpoint, Config config, Handler handler);
+
+    UdpReceiver(const UdpReceiver&) = delete;
+    UdpReceiver& operator=(const UdpReceiver&) = delete;
+
+    void close();
+
+    unsigned short port() const { return port_; }
+    uint64_t truncated() const { return truncated_.load(); }
+
+    /**
+     * Numeric form of a sender address ("203.0.113.5", "2001:db8::1")
+     */
+    static std::string_view format_address(const sockaddr_storage& address, char (&out)[INET6_ADDRSTRLEN]);
+
+private:
+    udp::socket socket_;
+    Handler handler_;
+    unsigned short port_ = 0;
+    std::atomic<uint64_t> truncated_{0};
+
+    // recvmmsg buffers, reused for every call
+    size_t slot_bytes_ = 0;
+    std::vector<char> buffers_;
+    std::vector<mmsghdr> headers_;
+    std::vector<iovec> iovecs_;
+    std::vector<sockaddr_storage> addresses_;
+
+    void wait();
+    void drain();
+};
+
+} // namespace siem::ingest
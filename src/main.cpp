@@ -1,10 +1,24 @@
 #include "core/event_normalizer.hpp"
+#include "core/simd_normalizer.hpp"
 #include "core/incident_clusterer.hpp"
 #include "core/correlation.hpp"
+#include "core/interner.hpp"
+#include "core/event_pipeline.hpp"
+#include "core/adaptive_batcher.hpp"
+#include "core/batch_tickets.hpp"
 #include "storage/mongo.hpp"
 #include "storage/change_stream.hpp"
+#include "storage/wal.hpp"
 #include "ingest/file_ingestor.hpp"
+#include "ingest/file_follower.hpp"
+#include "ingest/spool_ingestor.hpp"
+#include "ingest/syslog_server.hpp"
+#include "ingest/flow_collector.hpp"
+#include "ingest/grok_matcher.hpp"
 #include "ingest/http_ingestor.hpp"
+#include "ingest/binary_ingest_server.hpp"
+#include "ingest/shm_ingestor.hpp"
+#include "ingest/dead_letter_spool.hpp"
 #include "api/websocket_server.hpp"
 #include "api/rest_server.hpp"
 #include "audit/auditor.hpp"
@@ -18,6 +32,7 @@
 #include <csignal>
 #include <atomic>
 #include <thread>
+#include <set>
 #include <iostream>
 
 using namespace siem;
@@ -38,7 +53,35 @@ struct AppConfig {
     api::RESTServer::Config rest;
     core::IncidentClusterer::Config clustering;
     core::CorrelationEngine::Config correlation;
+    core::EventNormalizer::Config normalization;
+    bool normalization_simd = false;
+    size_t interner_max_strings = core::StringInterner::kDefaultMaxStrings;
+    size_t worker_threads = core::WorkerPool::default_threads();
     ingest::HTTPIngestor::Config http_ingest;
+    ingest::FileFollower::Config follow;
+    ingest::SpoolIngestor::Config spool;
+    bool spool_enabled = false;
+    ingest::SyslogServer::Config syslog;
+    bool syslog_enabled = false;
+    ingest::FlowCollector::Config netflow;
+    bool netflow_enabled = false;
+    ingest::BinaryIngestServer::Config agent_ingest;
+    bool agent_ingest_enabled = false;
+    ingest::ShmIngestor::Config shm_ingest;
+    bool shm_ingest_enabled = false;
+    storage::WriteAheadLog::Config wal;
+    int store_attempts = 3;         // Per batch from the log while MongoDB answers
+    bool wal_enabled = false;
+    core::EventPipeline::StageConfig cluster_stage;
+    core::EventPipeline::StageConfig correlate_stage;
+    core::EventPipeline::StageConfig store_stage{.workers = 4};
+    core::AdaptiveBatcher::Config batching;
+    bool batching_enabled = true;
+    ingest::DeadLetterSpool::Config dead_letter;
+    bool dead_letter_enabled = false;
+    ingest::GrokMatcher::Config grok;
+    bool grok_spool = true;
+    bool grok_syslog = true;
     std::string log_level = "info";
     std::string log_file = "logs/siem.log";
 };
@@ -59,6 +102,7 @@ AppConfig load_config(const std::string& config_path) {
         config.websocket_port = yaml["server"]["ws_port"].as<unsigned short>();
         config.rest.port = yaml["server"]["rest_port"].as<unsigned short>();
         config.rest.bind_address = yaml["server"]["bind_address"].as<std::string>("0.0.0.0");
+        config.rest.retry_after_seconds = yaml["server"]["retry_after_seconds"].as<int>(5);
     }
     
     // Clustering
@@ -88,6 +132,200 @@ AppConfig load_config(const std::string& config_path) {
     if (yaml["security"]) {
         config.http_ingest.hmac_secret = yaml["security"]["hmac_secret"].as<std::string>();
         config.http_ingest.max_body_size = yaml["security"]["max_body_size"].as<size_t>();
+        config.http_ingest.max_decoded_size = yaml["security"]["max_decoded_size"].as<size_t>(config.http_ingest.max_decoded_size);
+    }
+    
+    // Batch normalization
+    if (yaml["normalization"]) {
+        auto& norm = config.normalization;
+        norm.parallel_min_batch = yaml["normalization"]["parallel_min_batch"].as<size_t>(norm.parallel_min_batch);
+        norm.parallel_chunk = yaml["normalization"]["parallel_chunk"].as<size_t>(norm.parallel_chunk);
+        size_t threads = yaml["normalization"]["worker_threads"].as<size_t>(0);
+        if (threads > 0) config.worker_threads = threads;
+        config.normalization_simd = yaml["normalization"]["simd"].as<bool>(config.normalization_simd);
+        config.interner_max_strings = yaml["normalization"]["interner_max_strings"].as<size_t>(config.interner_max_strings);
+        
+        // Per-source field layouts: target -> pointer or list of pointers (highest priority first)
+        for (const auto& profile : yaml["normalization"]["profiles"]) {
+            auto& spec = norm.profiles[profile.first.as<std::string>()];
+            for (const auto& field : profile.second) {
+                auto& pointers = spec[field.first.as<std::string>()];
+                if (field.second.IsSequence()) {
+                    for (const auto& pointer : field.second) pointers.push_back(pointer.as<std::string>());
+                } else {
+                    pointers.push_back(field.second.as<std::string>());
+                }
+            }
+        }
+    }
+    
+    // Rate limiting (per source/host)
+    if (yaml["rate_limiting"]) {
+        auto& rl = config.http_ingest.rate_limit;
+        rl.enabled = yaml["rate_limiting"]["enabled"].as<bool>(rl.enabled);
+        rl.max_events_per_minute = yaml["rate_limiting"]["max_events_per_minute"].as<size_t>(rl.max_events_per_minute);
+        rl.burst = yaml["rate_limiting"]["burst"].as<size_t>(rl.burst);
+        rl.max_keys = yaml["rate_limiting"]["max_keys"].as<size_t>(rl.max_keys);
+        rl.idle_seconds = yaml["rate_limiting"]["idle_seconds"].as<int>(rl.idle_seconds);
+    }
+    
+    // Local log files to follow
+    if (yaml["follow"]) {
+        auto& follow = config.follow;
+        for (const auto& path : yaml["follow"]["paths"]) {
+            follow.paths.push_back(path.as<std::string>());
+        }
+        follow.checkpoint_file = yaml["follow"]["checkpoint_file"].as<std::string>(follow.checkpoint_file);
+        follow.batch_size = yaml["follow"]["batch_size"].as<size_t>(follow.batch_size);
+        follow.start_at_end = yaml["follow"]["start_at_end"].as<bool>(follow.start_at_end);
+    }
+    
+    // Spool directory for shipper-dropped files
+    if (yaml["spool"]) {
+        auto& spool = config.spool;
+        spool.dir = yaml["spool"]["dir"].as<std::string>(spool.dir);
+        spool.done_dir = yaml["spool"]["done_dir"].as<std::string>(spool.done_dir);
+        spool.failed_dir = yaml["spool"]["failed_dir"].as<std::string>(spool.failed_dir);
+        spool.batch_size = yaml["spool"]["batch_size"].as<size_t>(spool.batch_size);
+        spool.max_files_per_scan = yaml["spool"]["max_files_per_scan"].as<size_t>(spool.max_files_per_scan);
+        spool.max_window_bytes = yaml["spool"]["max_window_bytes"].as<size_t>(spool.max_window_bytes);
+        spool.poll_ms = yaml["spool"]["poll_ms"].as<int>(spool.poll_ms);
+        spool.format.cef_source = yaml["spool"]["cef_source"].as<std::string>(spool.format.cef_source);
+        spool.format.cef_keep_unknown = yaml["spool"]["cef_keep_unknown"].as<bool>(spool.format.cef_keep_unknown);
+        config.spool_enabled = yaml["spool"]["enabled"].as<bool>(true);
+    }
+    
+    // Native syslog listener
+    if (yaml["syslog"]) {
+        auto& syslog = config.syslog;
+        syslog.bind_address = yaml["syslog"]["bind_address"].as<std::string>(syslog.bind_address);
+        syslog.udp_enabled = yaml["syslog"]["udp"].as<bool>(syslog.udp_enabled);
+        syslog.udp_port = yaml["syslog"]["udp_port"].as<unsigned short>(syslog.udp_port);
+        syslog.tcp_enabled = yaml["syslog"]["tcp"].as<bool>(syslog.tcp_enabled);
+        syslog.tcp_port = yaml["syslog"]["tcp_port"].as<unsigned short>(syslog.tcp_port);
+        syslog.source = yaml["syslog"]["source"].as<std::string>(syslog.source);
+        syslog.batch_size = yaml["syslog"]["batch_size"].as<size_t>(syslog.batch_size);
+        syslog.flush_ms = yaml["syslog"]["flush_ms"].as<int>(syslog.flush_ms);
+        syslog.max_message_bytes = yaml["syslog"]["max_message_bytes"].as<size_t>(syslog.max_message_bytes);
+        syslog.cef_keep_unknown = yaml["syslog"]["cef_keep_unknown"].as<bool>(syslog.cef_keep_unknown);
+        config.syslog_enabled = yaml["syslog"]["enabled"].as<bool>(true);
+    }
+    
+    // NetFlow v9 / IPFIX collector
+    if (yaml["netflow"]) {
+        auto& netflow = config.netflow;
+        netflow.bind_address = yaml["netflow"]["bind_address"].as<std::string>(netflow.bind_address);
+        netflow.port = yaml["netflow"]["port"].as<unsigned short>(netflow.port);
+        netflow.source = yaml["netflow"]["source"].as<std::string>(netflow.source);
+        netflow.batch_size = yaml["netflow"]["batch_size"].as<size_t>(netflow.batch_size);
+        netflow.flush_ms = yaml["netflow"]["flush_ms"].as<int>(netflow.flush_ms);
+        netflow.receive_buffer_bytes = yaml["netflow"]["receive_buffer_bytes"].as<int>(netflow.receive_buffer_bytes);
+        netflow.max_templates = yaml["netflow"]["max_templates"].as<size_t>(netflow.max_templates);
+        config.netflow_enabled = yaml["netflow"]["enabled"].as<bool>(true);
+    }
+    
+    // Binary ingest protocol for agents
+    if (yaml["agent_ingest"]) {
+        auto& agent = config.agent_ingest;
+        agent.bind_address = yaml["agent_ingest"]["bind_address"].as<std::string>(agent.bind_address);
+        agent.tcp_enabled = yaml["agent_ingest"]["tcp"].as<bool>(agent.tcp_enabled);
+        agent.port = yaml["agent_ingest"]["port"].as<unsigned short>(agent.port);
+        agent.unix_path = yaml["agent_ingest"]["unix_path"].as<std::string>(agent.unix_path);
+        agent.max_frame_bytes = yaml["agent_ingest"]["max_frame_bytes"].as<size_t>(agent.max_frame_bytes);
+        agent.credit = yaml["agent_ingest"]["credit"].as<uint32_t>(agent.credit);
+        agent.auth_timeout_ms = yaml["agent_ingest"]["auth_timeout_ms"].as<int>(agent.auth_timeout_ms);
+        agent.max_connections = yaml["agent_ingest"]["max_connections"].as<size_t>(agent.max_connections);
+        agent.delivery_threads = yaml["agent_ingest"]["delivery_threads"].as<size_t>(agent.delivery_threads);
+        config.agent_ingest_enabled = yaml["agent_ingest"]["enabled"].as<bool>(true);
+    }
+    
+    // Durable local write-ahead log in front of storage
+    if (yaml["wal"]) {
+        auto& wal = config.wal;
+        wal.dir = yaml["wal"]["dir"].as<std::string>(wal.dir);
+        wal.segment_bytes = yaml["wal"]["segment_bytes"].as<size_t>(wal.segment_bytes);
+        wal.max_bytes = yaml["wal"]["max_bytes"].as<size_t>(wal.max_bytes);
+        wal.replay_batch = yaml["wal"]["replay_batch"].as<size_t>(wal.replay_batch);
+        wal.max_inflight = yaml["wal"]["max_inflight"].as<size_t>(wal.max_inflight);
+        config.store_attempts = yaml["wal"]["store_attempts"].as<int>(config.store_attempts);
+        wal.retry_initial_ms = yaml["wal"]["retry_initial_ms"].as<int>(wal.retry_initial_ms);
+        wal.retry_max_ms = yaml["wal"]["retry_max_ms"].as<int>(wal.retry_max_ms);
+        config.wal_enabled = yaml["wal"]["enabled"].as<bool>(true);
+    }
+    
+    // Cluster → correlate → store stages
+    if (yaml["pipeline"]) {
+        auto load_stage = [&](const char* name, core::EventPipeline::StageConfig& stage) {
+            auto node = yaml["pipeline"][name];
+            if (!node) return;
+            stage.workers = node["workers"].as<size_t>(stage.workers);
+            stage.queue_capacity = node["queue_capacity"].as<size_t>(stage.queue_capacity);
+            stage.max_events = node["max_events"].as<size_t>(stage.max_events);
+        };
+        load_stage("cluster", config.cluster_stage);
+        load_stage("correlate", config.correlate_stage);
+        load_stage("store", config.store_stage);
+    }
+    
+    // Micro-batching in front of the pipeline
+    if (yaml["batching"]) {
+        auto& batching = config.batching;
+        batching.latency_slo_ms = yaml["batching"]["latency_slo_ms"].as<int>(batching.latency_slo_ms);
+        batching.max_linger_ms = yaml["batching"]["max_linger_ms"].as<int>(batching.max_linger_ms);
+        batching.min_batch = yaml["batching"]["min_batch"].as<size_t>(batching.min_batch);
+        batching.max_batch = yaml["batching"]["max_batch"].as<size_t>(batching.max_batch);
+        batching.additive_step = yaml["batching"]["additive_step"].as<size_t>(batching.additive_step);
+        batching.decrease_factor = yaml["batching"]["decrease_factor"].as<double>(batching.decrease_factor);
+        batching.backlog_depth = yaml["batching"]["backlog_depth"].as<size_t>(batching.backlog_depth);
+        config.batching_enabled = yaml["batching"]["enabled"].as<bool>(true);
+    }
+    
+    // Events that fail normalization, kept for inspection and re-drive
+    if (yaml["dead_letter"]) {
+        auto& dlq = config.dead_letter;
+        dlq.dir = yaml["dead_letter"]["dir"].as<std::string>(dlq.dir);
+        dlq.file_bytes = yaml["dead_letter"]["file_bytes"].as<size_t>(dlq.file_bytes);
+        dlq.seal_seconds = yaml["dead_letter"]["seal_seconds"].as<int>(dlq.seal_seconds);
+        dlq.max_bytes = yaml["dead_letter"]["max_bytes"].as<size_t>(dlq.max_bytes);
+        dlq.max_queue = yaml["dead_letter"]["max_queue"].as<size_t>(dlq.max_queue);
+        config.dead_letter_enabled = yaml["dead_letter"]["enabled"].as<bool>(true);
+    }
+    
+    // Shared-memory ring for collectors on this host
+    if (yaml["shm_ingest"]) {
+        auto& shm = config.shm_ingest;
+        shm.control_path = yaml["shm_ingest"]["control_path"].as<std::string>(shm.control_path);
+        shm.capacity = yaml["shm_ingest"]["capacity"].as<size_t>(shm.capacity);
+        shm.batch_size = yaml["shm_ingest"]["batch_size"].as<size_t>(shm.batch_size);
+        shm.source = yaml["shm_ingest"]["source"].as<std::string>(shm.source);
+        if (yaml["shm_ingest"]["socket_mode"]) {
+            // Octal, like chmod: "0660"
+            shm.socket_mode = static_cast<unsigned>(
+                std::stoul(yaml["shm_ingest"]["socket_mode"].as<std::string>(), nullptr, 8));
+        }
+        for (const auto& uid : yaml["shm_ingest"]["allowed_uids"]) {
+            shm.allowed_uids.push_back(uid.as<uint32_t>());
+        }
+        for (const auto& gid : yaml["shm_ingest"]["allowed_gids"]) {
+            shm.allowed_gids.push_back(gid.as<uint32_t>());
+        }
+        config.shm_ingest_enabled = yaml["shm_ingest"]["enabled"].as<bool>(true);
+    }
+    
+    // Grok patterns for free-text logs
+    if (yaml["grok"]) {
+        auto& grok = config.grok;
+        for (const auto& definition : yaml["grok"]["definitions"]) {
+            grok.definitions[definition.first.as<std::string>()] = definition.second.as<std::string>();
+        }
+        for (const auto& pattern : yaml["grok"]["patterns"]) {
+            grok.patterns.push_back({pattern["name"].as<std::string>(), pattern["match"].as<std::string>(),
+                                     pattern["source"].as<std::string>("")});
+        }
+        grok.max_dfa_states = yaml["grok"]["max_dfa_states"].as<size_t>(grok.max_dfa_states);
+        grok.max_line_bytes = yaml["grok"]["max_line_bytes"].as<size_t>(grok.max_line_bytes);
+        config.grok_spool = yaml["grok"]["spool"].as<bool>(config.grok_spool);
+        config.grok_syslog = yaml["grok"]["syslog"].as<bool>(config.grok_syslog);
     }
     
     return config;
@@ -121,9 +359,20 @@ void setup_logging(const AppConfig& config) {
 int main(int argc, char** argv) {
     std::string config_path = "config/app.yaml";
     
-    // Simple argument parsing without CLI11
-    if (argc > 1) {
-        config_path = argv[1];
+    // Simple argument parsing without CLI11:
+    //   siemd [config]
+    //   siemd --redrive-dead-letters [--reason <reason>] [config]
+    bool redrive = false;
+    std::string redrive_reason;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--redrive-dead-letters") {
+            redrive = true;
+        } else if (arg == "--reason" && i + 1 < argc) {
+            redrive_reason = argv[++i];
+        } else {
+            config_path = arg;
+        }
     }
     
     try {
@@ -131,6 +380,23 @@ int main(int argc, char** argv) {
         spdlog::info(R"({{"msg":"loading_config","path":"{}"}})");
         AppConfig config = load_config(config_path);
         setup_logging(config);
+        core::StringInterner::global().set_max_strings(config.interner_max_strings);
+        
+        // Offline command: hand dead letters back to the spool and exit
+        if (redrive) {
+            size_t refused = 0;
+            size_t count = ingest::DeadLetterSpool::redrive(config.dead_letter, config.spool.dir, redrive_reason,
+                                                            &refused);
+            std::cout << count << " dead-lettered events moved to " << config.spool.dir << std::endl;
+            if (refused > 0) {
+                std::cerr << refused << " records are events a pipeline stage failed on, not raw input, and cannot "
+                          << "be re-driven; they stay in " << config.dead_letter.dir << " for inspection" << std::endl;
+            }
+            if (count > 0 && !config.spool_enabled) {
+                std::cerr << "Warning: spool ingest is disabled; they are picked up once it is enabled" << std::endl;
+            }
+            return 0;
+        }
         
         spdlog::info(R"({{"msg":"starting_siem","version":"1.0.0"}})");
         
@@ -138,7 +404,19 @@ int main(int argc, char** argv) {
         storage::MongoStorage mongo_storage(config.mongo);
         mongo_storage.initialize();
         
-        core::EventNormalizer normalizer;
+        core::WorkerPool worker_pool(config.worker_threads);
+        core::EventNormalizer normalizer(config.normalization, worker_pool);
+        
+        // Dropped events go to the dead-letter spool instead of only the log
+        std::unique_ptr<ingest::DeadLetterSpool> dead_letters;
+        if (config.dead_letter_enabled) {
+            config.dead_letter.redaction = config.normalization.redaction;
+            dead_letters = std::make_unique<ingest::DeadLetterSpool>(config.dead_letter);
+            dead_letters->start();
+            normalizer.on_failure([&dead_letters](const json& raw_event, const std::exception& error) {
+                dead_letters->add(raw_event, error);
+            });
+        }
         core::IncidentClusterer clusterer(config.clustering);
         core::CorrelationEngine correlator(config.correlation);
         ingest::HTTPIngestor http_ingestor(config.http_ingest);
@@ -149,6 +427,10 @@ int main(int argc, char** argv) {
         std::map<std::string, storage::Incident> incident_cache;
         std::mutex cache_mutex;
         
+        // Serializes incident writes, so an older copy never lands after a
+        // newer one; correlation only waits for the copy, not for MongoDB
+        std::mutex incident_store_mutex;
+        
         // WebSocket server
         api::WebSocketServer ws_server(config.websocket_port);
         
@@ -160,90 +442,364 @@ int main(int argc, char** argv) {
             spdlog::debug(R"({{"msg":"change_broadcasted","type":"{}"}})");
         });
         
-        // Event processing pipeline
-        auto process_events = [&](const std::vector<json>& raw_events) {
-            metrics::ScopedTimer timer(metrics, "ingest_batch");
-            
-            try {
-                // Normalize
-                auto events = normalizer.normalize_batch(raw_events);
-                metrics.increment("events_ingested_total");
-                
-                // Cluster
-                {
-                    metrics::ScopedTimer cluster_timer(metrics, "cluster_assign");
-                    clusterer.assign_clusters(events);
-                }
+        // Clustering state is not thread-safe, and the cluster stage may run
+        // more than one worker
+        std::mutex cluster_mutex;
+        auto cluster_events = [&](std::vector<storage::Event>& events) {
+            metrics::ScopedTimer cluster_timer(metrics, "cluster_assign");
+            std::lock_guard<std::mutex> lock(cluster_mutex);
+            clusterer.assign_clusters(events);
+        };
+        
+        // Correlate into the incident cache; returns the incidents touched
+        auto correlate_events = [&](std::vector<storage::Event>& events) {
+            // Correlate
+            std::vector<std::string> affected_incident_ids;
+            {
+                std::lock_guard<std::mutex> lock(cache_mutex);
+                affected_incident_ids = correlator.correlate_events(events, incident_cache);
                 
-                // Correlate
-                std::vector<std::string> affected_incident_ids;
-                {
-                    std::lock_guard<std::mutex> lock(cache_mutex);
-                    affected_incident_ids = correlator.correlate_events(events, incident_cache);
-                    
-                    // Update events with incident IDs
-                    for (auto& event : events) {
-                        for (const auto& inc_id : affected_incident_ids) {
-                            if (incident_cache.count(inc_id)) {
-                                const auto& inc = incident_cache[inc_id];
-                                // Check if event belongs to this incident
-                                if (event.cluster_id.has_value()) {
-                                    auto it = std::find(inc.cluster_ids.begin(), 
-                                                       inc.cluster_ids.end(), 
-                                                       *event.cluster_id);
-                                    if (it != inc.cluster_ids.end()) {
-                                        event.incident_id = inc_id;
-                                        break;
-                                    }
+                // Update events with incident IDs
+                for (auto& event : events) {
+                    for (const auto& inc_id : affected_incident_ids) {
+                        if (incident_cache.count(inc_id)) {
+                            const auto& inc = incident_cache[inc_id];
+                            // Check if event belongs to this incident
+                            if (event.cluster_id.has_value()) {
+                                auto it = std::find(inc.cluster_ids.begin(), 
+                                                   inc.cluster_ids.end(), 
+                                                   *event.cluster_id);
+                                if (it != inc.cluster_ids.end()) {
+                                    event.incident_id = inc_id;
+                                    break;
                                 }
                             }
                         }
                     }
                 }
-                
-                // Store events
+            }
+            return affected_incident_ids;
+        };
+        
+        // Store events, incidents and alerts; throws if storage fails
+        // What store_events got done for a batch, so a retry does not insert
+        // its events or alerts a second time; incident upserts are idempotent
+        struct StoreProgress {
+            bool events_stored = false;
+            std::set<std::string> alerted;
+        };
+        
+        auto store_events = [&](const std::vector<storage::Event>& events,
+                                const std::vector<std::string>& affected_incident_ids,
+                                StoreProgress& progress) {
+            // Store events
+            if (!progress.events_stored) {
                 mongo_storage.insert_events(events);
-                
-                // Store incidents
+                progress.events_stored = true;
+            }
+            
+            // Store copies of the incidents, so the cache is not locked
+            // across MongoDB round-trips
+            std::vector<storage::Incident> incidents;
+            {
+                std::lock_guard<std::mutex> store_lock(incident_store_mutex);
                 {
                     std::lock_guard<std::mutex> lock(cache_mutex);
+                    incidents.reserve(affected_incident_ids.size());
                     for (const auto& inc_id : affected_incident_ids) {
-                        if (incident_cache.count(inc_id)) {
-                            mongo_storage.upsert_incident(incident_cache[inc_id]);
-                            
-                            // Check for alerting conditions
-                            const auto& inc = incident_cache[inc_id];
-                            if (inc.scores.count("anomaly") && inc.scores.at("anomaly") >= 0.9) {
-                                if (inc.severity == storage::Severity::High || 
-                                    inc.severity == storage::Severity::Critical) {
-                                    
-                                    storage::Alert alert;
-                                    alert.incident_id = inc_id;
-                                    alert.ts = std::chrono::system_clock::now();
-                                    alert.action = storage::AlertAction::Notify;
-                                    alert.reason = "anomaly>=0.9";
-                                    alert.result = "success";
-                                    
-                                    mongo_storage.insert_alert(alert);
-                                    spdlog::warn(R"({{"msg":"alert_triggered","incident_id":"{}","severity":"{}"}})");
-                                }
-                            }
-                        }
+                        auto it = incident_cache.find(inc_id);
+                        if (it != incident_cache.end()) incidents.push_back(it->second);
                     }
                 }
-                
-                spdlog::info(R"({{"msg":"batch_processed","events":{},"incidents":{}}})",
-                           events.size(), affected_incident_ids.size());
-                
+                for (const auto& inc : incidents) {
+                    mongo_storage.upsert_incident(inc);
+                }
+            }
+            
+            // Check for alerting conditions
+            for (const auto& inc : incidents) {
+                if (progress.alerted.count(inc.id)) continue;
+                if (inc.scores.count("anomaly") && inc.scores.at("anomaly") >= 0.9) {
+                    if (inc.severity == storage::Severity::High || 
+                        inc.severity == storage::Severity::Critical) {
+                        
+                        storage::Alert alert;
+                        alert.incident_id = inc.id;
+                        alert.ts = std::chrono::system_clock::now();
+                        alert.action = storage::AlertAction::Notify;
+                        alert.reason = "anomaly>=0.9";
+                        alert.result = "success";
+                        
+                        mongo_storage.insert_alert(alert);
+                        progress.alerted.insert(inc.id);
+                        spdlog::warn(R"({{"msg":"alert_triggered","incident_id":"{}","severity":"{}"}})",
+                                    inc.id, storage::to_string(inc.severity));
+                    }
+                }
+            }
+            
+            spdlog::info(R"({{"msg":"batch_processed","events":{},"incidents":{}}})",
+                       events.size(), affected_incident_ids.size());
+        };
+        
+        // Write-ahead log: ingest is acknowledged once events are on local
+        // disk, and the pipeline catches up from the log
+        std::unique_ptr<storage::WriteAheadLog> wal;
+        if (config.wal_enabled) {
+            wal = std::make_unique<storage::WriteAheadLog>(config.wal);
+        }
+        
+        // Cluster → correlate → store, each stage on its own workers, so CPU
+        // stages keep going while storage round-trips are in flight
+        core::BatchTickets tickets;     // Outlives the pipeline that resolves them
+        core::EventPipeline pipeline;
+        pipeline.add_stage("cluster", config.cluster_stage, [&](core::EventPipeline::Batch& batch) {
+            cluster_events(batch.events);
+        });
+        pipeline.add_stage("correlate", config.correlate_stage, [&](core::EventPipeline::Batch& batch) {
+            batch.incident_ids = correlate_events(batch.events);
+        });
+        pipeline.add_stage("store", config.store_stage, [&](core::EventPipeline::Batch& batch) {
+            metrics::ScopedTimer timer(metrics, "ingest_batch");
+            StoreProgress progress;
+            if (!wal) {
+                // Throwing fails the tickets, and the ingest path keeps the
+                // events to send again
+                store_events(batch.events, batch.incident_ids, progress);
+                tickets.complete(batch.lsns);
+                return;
+            }
+            
+            // Events from the log wait out storage outages here: handing them
+            // back would cluster and correlate them a second time. A batch
+            // that fails while MongoDB answers pings is the problem itself,
+            // and goes to on_failure after store_attempts, unless its events
+            // are already stored.
+            int attempts = 0;
+            for (int delay_ms = config.wal.retry_initial_ms;;
+                 delay_ms = std::min(delay_ms * 2, config.wal.retry_max_ms)) {
+                try {
+                    store_events(batch.events, batch.incident_ids, progress);
+                    break;
+                } catch (const std::exception& e) {
+                    // Unacknowledged; replayed from the log on the next start
+                    if (shutdown_requested.load()) throw;
+                    if (mongo_storage.ping() && ++attempts >= config.store_attempts) {
+                        if (!progress.events_stored) throw;
+                        // The next batch touching these incidents upserts them again
+                        spdlog::error(R"({{"msg":"incident_store_failed","events":{},"incidents":{},"error":"{}"}})",
+                                     batch.events.size(), batch.incident_ids.size(), e.what());
+                        break;
+                    }
+                    spdlog::warn(R"({{"msg":"storage_retry","events":{},"attempts":{},"retry_ms":{},"error":"{}"}})",
+                                batch.events.size(), attempts, delay_ms, e.what());
+                }
+                for (int waited = 0; waited < delay_ms && !shutdown_requested.load(); waited += 100) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                }
+            }
+            for (uint64_t lsn : batch.lsns) wal->acknowledge(lsn);
+        });
+        
+        // A batch a stage gave up on is kept as dead letters, and acknowledged
+        // to the log so it is not replayed forever. Without the log, the
+        // callers waiting on it are told unless dead letters kept it
+        pipeline.on_failure([&](const std::string& stage, core::EventPipeline::Batch& batch,
+                                const std::exception& error) {
+            if (!wal && (!dead_letters || shutdown_requested.load())) {
+                tickets.fail(batch.lsns, stage + " failed: " + error.what());
+            }
+            // Left in the log for the next start
+            if (shutdown_requested.load()) return;
+            if (dead_letters) {
+                for (const auto& event : batch.events) {
+                    // Already normalized, so kept for inspection only
+                    dead_letters->add(event.source.str(), stage + "_failed", error.what(),
+                                      event.to_json().dump(-1, ' ', false, json::error_handler_t::replace), false);
+                }
+            }
+            if (wal) {
+                for (uint64_t lsn : batch.lsns) wal->acknowledge(lsn);
+            } else {
+                tickets.complete(batch.lsns);
+            }
+        });
+        
+        // Gather small ingest calls, or small batches replayed from the log,
+        // into batches sized by AIMD against the latency SLO, using what the
+        // pipeline reports as batches finish
+        std::unique_ptr<core::AdaptiveBatcher> batcher;
+        if (config.batching_enabled) {
+            batcher = std::make_unique<core::AdaptiveBatcher>(config.batching, [&](core::EventPipeline::Batch&& batch) {
+                // A batch that never reaches the pipeline fails every ticket
+                // merged into it, not only the caller's
+                auto lsns = wal ? std::vector<uint64_t>{} : batch.lsns;
+                try {
+                    pipeline.push(std::move(batch));
+                } catch (const std::exception& e) {
+                    tickets.fail(lsns, e.what());
+                    throw;
+                }
+            });
+            pipeline.on_complete([&](size_t, std::chrono::nanoseconds latency) {
+                batcher->observe(latency, pipeline.depth());
+            });
+        }
+        
+        // Entry point for every ingest path; takes the events. Paths that
+        // acknowledge what they ingest (REST, follower, spool, agents) pass
+        // wait: without the log they return only once the store stage has
+        // the events, and throw if it gave up on them, so nothing is
+        // acknowledged that a crash or a storage error could still lose
+        auto submit_events = [&](std::vector<storage::Event>& events, bool wait) {
+            metrics.increment("events_ingested_total");
+            
+            if (wal) {
+                // Throws when the log cannot take the batch, so the ingestor
+                // does not acknowledge it; the replay feeds the pipeline
+                metrics::ScopedTimer timer(metrics, "wal_append");
+                wal->append(events);
+                return;
+            }
+            
+            // Blocks while the first stage is full, which slows the ingestor
+            uint64_t ticket = wait ? tickets.issue() : 0;
+            try {
+                if (batcher) {
+                    batcher->add(events, ticket);
+                } else {
+                    core::EventPipeline::Batch batch;
+                    batch.events = std::move(events);
+                    if (ticket != 0) batch.lsns.push_back(ticket);
+                    pipeline.push(std::move(batch));
+                }
             } catch (const std::exception& e) {
-                spdlog::error(R"({{"msg":"processing_error","error":"{}"}})", e.what());
+                if (!wait) throw;
+                tickets.fail({ticket}, e.what());
             }
+            if (wait) tickets.wait(ticket);
         };
+        auto process_events = [&](std::vector<storage::Event>& events) { submit_events(events, true); };
+        auto queue_events = [&](std::vector<storage::Event>& events) { submit_events(events, false); };
+        
+        pipeline.start();
+        if (batcher) batcher->start();
+        if (wal) {
+            // Durable events go through the same batcher and pipeline, in log
+            // order, and the store stage acknowledges them
+            wal->start_deferred([&](std::vector<storage::Event>& events, uint64_t lsn) {
+                if (batcher) {
+                    batcher->add(events, lsn);
+                } else {
+                    pipeline.push(core::EventPipeline::Batch{std::move(events), {}, {lsn}});
+                }
+            });
+        }
         
         // REST server
-        api::RESTServer rest_server(config.rest, mongo_storage, http_ingestor);
+        api::RESTServer rest_server(config.rest, mongo_storage, http_ingestor, normalizer);
         rest_server.start(process_events);
         
+        // Events from native parsers (CEF / LEEF, flows) only need finishing
+        auto finish_parsed = [&](std::vector<storage::Event>& events) {
+            normalizer.finalize(events);
+            process_events(events);
+        };
+        auto finish_queued = [&](std::vector<storage::Event>& events) {
+            normalizer.finalize(events);
+            queue_events(events);
+        };
+        
+        // JSON / NDJSON spool files parsed straight into events; finished by
+        // finish_parsed, so redaction is the normalizer's
+        if (config.normalization_simd) {
+            config.spool.format.simd = std::make_shared<const core::SimdEventNormalizer>(config.normalization);
+        }
+        
+        // NDJSON lines that do not parse, and array elements the simd path
+        // cannot turn into events, keep their bytes as dead letters
+        if (dead_letters) {
+            auto skipped = [&dead_letters](std::string_view line, const char* reason) {
+                dead_letters->add("unknown", reason, "unparseable NDJSON line or JSON element", std::string(line));
+            };
+            config.spool.format.on_skipped = skipped;
+            config.follow.on_skipped = skipped;
+        }
+        
+        // Grok patterns, compiled once; a bad pattern stops startup here
+        std::shared_ptr<const ingest::GrokMatcher> grok;
+        if (!config.grok.patterns.empty()) {
+            grok = std::make_shared<const ingest::GrokMatcher>(config.grok);
+            if (config.grok_spool) config.spool.format.grok = grok;
+            if (config.grok_syslog) config.syslog.grok = grok;
+            spdlog::info(R"({{"msg":"grok_compiled","patterns":{}}})", config.grok.patterns.size());
+        }
+        
+        // Follow local log files
+        std::unique_ptr<ingest::FileFollower> file_follower;
+        if (!config.follow.paths.empty()) {
+            file_follower = std::make_unique<ingest::FileFollower>(config.follow);
+            file_follower->start([&](const std::vector<json>& raw_events) {
+                auto events = normalizer.normalize_batch(raw_events);
+                if (!events.empty()) {
+                    process_events(events);
+                }
+            });
+        }
+        
+        // Ingest files dropped into the spool directory
+        std::unique_ptr<ingest::SpoolIngestor> spool_ingestor;
+        if (config.spool_enabled) {
+            spool_ingestor = std::make_unique<ingest::SpoolIngestor>(config.spool, worker_pool);
+            spool_ingestor->start([&](const std::vector<json>& raw_events) {
+                auto events = normalizer.normalize_batch(raw_events);
+                if (!events.empty()) {
+                    process_events(events);
+                }
+            }, finish_parsed);
+        }
+        
+        // Syslog from network gear, normalized like any other raw event
+        std::unique_ptr<ingest::SyslogServer> syslog_server;
+        if (config.syslog_enabled) {
+            syslog_server = std::make_unique<ingest::SyslogServer>(config.syslog);
+            syslog_server->start([&](const std::vector<json>& raw_events) {
+                auto events = normalizer.normalize_batch(raw_events);
+                if (!events.empty()) {
+                    queue_events(events);
+                }
+            }, finish_queued);
+        }
+        
+        // Flow telemetry, decoded straight into events
+        std::unique_ptr<ingest::FlowCollector> flow_collector;
+        if (config.netflow_enabled) {
+            flow_collector = std::make_unique<ingest::FlowCollector>(config.netflow);
+            flow_collector->start(finish_queued);
+        }
+        
+        // Agents on persistent sessions; same secret, redaction and rate
+        // limits as POST /ingest
+        std::unique_ptr<ingest::BinaryIngestServer> agent_server;
+        if (config.agent_ingest_enabled) {
+            agent_server = std::make_unique<ingest::BinaryIngestServer>(config.agent_ingest, http_ingestor);
+            agent_server->start([&](const std::vector<json>& raw_events) {
+                auto events = normalizer.normalize_batch(raw_events);
+                size_t count = events.size();
+                if (!events.empty()) {
+                    process_events(events);
+                }
+                return count;
+            });
+        }
+        
+        // Co-located collectors writing fixed records into shared memory
+        std::unique_ptr<ingest::ShmIngestor> shm_ingestor;
+        if (config.shm_ingest_enabled) {
+            shm_ingestor = std::make_unique<ingest::ShmIngestor>(config.shm_ingest);
+            shm_ingestor->start(finish_queued);
+        }
+        
         // Start WebSocket server
         ws_server.start();
         
@@ -256,10 +812,149 @@ int main(int argc, char** argv) {
         
         // Metrics flush thread
         std::thread metrics_thread([&]() {
+            auto last_flush = std::chrono::steady_clock::now();
+            ingest::SpoolIngestor::Stats last_spool;
+            std::map<std::string, core::EventPipeline::StageStats> last_stages;
+            core::AdaptiveBatcher::Stats last_batching;
+            
             while (!shutdown_requested.load()) {
                 std::this_thread::sleep_for(std::chrono::seconds(60));
                 metrics.flush();
                 metrics.gauge("ws_clients", ws_server.client_count());
+                
+                const auto& interner = core::StringInterner::global();
+                metrics.gauge("interner_strings", interner.size());
+                metrics.gauge("interner_bytes", interner.memory_bytes());
+                
+                if (file_follower) {
+                    auto follow = file_follower->stats();
+                    metrics.gauge("follow_events_total", follow.events);
+                    metrics.gauge("follow_skipped_total", follow.skipped);
+                    metrics.gauge("follow_rotations_total", follow.rotations);
+                }
+                
+                auto now = std::chrono::steady_clock::now();
+                double elapsed = std::chrono::duration<double>(now - last_flush).count();
+                last_flush = now;
+                if (syslog_server) {
+                    auto syslog = syslog_server->stats();
+                    metrics.gauge("syslog_received_total", syslog.received);
+                    metrics.gauge("syslog_malformed_total", syslog.malformed);
+                    metrics.gauge("syslog_oversized_total", syslog.oversized);
+                    metrics.gauge("syslog_connections", syslog.connections);
+                    metrics.gauge("syslog_cef_total", syslog.cef);
+                }
+                
+                if (flow_collector) {
+                    auto netflow = flow_collector->stats();
+                    metrics.gauge("netflow_packets_total", netflow.packets);
+                    metrics.gauge("netflow_records_total", netflow.records);
+                    metrics.gauge("netflow_malformed_total", netflow.malformed);
+                    metrics.gauge("netflow_missing_template_total", netflow.missing_template);
+                    metrics.gauge("netflow_templates", netflow.templates);
+                    metrics.gauge("netflow_evicted_templates_total", netflow.evicted_templates);
+                }
+                
+                if (agent_server) {
+                    auto agent = agent_server->stats();
+                    metrics.gauge("agent_ingest_connections", agent.connections);
+                    metrics.gauge("agent_ingest_auth_failures_total", agent.auth_failures);
+                    metrics.gauge("agent_ingest_frames_total", agent.frames);
+                    metrics.gauge("agent_ingest_events_total", agent.events);
+                    metrics.gauge("agent_ingest_rejected_total", agent.rejected);
+                    metrics.gauge("agent_ingest_protocol_errors_total", agent.protocol_errors);
+                }
+                
+                if (wal) {
+                    auto wal_stats = wal->stats();
+                    metrics.gauge("wal_appended_events_total", wal_stats.appended_events);
+                    metrics.gauge("wal_syncs_total", wal_stats.syncs);
+                    metrics.gauge("wal_replayed_events_total", wal_stats.replayed_events);
+                    metrics.gauge("wal_replay_failures_total", wal_stats.replay_failures);
+                    metrics.gauge("wal_corrupt_records_total", wal_stats.corrupt_records);
+                    metrics.gauge("wal_pending_bytes", wal_stats.pending_bytes);
+                    metrics.gauge("wal_segments", wal_stats.segments);
+                }
+                
+                if (dead_letters) {
+                    auto dlq = dead_letters->stats();
+                    metrics.gauge("dead_letter_written_total", dlq.written);
+                    metrics.gauge("dead_letter_dropped_total", dlq.dropped);
+                    metrics.gauge("dead_letter_evicted_files_total", dlq.evicted_files);
+                    metrics.gauge("dead_letter_bytes", dlq.bytes);
+                    metrics.gauge("dead_letter_files", dlq.files);
+                    for (const auto& [reason, count] : dlq.reasons) {
+                        metrics.gauge("dead_letter_events_total", count, {{"reason", reason}});
+                    }
+                }
+                
+                if (pipeline.is_running()) {
+                    for (const auto& stage : pipeline.stats()) {
+                        json labels = {{"stage", stage.name}};
+                        const auto& last = last_stages[stage.name];
+                        uint64_t batches = stage.batches - last.batches;
+                        metrics.gauge("pipeline_queue_depth", stage.depth, labels);
+                        metrics.gauge("pipeline_events_total", stage.events, labels);
+                        metrics.gauge("pipeline_failures_total", stage.failures, labels);
+                        if (batches > 0) {
+                            metrics.gauge("pipeline_batch_events", static_cast<double>(stage.events - last.events) / batches, labels);
+                            metrics.gauge("pipeline_wait_ms", (stage.wait_ns - last.wait_ns) / 1e6 / batches, labels);
+                            metrics.gauge("pipeline_service_ms", (stage.service_ns - last.service_ns) / 1e6 / batches, labels);
+                        }
+                        last_stages[stage.name] = stage;
+                    }
+                }
+                
+                if (batcher) {
+                    auto batching = batcher->stats();
+                    metrics.gauge("batcher_target_events", batching.target);
+                    metrics.gauge("batcher_batches_total", batching.batches);
+                    metrics.gauge("batcher_size_flushes_total", batching.size_flushes);
+                    metrics.gauge("batcher_linger_flushes_total", batching.linger_flushes);
+                    metrics.gauge("batcher_late_total", batching.late);
+                    uint64_t observed = batching.on_time + batching.late - last_batching.on_time - last_batching.late;
+                    if (observed > 0) {
+                        metrics.gauge("batcher_latency_ms", (batching.latency_ns - last_batching.latency_ns) / 1e6 / observed);
+                    }
+                    last_batching = batching;
+                }
+                
+                if (shm_ingestor) {
+                    auto shm = shm_ingestor->stats();
+                    metrics.gauge("shm_ingest_records_total", shm.records);
+                    metrics.gauge("shm_ingest_batches_total", shm.batches);
+                    metrics.gauge("shm_ingest_full_total", shm.full);
+                    metrics.gauge("shm_ingest_producers_total", shm.producers);
+                    metrics.gauge("shm_ingest_rejected_total", shm.rejected);
+                    metrics.gauge("shm_ingest_wakeups_total", shm.wakeups);
+                }
+                
+                if (grok) {
+                    auto stats = grok->stats();
+                    for (const auto& pattern : stats.patterns) {
+                        json labels = {{"pattern", pattern.name}};
+                        metrics.gauge("grok_hits_total", pattern.hits, labels);
+                        metrics.gauge("grok_match_ns_mean", pattern.mean_ns(), labels);
+                        metrics.gauge("grok_match_ns_p99", pattern.percentile_ns(0.99), labels);
+                    }
+                    metrics.gauge("grok_unmatched_total", stats.unmatched.hits);
+                }
+                
+                if (spool_ingestor) {
+                    auto spool = spool_ingestor->stats();
+                    uint64_t files = spool.files_done + spool.files_failed;
+                    uint64_t last_files = last_spool.files_done + last_spool.files_failed;
+                    metrics.gauge("spool_files_per_second", (files - last_files) / elapsed);
+                    metrics.gauge("spool_bytes_per_second", (spool.bytes - last_spool.bytes) / elapsed);
+                    metrics.gauge("spool_files_failed_total", spool.files_failed);
+                    last_spool = spool;
+                }
+                
+                for (const auto& key : http_ingestor.rate_limiter().snapshot()) {
+                    json labels = {{"source", key.source}, {"host", key.host}};
+                    metrics.gauge("ingest_accepted_total", key.accepted, labels);
+                    metrics.gauge("ingest_rate_limited_total", key.dropped, labels);
+                }
             }
         });
         
@@ -273,7 +968,19 @@ int main(int argc, char** argv) {
         
         change_watcher.stop();
         ws_server.stop();
+        if (file_follower) file_follower->stop();
+        if (spool_ingestor) spool_ingestor->stop();
+        if (syslog_server) syslog_server->stop();
+        if (flow_collector) flow_collector->stop();
+        if (agent_server) agent_server->stop();
+        if (shm_ingestor) shm_ingestor->stop();
         rest_server.stop();
+        // Stop the replay before draining the pipeline; what it still
+        // stores is acknowledged to the log after the replay has stopped
+        if (wal) wal->stop();
+        if (batcher) batcher->stop();
+        pipeline.stop();
+        if (dead_letters) dead_letters->stop();
         
         if (metrics_thread.joinable()) {
             metrics_thread.join();
@@ -104,7 +104,9 @@ void MongoStorage::insert_events(const std::vector<Event>& events) {
     docs.reserve(events.size());
     
     for (const auto& event : events) {
-        auto json_str = event.to_json().dump();
+        // Ingest repairs text it did not parse as JSON; replace is the backstop
+        // so one bad byte never fails a whole batch
+        auto json_str = event.to_json().dump(-1, ' ', false, json::error_handler_t::replace);
         docs.push_back(bsoncxx::from_json(json_str));
     }
     
@@ -115,7 +117,7 @@ void MongoStorage::upsert_incident(const Incident& incident) {
     auto client = pool_->acquire();
     auto collection = (*client)[config_.db_name]["incidents"];
     
-    auto json_str = incident.to_json().dump();
+    auto json_str = incident.to_json().dump(-1, ' ', false, json::error_handler_t::replace);
     auto doc = bsoncxx::from_json(json_str);
     
     document filter;
@@ -245,95 +247,22 @@ std::vector<Event> MongoStorage::query_recent_events(int limit) {
     return events;
 }
 
-mongocxx::client MongoStorage::get_client() {
-    return mongocxx::client{mongocxx::uri{config_.uri}};
-}
-
-// Schema implementations
-json Event::to_json() const {
-    json j;
-    j["ts"] = std::chrono::system_clock::to_time_t(ts);
-    j["source"] = source;
-    j["host"] = host;
-    j["trace_id"] = trace_id;
-    j["fingerprint"] = fingerprint;
-    j["features"] = features;
-    if (cluster_id.has_value()) j["cluster_id"] = *cluster_id;
-    if (incident_id.has_value()) j["incident_id"] = *incident_id;
-    return j;
-}
-
-Event Event::from_json(const json& j) {
-    Event e;
-    e.ts = std::chrono::system_clock::from_time_t(j.value("ts", 0));
-    e.source = j.value("source", "");
-    e.host = j.value("host", "");
-    e.trace_id = j.value("trace_id", "");
-    e.fingerprint = j.value("fingerprint", "");
-    e.features = j.value("features", json::object());
-    if (j.contains("cluster_id")) e.cluster_id = j["cluster_id"].get<std::string>();
-    if (j.contains("incident_id")) e.incident_id = j["incident_id"].get<std::string>();
-    return e;
-}
-
-json Incident::to_json() const {
-    json j;
-    j["_id"] = id;
-    j["status"] = to_string(status);
-    j["title"] = title;
-    j["severity"] = to_string(severity);
-    j["entity"] = entity;
-    j["cluster_ids"] = cluster_ids;
-    j["scores"] = scores;
-    j["created_at"] = std::chrono::system_clock::to_time_t(created_at);
-    j["updated_at"] = std::chrono::system_clock::to_time_t(updated_at);
-    j["last_event_ts"] = std::chrono::system_clock::to_time_t(last_event_ts);
-    return j;
-}
-
-Incident Incident::from_json(const json& j) {
-    Incident i;
-    i.id = j.value("_id", "");
-    i.status = status_from_string(j.value("status", "open"));
-    i.title = j.value("title", "");
-    i.severity = severity_from_string(j.value("severity", "low"));
-    i.entity = j.value("entity", json::object());
-    i.cluster_ids = j.value("cluster_ids", std::vector<std::string>{});
-    i.scores = j.value("scores", std::map<std::string, double>{});
-    i.created_at = std::chrono::system_clock::from_time_t(j.value("created_at", 0));
-    i.updated_at = std::chrono::system_clock::from_time_t(j.value("updated_at", 0));
-    i.last_event_ts = std::chrono::system_clock::from_time_t(j.value("last_event_ts", 0));
-    return i;
-}
-
-json Alert::to_json() const {
-    json j;
-    j["incident_id"] = incident_id;
-    j["ts"] = std::chrono::system_clock::to_time_t(ts);
-    j["action"] = to_string(action);
-    j["reason"] = reason;
-    j["result"] = result;
-    return j;
-}
-
-json AuditEntry::to_json() const {
-    json j;
-    j["ts"] = std::chrono::system_clock::to_time_t(ts);
-    j["actor"] = actor;
-    j["action"] = action;
-    j["incident_id"] = incident_id;
-    j["before"] = before;
-    j["after"] = after;
-    return j;
+bool MongoStorage::ping() {
+    try {
+        auto client = pool_->acquire();
+        auto db = (*client)[config_.db_name];
+        
+        document cmd;
+        cmd << "ping" << 1;
+        db.run_command(cmd.view());
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
 }
 
-json MetricPoint::to_json() const {
-    json j;
-    j["ts"] = std::chrono::system_clock::to_time_t(ts);
-    j["name"] = name;
-    j["value"] = value;
-    j["labels"] = labels;
-    return j;
+mongocxx::client MongoStorage::get_client() {
+    return mongocxx::client{mongocxx::uri{config_.uri}};
 }
 
 } // namespace siem::storage
@@ -71,6 +71,11 @@ public:
      * Query recent events
      */
     std::vector<Event> query_recent_events(int limit = 100);
+    
+    /**
+     * True when the server answers a ping
+     */
+    bool ping();
 
     /**
      * Get MongoDB client for change streams
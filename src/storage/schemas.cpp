@@ -0,0 +1,260 @@
+#include "storage/schemas.hpp"
+
+namespace siem::storage {
+
+template <typename Json>
+void EventFeatures::assign(FeatureSlot slot, std::string_view key, Json&& value) {
+    if (value.is_string()) {
+        set_string(slot, key, value.template get_ref<const std::string&>());
+        return;
+    }
+
+    clear(slot, key);
+    switch (slot) {
+        case FeatureSlot::Dport:
+        case FeatureSlot::Sport:
+            if (value.is_number_integer()) {
+                // is_number_integer() covers unsigned values too
+                bool in_range = value.is_number_unsigned()
+                    ? value.template get<uint64_t>() <= 65535
+                    : value.template get<int64_t>() >= 0 && value.template get<int64_t>() <= 65535;
+                if (in_range) {
+                    (slot == FeatureSlot::Dport ? dport : sport) = static_cast<uint16_t>(value.template get<uint64_t>());
+                    return;
+                }
+            }
+            break;
+        case FeatureSlot::Bytes:
+        case FeatureSlot::Packets:
+            if (value.is_number_integer() && (value.is_number_unsigned() || value.template get<int64_t>() >= 0)) {
+                (slot == FeatureSlot::Bytes ? bytes : packets) = value.template get<uint64_t>();
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    extra[std::string(key)] = std::forward<Json>(value);
+}
+
+void EventFeatures::set(std::string_view key, json value) {
+    assign(slot_of(key), key, std::move(value));
+}
+
+void EventFeatures::set(FeatureSlot slot, std::string_view key, const json& value) {
+    assign(slot, key, value);
+}
+
+void EventFeatures::set(FeatureSlot slot, std::string_view key, json&& value) {
+    assign(slot, key, std::move(value));
+}
+
+void EventFeatures::set_string(std::string_view key, std::string_view value) {
+    set_string(slot_of(key), key, value);
+}
+
+void EventFeatures::set_string(FeatureSlot slot, std::string_view key, std::string_view value) {
+    clear(slot, key);
+    switch (slot) {
+        case FeatureSlot::Verb:
+            verb = verb_from_string(value);
+            if (verb != Verb::Other) return;
+            break;
+        case FeatureSlot::Outcome:
+            outcome = outcome_from_string(value);
+            if (outcome != Outcome::Other) return;
+            break;
+        case FeatureSlot::Proto:
+            proto = proto_from_string(value);
+            if (proto != Proto::Other) return;
+            break;
+        case FeatureSlot::Ip:
+        case FeatureSlot::DstIp:
+        case FeatureSlot::User:
+            if (!value.empty()) {
+                (slot == FeatureSlot::Ip ? ip : slot == FeatureSlot::DstIp ? dst_ip : user) = Symbol(value);
+                return;
+            }
+            break;
+        default:
+            break;
+    }
+    extra[std::string(key)] = std::string(value);
+}
+
+FeatureSlot EventFeatures::slot_of(std::string_view key) {
+    if (key == "verb") return FeatureSlot::Verb;
+    if (key == "outcome") return FeatureSlot::Outcome;
+    if (key == "proto") return FeatureSlot::Proto;
+    if (key == "dport") return FeatureSlot::Dport;
+    if (key == "sport") return FeatureSlot::Sport;
+    if (key == "bytes") return FeatureSlot::Bytes;
+    if (key == "packets") return FeatureSlot::Packets;
+    if (key == "ip") return FeatureSlot::Ip;
+    if (key == "dst_ip") return FeatureSlot::DstIp;
+    if (key == "user") return FeatureSlot::User;
+    return FeatureSlot::Extra;
+}
+
+std::string_view EventFeatures::verb_name() const {
+    return verb == Verb::Other ? extra_string("verb") : to_string(verb);
+}
+
+std::string_view EventFeatures::outcome_name() const {
+    return outcome == Outcome::Other ? extra_string("outcome") : to_string(outcome);
+}
+
+std::string_view EventFeatures::proto_name() const {
+    return proto == Proto::Other ? extra_string("proto") : to_string(proto);
+}
+
+bool EventFeatures::empty() const {
+    return verb == Verb::None && outcome == Outcome::None && proto == Proto::None &&
+           !dport && !sport && !bytes && !packets && ip.empty() && dst_ip.empty() && user.empty() &&
+           extra.empty();
+}
+
+json EventFeatures::to_json() const {
+    json j = extra.is_object() ? extra : json::object();
+    if (verb != Verb::None && verb != Verb::Other) j["verb"] = std::string(to_string(verb));
+    if (outcome != Outcome::None && outcome != Outcome::Other) j["outcome"] = std::string(to_string(outcome));
+    if (proto != Proto::None && proto != Proto::Other) j["proto"] = std::string(to_string(proto));
+    if (dport) j["dport"] = *dport;
+    if (sport) j["sport"] = *sport;
+    if (bytes) j["bytes"] = *bytes;
+    if (packets) j["packets"] = *packets;
+    if (!ip.empty()) j["ip"] = ip.str();
+    if (!dst_ip.empty()) j["dst_ip"] = dst_ip.str();
+    if (!user.empty()) j["user"] = user.str();
+    return j;
+}
+
+EventFeatures EventFeatures::from_json(const json& j) {
+    EventFeatures features;
+    if (!j.is_object()) return features;
+    for (auto it = j.begin(); it != j.end(); ++it) {
+        features.set(it.key(), it.value());
+    }
+    return features;
+}
+
+std::string_view EventFeatures::extra_string(std::string_view key) const {
+    if (!extra.is_object()) return {};
+    auto it = extra.find(std::string(key));
+    if (it == extra.end() || !it->is_string()) return {};
+    return it->get_ref<const std::string&>();
+}
+
+void EventFeatures::clear(FeatureSlot slot, std::string_view key) {
+    switch (slot) {
+        case FeatureSlot::Verb: verb = Verb::None; break;
+        case FeatureSlot::Outcome: outcome = Outcome::None; break;
+        case FeatureSlot::Proto: proto = Proto::None; break;
+        case FeatureSlot::Dport: dport.reset(); break;
+        case FeatureSlot::Sport: sport.reset(); break;
+        case FeatureSlot::Bytes: bytes.reset(); break;
+        case FeatureSlot::Packets: packets.reset(); break;
+        case FeatureSlot::Ip: ip = Symbol(); break;
+        case FeatureSlot::DstIp: dst_ip = Symbol(); break;
+        case FeatureSlot::User: user = Symbol(); break;
+        case FeatureSlot::Extra: break;
+    }
+
+    // An Other value or a misfit from an earlier set; extra is usually null
+    if (extra.is_object() && !extra.empty()) extra.erase(std::string(key));
+}
+
+json Event::to_json() const {
+    json j;
+    j["ts"] = std::chrono::system_clock::to_time_t(ts);
+    j["source"] = source.str();
+    j["host"] = host.str();
+    j["trace_id"] = trace_id;
+    j["fingerprint"] = format_fingerprint(fingerprint);
+    j["features"] = features.to_json();
+    if (cluster_id.has_value()) j["cluster_id"] = *cluster_id;
+    if (incident_id.has_value()) j["incident_id"] = *incident_id;
+    return j;
+}
+
+Event Event::from_json(const json& j) {
+    Event e;
+    e.ts = std::chrono::system_clock::from_time_t(j.value("ts", 0));
+    e.source = Symbol(j.value("source", ""));
+    e.host = Symbol(j.value("host", ""));
+    e.trace_id = j.value("trace_id", "");
+    e.fingerprint = parse_fingerprint(j.value("fingerprint", ""));
+    e.features = EventFeatures::from_json(j.value("features", json::object()));
+    if (j.contains("cluster_id")) e.cluster_id = j["cluster_id"].get<std::string>();
+    if (j.contains("incident_id")) e.incident_id = j["incident_id"].get<std::string>();
+    return e;
+}
+
+json Incident::to_json() const {
+    json j;
+    j["_id"] = id;
+    j["status"] = to_string(status);
+    j["title"] = title;
+    j["severity"] = to_string(severity);
+    j["entity"] = entity;
+    j["cluster_ids"] = cluster_ids;
+    j["scores"] = scores;
+    j["created_at"] = std::chrono::system_clock::to_time_t(created_at);
+    j["updated_at"] = std::chrono::system_clock::to_time_t(updated_at);
+    j["last_event_ts"] = std::chrono::system_clock::to_time_t(last_event_ts);
+    return j;
+}
+
+Incident Incident::from_json(const json& j) {
+    Incident i;
+    i.id = j.value("_id", "");
+    i.status = status_from_string(j.value("status", "open"));
+    i.title = j.value("title", "");
+    i.severity = severity_from_string(j.value("severity", "low"));
+    i.entity = j.value("entity", json::object());
+    for (const char* key : {"ip", "host"}) {
+        auto it = i.entity.find(key);
+        if (it != i.entity.end() && it->is_string()) {
+            i.entity_key = Symbol(it->get_ref<const std::string&>());
+            break;
+        }
+    }
+    i.cluster_ids = j.value("cluster_ids", std::vector<std::string>{});
+    i.scores = j.value("scores", std::map<std::string, double>{});
+    i.created_at = std::chrono::system_clock::from_time_t(j.value("created_at", 0));
+    i.updated_at = std::chrono::system_clock::from_time_t(j.value("updated_at", 0));
+    i.last_event_ts = std::chrono::system_clock::from_time_t(j.value("last_event_ts", 0));
+    return i;
+}
+
+json Alert::to_json() const {
+    json j;
+    j["incident_id"] = incident_id;
+    j["ts"] = std::chrono::system_clock::to_time_t(ts);
+    j["action"] = to_string(action);
+    j["reason"] = reason;
+    j["result"] = result;
+    return j;
+}
+
+json AuditEntry::to_json() const {
+    json j;
+    j["ts"] = std::chrono::system_clock::to_time_t(ts);
+    j["actor"] = actor;
+    j["action"] = action;
+    j["incident_id"] = incident_id;
+    j["before"] = before;
+    j["after"] = after;
+    return j;
+}
+
+json MetricPoint::to_json() const {
+    json j;
+    j["ts"] = std::chrono::system_clock::to_time_t(ts);
+    j["name"] = name;
+    j["value"] = value;
+    j["labels"] = labels;
+    return j;
+}
+
+} // namespace siem::storage
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
 #include <vector>
 #include <map>
 #include <chrono>
 #include <optional>
 #include <nlohmann/json.hpp>
+#include "core/interner.hpp"
 
 namespace siem::storage {
 
 using json = nlohmann::json;
 using timestamp_t = std::chrono::system_clock::time_point;
+using core::Symbol;
 
 enum class Severity {
     Low,
@@ -72,16 +77,206 @@ inline IncidentStatus status_from_string(const std::string& s) {
     return IncidentStatus::Open;
 }
 
+/**
+ * Fingerprints are 64-bit integers in memory and 16 hex characters at the
+ * storage/API boundary
+ */
+inline std::string format_fingerprint(uint64_t fingerprint) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        hex[i] = digits[fingerprint & 0xf];
+        fingerprint >>= 4;
+    }
+    return hex;
+}
+
+inline uint64_t parse_fingerprint(std::string_view hex) {
+    uint64_t fingerprint = 0;
+    auto [end, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), fingerprint, 16);
+    return ec == std::errc() ? fingerprint : 0;
+}
+
+/**
+ * Event feature vocabularies; None means the field is absent and Other means a
+ * string outside the vocabulary, kept verbatim in EventFeatures::extra
+ */
+enum class Verb : uint8_t {
+    None, Other,
+    Allow, Deny, Auth, Login, Logout, Connect, Access,
+    Upload, Download, Exfil, Malware, Scan
+};
+
+enum class Outcome : uint8_t {
+    None, Other,
+    Success, Fail, Allow, Deny, Block, Alert
+};
+
+enum class Proto : uint8_t {
+    None, Other,
+    Tcp, Udp, Icmp, Http, Https, Dns, Ssh
+};
+
+inline std::string_view to_string(Verb v) {
+    switch (v) {
+        case Verb::None:
+        case Verb::Other: return "";
+        case Verb::Allow: return "allow";
+        case Verb::Deny: return "deny";
+        case Verb::Auth: return "auth";
+        case Verb::Login: return "login";
+        case Verb::Logout: return "logout";
+        case Verb::Connect: return "connect";
+        case Verb::Access: return "access";
+        case Verb::Upload: return "upload";
+        case Verb::Download: return "download";
+        case Verb::Exfil: return "exfil";
+        case Verb::Malware: return "malware";
+        case Verb::Scan: return "scan";
+    }
+    return "";
+}
+
+inline std::string_view to_string(Outcome o) {
+    switch (o) {
+        case Outcome::None:
+        case Outcome::Other: return "";
+        case Outcome::Success: return "success";
+        case Outcome::Fail: return "fail";
+        case Outcome::Allow: return "allow";
+        case Outcome::Deny: return "deny";
+        case Outcome::Block: return "block";
+        case Outcome::Alert: return "alert";
+    }
+    return "";
+}
+
+inline std::string_view to_string(Proto p) {
+    switch (p) {
+        case Proto::None:
+        case Proto::Other: return "";
+        case Proto::Tcp: return "tcp";
+        case Proto::Udp: return "udp";
+        case Proto::Icmp: return "icmp";
+        case Proto::Http: return "http";
+        case Proto::Https: return "https";
+        case Proto::Dns: return "dns";
+        case Proto::Ssh: return "ssh";
+    }
+    return "";
+}
+
+inline Verb verb_from_string(std::string_view s) {
+    if (s == "allow") return Verb::Allow;
+    if (s == "deny") return Verb::Deny;
+    if (s == "auth") return Verb::Auth;
+    if (s == "login") return Verb::Login;
+    if (s == "logout") return Verb::Logout;
+    if (s == "connect") return Verb::Connect;
+    if (s == "access") return Verb::Access;
+    if (s == "upload") return Verb::Upload;
+    if (s == "download") return Verb::Download;
+    if (s == "exfil") return Verb::Exfil;
+    if (s == "malware") return Verb::Malware;
+    if (s == "scan") return Verb::Scan;
+    return Verb::Other;
+}
+
+inline Outcome outcome_from_string(std::string_view s) {
+    if (s == "success") return Outcome::Success;
+    if (s == "fail") return Outcome::Fail;
+    if (s == "allow") return Outcome::Allow;
+    if (s == "deny") return Outcome::Deny;
+    if (s == "block") return Outcome::Block;
+    if (s == "alert") return Outcome::Alert;
+    return Outcome::Other;
+}
+
+inline Proto proto_from_string(std::string_view s) {
+    if (s == "tcp") return Proto::Tcp;
+    if (s == "udp") return Proto::Udp;
+    if (s == "icmp") return Proto::Icmp;
+    if (s == "http") return Proto::Http;
+    if (s == "https") return Proto::Https;
+    if (s == "dns") return Proto::Dns;
+    if (s == "ssh") return Proto::Ssh;
+    return Proto::Other;
+}
+
+/**
+ * Fixed EventFeatures slot a feature name maps to; Extra for any other name
+ */
+enum class FeatureSlot : uint8_t {
+    Verb, Outcome, Proto, Dport, Sport, Bytes, Packets, Ip, DstIp, User, Extra
+};
+
+/**
+ * Typed event features
+ * Known fields live in fixed slots. Unknown fields and values that do not
+ * fit their slot (strings outside the vocabulary, wrong types, out-of-range
+ * ports) go to the extra object, which stays null for typical events.
+ * Serializes to the same flat features object as the old json field.
+ */
+struct EventFeatures {
+    Verb verb = Verb::None;
+    Outcome outcome = Outcome::None;
+    Proto proto = Proto::None;
+    std::optional<uint16_t> dport;
+    std::optional<uint16_t> sport;
+    std::optional<uint64_t> bytes;   // flow counters
+    std::optional<uint64_t> packets;
+    Symbol ip;                    // empty when absent
+    Symbol dst_ip;                // empty when absent
+    Symbol user;                  // empty when absent
+    json extra;                   // overflow
+
+    /**
+     * Store a field by feature name; last write wins
+     */
+    void set(std::string_view key, json value);
+    void set_string(std::string_view key, std::string_view value);
+
+    /**
+     * Same with the slot already resolved by slot_of(key), for callers that
+     * compile field names once; value is only copied if it lands in extra
+     */
+    void set(FeatureSlot slot, std::string_view key, const json& value);
+    void set(FeatureSlot slot, std::string_view key, json&& value);
+    void set_string(FeatureSlot slot, std::string_view key, std::string_view value);
+
+    static FeatureSlot slot_of(std::string_view key);
+
+    /**
+     * Field names including Other values; empty when absent
+     */
+    std::string_view verb_name() const;
+    std::string_view outcome_name() const;
+    std::string_view proto_name() const;
+
+    bool empty() const;
+
+    json to_json() const;
+    static EventFeatures from_json(const json& j);
+
+    bool operator==(const EventFeatures&) const = default;
+
+private:
+    std::string_view extra_string(std::string_view key) const;
+    void clear(FeatureSlot slot, std::string_view key);
+    template <typename Json>
+    void assign(FeatureSlot slot, std::string_view key, Json&& value);
+};
+
 /**
  * Normalized security event
  */
 struct Event {
     timestamp_t ts;
-    std::string source;           // fw, ids, app
-    std::string host;
+    Symbol source;                // fw, ids, app
+    Symbol host;
     std::string trace_id;
-    std::string fingerprint;
-    json features;                // proto, dport, bytes, etc.
+    uint64_t fingerprint = 0;
+    EventFeatures features;
     std::optional<std::string> cluster_id;
     std::optional<std::string> incident_id;
     
@@ -98,6 +293,7 @@ struct Incident {
     std::string title;
     Severity severity;
     json entity;                  // host, ip, user
+    Symbol entity_key;            // entity ip, else host; derived, not stored
     std::vector<std::string> cluster_ids;
     std::map<std::string, double> scores;  // anomaly, confidence
     timestamp_t created_at;
@@ -0,0 +1,691 @@
+#include "storage/wal.hpp"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace siem::storage {
+
+namespace fs = std::filesystem;
+
+struct WriteAheadLog::Segment {
+    uint64_t base_lsn = 0;      // First LSN in the file
+    uint64_t last_lsn = 0;      // base_lsn - 1 while empty
+    uint64_t size = 0;
+    std::string path;
+    int fd = -1;
+
+    ~Segment() {
+        if (fd >= 0) ::close(fd);
+    }
+};
+
+namespace {
+
+constexpr size_t kHeaderSize = 16;          // u32 length | u32 crc | u64 lsn
+constexpr uint32_t kMaxRecord = 1u << 30;
+
+enum EventFlags : uint8_t {
+    kDport = 1, kSport = 2, kBytes = 4, kPackets = 8, kExtra = 16, kCluster = 32, kIncident = 64
+};
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::system_category(), what);
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void put_string(std::string& out, std::string_view value) {
+    put_varint(out, value.size());
+    out.append(value);
+}
+
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    template <typename T>
+    T get() {
+        need(sizeof(T));
+        T value;
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto byte = get<uint8_t>();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("bad varint in WAL record");
+    }
+
+    std::string_view string() {
+        uint64_t size = varint();
+        need(size);
+        std::string_view value = data_.substr(pos_, size);
+        pos_ += size;
+        return value;
+    }
+
+    bool done() const { return pos_ == data_.size(); }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+
+    void need(uint64_t size) const {
+        if (size > data_.size() - pos_) throw std::runtime_error("truncated WAL record");
+    }
+};
+
+uint32_t record_crc(uint64_t lsn, std::string_view payload) {
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(&lsn), sizeof(lsn));
+    // zlib takes uInt lengths; records are capped well below that
+    return static_cast<uint32_t>(
+        crc32(crc, reinterpret_cast<const Bytef*>(payload.data()), static_cast<uInt>(payload.size())));
+}
+
+std::string segment_name(uint64_t base_lsn) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "wal-%020llu.log", static_cast<unsigned long long>(base_lsn));
+    return name;
+}
+
+bool parse_segment_name(const std::string& name, uint64_t& base_lsn) {
+    if (name.size() != 28 || !name.starts_with("wal-") || !name.ends_with(".log")) return false;
+    auto [end, ec] = std::from_chars(name.data() + 4, name.data() + 24, base_lsn);
+    return ec == std::errc() && end == name.data() + 24;
+}
+
+void sync_dir(const std::string& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return;
+    ::fsync(fd);
+    ::close(fd);
+}
+
+/**
+ * pread until size bytes or EOF; returns bytes read
+ */
+size_t read_at(int fd, char* out, size_t size, uint64_t offset) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pread(fd, out + done, size - done, static_cast<off_t>(offset + done));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw_errno("pread");
+        }
+        if (n == 0) break;
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
+
+} // namespace
+
+void WriteAheadLog::encode_events(const std::vector<Event>& events, std::string& out) {
+    put_varint(out, events.size());
+    for (const auto& event : events) {
+        const auto& f = event.features;
+        put<int64_t>(out, std::chrono::duration_cast<std::chrono::nanoseconds>(event.ts.time_since_epoch()).count());
+        put<uint64_t>(out, event.fingerprint);
+        put<uint8_t>(out, static_cast<uint8_t>(f.verb));
+        put<uint8_t>(out, static_cast<uint8_t>(f.outcome));
+        put<uint8_t>(out, static_cast<uint8_t>(f.proto));
+
+        uint8_t flags = (f.dport ? kDport : 0) | (f.sport ? kSport : 0) | (f.bytes ? kBytes : 0) |
+                        (f.packets ? kPackets : 0) | (f.extra.is_null() ? 0 : kExtra) |
+                        (event.cluster_id ? kCluster : 0) | (event.incident_id ? kIncident : 0);
+        put<uint8_t>(out, flags);
+        if (f.dport) put<uint16_t>(out, *f.dport);
+        if (f.sport) put<uint16_t>(out, *f.sport);
+        if (f.bytes) put_varint(out, *f.bytes);
+        if (f.packets) put_varint(out, *f.packets);
+
+        put_string(out, event.source.view());
+        put_string(out, event.host.view());
+        put_string(out, event.trace_id);
+        put_string(out, f.ip.view());
+        put_string(out, f.dst_ip.view());
+        put_string(out, f.user.view());
+        if (flags & kExtra) {
+            // Rare (vocabulary misses, unknown keys); MessagePack keeps it exact
+            auto packed = json::to_msgpack(f.extra);
+            put_varint(out, packed.size());
+            out.append(reinterpret_cast<const char*>(packed.data()), packed.size());
+        }
+        if (event.cluster_id) put_string(out, *event.cluster_id);
+        if (event.incident_id) put_string(out, *event.incident_id);
+    }
+}
+
+std::vector<Event> WriteAheadLog::decode_events(std::string_view payload) {
+    Reader reader(payload);
+    uint64_t count = reader.varint();
+    // Every event takes at least 25 bytes; do not trust count further than that
+    if (count > payload.size() / 25) throw std::runtime_error("bad event count in WAL record");
+
+    std::vector<Event> events(count);
+    for (auto& event : events) {
+        auto& f = event.features;
+        event.ts = timestamp_t(std::chrono::duration_cast<timestamp_t::duration>(
+            std::chrono::nanoseconds(reader.get<int64_t>())));
+        event.fingerprint = reader.get<uint64_t>();
+        f.verb = static_cast<Verb>(reader.get<uint8_t>());
+        f.outcome = static_cast<Outcome>(reader.get<uint8_t>());
+        f.proto = static_cast<Proto>(reader.get<uint8_t>());
+        if (f.verb > Verb::Scan || f.outcome > Outcome::Alert || f.proto > Proto::Ssh) {
+            throw std::runtime_error("bad enum in WAL record");
+        }
+
+        auto flags = reader.get<uint8_t>();
+        if (flags & kDport) f.dport = reader.get<uint16_t>();
+        if (flags & kSport) f.sport = reader.get<uint16_t>();
+        if (flags & kBytes) f.bytes = reader.varint();
+        if (flags & kPackets) f.packets = reader.varint();
+
+        auto symbol = [&] {
+            auto text = reader.string();
+            return text.empty() ? Symbol() : Symbol(text);
+        };
+        event.source = symbol();
+        event.host = symbol();
+        event.trace_id = std::string(reader.string());
+        f.ip = symbol();
+        f.dst_ip = symbol();
+        f.user = symbol();
+        if (flags & kExtra) {
+            auto packed = reader.string();
+            f.extra = json::from_msgpack(packed.begin(), packed.end());
+        }
+        if (flags & kCluster) event.cluster_id = std::string(reader.string());
+        if (flags & kIncident) event.incident_id = std::string(reader.string());
+    }
+    if (!reader.done()) throw std::runtime_error("trailing bytes in WAL record");
+    return events;
+}
+
+WriteAheadLog::WriteAheadLog(Config config) : config_(std::move(config)) {
+    config_.replay_batch = std::max<size_t>(config_.replay_batch, 1);
+    fs::create_directories(config_.dir);
+    recover();
+
+    spdlog::info(R"({{"msg":"wal_opened","dir":"{}","segments":{},"next_lsn":{},"checkpoint":{}}})",
+                config_.dir, segments_.size(), next_lsn_, acked_lsn_.load());
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    stop();
+}
+
+void WriteAheadLog::recover() {
+    uint64_t checkpoint = 0;
+    {
+        std::ifstream in(fs::path(config_.dir) / "checkpoint");
+        in >> checkpoint;
+    }
+    acked_lsn_ = checkpoint;
+
+    std::vector<uint64_t> bases;
+    for (const auto& entry : fs::directory_iterator(config_.dir)) {
+        uint64_t base;
+        if (entry.is_regular_file() && parse_segment_name(entry.path().filename().string(), base)) {
+            bases.push_back(base);
+        }
+    }
+    std::sort(bases.begin(), bases.end());
+
+    for (size_t i = 0; i < bases.size(); ++i) {
+        auto segment = std::make_shared<Segment>();
+        segment->base_lsn = bases[i];
+        segment->path = (fs::path(config_.dir) / segment_name(bases[i])).string();
+        segment->fd = ::open(segment->path.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+        if (segment->fd < 0) throw_errno("open " + segment->path);
+        struct stat st{};
+        if (::fstat(segment->fd, &st) != 0) throw_errno("fstat " + segment->path);
+        segment->size = static_cast<uint64_t>(st.st_size);
+        segment->last_lsn = i + 1 < bases.size() ? bases[i + 1] - 1 : bases[i] - 1;
+
+        // Wholly acknowledged before the last shutdown
+        if (i + 1 < bases.size() && segment->last_lsn <= checkpoint) {
+            fs::remove(segment->path);
+            continue;
+        }
+        segments_.push_back(std::move(segment));
+    }
+
+    if (!segments_.empty()) {
+        // Only the newest segment can have a torn tail: find its last good record
+        auto& tail = *segments_.back();
+        uint64_t offset = 0, lsn = tail.base_lsn;
+        std::string payload;
+        while (true) {
+            char header[kHeaderSize];
+            if (read_at(tail.fd, header, kHeaderSize, offset) < kHeaderSize) break;
+            uint32_t length, crc;
+            uint64_t record_lsn;
+            std::memcpy(&length, header, 4);
+            std::memcpy(&crc, header + 4, 4);
+            std::memcpy(&record_lsn, header + 8, 8);
+            if (record_lsn != lsn || length > kMaxRecord) break;
+            payload.resize(length);
+            if (read_at(tail.fd, payload.data(), length, offset + kHeaderSize) < length) break;
+            if (record_crc(record_lsn, payload) != crc) break;
+            offset += kHeaderSize + length;
+            lsn++;
+        }
+        if (offset < tail.size) {
+            spdlog::warn(R"({{"msg":"wal_tail_truncated","segment":"{}","bytes":{}}})", tail.path, tail.size - offset);
+            if (::ftruncate(tail.fd, static_cast<off_t>(offset)) != 0) throw_errno("ftruncate " + tail.path);
+            tail.size = offset;
+        }
+        tail.last_lsn = lsn - 1;
+        // Written before a restart is not necessarily on disk yet
+        if (::fdatasync(tail.fd) != 0) throw_errno("fdatasync " + tail.path);
+        next_lsn_ = lsn;
+    }
+
+    // Never hand out an LSN the checkpoint already covers
+    next_lsn_ = std::max(next_lsn_, checkpoint + 1);
+    if (segments_.empty() || segments_.back()->last_lsn + 1 != next_lsn_) {
+        segments_.push_back(open_segment(next_lsn_));
+    }
+
+    written_lsn_ = next_lsn_ - 1;
+    durable_lsn_ = written_lsn_;
+    for (const auto& segment : segments_) total_bytes_ += segment->size;
+}
+
+std::shared_ptr<WriteAheadLog::Segment> WriteAheadLog::open_segment(uint64_t base_lsn) {
+    auto segment = std::make_shared<Segment>();
+    segment->base_lsn = base_lsn;
+    segment->last_lsn = base_lsn - 1;
+    segment->path = (fs::path(config_.dir) / segment_name(base_lsn)).string();
+    segment->fd = ::open(segment->path.c_str(), O_RDWR | O_APPEND | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+    if (segment->fd < 0) throw_errno("open " + segment->path);
+    sync_dir(config_.dir);
+    return segment;
+}
+
+uint64_t WriteAheadLog::append(const std::vector<Event>& events) {
+    if (events.empty()) return durable_lsn_.load();
+
+    // Encode outside the lock; the header is filled in once the LSN is known
+    std::string record(kHeaderSize, '\0');
+    encode_events(events, record);
+    if (record.size() - kHeaderSize > kMaxRecord) throw std::runtime_error("event batch too large for the WAL");
+    auto length = static_cast<uint32_t>(record.size() - kHeaderSize);
+
+    uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        if (total_bytes_ - acked_bytes_ + record.size() > config_.max_bytes) {
+            throw std::runtime_error("write-ahead log is full");
+        }
+
+        auto segment = segments_.back();
+        if (segment->size > 0 && segment->size + record.size() > config_.segment_bytes) {
+            // Group commit only syncs the newest segment, so finish this one here
+            if (::fdatasync(segment->fd) != 0) throw_errno("fdatasync " + segment->path);
+            segment = open_segment(next_lsn_);
+            segments_.push_back(segment);
+        }
+
+        lsn = next_lsn_;
+        uint32_t crc = record_crc(lsn, std::string_view(record).substr(kHeaderSize));
+        std::memcpy(record.data(), &length, 4);
+        std::memcpy(record.data() + 4, &crc, 4);
+        std::memcpy(record.data() + 8, &lsn, 8);
+
+        size_t done = 0;
+        while (done < record.size()) {
+            ssize_t n = ::write(segment->fd, record.data() + done, record.size() - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                int error = errno;
+                // Leave no partial record behind for the next append to follow
+                [[maybe_unused]] int rc = ::ftruncate(segment->fd, static_cast<off_t>(segment->size));
+                throw std::system_error(error, std::system_category(), "write " + segment->path);
+            }
+            done += static_cast<size_t>(n);
+        }
+
+        next_lsn_++;
+        segment->size += record.size();
+        segment->last_lsn = lsn;
+        written_lsn_ = lsn;
+        total_bytes_ += record.size();
+    }
+
+    appended_records_++;
+    appended_events_ += events.size();
+    sync_to(lsn);
+    return lsn;
+}
+
+void WriteAheadLog::sync_to(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(sync_mutex_);
+    while (durable_lsn_.load() < lsn) {
+        if (syncing_) {
+            synced_cv_.wait(lock);
+            continue;
+        }
+
+        // Leader: one fdatasync covers every record written so far
+        syncing_ = true;
+        lock.unlock();
+        std::shared_ptr<Segment> segment;
+        uint64_t target;
+        {
+            std::lock_guard<std::mutex> write_lock(write_mutex_);
+            segment = segments_.back();
+            target = written_lsn_;
+        }
+        int rc = ::fdatasync(segment->fd);
+        int error = errno;
+        lock.lock();
+        syncing_ = false;
+        synced_cv_.notify_all();
+        if (rc != 0) throw std::system_error(error, std::system_category(), "fdatasync " + segment->path);
+
+        syncs_++;
+        if (target > durable_lsn_.load()) durable_lsn_ = target;
+        replay_cv_.notify_all();
+    }
+}
+
+void WriteAheadLog::start(ReplaySink sink) {
+    start_deferred([this, sink = std::move(sink)](std::vector<Event>& events, uint64_t lsn) {
+        sink(events);
+        acknowledge(lsn);
+    });
+}
+
+void WriteAheadLog::start_deferred(DeferredSink sink) {
+    if (thread_) {
+        spdlog::warn(R"({{"msg":"wal_replay_already_running"}})");
+        return;
+    }
+    sink_ = std::move(sink);
+    {
+        // Whatever was handed out before a stop is read again
+        std::lock_guard<std::mutex> lock(ack_mutex_);
+        inflight_.clear();
+    }
+    running_ = true;
+    thread_ = std::make_unique<std::thread>([this]() { replay_loop(); });
+}
+
+void WriteAheadLog::stop() {
+    if (!thread_) return;
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        running_ = false;
+    }
+    replay_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(ack_mutex_);
+        ack_cv_.notify_all();
+    }
+    if (thread_->joinable()) thread_->join();
+    thread_.reset();
+
+    spdlog::info(R"({{"msg":"wal_replay_stopped","acked_lsn":{},"written_lsn":{}}})", acked_lsn_.load(), written_lsn());
+}
+
+void WriteAheadLog::replay_loop() {
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        cursor_ = {segments_.front(), 0, segments_.front()->base_lsn};
+    }
+
+    int backoff = config_.retry_initial_ms;
+    std::vector<Event> events;
+    while (running_) {
+        {
+            std::unique_lock<std::mutex> lock(sync_mutex_);
+            replay_cv_.wait(lock, [&] { return !running_ || durable_lsn_.load() >= cursor_.lsn; });
+        }
+        {
+            std::unique_lock<std::mutex> lock(ack_mutex_);
+            ack_cv_.wait(lock, [&] { return !running_ || inflight_.size() < config_.max_inflight; });
+        }
+        if (!running_) break;
+
+        Cursor start = cursor_;
+        uint64_t consumed = 0;
+        try {
+            read_batch(events, consumed);
+        } catch (const std::exception& e) {
+            // I/O error on our own files; nothing better to do than retry
+            spdlog::error(R"({{"msg":"wal_read_failed","error":"{}"}})", e.what());
+            rewind(start);
+            if (!wait_retry(config_.retry_max_ms)) break;
+            continue;
+        }
+        if (cursor_.lsn == start.lsn) continue;
+
+        uint64_t lsn = cursor_.lsn - 1;
+        {
+            std::lock_guard<std::mutex> lock(ack_mutex_);
+            inflight_.push_back(Inflight{lsn, consumed, false});
+        }
+
+        if (events.empty()) {
+            // Only corrupt or already acknowledged records
+            acknowledge(lsn);
+            continue;
+        }
+
+        size_t count = events.size();
+        try {
+            sink_(events, lsn);
+        } catch (const std::exception& e) {
+            {
+                // Not taken, so nothing can have acknowledged it
+                std::lock_guard<std::mutex> lock(ack_mutex_);
+                inflight_.pop_back();
+            }
+            replay_failures_++;
+            spdlog::error(R"({{"msg":"wal_replay_failed","lsn":{},"events":{},"retry_ms":{},"error":"{}"}})",
+                         start.lsn, count, backoff, e.what());
+            rewind(start);
+            if (!wait_retry(backoff)) break;
+            backoff = std::min(backoff * 2, config_.retry_max_ms);
+            continue;
+        }
+        replayed_events_ += count;
+        backoff = config_.retry_initial_ms;
+    }
+}
+
+void WriteAheadLog::rewind(const Cursor& to) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    cursor_ = to;
+}
+
+void WriteAheadLog::read_batch(std::vector<Event>& events, uint64_t& consumed) {
+    events.clear();
+    uint64_t durable = durable_lsn_.load();
+    uint64_t acked = acked_lsn_.load();
+    std::string payload;
+
+    auto next_segment = [&]() -> bool {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto it = std::find(segments_.begin(), segments_.end(), cursor_.segment);
+        if (it == segments_.end() || ++it == segments_.end()) return false;
+        cursor_ = {*it, 0, (*it)->base_lsn};
+        return true;
+    };
+
+    while (events.size() < config_.replay_batch && cursor_.lsn <= durable) {
+        Segment& segment = *cursor_.segment;
+        char header[kHeaderSize];
+        size_t got = read_at(segment.fd, header, kHeaderSize, cursor_.offset);
+        if (got == 0) {
+            if (!next_segment()) break;
+            continue;
+        }
+
+        uint32_t length = 0, crc = 0;
+        uint64_t lsn = 0;
+        std::memcpy(&length, header, 4);
+        std::memcpy(&crc, header + 4, 4);
+        std::memcpy(&lsn, header + 8, 8);
+
+        bool good = got == kHeaderSize && lsn == cursor_.lsn && length <= kMaxRecord;
+        std::vector<Event> decoded;
+        if (good) {
+            payload.resize(length);
+            good = read_at(segment.fd, payload.data(), length, cursor_.offset + kHeaderSize) == length &&
+                   record_crc(lsn, payload) == crc;
+        }
+        if (good && lsn > acked) {
+            try {
+                decoded = decode_events(payload);
+            } catch (const std::exception&) {
+                good = false;
+            }
+        }
+
+        if (!good) {
+            // Record boundaries past this point cannot be trusted; give up
+            // on the rest of the segment
+            corrupt_records_++;
+            uint64_t skipped;
+            {
+                std::lock_guard<std::mutex> lock(write_mutex_);
+                skipped = segment.size - std::min(segment.size, cursor_.offset);
+                cursor_.offset = segment.size;
+                cursor_.lsn = segment.last_lsn + 1;
+            }
+            spdlog::error(R"({{"msg":"wal_corrupt_record","segment":"{}","lsn":{},"skipped_bytes":{}}})",
+                         segment.path, lsn, skipped);
+            consumed += skipped;
+            if (!next_segment()) break;
+            continue;
+        }
+
+        for (auto& event : decoded) events.push_back(std::move(event));
+        cursor_.offset += kHeaderSize + length;
+        cursor_.lsn++;
+        consumed += kHeaderSize + length;
+    }
+}
+
+void WriteAheadLog::acknowledge(uint64_t lsn) {
+    std::lock_guard<std::mutex> lock(ack_mutex_);
+    auto it = std::find_if(inflight_.begin(), inflight_.end(),
+                           [lsn](const Inflight& batch) { return batch.lsn == lsn; });
+    if (it == inflight_.end()) return;
+    it->done = true;
+
+    uint64_t acked = 0;
+    uint64_t consumed = 0;
+    while (!inflight_.empty() && inflight_.front().done) {
+        acked = inflight_.front().lsn;
+        consumed += inflight_.front().consumed;
+        inflight_.pop_front();
+    }
+    if (acked == 0) return;
+
+    // Under ack_mutex_, so checkpoints are written one at a time and in order
+    advance(acked, consumed);
+    ack_cv_.notify_all();
+}
+
+void WriteAheadLog::advance(uint64_t lsn, uint64_t consumed) {
+    acked_lsn_ = std::max(acked_lsn_.load(), lsn);
+    write_checkpoint(acked_lsn_.load());
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    acked_bytes_ += consumed;
+    // Segments whose records are all acknowledged; never the one being written
+    while (segments_.size() > 1 && segments_[1]->base_lsn <= acked_lsn_.load() + 1 &&
+           segments_.front() != cursor_.segment) {
+        auto& segment = segments_.front();
+        std::error_code ec;
+        fs::remove(segment->path, ec);
+        total_bytes_ -= segment->size;
+        acked_bytes_ -= std::min(acked_bytes_, segment->size);
+        segments_.pop_front();
+    }
+}
+
+void WriteAheadLog::write_checkpoint(uint64_t lsn) {
+    // Not synced: a checkpoint lost in a crash only means replaying again
+    auto path = fs::path(config_.dir) / "checkpoint";
+    auto tmp = fs::path(config_.dir) / "checkpoint.tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        out << lsn << '\n';
+        if (!out) {
+            spdlog::warn(R"({{"msg":"wal_checkpoint_failed","path":"{}"}})", tmp.string());
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) spdlog::warn(R"({{"msg":"wal_checkpoint_failed","error":"{}"}})", ec.message());
+}
+
+bool WriteAheadLog::wait_retry(int ms) {
+    std::unique_lock<std::mutex> lock(sync_mutex_);
+    replay_cv_.wait_for(lock, std::chrono::milliseconds(ms), [&] { return !running_; });
+    return running_;
+}
+
+WriteAheadLog::Stats WriteAheadLog::stats() const {
+    Stats stats;
+    stats.appended_records = appended_records_.load();
+    stats.appended_events = appended_events_.load();
+    stats.syncs = syncs_.load();
+    stats.replayed_events = replayed_events_.load();
+    stats.replay_failures = replay_failures_.load();
+    stats.corrupt_records = corrupt_records_.load();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    stats.pending_bytes = total_bytes_ - std::min(total_bytes_, acked_bytes_);
+    stats.segments = segments_.size();
+    return stats;
+}
+
+uint64_t WriteAheadLog::written_lsn() const {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return written_lsn_;
+}
+
+uint64_t WriteAheadLog::durable_lsn() const {
+    return durable_lsn_.load();
+}
+
+uint64_t WriteAheadLog::acked_lsn() const {
+    return acked_lsn_.load();
+}
+
+} // namespace siem::storage
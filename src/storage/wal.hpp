@@ -0,0 +1,185 @@
+#pragma once
+
+#include "storage/schemas.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace siem::storage {
+
+/**
+ * Durable local write-ahead log for ingested events
+ * - append() writes a batch as one record and returns once fdatasync covers
+ *   it. Concurrent appenders share syncs (group commit): whoever finds no
+ *   sync in flight syncs everything written so far, the rest wait for it.
+ * - Segments are named after their first LSN and rolled at segment_bytes.
+ *   Records are `u32 length | u32 crc32 | u64 lsn | events`; a torn or
+ *   corrupt tail of the newest segment is cut off when the log is opened.
+ * - The replayer hands durable records to the sink in LSN order. A sink
+ *   that throws gets the same records again after a backoff. A deferred
+ *   sink acknowledges batches later, in any order, with up to max_inflight
+ *   outstanding; the checkpoint only moves past a fully acknowledged
+ *   prefix, and segments that hold only acknowledged records are deleted.
+ * Delivery is at-least-once: a checkpoint lost in a crash replays its
+ * batches again.
+ */
+class WriteAheadLog {
+public:
+    struct Config {
+        std::string dir = "data/wal";
+        size_t segment_bytes = 64 * 1024 * 1024;
+        size_t max_bytes = 4ULL * 1024 * 1024 * 1024;   // append() refuses past this much unacknowledged data
+        size_t replay_batch = 4096;                      // Events per sink call, at record granularity
+        size_t max_inflight = 8;                         // Deferred batches handed out, not yet acknowledged
+        int retry_initial_ms = 500;
+        int retry_max_ms = 30000;
+    };
+
+    struct Stats {
+        uint64_t appended_records = 0;
+        uint64_t appended_events = 0;
+        uint64_t syncs = 0;
+        uint64_t replayed_events = 0;
+        uint64_t replay_failures = 0;
+        uint64_t corrupt_records = 0;       // Skipped while replaying
+        uint64_t pending_bytes = 0;         // Written but not acknowledged
+        uint64_t segments = 0;
+    };
+
+    /**
+     * Called from the replay thread; throw to have the batch retried
+     */
+    using ReplaySink = std::function<void(std::vector<Event>&)>;
+
+    /**
+     * Called from the replay thread with a batch and the LSN of its last
+     * record, which is passed to acknowledge() once the batch is stored;
+     * throw to have the batch retried
+     */
+    using DeferredSink = std::function<void(std::vector<Event>&, uint64_t lsn)>;
+
+    /**
+     * Open or create the log in config.dir and recover its tail; throws
+     * std::system_error on I/O failures
+     */
+    explicit WriteAheadLog(Config config);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * Append events as one record and wait until it is on disk; returns its
+     * LSN. Throws std::runtime_error when the log is over max_bytes and
+     * std::system_error when the write or sync fails.
+     */
+    uint64_t append(const std::vector<Event>& events);
+
+    /**
+     * Start replaying from the checkpoint; a batch is acknowledged when the
+     * sink returns
+     */
+    void start(ReplaySink sink);
+
+    /**
+     * Start replaying from the checkpoint; batches stay unacknowledged
+     * until acknowledge() is called with their LSN
+     */
+    void start_deferred(DeferredSink sink);
+
+    /**
+     * Acknowledge a batch handed to a deferred sink; thread-safe, in any
+     * order, and still valid after stop(). Unknown LSNs are ignored.
+     */
+    void acknowledge(uint64_t lsn);
+
+    /**
+     * Stop replaying; unacknowledged records stay for the next start
+     */
+    void stop();
+
+    Stats stats() const;
+
+    /**
+     * Highest LSN written, synced and acknowledged by the sink
+     */
+    uint64_t written_lsn() const;
+    uint64_t durable_lsn() const;
+    uint64_t acked_lsn() const;
+
+    /**
+     * Record payload codec; exposed for tests. decode_events throws
+     * std::runtime_error on malformed input
+     */
+    static void encode_events(const std::vector<Event>& events, std::string& out);
+    static std::vector<Event> decode_events(std::string_view payload);
+
+private:
+    struct Segment;
+
+    Config config_;
+
+    // Writer state, under write_mutex_
+    mutable std::mutex write_mutex_;
+    std::deque<std::shared_ptr<Segment>> segments_;
+    uint64_t next_lsn_ = 1;
+    uint64_t written_lsn_ = 0;
+    uint64_t total_bytes_ = 0;              // Bytes across all segments
+    uint64_t acked_bytes_ = 0;              // Of which acknowledged, in undeleted segments
+
+    // Group commit, under sync_mutex_
+    mutable std::mutex sync_mutex_;
+    std::condition_variable synced_cv_;
+    bool syncing_ = false;
+    std::atomic<uint64_t> durable_lsn_{0};
+
+    // Replay; cursor_ belongs to the replay thread
+    struct Cursor {
+        std::shared_ptr<Segment> segment;
+        uint64_t offset = 0;
+        uint64_t lsn = 0;                   // Expected at offset
+    };
+    DeferredSink sink_;
+    Cursor cursor_;                         // segment also read by advance(), under write_mutex_
+    std::atomic<uint64_t> acked_lsn_{0};
+
+    // Batches handed out, in LSN order, under ack_mutex_
+    struct Inflight {
+        uint64_t lsn = 0;                   // Last record in the batch
+        uint64_t consumed = 0;              // Bytes it covers
+        bool done = false;
+    };
+    std::mutex ack_mutex_;
+    std::condition_variable ack_cv_;        // Room in inflight_, or stop
+    std::deque<Inflight> inflight_;
+    std::atomic<bool> running_{false};
+    std::condition_variable replay_cv_;     // With sync_mutex_; durable_lsn_ moved or stop
+    std::unique_ptr<std::thread> thread_;
+
+    std::atomic<uint64_t> appended_records_{0};
+    std::atomic<uint64_t> appended_events_{0};
+    std::atomic<uint64_t> syncs_{0};
+    std::atomic<uint64_t> replayed_events_{0};
+    std::atomic<uint64_t> replay_failures_{0};
+    std::atomic<uint64_t> corrupt_records_{0};
+
+    void recover();
+    std::shared_ptr<Segment> open_segment(uint64_t base_lsn);
+    void sync_to(uint64_t lsn);
+    void replay_loop();
+    void read_batch(std::vector<Event>& events, uint64_t& consumed);
+    void rewind(const Cursor& to);
+    void advance(uint64_t lsn, uint64_t consumed);
+    void write_checkpoint(uint64_t lsn);
+    bool wait_retry(int ms);
+};
+
+} // namespace siem::storage
@@ -0,0 +1,223 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/adaptive_batcher.hpp"
+#include "core/event_pipeline.hpp"
+#include "test_support.hpp"
+#include <mutex>
+#include <thread>
+
+using namespace siem;
+using namespace siem::core;
+using namespace std::chrono_literals;
+using namespace siem::test;
+
+namespace {
+
+/**
+ * Collects what the batcher sends
+ */
+struct Recorder {
+    std::mutex mutex;
+    std::vector<size_t> sizes;
+    std::vector<std::vector<uint64_t>> lsns;
+    size_t events = 0;
+
+    AdaptiveBatcher::Sink sink() {
+        return [this](EventPipeline::Batch&& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sizes.push_back(batch.events.size());
+            lsns.push_back(batch.lsns);
+            events += batch.events.size();
+        };
+    }
+
+    size_t total() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return events;
+    }
+};
+
+} // namespace
+
+TEST_CASE("AdaptiveBatcher sends full batches on the caller", "[batcher]") {
+    AdaptiveBatcher::Config config;
+    config.min_batch = 10;
+    config.max_linger_ms = 60000;
+    Recorder recorder;
+    AdaptiveBatcher batcher(config, recorder.sink());
+    batcher.start();
+
+    for (int i = 0; i < 9; ++i) {
+        auto events = make_events(i, 1);
+        batcher.add(events);
+        REQUIRE(events.empty());
+    }
+    REQUIRE(recorder.total() == 0);
+
+    auto events = make_events(9, 3);
+    batcher.add(events);
+    REQUIRE(recorder.sizes == std::vector<size_t>{12});
+
+    // A batch at the target skips the buffer
+    events = make_events(20, 25);
+    batcher.add(events);
+    REQUIRE(recorder.sizes == std::vector<size_t>{12, 25});
+
+    // Write-ahead log LSNs go out with their events
+    events = make_events(50, 4);
+    batcher.add(events, 7);
+    events = make_events(60, 6);
+    batcher.add(events, 8);
+    events = make_events(70, 30);
+    batcher.add(events, 9);
+    REQUIRE(recorder.sizes == std::vector<size_t>{12, 25, 10, 30});
+    REQUIRE(recorder.lsns == std::vector<std::vector<uint64_t>>{{}, {}, {7, 8}, {9}});
+
+    auto stats = batcher.stats();
+    REQUIRE(stats.batches == 4);
+    REQUIRE(stats.events == 77);
+    REQUIRE(stats.size_flushes == 4);
+    REQUIRE(stats.linger_flushes == 0);
+    batcher.stop();
+}
+
+TEST_CASE("AdaptiveBatcher sends a partial batch after max_linger_ms", "[batcher]") {
+    AdaptiveBatcher::Config config;
+    config.min_batch = 1000;
+    config.max_linger_ms = 20;
+    Recorder recorder;
+    AdaptiveBatcher batcher(config, recorder.sink());
+    batcher.start();
+
+    auto started = std::chrono::steady_clock::now();
+    auto events = make_events(0, 5);
+    batcher.add(events);
+    REQUIRE(wait_for([&] { return recorder.total() == 5; }));
+    REQUIRE(std::chrono::steady_clock::now() - started >= 20ms);
+    REQUIRE(batcher.stats().linger_flushes == 1);
+
+    // The timer re-arms for the next partial batch
+    events = make_events(5, 2);
+    batcher.add(events);
+    REQUIRE(wait_for([&] { return recorder.total() == 7; }));
+    REQUIRE(batcher.stats().linger_flushes == 2);
+    batcher.stop();
+}
+
+TEST_CASE("AdaptiveBatcher stop sends what is buffered", "[batcher]") {
+    AdaptiveBatcher::Config config;
+    config.min_batch = 100;
+    config.max_linger_ms = 60000;
+    Recorder recorder;
+
+    SECTION("Running") {
+        AdaptiveBatcher batcher(config, recorder.sink());
+        batcher.start();
+        auto events = make_events(0, 7);
+        batcher.add(events);
+        batcher.stop();
+        REQUIRE(recorder.sizes == std::vector<size_t>{7});
+    }
+
+    SECTION("Never started") {
+        AdaptiveBatcher batcher(config, recorder.sink());
+        auto events = make_events(0, 3);
+        batcher.add(events);
+        batcher.stop();
+        REQUIRE(recorder.sizes == std::vector<size_t>{3});
+    }
+}
+
+TEST_CASE("AdaptiveBatcher sizes batches by AIMD against the SLO", "[batcher]") {
+    AdaptiveBatcher::Config config;
+    config.latency_slo_ms = 100;
+    config.max_linger_ms = 20;             // Leaves 80 ms for the pipeline
+    config.min_batch = 16;
+    config.max_batch = 200;
+    config.additive_step = 32;
+    config.decrease_factor = 0.5;
+    config.backlog_depth = 4;
+    AdaptiveBatcher batcher(config, [](EventPipeline::Batch&&) {});
+    REQUIRE(batcher.target() == 16);
+
+    SECTION("On time grows additively, up to max_batch") {
+        batcher.observe(80ms, 0);
+        REQUIRE(batcher.target() == 48);
+        batcher.observe(10ms, 0);
+        REQUIRE(batcher.target() == 80);
+        for (int i = 0; i < 10; ++i) batcher.observe(1ms, 0);
+        REQUIRE(batcher.target() == 200);
+    }
+
+    SECTION("Late shrinks multiplicatively, down to min_batch") {
+        for (int i = 0; i < 5; ++i) batcher.observe(1ms, 0);
+        REQUIRE(batcher.target() == 176);
+        batcher.observe(81ms, 0);
+        REQUIRE(batcher.target() == 88);
+        batcher.observe(500ms, 4);
+        REQUIRE(batcher.target() == 44);
+        batcher.observe(500ms, 0);
+        batcher.observe(500ms, 0);
+        REQUIRE(batcher.target() == 16);
+    }
+
+    SECTION("Late behind a backlog still grows") {
+        batcher.observe(500ms, 5);
+        REQUIRE(batcher.target() == 48);
+    }
+
+    auto stats = batcher.stats();
+    REQUIRE(stats.target == batcher.target());
+    REQUIRE(stats.on_time + stats.late > 0);
+    REQUIRE(stats.latency_ns > 0);
+}
+
+TEST_CASE("AdaptiveBatcher closes the loop through the pipeline", "[batcher][pipeline]") {
+    EventPipeline pipeline;
+    std::mutex mutex;
+    std::vector<std::pair<size_t, std::chrono::nanoseconds>> completed;
+    size_t stored = 0;
+
+    pipeline.add_stage("store", EventPipeline::StageConfig{}, [&](EventPipeline::Batch& batch) {
+        std::this_thread::sleep_for(2ms);
+        std::lock_guard<std::mutex> lock(mutex);
+        stored += batch.events.size();
+    });
+
+    AdaptiveBatcher::Config config;
+    config.min_batch = 8;
+    config.max_linger_ms = 5;
+    AdaptiveBatcher batcher(config, [&](EventPipeline::Batch&& batch) {
+        pipeline.push(std::move(batch));
+    });
+    pipeline.on_complete([&](size_t events, std::chrono::nanoseconds latency) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completed.emplace_back(events, latency);
+        }
+        batcher.observe(latency, pipeline.depth());
+    });
+    pipeline.start();
+    batcher.start();
+    REQUIRE_THROWS_AS(pipeline.on_complete(nullptr), std::logic_error);
+
+    for (int i = 0; i < 500; ++i) {
+        auto events = make_events(i, 1);
+        batcher.add(events);
+    }
+    batcher.stop();
+    pipeline.stop();
+
+    REQUIRE(stored == 500);
+    size_t reported = 0;
+    for (const auto& [events, latency] : completed) {
+        reported += events;
+        REQUIRE(latency >= 2ms);
+    }
+    REQUIRE(reported == 500);
+
+    // Every batch well within the SLO, so the target only grew
+    auto stats = batcher.stats();
+    REQUIRE(stats.on_time == completed.size());
+    REQUIRE(stats.late == 0);
+    REQUIRE(stats.target > config.min_batch);
+}
@@ -0,0 +1,213 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/cef_parser.hpp"
+#include "ingest/spool_ingestor.hpp"
+#include "ingest/syslog_server.hpp"
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace siem;
+using namespace siem::ingest;
+namespace fs = std::filesystem;
+
+namespace {
+
+std::map<std::string, std::string> extensions(const CefMessage& message) {
+    std::map<std::string, std::string> out;
+    CefParser::for_each_extension(message, [&](std::string_view key, std::string_view value) {
+        out[std::string(key)] = std::string(value);
+    });
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("CefParser tokenizes CEF and LEEF records", "[cef]") {
+    CefMessage m;
+
+    SECTION("CEF with escapes and spaces in values") {
+        std::string_view line =
+            R"(Nov  7 23:00:01 fw01 CEF:0|Sec\|Corp|threatmanager|1.0|100|worm successfully stopped|10|)"
+            R"(src=10.0.0.1 dst=2.1.2.2 spt=1232 msg=a b\=c \\ done request=http://x/?q=1 cs1Label=Rule cs1=Block all)";
+
+        REQUIRE(CefParser::parse(line, m));
+        REQUIRE(m.format == CefMessage::Format::Cef);
+        REQUIRE(m.version == "0");
+        REQUIRE(m.vendor == R"(Sec\|Corp)");
+        REQUIRE(m.product == "threatmanager");
+        REQUIRE(m.event_id == "100");
+        REQUIRE(m.name == "worm successfully stopped");
+        REQUIRE(m.severity == "10");
+
+        auto ext = extensions(m);
+        REQUIRE(ext.size() == 7);
+        REQUIRE(ext["src"] == "10.0.0.1");
+        REQUIRE(ext["msg"] == R"(a b\=c \\ done)");
+        REQUIRE(ext["request"] == "http://x/?q=1");
+        REQUIRE(ext["cs1"] == "Block all");
+
+        std::string unescaped;
+        CefParser::unescape(ext["msg"], unescaped);
+        REQUIRE(unescaped == R"(a b=c \ done)");
+    }
+
+    SECTION("LEEF 1.0 and 2.0 delimiters") {
+        REQUIRE(CefParser::parse("LEEF:1.0|Microsoft|MSExchange|4.0 SP1|15345|src=192.0.2.0\tdst=172.50.123.1\tsev=5", m));
+        REQUIRE(m.format == CefMessage::Format::Leef);
+        REQUIRE(m.event_id == "15345");
+        REQUIRE(extensions(m)["dst"] == "172.50.123.1");
+
+        REQUIRE(CefParser::parse("LEEF:2.0|Lancope|StealthWatch|1.0|41|^|src=10.0.1.8^dst=10.0.0.5^sev=5", m));
+        REQUIRE(m.delimiter == '^');
+        REQUIRE(extensions(m).size() == 3);
+
+        REQUIRE(CefParser::parse("LEEF:2.0|V|P|1|id|x7C|src=10.0.1.8|usrName=bob", m));
+        REQUIRE(m.delimiter == '|');
+        REQUIRE(extensions(m)["usrName"] == "bob");
+    }
+
+    SECTION("Missing headers") {
+        REQUIRE_FALSE(CefParser::parse("CEF:0|vendor|product|1.0|100|name", m));
+        REQUIRE_FALSE(CefParser::parse("just a syslog line", m));
+        REQUIRE_FALSE(CefParser::parse("xCEF:0|a|b|c|d|e|f|", m));
+    }
+}
+
+TEST_CASE("CefParser maps known keys onto event fields", "[cef]") {
+    CefMessage m;
+    storage::Event event;
+
+    SECTION("CEF") {
+        REQUIRE(CefParser::parse(
+            "CEF:0|Palo Alto|PAN-OS|10.1|TRAFFIC|end|3|rt=Nov 07 2025 23:00:01.250 UTC dvchost=pa-01 dvc=10.9.9.9 "
+            "src=10.0.0.7 dst=192.0.2.10 spt=52144 dpt=22 proto=TCP act=blocked outcome=failure "
+            "duser=root suser=alice in=100 out=23 cs1=Internet Egress", m));
+        CefParser::to_event(m, event);
+
+        REQUIRE(event.host == "pa-01");
+        REQUIRE(event.ts == storage::timestamp_t(std::chrono::milliseconds(1762556401250)));
+        REQUIRE(event.features.ip == "10.0.0.7");
+        REQUIRE(event.features.dst_ip == "192.0.2.10");
+        REQUIRE(event.features.sport == 52144);
+        REQUIRE(event.features.dport == 22);
+        REQUIRE(event.features.proto == storage::Proto::Tcp);
+        REQUIRE(event.features.verb == storage::Verb::Deny);
+        REQUIRE(event.features.outcome == storage::Outcome::Fail);
+        REQUIRE(event.features.user == "alice");
+        REQUIRE(event.features.bytes == 123);
+        REQUIRE(event.features.extra["vendor"] == "Palo Alto");
+        REQUIRE(event.features.extra["signature"] == "TRAFFIC");
+        REQUIRE(event.features.extra["severity"] == 3);
+        REQUIRE(event.features.extra["cs1"] == "Internet Egress");
+    }
+
+    SECTION("LEEF with unknown keys dropped") {
+        REQUIRE(CefParser::parse("LEEF:1.0|IBM|QRadar|7.5|login|src=10.1.1.1\tusrName=bob\tproto=17\t"
+                                 "devTime=1762556401000\tsrcBytes=10\tdstBytes=5\tsev=7\tcustom=x", m));
+        CefParser::to_event(m, event, false);
+
+        REQUIRE(event.features.ip == "10.1.1.1");
+        REQUIRE(event.features.user == "bob");
+        REQUIRE(event.features.proto == storage::Proto::Udp);
+        REQUIRE(event.features.bytes == 15);
+        REQUIRE(event.ts == storage::timestamp_t(std::chrono::milliseconds(1762556401000)));
+        REQUIRE(event.features.extra["severity"] == 7);
+        REQUIRE_FALSE(event.features.extra.contains("custom"));
+    }
+}
+
+TEST_CASE("CEF files and spools deliver parsed events", "[cef]") {
+    auto dir = fs::temp_directory_path() / "siem_cef_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto path = dir / "fw.cef";
+    std::ofstream(path, std::ios::binary)
+        << "CEF:0|V|P|1|1|n|5|src=10.0.0.1 dpt=22\r\n"
+        << "not cef\n"
+        << "\n"
+        << "<134>Nov  7 23:00:01 fw01 CEF:0|V|P|1|2|n|5|src=10.0.0.2 dvchost=fw01\n";
+
+    FileIngestor ingestor;
+    REQUIRE_THROWS_AS(ingestor.read_file(path.string(), [](json&&) {}), std::invalid_argument);
+
+    std::vector<storage::Event> events;
+    auto stats = ingestor.ingest_file(path.string(), {}, [&](std::vector<storage::Event>& batch) {
+        events.insert(events.end(), batch.begin(), batch.end());
+    });
+    REQUIRE(stats.events == 2);
+    REQUIRE(stats.skipped == 1);
+    REQUIRE(events.size() == 2);
+    REQUIRE(events[0].source == "cef");
+    REQUIRE(events[0].host == "unknown");
+    REQUIRE(events[0].features.dport == 22);
+    REQUIRE(events[1].host == "fw01");
+
+    SpoolIngestor::Config config;
+    config.dir = dir.string();
+    core::WorkerPool pool(1);
+    SpoolIngestor spool(config, pool);
+    fs::create_directories(dir / "done");
+    fs::create_directories(dir / "failed");
+    std::ofstream(dir / "events.ndjson", std::ios::binary) << R"({"seq":1})" << "\n";
+
+    size_t raw = 0, parsed = 0;
+    REQUIRE(spool.scan([&](const std::vector<json>& batch) { raw += batch.size(); },
+                       [&](std::vector<storage::Event>& batch) { parsed += batch.size(); }) == 2);
+    REQUIRE(raw == 1);
+    REQUIRE(parsed == 2);
+    REQUIRE(fs::exists(dir / "done" / "fw.cef"));
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("SyslogServer delivers CEF payloads as parsed events", "[cef]") {
+    SyslogServer::Config config;
+    config.bind_address = "127.0.0.1";
+    config.udp_port = 0;
+    config.tcp_enabled = false;
+    config.flush_ms = 10;
+    SyslogServer server(config);
+
+    std::mutex mutex;
+    std::vector<json> raw;
+    std::vector<storage::Event> parsed;
+    server.start(
+        [&](const std::vector<json>& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            raw.insert(raw.end(), batch.begin(), batch.end());
+        },
+        [&](std::vector<storage::Event>& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            parsed.insert(parsed.end(), batch.begin(), batch.end());
+        });
+
+    net::io_context ioc;
+    udp::socket client(ioc, udp::v4());
+    udp::endpoint target(net::ip::make_address("127.0.0.1"), server.udp_port());
+    for (std::string msg : {"<134>Nov  7 23:00:01 fw01 CEF:0|V|P|1|100|Port scan|8|src=203.0.113.9 dpt=443",
+                            "<134>1 2025-11-07T23:00:01Z fw02 - - - - LEEF:1.0|V|P|1|7|src=203.0.113.8",
+                            "<13>1 - host app - - - plain message"}) {
+        client.send_to(net::buffer(msg), target);
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (raw.size() + parsed.size() >= 3) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    server.stop();
+
+    REQUIRE(raw.size() == 1);
+    REQUIRE(parsed.size() == 2);
+    REQUIRE(parsed[0].source == "syslog");
+    REQUIRE(parsed[0].host == "fw01");
+    REQUIRE(parsed[0].features.ip == "203.0.113.9");
+    REQUIRE(parsed[0].features.extra["name"] == "Port scan");
+    REQUIRE(parsed[1].host == "fw02");
+    REQUIRE(parsed[1].ts == storage::timestamp_t(std::chrono::milliseconds(1762556401000)));
+    REQUIRE(server.stats().cef == 2);
+}
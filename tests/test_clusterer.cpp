@@ -2,8 +2,8 @@
 #include <catch2/catch_approx.hpp>
 #include "core/incident_clusterer.hpp"
 
+using namespace siem;
 using namespace siem::core;
-using namespace siem::storage;
 
 TEST_CASE("IncidentClusterer assigns clusters", "[clusterer]") {
     IncidentClusterer::Config config;
@@ -14,13 +14,15 @@ TEST_CASE("IncidentClusterer assigns clusters", "[clusterer]") {
     
     SECTION("Events with same fingerprint get same cluster") {
         std::vector<storage::Event> events(2);
-        events[0].fingerprint = "abc123";
+        events[0].fingerprint = 0xabc123;
         events[0].ts = std::chrono::system_clock::now();
-        events[0].features = {{"verb_deny", 1}, {"proto_tcp", 1}};
+        events[0].features.verb = storage::Verb::Deny;
+        events[0].features.proto = storage::Proto::Tcp;
         
-        events[1].fingerprint = "abc123";
+        events[1].fingerprint = 0xabc123;
         events[1].ts = std::chrono::system_clock::now();
-        events[1].features = {{"verb_deny", 1}, {"proto_tcp", 1}};
+        events[1].features.verb = storage::Verb::Deny;
+        events[1].features.proto = storage::Proto::Tcp;
         
         clusterer.assign_clusters(events);
         
@@ -31,13 +33,13 @@ TEST_CASE("IncidentClusterer assigns clusters", "[clusterer]") {
     
     SECTION("Events with different fingerprints get different clusters") {
         std::vector<storage::Event> events(2);
-        events[0].fingerprint = "abc123";
+        events[0].fingerprint = 0xabc123;
         events[0].ts = std::chrono::system_clock::now();
-        events[0].features = {{"verb_deny", 1}};
+        events[0].features.verb = storage::Verb::Deny;
         
-        events[1].fingerprint = "xyz789";
+        events[1].fingerprint = 0x789abc;
         events[1].ts = std::chrono::system_clock::now();
-        events[1].features = {{"verb_allow", 1}};
+        events[1].features.verb = storage::Verb::Allow;
         
         clusterer.assign_clusters(events);
         
@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/secret_redactor.hpp"
+#include "ingest/content_decoder.hpp"
+#include "ingest/http_ingestor.hpp"
+#include <istream>
+#include <iterator>
+#include <stdexcept>
+#include <zlib.h>
+#include <zstd.h>
+
+using namespace siem::ingest;
+
+namespace {
+
+std::string gzip(const std::string& data) {
+    z_stream z{};
+    REQUIRE(deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    std::string out(deflateBound(&z, static_cast<uLong>(data.size())), '\0');
+    z.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    z.avail_in = static_cast<uInt>(data.size());
+    z.next_out = reinterpret_cast<Bytef*>(out.data());
+    z.avail_out = static_cast<uInt>(out.size());
+    REQUIRE(deflate(&z, Z_FINISH) == Z_STREAM_END);
+    out.resize(z.total_out);
+    deflateEnd(&z);
+    return out;
+}
+
+std::string zstd(const std::string& data) {
+    std::string out(ZSTD_compressBound(data.size()), '\0');
+    size_t n = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), 3);
+    REQUIRE_FALSE(ZSTD_isError(n));
+    out.resize(n);
+    return out;
+}
+
+std::string decode(ContentEncoding encoding, const std::string& body, size_t max_output = 1 << 24) {
+    ContentDecoder decoder(encoding, body, max_output);
+    std::istream in(&decoder);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::string make_body(int events) {
+    std::string body = "[";
+    for (int i = 0; i < events; ++i) {
+        if (i) body += ",";
+        body += R"({"source":"fw","host":"edge-)" + std::to_string(i % 7) +
+                R"(","verb":"deny","object":{"proto":"tcp","dport":)" + std::to_string(i % 1024) + "}}";
+    }
+    return body + "]";
+}
+
+} // namespace
+
+TEST_CASE("Content-Encoding headers map to decoders", "[content_decoder]") {
+    REQUIRE(parse_content_encoding("") == ContentEncoding::Identity);
+    REQUIRE(parse_content_encoding("identity") == ContentEncoding::Identity);
+    REQUIRE(parse_content_encoding(" GZIP ") == ContentEncoding::Gzip);
+    REQUIRE(parse_content_encoding("x-gzip") == ContentEncoding::Gzip);
+    REQUIRE(parse_content_encoding("zstd") == ContentEncoding::Zstd);
+    REQUIRE_FALSE(parse_content_encoding("br"));
+    REQUIRE_FALSE(parse_content_encoding("deflate"));
+    REQUIRE_FALSE(parse_content_encoding("gzip, zstd"));
+}
+
+TEST_CASE("ContentDecoder streams gzip and zstd bodies", "[content_decoder]") {
+    // Several decode windows' worth
+    std::string body = make_body(5000);
+    REQUIRE(body.size() > 4 * 64 * 1024);
+
+    SECTION("Round trips") {
+        REQUIRE(decode(ContentEncoding::Gzip, gzip(body)) == body);
+        REQUIRE(decode(ContentEncoding::Zstd, zstd(body)) == body);
+        REQUIRE(decode(ContentEncoding::Identity, body) == body);
+    }
+
+    SECTION("Concatenated members and frames read as one body") {
+        std::string half = body.substr(0, body.size() / 2), rest = body.substr(body.size() / 2);
+        REQUIRE(decode(ContentEncoding::Gzip, gzip(half) + gzip(rest)) == body);
+        REQUIRE(decode(ContentEncoding::Zstd, zstd(half) + zstd(rest)) == body);
+    }
+
+    SECTION("Truncated and corrupt bodies throw") {
+        for (auto [encoding, packed] : {std::pair{ContentEncoding::Gzip, gzip(body)},
+                                        std::pair{ContentEncoding::Zstd, zstd(body)}}) {
+            REQUIRE_THROWS_AS(decode(encoding, packed.substr(0, packed.size() / 2)), std::runtime_error);
+            REQUIRE_THROWS_AS(decode(encoding, packed + "garbage"), std::runtime_error);
+            REQUIRE_THROWS_AS(decode(encoding, ""), std::runtime_error);
+            packed[0] ^= 0x55;
+            REQUIRE_THROWS_AS(decode(encoding, packed), std::runtime_error);
+        }
+        // gzip carries a CRC; zstd frames only do when the sender asks
+        std::string packed = gzip(body);
+        packed[packed.size() / 2] ^= 0x55;
+        REQUIRE_THROWS_AS(decode(ContentEncoding::Gzip, packed), std::runtime_error);
+        REQUIRE_THROWS_AS(decode(ContentEncoding::Gzip, body), std::runtime_error);
+    }
+
+    SECTION("Output past the cap stops decoding") {
+        // 64 MB of zeros is about 64 KB of gzip
+        std::string bomb(64 << 20, '\0');
+        for (auto [encoding, packed] : {std::pair{ContentEncoding::Gzip, gzip(bomb)},
+                                        std::pair{ContentEncoding::Zstd, zstd(bomb)}}) {
+            REQUIRE(packed.size() < (1 << 20));
+            ContentDecoder decoder(encoding, packed, 1 << 20);
+            std::istream in(&decoder);
+            REQUIRE_THROWS_WITH(std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()),
+                                "Decompressed body exceeds maximum size");
+            REQUIRE(decoder.decoded() <= (1 << 20) + 64 * 1024);
+        }
+        REQUIRE_THROWS_AS(decode(ContentEncoding::Identity, body, 100), std::runtime_error);
+    }
+}
+
+TEST_CASE("HTTPIngestor accepts compressed ingest bodies", "[content_decoder]") {
+    HTTPIngestor::Config config;
+    config.hmac_secret = "ingest-secret";
+    config.max_body_size = 64 * 1024;
+    config.max_decoded_size = 1 << 20;
+    config.rate_limit.max_events_per_minute = 1000000;
+    config.rate_limit.burst = 1000000;
+    HTTPIngestor ingestor(config);
+
+    // Larger than max_body_size before compression
+    json batch = json::parse(make_body(2000));
+    batch[3]["password"] = "hunter2";
+    std::string body = batch.dump();
+    REQUIRE(body.size() > config.max_body_size);
+
+    std::vector<json> events;
+    auto sink = [&](json&& event) { events.push_back(std::move(event)); };
+
+    for (auto [encoding, packed] : {std::pair{ContentEncoding::Gzip, gzip(body)},
+                                    std::pair{ContentEncoding::Zstd, zstd(body)}}) {
+        events.clear();
+        REQUIRE(packed.size() <= config.max_body_size);
+
+        // The signature covers the bytes on the wire
+        REQUIRE(ingestor.verify_signature(packed, HTTPIngestor::compute_hmac("ingest-secret", packed)));
+
+        auto stats = ingestor.parse_ingest_request(packed, encoding, sink);
+        REQUIRE(stats.accepted == 2000);
+        REQUIRE(stats.redacted == 1);
+        REQUIRE(events.size() == 2000);
+        REQUIRE(events[3]["password"] == siem::core::SecretRedactor::kMarker);
+        REQUIRE(events[1999] == batch[1999]);
+    }
+
+    SECTION("The decoded cap applies separately from the body cap") {
+        std::string big = make_body(20000);
+        REQUIRE(big.size() > config.max_decoded_size);
+        REQUIRE_THROWS_AS(ingestor.parse_ingest_request(gzip(big), ContentEncoding::Gzip, sink), std::runtime_error);
+        REQUIRE_THROWS_AS(ingestor.parse_ingest_request(body, ContentEncoding::Identity, sink), std::runtime_error);
+    }
+}
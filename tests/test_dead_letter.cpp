@@ -0,0 +1,300 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/dead_letter_spool.hpp"
+#include "core/event_normalizer.hpp"
+#include "ingest/file_ingestor.hpp"
+#include "test_support.hpp"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+using namespace siem;
+using namespace siem::ingest;
+namespace fs = std::filesystem;
+using namespace siem::test;
+
+namespace {
+
+std::vector<fs::path> files_with(const fs::path& dir, const std::string& extension) {
+    std::vector<fs::path> files;
+    if (!fs::exists(dir)) return files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.path().extension() == extension) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::vector<json> read_ndjson(const fs::path& path) {
+    std::vector<json> lines;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) lines.push_back(json::parse(line));
+    return lines;
+}
+
+} // namespace
+
+TEST_CASE("EventNormalizer reports the events it drops", "[dead_letter][normalizer]") {
+    core::EventNormalizer::Config config;
+    config.parallel_min_batch = 4;
+    config.parallel_chunk = 2;
+    core::WorkerPool pool(2);
+    core::EventNormalizer normalizer(config, pool);
+
+    std::mutex mutex;
+    std::vector<std::pair<json, std::string>> failures;
+    normalizer.on_failure([&](const json& raw, const std::exception& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        failures.emplace_back(raw, error.what());
+    });
+
+    std::vector<json> raw = {
+        {{"source", "fw"}, {"host", "a"}},
+        json::array({1, 2}),
+        "not an event",
+        {{"source", "fw"}, {"host", "b"}},
+    };
+
+    SECTION("Serial path") {
+        auto events = normalizer.normalize_batch({raw.begin(), raw.begin() + 3});
+        REQUIRE(events.size() == 1);
+        REQUIRE(failures.size() == 2);
+    }
+
+    SECTION("Parallel path keeps order and reports from pool threads") {
+        auto events = normalizer.normalize_batch(raw);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[0].host == "a");
+        REQUIRE(events[1].host == "b");
+        REQUIRE(failures.size() == 2);
+    }
+
+    for (const auto& [event, error] : failures) {
+        REQUIRE_FALSE(event.is_object());
+        REQUIRE(error == "Event is not a JSON object");
+    }
+
+    // A throwing handler does not take the batch down
+    normalizer.on_failure([](const json&, const std::exception&) { throw std::runtime_error("handler"); });
+    REQUIRE(normalizer.normalize_batch({raw[1], raw[0]}).size() == 1);
+}
+
+TEST_CASE("DeadLetterSpool labels failures by kind", "[dead_letter]") {
+    REQUIRE(DeadLetterSpool::reason_of(std::invalid_argument("x")) == "invalid_argument");
+    REQUIRE(DeadLetterSpool::reason_of(std::runtime_error("x")) == "runtime_error");
+    REQUIRE(DeadLetterSpool::reason_of(std::system_error(EIO, std::system_category())) == "system_error");
+    REQUIRE(DeadLetterSpool::reason_of(std::exception()) == "error");
+    try {
+        json(1).get<std::string>();
+        FAIL("expected a type error");
+    } catch (const json::exception& e) {
+        REQUIRE(DeadLetterSpool::reason_of(e) == "type_error.302");
+    }
+}
+
+TEST_CASE("DeadLetterSpool keeps failed events and re-drives them", "[dead_letter]") {
+    auto dir = fresh_dir("store");
+    auto spool = fresh_dir("spool");
+    DeadLetterSpool::Config config;
+    config.dir = dir.string();
+    config.flush_ms = 10;
+
+    {
+        DeadLetterSpool dead_letters(config);
+        dead_letters.start();
+        for (int i = 0; i < 3; ++i) {
+            dead_letters.add(json{{"source", "fw"}, {"n", i}}, std::invalid_argument("bad field"));
+        }
+        dead_letters.add("edr", "parse_error.101", "syntax error", R"({"source":"edr","n":3})");
+        dead_letters.add(json::array({"no", "source"}), std::runtime_error("boom"));
+        dead_letters.stop();
+
+        auto stats = dead_letters.stats();
+        REQUIRE(stats.written == 5);
+        REQUIRE(stats.dropped == 0);
+        REQUIRE(stats.files == 1);
+        REQUIRE(stats.bytes == fs::file_size(files_with(dir, ".ndjson").front()));
+        REQUIRE(stats.reasons.at("invalid_argument") == 3);
+        REQUIRE(stats.reasons.at("parse_error.101") == 1);
+        REQUIRE(stats.reasons.at("runtime_error") == 1);
+    }
+
+    // Sealed on stop; nothing left active
+    REQUIRE(files_with(dir, ".active").empty());
+    auto records = read_ndjson(files_with(dir, ".ndjson").front());
+    REQUIRE(records.size() == 5);
+    REQUIRE(records[0]["source"] == "fw");
+    REQUIRE(records[0]["reason"] == "invalid_argument");
+    REQUIRE(records[0]["error"] == "bad field");
+    REQUIRE(json::parse(records[0]["raw"].get<std::string>()) == json{{"source", "fw"}, {"n", 0}});
+    REQUIRE(records[4]["source"] == "unknown");
+    REQUIRE(records[0]["ts"].get<int64_t>() > 0);
+
+    SECTION("Re-drive by reason leaves the other records") {
+        REQUIRE(DeadLetterSpool::redrive(config, spool.string(), "invalid_argument") == 3);
+
+        auto spooled = files_with(spool, ".ndjson");
+        REQUIRE(spooled.size() == 1);
+        auto events = read_ndjson(spooled.front());
+        REQUIRE(events.size() == 3);
+        for (int i = 0; i < 3; ++i) REQUIRE(events[i] == json{{"source", "fw"}, {"n", i}});
+
+        auto left = read_ndjson(files_with(dir, ".ndjson").front());
+        REQUIRE(left.size() == 2);
+        REQUIRE(left[0]["reason"] == "parse_error.101");
+
+        REQUIRE(DeadLetterSpool::redrive(config, spool.string(), "invalid_argument") == 0);
+        REQUIRE(files_with(spool, ".ndjson").size() == 1);
+    }
+
+    SECTION("Re-drive of everything empties the store") {
+        // A torn line from a crash is dropped rather than re-driven
+        std::ofstream(files_with(dir, ".ndjson").front(), std::ios::app) << R"({"ts":1,"raw":)";
+
+        REQUIRE(DeadLetterSpool::redrive(config, spool.string()) == 5);
+        REQUIRE(files_with(dir, ".ndjson").empty());
+        REQUIRE(read_ndjson(files_with(spool, ".ndjson").front()).size() == 5);
+        REQUIRE(files_with(spool, ".tmp").empty());
+    }
+
+    fs::remove_all(dir);
+    fs::remove_all(spool);
+}
+
+TEST_CASE("DeadLetterSpool keeps stage failures but does not re-drive them", "[dead_letter]") {
+    auto dir = fresh_dir("stage");
+    auto spool = fresh_dir("stage_spool");
+    DeadLetterSpool::Config config;
+    config.dir = dir.string();
+    config.flush_ms = 10;
+
+    storage::Event stored;
+    stored.source = storage::Symbol("fw");
+    stored.trace_id = "t-1";
+    stored.features.set_string("verb", "deny");
+    stored.features.set("bytes", 42);
+    {
+        DeadLetterSpool dead_letters(config);
+        dead_letters.start();
+        dead_letters.add("fw", "store_failed", "E11000", stored.to_json().dump(), false);
+        dead_letters.add("fw", "invalid_argument", "bad", R"({"source":"fw","n":1})");
+        dead_letters.stop();
+    }
+
+    size_t refused = 0;
+    REQUIRE(DeadLetterSpool::redrive(config, spool.string(), "store_failed", &refused) == 0);
+    REQUIRE(refused == 1);
+    REQUIRE(files_with(spool, ".ndjson").empty());
+
+    // Everything else still goes; the stored event stays, intact
+    REQUIRE(DeadLetterSpool::redrive(config, spool.string(), {}, &refused) == 1);
+    REQUIRE(refused == 1);
+    REQUIRE(read_ndjson(files_with(spool, ".ndjson").front()) == std::vector<json>{{{"source", "fw"}, {"n", 1}}});
+
+    auto left = read_ndjson(files_with(dir, ".ndjson").front());
+    REQUIRE(left.size() == 1);
+    REQUIRE(left[0]["reason"] == "store_failed");
+    REQUIRE(left[0]["redrivable"] == false);
+    auto event = storage::Event::from_json(json::parse(left[0]["raw"].get<std::string>()));
+    REQUIRE(event.trace_id == "t-1");
+    REQUIRE(event.features.bytes == 42u);
+
+    fs::remove_all(dir);
+    fs::remove_all(spool);
+}
+
+TEST_CASE("DeadLetterSpool redacts what it keeps", "[dead_letter][redactor]") {
+    auto dir = fresh_dir("redact");
+    DeadLetterSpool::Config config;
+    config.dir = dir.string();
+    config.flush_ms = 10;
+
+    {
+        DeadLetterSpool dead_letters(config);
+        dead_letters.start();
+        dead_letters.add(json{{"source", "fw"}, {"password", "hunter2"}, {"n", 1}}, std::invalid_argument("bad"));
+
+        // Skipped NDJSON lines arrive as their bytes, valid JSON or not
+        FileIngestor ingestor(FileIngestor::Config{.on_skipped = [&](std::string_view line, const char* reason) {
+            dead_letters.add("unknown", reason, "unparseable NDJSON line", std::string(line));
+        }});
+        auto stats = ingestor.parse_ndjson(
+            "{\"n\":2}\n"
+            "{\"token\":\"abc123\",\"msg\":\"cut off\n"
+            "[\"url?password=s3cr3t\"]\r\n",
+            [](json&&) {});
+        REQUIRE(stats.events == 1);
+        REQUIRE(stats.skipped == 2);
+        dead_letters.stop();
+        REQUIRE(dead_letters.stats().reasons.at("malformed") == 1);
+        REQUIRE(dead_letters.stats().reasons.at("not_object") == 1);
+    }
+
+    auto records = read_ndjson(files_with(dir, ".ndjson").front());
+    REQUIRE(records.size() == 3);
+    REQUIRE(json::parse(records[0]["raw"].get<std::string>()) ==
+            json{{"source", "fw"}, {"password", "***REDACTED***"}, {"n", 1}});
+    REQUIRE(records[1]["raw"] == "{\"token\":\"***REDACTED***\",\"msg\":\"cut off");
+    REQUIRE(records[2]["raw"] == "[\"url?password=***REDACTED***\"]\r");
+    fs::remove_all(dir);
+}
+
+TEST_CASE("DeadLetterSpool stays within its bounds", "[dead_letter]") {
+    auto dir = fresh_dir("bounds");
+    DeadLetterSpool::Config config;
+    config.dir = dir.string();
+    config.flush_ms = 5;
+
+    SECTION("A full queue drops and counts") {
+        config.max_queue = 2;
+        DeadLetterSpool dead_letters(config);
+        for (int i = 0; i < 5; ++i) dead_letters.add("fw", "invalid_argument", "bad", "{}");
+        auto stats = dead_letters.stats();
+        REQUIRE(stats.dropped == 3);
+        REQUIRE(stats.reasons.at("invalid_argument") == 5);
+
+        dead_letters.start();
+        dead_letters.stop();
+        REQUIRE(dead_letters.stats().written == 2);
+    }
+
+    SECTION("Full files are sealed and the oldest evicted past max_bytes") {
+        config.file_bytes = 1024;
+        config.max_bytes = 4096;
+        DeadLetterSpool dead_letters(config);
+        dead_letters.start();
+        std::string raw = json{{"source", "fw"}, {"pad", std::string(200, 'x')}}.dump();
+        for (int i = 0; i < 100; ++i) {
+            dead_letters.add("fw", "invalid_argument", "bad", raw);
+            if (i % 4 == 3) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        dead_letters.stop();
+
+        auto stats = dead_letters.stats();
+        REQUIRE(stats.written == 100);
+        REQUIRE(stats.evicted_files > 0);
+        REQUIRE(stats.bytes <= config.max_bytes);
+
+        uint64_t on_disk = 0;
+        for (const auto& path : files_with(dir, ".ndjson")) on_disk += fs::file_size(path);
+        REQUIRE(on_disk == stats.bytes);
+        REQUIRE(files_with(dir, ".ndjson").size() == stats.files);
+    }
+
+    SECTION("Files a crashed run left active are sealed on start") {
+        fs::create_directories(dir);
+        std::ofstream(dir / "dead-letter-0000000000001-000000.active")
+            << R"({"ts":1,"source":"fw","reason":"x","error":"e","raw":"{}"})" << '\n';
+
+        DeadLetterSpool dead_letters(config);
+        dead_letters.start();
+        REQUIRE(files_with(dir, ".active").empty());
+        REQUIRE(files_with(dir, ".ndjson").size() == 1);
+        REQUIRE(dead_letters.stats().files == 1);
+        dead_letters.stop();
+    }
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,287 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/batch_tickets.hpp"
+#include "core/event_pipeline.hpp"
+#include "test_support.hpp"
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace siem;
+using namespace siem::core;
+using namespace siem::test;
+
+namespace {
+
+/**
+ * Holds a stage's workers until opened
+ */
+struct Gate {
+    std::atomic<bool> open{false};
+
+    void pass() const {
+        while (!open.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+};
+
+} // namespace
+
+TEST_CASE("MpmcQueue is a bounded FIFO", "[pipeline][mpmc]") {
+    MpmcQueue<int> queue(5);
+    REQUIRE(queue.capacity() == 8);
+    REQUIRE(queue.empty());
+
+    for (int i = 0; i < 8; ++i) REQUIRE(queue.try_push(i));
+    int extra = 99;
+    REQUIRE_FALSE(queue.try_push(extra));
+    REQUIRE(extra == 99);
+    REQUIRE(queue.size() == 8);
+
+    int value = -1;
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(queue.try_pop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE_FALSE(queue.try_pop(value));
+
+    // Cells come back on the next lap
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 8; ++i) REQUIRE(queue.try_push(i));
+        for (int i = 0; i < 8; ++i) REQUIRE(queue.try_pop(value));
+    }
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("MpmcQueue hands every value to exactly one consumer", "[pipeline][mpmc]") {
+    MpmcQueue<uint64_t> queue(64);
+    constexpr int kProducers = 4, kConsumers = 4;
+    constexpr uint64_t kPerProducer = 20000;
+
+    std::atomic<uint64_t> popped{0};
+    std::atomic<uint64_t> sum{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 1; i <= kPerProducer; ++i) {
+                uint64_t value = p * kPerProducer + i;
+                while (!queue.try_push(value)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < kConsumers; ++c) {
+        threads.emplace_back([&] {
+            uint64_t value;
+            while (popped.load() < kProducers * kPerProducer) {
+                if (queue.try_pop(value)) {
+                    sum += value;
+                    popped++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    uint64_t n = kProducers * kPerProducer;
+    REQUIRE(popped.load() == n);
+    REQUIRE(sum.load() == n * (n + 1) / 2);
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("EventPipeline runs batches through every stage", "[pipeline]") {
+    EventPipeline pipeline;
+    EventPipeline::StageConfig config;
+    config.queue_capacity = 8;
+
+    std::mutex mutex;
+    std::set<std::string> stored;
+    std::multiset<uint64_t> stored_lsns;
+    std::vector<size_t> first_stage_sizes;
+    int mismatches = 0;                 // Checked after stop(); Catch2 asserts on this thread only
+    Gate gate;
+    gate.open = true;
+
+    pipeline.add_stage("tag", config, [&](EventPipeline::Batch& batch) {
+        gate.pass();
+        if (batch.events.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            first_stage_sizes.push_back(batch.events.size());
+        }
+        for (auto& event : batch.events) event.cluster_id = "c" + event.trace_id;
+        if (batch.events.front().trace_id == "bad") throw std::runtime_error("bad batch");
+    });
+    pipeline.add_stage("correlate", config, [&](EventPipeline::Batch& batch) {
+        batch.incident_ids.push_back("inc_1");
+    });
+    config.workers = 3;
+    pipeline.add_stage("store", config, [&](EventPipeline::Batch& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (batch.incident_ids != std::vector<std::string>{"inc_1"}) mismatches++;
+        for (const auto& event : batch.events) {
+            if (event.cluster_id != "c" + event.trace_id) mismatches++;
+            stored.insert(event.trace_id);
+        }
+        stored_lsns.insert(batch.lsns.begin(), batch.lsns.end());
+    });
+
+    std::vector<std::string> failed;
+    pipeline.on_failure([&](const std::string& stage, EventPipeline::Batch& batch, const std::exception& error) {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed.push_back(stage + ":" + batch.events.front().trace_id + ":" + error.what());
+    });
+
+    REQUIRE_THROWS_AS(pipeline.push(make_events(0, 1)), std::runtime_error);
+    pipeline.start();
+    REQUIRE_THROWS_AS(pipeline.on_failure(nullptr), std::logic_error);
+
+    SECTION("Concurrent producers; stop drains every stage") {
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p) {
+            producers.emplace_back([&, p] {
+                for (int i = 0; i < 250; ++i) pipeline.push(make_events((p * 250 + i) * 4, 4));
+            });
+        }
+        for (auto& producer : producers) producer.join();
+        pipeline.stop();
+
+        REQUIRE(stored.size() == 4000);
+        auto stats = pipeline.stats();
+        REQUIRE(stats.size() == 3);
+        for (const auto& stage : stats) {
+            REQUIRE(stage.events == 4000);
+            REQUIRE(stage.depth == 0);
+            REQUIRE(stage.failures == 0);
+        }
+        REQUIRE(stats[0].name == "tag");
+        REQUIRE(stats[2].batches <= stats[2].events);
+    }
+
+    SECTION("Batches queued behind a busy worker are merged, up to max_events") {
+        gate.open = false;
+        pipeline.push(make_events(0, 1));
+        REQUIRE(wait_for([&] { return pipeline.stats()[0].depth == 0; }));   // Taken by the worker
+
+        // Backpressure: the queue holds 8 batches, the 9th push waits
+        std::atomic<int> pushed{0};
+        std::thread producer([&] {
+            for (int i = 1; i <= 9; ++i) {
+                pipeline.push(make_events(i * 1000, 1000));
+                pushed++;
+            }
+        });
+        REQUIRE(wait_for([&] { return pushed.load() == 8; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(pushed.load() == 8);
+
+        gate.open = true;
+        producer.join();
+        pipeline.stop();
+
+        REQUIRE(stored.size() == 9001);
+        // The held batch alone, then the queued ones merged until max_events (4096)
+        REQUIRE(first_stage_sizes.front() == 1);
+        REQUIRE(first_stage_sizes.size() < 10);
+        for (size_t size : first_stage_sizes) REQUIRE(size <= 4096 + 1000);
+        REQUIRE(pipeline.stats()[0].wait_ns > 0);
+    }
+
+    SECTION("Write-ahead log LSNs ride along to the last stage") {
+        gate.open = false;
+        pipeline.push(EventPipeline::Batch{make_events(0, 1), {}, {1}});
+        REQUIRE(wait_for([&] { return pipeline.stats()[0].depth == 0; }));
+        for (uint64_t lsn = 2; lsn <= 4; ++lsn) {
+            pipeline.push(EventPipeline::Batch{make_events(static_cast<int>(lsn) * 10, 2), {}, {lsn}});
+        }
+        pipeline.push(EventPipeline::Batch{{}, {}, {5}});      // Nothing left to store, still acknowledged
+        gate.open = true;
+        pipeline.stop();
+
+        REQUIRE(stored.size() == 7);
+        REQUIRE(stored_lsns == std::multiset<uint64_t>{1, 2, 3, 4, 5});
+    }
+
+    SECTION("A failing stage drops its batch and keeps going") {
+        auto bad = make_events(0, 1);
+        bad[0].trace_id = "bad";
+        pipeline.push(std::move(bad));
+        REQUIRE(wait_for([&] { return pipeline.stats()[0].failures == 1; }));
+        pipeline.push(make_events(1, 2));
+        pipeline.stop();
+
+        REQUIRE(stored == std::set<std::string>{"1", "2"});
+        REQUIRE(pipeline.stats()[1].events == 2);
+        REQUIRE(failed == std::vector<std::string>{"tag:bad:bad batch"});
+    }
+
+    REQUIRE(mismatches == 0);
+    REQUIRE_FALSE(pipeline.is_running());
+    REQUIRE_THROWS_AS(pipeline.push(make_events(0, 1)), std::runtime_error);
+}
+
+TEST_CASE("BatchTickets let producers wait until their batch is stored", "[pipeline]") {
+    BatchTickets tickets;
+    EventPipeline pipeline;
+    EventPipeline::StageConfig config;
+    config.workers = 2;
+
+    std::mutex mutex;
+    std::set<std::string> stored;
+    pipeline.add_stage("store", config, [&](EventPipeline::Batch& batch) {
+        for (const auto& event : batch.events) {
+            if (event.trace_id == "bad") throw std::runtime_error("storage refused");
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& event : batch.events) stored.insert(event.trace_id);
+        }
+        tickets.complete(batch.lsns);
+    });
+    pipeline.on_failure([&](const std::string& stage, EventPipeline::Batch& batch, const std::exception& error) {
+        tickets.fail(batch.lsns, stage + " failed: " + error.what());
+    });
+    pipeline.start();
+
+    auto submit = [&](std::vector<storage::Event> events) {
+        EventPipeline::Batch batch;
+        batch.events = std::move(events);
+        batch.lsns.push_back(tickets.issue());
+        uint64_t ticket = batch.lsns.back();
+        pipeline.push(std::move(batch));
+        tickets.wait(ticket);
+    };
+
+    // Once wait() returns, the events are stored
+    std::vector<std::thread> producers;
+    std::atomic<int> missing{0};
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < 50; ++i) {
+                auto events = make_events((p * 50 + i) * 2, 2);
+                std::string last = events.back().trace_id;
+                submit(std::move(events));
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!stored.count(last)) missing++;
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    REQUIRE(missing.load() == 0);
+    REQUIRE(stored.size() == 400);
+
+    // A batch the stage gives up on fails its waiter instead of vanishing
+    auto bad = make_events(0, 1);
+    bad[0].trace_id = "bad";
+    REQUIRE_THROWS_WITH(submit(std::move(bad)), "store failed: storage refused");
+    REQUIRE(tickets.pending() == 0);
+
+    // Only the first outcome counts
+    uint64_t ticket = tickets.issue();
+    tickets.complete({ticket});
+    tickets.fail({ticket}, "too late");
+    tickets.wait(ticket);
+    REQUIRE_THROWS_AS(tickets.wait(ticket), std::invalid_argument);
+
+    pipeline.stop();
+}
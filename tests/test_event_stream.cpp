@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/event_stream.hpp"
+#include "ingest/file_ingestor.hpp"
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace siem::ingest;
+
+TEST_CASE("EventStreamParser emits events one at a time", "[event_stream]") {
+    std::vector<json> events;
+    auto sink = [&events](json&& e) { events.push_back(std::move(e)); };
+
+    SECTION("Array of objects with nested values") {
+        std::string body = R"([
+            {"source":"fw","entity":{"ip":"10.0.0.7"},"object":{"proto":"tcp","dport":22,"tags":["a",{"b":1}]}},
+            {"source":"ids","ok":true,"ratio":0.5,"none":null}
+        ])";
+
+        REQUIRE(EventStreamParser::parse(body, sink) == 2);
+        REQUIRE(events.size() == 2);
+        REQUIRE(events[0] == json::parse(body)[0]);
+        REQUIRE(events[1] == json::parse(body)[1]);
+    }
+
+    SECTION("Non-object array elements are skipped") {
+        std::string body = R"([1, "x", [ {"nested":1} ], {"source":"fw"}, null])";
+
+        REQUIRE(EventStreamParser::parse(body, sink) == 1);
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0]["source"] == "fw");
+    }
+
+    SECTION("Events are delivered before the document is complete") {
+        std::string body = R"([{"source":"fw"}, {"source":"ids"}, oops])";
+
+        REQUIRE_THROWS(EventStreamParser::parse(body, sink));
+        REQUIRE(events.size() == 2);
+    }
+
+    SECTION("Array root is required by default") {
+        REQUIRE_THROWS_AS(EventStreamParser::parse(R"({"source":"fw"})", sink), std::runtime_error);
+        REQUIRE_THROWS_AS(EventStreamParser::parse("42", sink), std::runtime_error);
+        REQUIRE(events.empty());
+    }
+
+    SECTION("Single object root when allowed") {
+        REQUIRE(EventStreamParser::parse(R"({"source":"fw","object":{"dport":22}})", sink,
+                                         EventStreamParser::Root::ArrayOrObject) == 1);
+        REQUIRE(events[0]["object"]["dport"] == 22);
+    }
+}
+
+TEST_CASE("FileIngestor parses arrays and single objects", "[event_stream]") {
+    FileIngestor ingestor;
+
+    REQUIRE(ingestor.parse_json(R"([{"a":1},{"b":2}])").size() == 2);
+    REQUIRE(ingestor.parse_json(R"({"a":1})").size() == 1);
+    REQUIRE(ingestor.parse_json("\"scalar\"").empty());
+    REQUIRE_THROWS(ingestor.parse_json("[{"));
+}
+
+TEST_CASE("FileIngestor streams mapped files in fixed-size batches", "[event_stream]") {
+    auto dir = std::filesystem::temp_directory_path() / "siem_file_ingestor_test";
+    std::filesystem::create_directories(dir);
+    auto write = [&dir](const std::string& name, const std::string& content) {
+        auto path = (dir / name).string();
+        std::ofstream(path, std::ios::binary) << content;
+        return path;
+    };
+
+    std::vector<size_t> batch_sizes;
+    std::vector<json> events;
+    auto callback = [&](const std::vector<json>& batch) {
+        batch_sizes.push_back(batch.size());
+        events.insert(events.end(), batch.begin(), batch.end());
+    };
+
+    SECTION("NDJSON across windows, with blank, CRLF and bad lines") {
+        std::string content;
+        for (int i = 0; i < 10; ++i) {
+            content += R"({"source":"fw","seq":)" + std::to_string(i) + "}\r\n";
+            if (i == 3) content += "\n   \n";
+            if (i == 5) content += "{\"broken\":\n[1,2]\n";
+        }
+        content += R"({"source":"fw","seq":10})"; // No trailing newline
+
+        FileIngestor ingestor(FileIngestor::Config{.batch_size = 4, .window_bytes = 64});
+        auto stats = ingestor.ingest_file(write("events.ndjson", content), callback);
+
+        REQUIRE(stats.events == 11);
+        REQUIRE(stats.skipped == 2);
+        REQUIRE(stats.bytes == content.size());
+        REQUIRE(batch_sizes == std::vector<size_t>{4, 4, 3});
+        for (size_t i = 0; i < events.size(); ++i) {
+            REQUIRE(events[i]["seq"] == i);
+        }
+    }
+
+    SECTION("JSON documents keep whole-document semantics") {
+        FileIngestor ingestor(FileIngestor::Config{.batch_size = 2});
+        auto stats = ingestor.ingest_file(write("events.json", R"([{"a":1},{"b":2},{"c":3}])"), callback);
+
+        REQUIRE(stats.events == 3);
+        REQUIRE(batch_sizes == std::vector<size_t>{2, 1});
+        REQUIRE_THROWS(ingestor.ingest_file(write("bad.json", "[{\"a\":1},"), callback));
+    }
+
+    SECTION("Empty and missing files") {
+        FileIngestor ingestor;
+        REQUIRE(ingestor.ingest_file(write("empty.jsonl", ""), callback).events == 0);
+        REQUIRE(batch_sizes.empty());
+        REQUIRE_THROWS_AS(ingestor.ingest_file((dir / "missing.ndjson").string(), callback),
+                          std::runtime_error);
+    }
+
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/event_normalizer.hpp"
+#include "core/field_plan.hpp"
+
+using namespace siem;
+using namespace siem::core;
+
+TEST_CASE("FieldPlan compiles and executes pointer specs", "[field_plan]") {
+    SECTION("Priority lists, escapes and array indices") {
+        auto plan = FieldPlan::compile({
+            {"user", {"/actor/alternateId", "/actor/id"}},
+            {"ip", {"/client/addrs/1"}},
+            {"path", {"/target~1path/a~0b"}},
+        });
+        REQUIRE(plan.size() == 4);
+
+        // Feature slots are resolved when the plan is compiled
+        REQUIRE(plan.steps()[0].slot == storage::FeatureSlot::Ip);
+        REQUIRE(plan.steps()[1].slot == storage::FeatureSlot::Extra);
+        REQUIRE(plan.steps()[3].slot == storage::FeatureSlot::User);
+
+        json raw = {
+            {"actor", {{"id", "00u1"}, {"alternateId", "alice@example.com"}}},
+            {"client", {{"addrs", {"10.0.0.1", "203.0.113.5"}}}},
+            {"target/path", {{"a~b", "/etc/shadow"}}}
+        };
+
+        storage::Event event;
+        std::optional<storage::timestamp_t> ts;
+        plan.execute(raw, event, ts);
+
+        REQUIRE(event.features.user == "alice@example.com");
+        REQUIRE(event.features.ip == "203.0.113.5");
+        REQUIRE(event.features.extra["path"] == "/etc/shadow");
+        REQUIRE_FALSE(ts.has_value());
+
+        raw["actor"].erase("alternateId");
+        storage::Event fallback;
+        plan.execute(raw, fallback, ts);
+        REQUIRE(fallback.features.user == "00u1");
+    }
+
+    SECTION("Malformed pointers fail at compile time") {
+        REQUIRE_THROWS_AS(FieldPlan::compile({{"ip", {"client/ip"}}}), std::invalid_argument);
+        REQUIRE_THROWS_AS(FieldPlan::compile({{"ip", {""}}}), std::invalid_argument);
+        REQUIRE_THROWS_AS(FieldPlan::compile({{"ip", {"/a~2"}}}), std::invalid_argument);
+        REQUIRE_THROWS_AS(FieldPlan::compile({{"", {"/a"}}}), std::invalid_argument);
+    }
+}
+
+TEST_CASE("EventNormalizer applies per-source profiles", "[field_plan][normalizer]") {
+    EventNormalizer::Config config;
+    config.profiles["paloalto"] = {
+        {"ts", {"/receive_time"}},
+        {"host", {"/device_name"}},
+        {"verb", {"/action"}},
+        {"proto", {"/proto"}},
+        {"dport", {"/dport"}},
+        {"ip", {"/src"}},
+        {"rule", {"/rule"}},
+    };
+    EventNormalizer normalizer(config);
+
+    auto event = normalizer.normalize({
+        {"source", "paloalto"},
+        {"receive_time", "2025-11-07T23:00:01Z"},
+        {"device_name", "pa-edge-01"},
+        {"action", "deny"},
+        {"proto", "tcp"},
+        {"dport", 3389},
+        {"src", "198.51.100.4"},
+        {"rule", "block-rdp"},
+        {"host", "ignored"},
+        {"entity", {{"ip", "ignored"}}}
+    });
+
+    REQUIRE(event.host == "pa-edge-01");
+    REQUIRE(event.features.verb == storage::Verb::Deny);
+    REQUIRE(event.features.proto == storage::Proto::Tcp);
+    REQUIRE(event.features.dport == 3389);
+    REQUIRE(event.features.ip == "198.51.100.4");
+    REQUIRE(event.features.extra["rule"] == "block-rdp");
+    REQUIRE(std::chrono::system_clock::to_time_t(event.ts) == 1762556401);
+
+    // Sources without a profile keep the built-in layout
+    auto other = normalizer.normalize({
+        {"source", "fw"}, {"host", "edge-01"}, {"entity", {{"ip", "10.0.0.7"}}}
+    });
+    REQUIRE(other.host == "edge-01");
+    REQUIRE(other.features.ip == "10.0.0.7");
+}
@@ -0,0 +1,175 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/file_follower.hpp"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace siem::ingest;
+namespace fs = std::filesystem;
+
+namespace {
+
+void append(const fs::path& path, const std::string& content) {
+    std::ofstream(path, std::ios::app | std::ios::binary) << content;
+}
+
+std::string lines(int from, int to) {
+    std::string out;
+    for (int i = from; i < to; ++i) out += R"({"seq":)" + std::to_string(i) + "}\n";
+    return out;
+}
+
+} // namespace
+
+TEST_CASE("FileFollower reads appends, rotations and resumes from checkpoints", "[follow]") {
+    auto dir = fs::temp_directory_path() / "siem_file_follower_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto log = dir / "app.log";
+
+    FileFollower::Config config;
+    config.paths = {log.string()};
+    config.checkpoint_file = (dir / "state" / "checkpoints.json").string();
+    config.batch_size = 4;
+    std::vector<std::string> skipped;
+    config.on_skipped = [&](std::string_view line, const char* reason) {
+        skipped.push_back(std::string(reason) + ":" + std::string(line));
+    };
+
+    std::vector<int> seen;
+    std::vector<size_t> batch_sizes;
+    auto callback = [&](const std::vector<json>& batch) {
+        batch_sizes.push_back(batch.size());
+        for (const auto& event : batch) seen.push_back(event["seq"].get<int>());
+    };
+    auto expect_sequence = [&](int count) {
+        REQUIRE(seen.size() == static_cast<size_t>(count));
+        for (int i = 0; i < count; ++i) REQUIRE(seen[i] == i);
+    };
+
+    SECTION("Appends, partial lines, rotation and restart") {
+        {
+            FileFollower follower(config);
+            follower.scan(callback);  // File does not exist yet
+            REQUIRE(seen.empty());
+
+            append(log, lines(0, 10) + R"({"seq":10)");  // Last line still being written
+            follower.scan(callback);
+            expect_sequence(10);
+            REQUIRE(batch_sizes == std::vector<size_t>{4, 4, 2});
+
+            append(log, "}\nnot json\n" + lines(11, 13));
+            follower.scan(callback);
+            expect_sequence(13);
+            REQUIRE(follower.stats().skipped == 1);
+            REQUIRE(skipped == std::vector<std::string>{"malformed:not json"});
+
+            // logrotate-style: rename, writer finishes the old file, then a new file appears
+            fs::rename(log, dir / "app.log.1");
+            append(dir / "app.log.1", lines(13, 15) + R"({"seq":15})");
+            append(log, lines(16, 18));
+            follower.scan(callback);
+            expect_sequence(18);
+            REQUIRE(follower.stats().rotations == 1);
+
+            append(log, lines(18, 20));
+        }
+
+        // Restart resumes after the checkpoint: nothing is replayed or lost
+        FileFollower restarted(config);
+        restarted.scan(callback);
+        expect_sequence(20);
+    }
+
+    SECTION("Rotation while stopped drains the old inode first") {
+        {
+            FileFollower follower(config);
+            append(log, lines(0, 5));
+            follower.scan(callback);
+            expect_sequence(5);
+        }
+
+        append(log, lines(5, 7));
+        fs::rename(log, dir / "app.log.1");
+        append(log, lines(7, 9));
+
+        FileFollower restarted(config);
+        restarted.scan(callback);
+        expect_sequence(9);
+    }
+
+    SECTION("Truncation in place restarts at offset zero") {
+        FileFollower follower(config);
+        append(log, lines(0, 3));
+        follower.scan(callback);
+
+        std::ofstream(log, std::ios::trunc) << lines(3, 5);
+        follower.scan(callback);
+        expect_sequence(5);
+        REQUIRE(follower.stats().truncations == 1);
+    }
+
+    SECTION("start_at_end checkpoints the offset it skips to") {
+        append(log, lines(0, 3));
+        config.start_at_end = true;
+        {
+            FileFollower follower(config);
+            follower.scan(callback);
+            REQUIRE(seen.empty());
+        }
+
+        // Appended while down, before anything was delivered
+        append(log, lines(3, 5));
+        FileFollower restarted(config);
+        restarted.scan(callback);
+        REQUIRE(seen == std::vector<int>{3, 4});
+    }
+
+    SECTION("A shorter file on the checkpointed inode restarts at zero") {
+        {
+            FileFollower follower(config);
+            append(log, lines(0, 5));
+            follower.scan(callback);
+            expect_sequence(5);
+        }
+
+        // Truncated while down, like an inode reused by a new file
+        std::ofstream(log, std::ios::trunc) << lines(5, 7);
+        FileFollower restarted(config);
+        restarted.scan(callback);
+        expect_sequence(7);
+        REQUIRE(restarted.stats().truncations == 1);
+    }
+
+    SECTION("The follow thread wakes on appends") {
+        config.rescan_ms = 60000;  // Only inotify can deliver within the test
+        FileFollower follower(config);
+
+        std::mutex mutex;
+        size_t count = 0;
+        follower.start([&](const std::vector<json>& batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            count += batch.size();
+        });
+
+        append(log, lines(0, 6));
+        for (int i = 0; i < 200; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (count == 6) break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        follower.stop();
+        REQUIRE(count == 6);
+    }
+
+    SECTION("A corrupt checkpoint file refuses to start") {
+        fs::create_directories(dir / "state");
+        std::ofstream(config.checkpoint_file) << "{oops";
+        FileFollower follower(config);
+        REQUIRE_THROWS_AS(follower.start(callback), std::runtime_error);
+    }
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,256 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/event_normalizer.hpp"
+#include "ingest/flow_collector.hpp"
+#include "ingest/flow_encoder.hpp"
+#include <mutex>
+#include <thread>
+
+using namespace siem;
+using namespace siem::ingest;
+
+namespace {
+
+constexpr int64_t kNow = 1762556401000;  // 2025-11-07T23:00:01Z
+
+std::vector<FlowRecord> sample_flows() {
+    FlowRecord ssh;
+    ssh.src_ip = "10.0.0.7";
+    ssh.dst_ip = "192.0.2.10";
+    ssh.sport = 52144;
+    ssh.dport = 22;
+    ssh.proto = 6;
+    ssh.tcp_flags = 0x12;
+    ssh.bytes = 4096;
+    ssh.packets = 12;
+    ssh.start_ms = kNow - 5000;
+    ssh.end_ms = kNow - 1000;
+
+    FlowRecord dns = ssh;
+    dns.src_ip = "2001:db8::5";
+    dns.dst_ip = "2001:db8::53";
+    dns.dport = 53;
+    dns.proto = 17;
+    dns.bytes = 80;
+
+    FlowRecord gre = ssh;
+    gre.proto = 47;
+    gre.sport = gre.dport = 0;
+    return {ssh, dns, gre};
+}
+
+} // namespace
+
+TEST_CASE("FlowDecoder decodes NetFlow v9 and IPFIX into events", "[flow]") {
+    auto version = GENERATE(FlowEncoder::Version::NetflowV9, FlowEncoder::Version::Ipfix);
+    FlowEncoder encoder(FlowEncoder::Config{version, 7, 256, kNow - 3600000});
+    FlowDecoder decoder;
+    std::string_view exporter = "198.51.100.1";
+    std::vector<storage::Event> events;
+
+    // Data before the template cannot be decoded
+    auto early = decoder.decode(encoder.data(sample_flows(), kNow), exporter, events);
+    REQUIRE(early.missing_template == 2);
+    REQUIRE(events.empty());
+
+    auto learned = decoder.decode(encoder.templates(kNow), exporter, events);
+    REQUIRE(learned.templates == 2);
+    REQUIRE_FALSE(learned.malformed);
+    REQUIRE(decoder.template_count() == 2);
+
+    auto result = decoder.decode(encoder.data(sample_flows(), kNow), exporter, events);
+    REQUIRE_FALSE(result.malformed);
+    REQUIRE(result.records == 3);
+    REQUIRE(events.size() == 3);
+
+    // IPv4 set first, then IPv6
+    const auto& ssh = events[0];
+    REQUIRE(ssh.source == "netflow");
+    REQUIRE(ssh.host == "198.51.100.1");
+    REQUIRE(ssh.features.proto == storage::Proto::Tcp);
+    REQUIRE(ssh.features.sport == 52144);
+    REQUIRE(ssh.features.dport == 22);
+    REQUIRE(ssh.features.ip == "10.0.0.7");
+    REQUIRE(ssh.features.bytes == 4096);
+    REQUIRE(ssh.features.packets == 12);
+    REQUIRE(ssh.features.dst_ip == "192.0.2.10");
+    REQUIRE_FALSE(ssh.features.ip.interned());
+    REQUIRE(ssh.features.extra.is_null());
+    REQUIRE(storage::EventFeatures::from_json(ssh.features.to_json()) == ssh.features);
+    REQUIRE(ssh.ts == storage::timestamp_t(std::chrono::milliseconds(kNow - 1000)));
+
+    REQUIRE(events[1].features.proto_name() == "47");
+    REQUIRE(events[2].features.proto == storage::Proto::Udp);
+    REQUIRE(events[2].features.ip == "2001:db8::5");
+
+    // Fingerprints match an equivalent event from the JSON normalizer
+    core::EventNormalizer normalizer;
+    auto normalized = normalizer.normalize({
+        {"source", "netflow"}, {"host", "198.51.100.1"},
+        {"entity", {{"ip", "10.0.0.7"}}},
+        {"object", {{"proto", "tcp"}, {"dport", 22}}}
+    });
+    REQUIRE(normalizer.compute_fingerprint(ssh) == normalized.fingerprint);
+
+    SECTION("Templates are scoped per exporter and domain") {
+        std::vector<storage::Event> other;
+        auto unknown = decoder.decode(encoder.data(sample_flows(), kNow), "198.51.100.2", other);
+        REQUIRE(unknown.missing_template == 2);
+        REQUIRE(other.empty());
+    }
+
+    SECTION("Truncated packets are rejected set by set") {
+        auto packet = encoder.data(sample_flows(), kNow);
+        std::vector<storage::Event> partial;
+        auto truncated = decoder.decode(std::string_view(packet).substr(0, packet.size() - 10), exporter, partial);
+        REQUIRE(truncated.malformed);
+        // v9 keeps the intact IPv4 set; IPFIX's header length no longer matches
+        REQUIRE(partial.size() == (version == FlowEncoder::Version::NetflowV9 ? 2 : 0));
+
+        REQUIRE(decoder.decode("\x00\x05garbage", exporter, partial).malformed);
+    }
+}
+
+TEST_CASE("FlowDecoder evicts the least recently used exporters", "[flow]") {
+    FlowEncoder encoder(FlowEncoder::Config{FlowEncoder::Version::Ipfix, 7, 256, kNow - 3600000});
+    FlowDecoder decoder(FlowDecoder::Config{"netflow", 4});
+    std::vector<storage::Event> events;
+
+    REQUIRE(decoder.decode(encoder.templates(kNow), "198.51.100.1", events).templates == 2);
+    REQUIRE(decoder.decode(encoder.templates(kNow), "198.51.100.2", events).templates == 2);
+    REQUIRE(decoder.decode(encoder.data(sample_flows(), kNow), "198.51.100.1", events).records == 3);
+
+    // A new exporter pushes out the one idle longest, not the one in use
+    auto spoofed = decoder.decode(encoder.templates(kNow), "203.0.113.66", events);
+    REQUIRE(spoofed.evicted == 2);
+    REQUIRE(decoder.template_count() == 4);
+    REQUIRE(decoder.decode(encoder.data(sample_flows(), kNow), "198.51.100.1", events).records == 3);
+    REQUIRE(decoder.decode(encoder.data(sample_flows(), kNow), "198.51.100.2", events).missing_template == 2);
+
+    // Re-learning replaces in place without evicting
+    REQUIRE(decoder.decode(encoder.templates(kNow), "198.51.100.1", events).evicted == 0);
+    REQUIRE(decoder.template_count() == 4);
+}
+
+TEST_CASE("FlowDecoder handles IPFIX withdrawals and variable-length fields", "[flow]") {
+    auto be16 = [](std::string& out, uint16_t v) {
+        out += static_cast<char>(v >> 8);
+        out += static_cast<char>(v);
+    };
+    auto packet = [&](const std::string& sets) {
+        std::string out;
+        be16(out, 10);
+        be16(out, static_cast<uint16_t>(16 + sets.size()));
+        out.append("\x69\x0e\x7b\xf1" "\0\0\0\0" "\0\0\0\0", 12);
+        return out + sets;
+    };
+
+    // Template 300: enterprise field, variable-length string, dport
+    std::string tmpl;
+    be16(tmpl, 2); be16(tmpl, 24);
+    be16(tmpl, 300); be16(tmpl, 3);
+    be16(tmpl, 0x8000 | 1); be16(tmpl, 4); tmpl.append("\0\0\x12\x34", 4);
+    be16(tmpl, 82); be16(tmpl, 65535);
+    be16(tmpl, 11); be16(tmpl, 2);
+
+    std::string data;
+    be16(data, 300); be16(data, 4 + 4 + 1 + 4 + 2);
+    data.append("\xde\xad\xbe\xef", 4);
+    data += '\x04';
+    data.append("eth0", 4);
+    be16(data, 443);
+
+    FlowDecoder decoder;
+    std::string_view exporter = "198.51.100.9";
+    std::vector<storage::Event> events;
+    REQUIRE(decoder.decode(packet(tmpl + data), exporter, events).records == 1);
+    REQUIRE(events[0].features.dport == 443);
+    REQUIRE(events[0].features.ip.empty());
+
+    std::string withdraw;
+    be16(withdraw, 2); be16(withdraw, 8);
+    be16(withdraw, 300); be16(withdraw, 0);
+    REQUIRE(decoder.decode(packet(withdraw), exporter, events).templates == 1);
+    REQUIRE(decoder.template_count() == 0);
+    REQUIRE(decoder.decode(packet(data), exporter, events).missing_template == 1);
+}
+
+TEST_CASE("FlowDecoder ignores end times a timestamp cannot hold", "[flow]") {
+    auto be16 = [](std::string& out, uint16_t v) {
+        out += static_cast<char>(v >> 8);
+        out += static_cast<char>(v);
+    };
+    constexpr int64_t kExportMs = int64_t{0x690e7bf1} * 1000;
+
+    // Template 301: flowEndSeconds and flowEndMilliseconds, 8 bytes each
+    std::string tmpl;
+    be16(tmpl, 2); be16(tmpl, 16);
+    be16(tmpl, 301); be16(tmpl, 2);
+    be16(tmpl, 151); be16(tmpl, 8);
+    be16(tmpl, 153); be16(tmpl, 8);
+
+    auto packet = [&](uint64_t end_seconds, uint64_t end_ms) {
+        std::string data;
+        be16(data, 301); be16(data, 4 + 16);
+        for (uint64_t v : {end_seconds, end_ms}) {
+            for (int shift = 56; shift >= 0; shift -= 8) data += static_cast<char>(v >> shift);
+        }
+        std::string out;
+        be16(out, 10);
+        be16(out, static_cast<uint16_t>(16 + tmpl.size() + data.size()));
+        out.append("\x69\x0e\x7b\xf1" "\0\0\0\0" "\0\0\0\0", 12);
+        return out + tmpl + data;
+    };
+
+    FlowDecoder decoder;
+    std::vector<storage::Event> events;
+    REQUIRE(decoder.decode(packet(UINT64_MAX, 0), "198.51.100.9", events).records == 1);
+    REQUIRE(decoder.decode(packet(0, UINT64_MAX / 2), "198.51.100.9", events).records == 1);
+    REQUIRE(decoder.decode(packet(kNow / 1000, UINT64_MAX), "198.51.100.9", events).records == 1);
+    REQUIRE(events[0].ts == storage::timestamp_t(std::chrono::milliseconds(kExportMs)));
+    REQUIRE(events[1].ts == storage::timestamp_t(std::chrono::milliseconds(kExportMs)));
+    REQUIRE(events[2].ts == storage::timestamp_t(std::chrono::milliseconds(kNow / 1000 * 1000)));
+}
+
+TEST_CASE("FlowCollector delivers events over UDP", "[flow]") {
+    core::EventNormalizer normalizer;
+    FlowCollector::Config config;
+    config.bind_address = "127.0.0.1";
+    config.port = 0;
+    config.flush_ms = 10;
+    FlowCollector collector(config);
+
+    std::mutex mutex;
+    std::vector<storage::Event> events;
+    collector.start([&](std::vector<storage::Event>& batch) {
+        normalizer.finalize(batch);
+        std::lock_guard<std::mutex> lock(mutex);
+        events.insert(events.end(), batch.begin(), batch.end());
+    });
+
+    net::io_context ioc;
+    udp::socket client(ioc, udp::v4());
+    udp::endpoint target(net::ip::make_address("127.0.0.1"), collector.port());
+    FlowEncoder encoder;
+    client.send_to(net::buffer(encoder.templates(kNow)), target);
+    client.send_to(net::buffer(encoder.data(sample_flows(), kNow)), target);
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (events.size() >= 3) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    collector.stop();
+
+    REQUIRE(events.size() == 3);
+    for (const auto& event : events) {
+        REQUIRE(event.host == "127.0.0.1");
+        REQUIRE(event.fingerprint == normalizer.compute_fingerprint(event));
+        REQUIRE_FALSE(event.trace_id.empty());
+    }
+    auto stats = collector.stats();
+    REQUIRE(stats.packets == 2);
+    REQUIRE(stats.records == 3);
+    REQUIRE(stats.templates == 2);
+}
@@ -0,0 +1,252 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/grok_matcher.hpp"
+#include "ingest/file_ingestor.hpp"
+#include "ingest/syslog_server.hpp"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <regex>
+#include <thread>
+
+using namespace siem::ingest;
+namespace fs = std::filesystem;
+
+namespace {
+
+GrokMatcher::Config config_of(std::vector<GrokMatcher::Pattern> patterns) {
+    GrokMatcher::Config config;
+    config.patterns = std::move(patterns);
+    return config;
+}
+
+} // namespace
+
+TEST_CASE("GrokMatcher extracts typed, nested captures", "[grok]") {
+    GrokMatcher::Config config = config_of({
+        {"sshd", "%{WORD:outcome} %{SSH_METHOD} for (?:invalid user )?%{USERNAME:entity.user} from "
+                 "%{IP:entity.ip} port %{INT:object.sport:int} ssh2", "sshd"},
+        {"access", R"(%{IPORHOST:entity.ip} - %{NOTSPACE:entity.user} \[%{HTTPDATE:ts}\] )"
+                   R"("%{WORD:verb} %{URIPATHPARAM:object.path} HTTP/%{NUMBER:object.http:float}" )"
+                   R"(%{INT:object.status:int} (?:%{INT:object.bytes:int}|-))", ""},
+        {"app", "^%{TIMESTAMP_ISO8601:ts} +%{LOGLEVEL:level} (?<text>.*)$", ""},
+    });
+    config.definitions["SSH_METHOD"] = "password|publickey";
+    GrokMatcher grok(config);
+
+    json event = {{"source", "app"}};
+    REQUIRE(grok.match("Failed password for invalid user admin from 203.0.113.5 port 52144 ssh2", event));
+    REQUIRE(event["source"] == "sshd");
+    REQUIRE(event["outcome"] == "Failed");
+    REQUIRE(event["entity"]["user"] == "admin");
+    REQUIRE(event["entity"]["ip"] == "203.0.113.5");
+    REQUIRE(event["object"]["sport"] == 52144);
+
+    event = json::object();
+    REQUIRE(grok.match(R"(10.1.2.3 - alice [07/Nov/2025:23:00:01 +0000] "GET /login?next=%2F HTTP/1.1" 401 -)",
+                       event));
+    REQUIRE(event["entity"]["ip"] == "10.1.2.3");
+    REQUIRE(event["ts"] == "07/Nov/2025:23:00:01 +0000");
+    REQUIRE(event["verb"] == "GET");
+    REQUIRE(event["object"]["path"] == "/login?next=%2F");
+    REQUIRE(event["object"]["http"] == 1.1);
+    REQUIRE(event["object"]["status"] == 401);
+    REQUIRE_FALSE(event["object"].contains("bytes"));
+    REQUIRE_FALSE(event.contains("source"));
+
+    event = json::object();
+    REQUIRE(grok.match("2025-11-07T23:00:01.003Z  WARN disk 91% full", event));
+    REQUIRE(event["ts"] == "2025-11-07T23:00:01.003Z");
+    REQUIRE(event["level"] == "WARN");
+    REQUIRE(event["text"] == "disk 91% full");
+
+    // Whole-line matches only; nothing is written on a miss
+    event = {{"kept", true}};
+    REQUIRE_FALSE(grok.match("Failed password for root from 203.0.113.5 port 22 ssh2 extra", event));
+    REQUIRE(event == json{{"kept", true}});
+    REQUIRE(grok.find("Accepted publickey for bob from ::1 port 22 ssh2") == 0);
+    REQUIRE(grok.find("") == -1);
+}
+
+TEST_CASE("GrokMatcher picks the first listed pattern and honours laziness", "[grok]") {
+    GrokMatcher grok(config_of({
+        {"specific", "user=%{WORD:user} %{GREEDYDATA:rest}", ""},
+        {"generic", "%{DATA:key}=%{GREEDYDATA:value}", ""},
+        {"digits", "[0-9]{2,3}", ""},
+    }));
+
+    json event;
+    REQUIRE(grok.match("user=bob logged in", event));
+    REQUIRE(event == json{{"user", "bob"}, {"rest", "logged in"}});
+
+    event = json::object();
+    REQUIRE(grok.match("a=b=c", event));
+    REQUIRE(event["key"] == "a");
+    REQUIRE(event["value"] == "b=c");
+
+    REQUIRE(grok.find("12") == 2);
+    REQUIRE(grok.find("123") == 2);
+    REQUIRE(grok.find("1234") == -1);
+    REQUIRE(grok.find("1") == -1);
+
+    auto stats = grok.stats();
+    REQUIRE(stats.patterns.size() == 3);
+    REQUIRE(stats.patterns[0].name == "specific");
+    REQUIRE(stats.patterns[0].hits == 1);
+    REQUIRE(stats.patterns[1].hits == 1);
+    REQUIRE(stats.patterns[2].hits == 0);  // find() is not counted
+
+    // Long enough that the visited set leaves its bitmap for the sparse table
+    std::string value(40000, 'v');
+    event = json::object();
+    REQUIRE(grok.match("k=" + value + "=tail", event));
+    REQUIRE(event["key"] == "k");
+    REQUIRE(event["value"] == value + "=tail");
+    event = json::object();
+    REQUIRE(grok.match("a=b=c", event));
+    REQUIRE(event["value"] == "b=c");
+
+    event = json::object();
+    REQUIRE_FALSE(grok.match("no equals sign", event));
+    stats = grok.stats();
+    REQUIRE(stats.unmatched.hits == 1);
+
+    uint64_t bucketed = 0;
+    for (uint64_t count : stats.patterns[0].buckets) bucketed += count;
+    REQUIRE(bucketed == 1);
+    REQUIRE(stats.patterns[0].percentile_ns(0.99) >= stats.patterns[0].mean_ns() / 2);
+}
+
+TEST_CASE("GrokMatcher agrees with std::regex", "[grok]") {
+    const std::vector<std::string> patterns = {
+        "(?<a>a*)(?<b>a|b)*",
+        "(?<a>[ab]*?)(?<b>b+)(?<c>.*)",
+        "(?:(?<a>ab|a)(?<b>b?))+c?",
+        "(?<a>a{1,3}?)(?<b>a{0,2})b?",
+        "(?<a>[^b]*)b(?<b>\\w*)",
+    };
+    std::mt19937 rng(7);
+
+    for (const auto& pattern : patterns) {
+        GrokMatcher grok(config_of({{"p", pattern, ""}}));
+        std::regex re(std::regex_replace(pattern, std::regex("\\?<[a-z]>"), ""));
+
+        for (int i = 0; i < 300; ++i) {
+            std::string line;
+            size_t length = rng() % 8;
+            for (size_t j = 0; j < length; ++j) line += "abc"[rng() % 3];
+
+            std::smatch expected;
+            bool matched = std::regex_match(line, expected, re);
+            json event = json::object();
+            INFO(pattern << " on \"" << line << "\"");
+            REQUIRE(grok.match(line, event) == matched);
+            if (!matched) continue;
+
+            for (size_t group = 1; group < expected.size(); ++group) {
+                std::string name(1, static_cast<char>('a' + group - 1));
+                if (expected[group].matched && expected[group].length() > 0) {
+                    REQUIRE(event[name] == expected[group].str());
+                } else {
+                    REQUIRE_FALSE(event.contains(name));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("GrokMatcher rejects what it cannot compile", "[grok]") {
+    auto compile = [](std::string match) { return GrokMatcher(config_of({{"p", std::move(match), ""}})); };
+
+    REQUIRE_THROWS_AS(compile("%{NOPE:x}"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("\\bword\\b"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("(?=a)a"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("(?<!a)b"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("(a"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("a)"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("[a-"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("a{3,1}"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("a++"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("%{INT:n:bool}"), std::invalid_argument);
+    REQUIRE_THROWS_AS(compile("%{INT:a..b}"), std::invalid_argument);
+    REQUIRE_NOTHROW(compile("a{,2}"));  // Not a quantifier: literal text
+
+    GrokMatcher::Config recursive = config_of({{"p", "%{A}", ""}});
+    recursive.definitions = {{"A", "x%{B}"}, {"B", "y%{A}?"}};
+    REQUIRE_THROWS_AS(GrokMatcher(recursive), std::invalid_argument);
+
+    GrokMatcher::Config large = config_of({{"p", "(?:a|b)*a(?:a|b){12}", ""}});
+    large.max_dfa_states = 1000;
+    REQUIRE_THROWS_AS(GrokMatcher(large), std::invalid_argument);
+}
+
+TEST_CASE("Text files and syslog messages are parsed with grok", "[grok]") {
+    auto grok = std::make_shared<const GrokMatcher>(config_of({
+        {"login", "login %{WORD:outcome} user=%{USERNAME:entity.user} ip=%{IP:entity.ip}", "auth"},
+    }));
+
+    auto dir = fs::temp_directory_path() / "siem_grok_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto path = dir / "app.log";
+    std::ofstream(path, std::ios::binary) << "login failed user=bob ip=10.0.0.1\r\n"
+                                          << "something else\n\n"
+                                          << "login ok user=alice ip=10.0.0.2";
+
+    FileIngestor::Config config;
+    config.format = FileIngestor::Format::Text;
+    REQUIRE_THROWS_AS(FileIngestor(config).read_file(path.string(), [](json&&) {}), std::invalid_argument);
+
+    config.format = FileIngestor::Format::Auto;
+    config.grok = grok;
+    FileIngestor ingestor(config);
+    std::vector<json> events;
+    auto stats = ingestor.ingest_file(path.string(), [&](const std::vector<json>& batch) {
+        events.insert(events.end(), batch.begin(), batch.end());
+    });
+    REQUIRE(stats.events == 2);
+    REQUIRE(stats.skipped == 1);
+    REQUIRE(events[0]["source"] == "auth");
+    REQUIRE(events[0]["message"] == "login failed user=bob ip=10.0.0.1");
+    REQUIRE(events[0]["entity"]["user"] == "bob");
+    REQUIRE(events[1]["entity"]["ip"] == "10.0.0.2");
+    fs::remove_all(dir);
+
+    SyslogServer::Config syslog_config;
+    syslog_config.bind_address = "127.0.0.1";
+    syslog_config.udp_port = 0;
+    syslog_config.tcp_enabled = false;
+    syslog_config.flush_ms = 10;
+    syslog_config.grok = grok;
+    SyslogServer server(syslog_config);
+
+    std::mutex mutex;
+    std::vector<json> received;
+    server.start([&](const std::vector<json>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.insert(received.end(), batch.begin(), batch.end());
+    });
+
+    net::io_context ioc;
+    udp::socket client(ioc, udp::v4());
+    udp::endpoint target(net::ip::make_address("127.0.0.1"), server.udp_port());
+    for (std::string msg : {"<38>Nov  7 23:00:01 web01 app: login failed user=carol ip=10.0.0.3",
+                            "<38>Nov  7 23:00:01 web01 app: unrelated"}) {
+        client.send_to(net::buffer(msg), target);
+    }
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() >= 2) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    server.stop();
+
+    REQUIRE(received.size() == 2);
+    REQUIRE(received[0]["source"] == "auth");
+    REQUIRE(received[0]["host"] == "web01");
+    REQUIRE(received[0]["entity"]["user"] == "carol");
+    REQUIRE(received[1]["source"] == "syslog");
+    REQUIRE_FALSE(received[1].contains("entity"));
+}
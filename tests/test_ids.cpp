@@ -1,6 +1,9 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include "core/ids.hpp"
+#include <algorithm>
 #include <set>
+#include <vector>
 
 using namespace siem::core;
 
@@ -10,7 +13,7 @@ TEST_CASE("IDGenerator generates unique IDs", "[ids]") {
         
         for (int i = 0; i < 1000; ++i) {
             auto id = IDGenerator::generate_incident_id();
-            REQUIRE(id.starts_with("inc_"));
+            REQUIRE(id.starts_with("incu_"));
             REQUIRE(ids.find(id) == ids.end()); // Unique
             ids.insert(id);
         }
@@ -19,13 +22,15 @@ TEST_CASE("IDGenerator generates unique IDs", "[ids]") {
     }
     
     SECTION("Cluster IDs are deterministic") {
-        std::string fingerprint = "test_fingerprint_123";
+        uint64_t fingerprint = 0x9f2a8b3c12345678ULL;
         
         auto id1 = IDGenerator::generate_cluster_id(fingerprint);
         auto id2 = IDGenerator::generate_cluster_id(fingerprint);
         
         REQUIRE(id1 == id2);
         REQUIRE(id1.starts_with("clu_"));
+        REQUIRE(id1.size() == 12);
+        REQUIRE(id1 != IDGenerator::generate_cluster_id(fingerprint + 1));
     }
     
     SECTION("Trace IDs are unique") {
@@ -41,3 +46,69 @@ TEST_CASE("IDGenerator generates unique IDs", "[ids]") {
     }
 }
 
+TEST_CASE("IDGenerator ULIDs sort by creation time", "[ids]") {
+    using namespace std::chrono;
+
+    SECTION("Format and timestamp round trip") {
+        auto now = system_clock::now();
+        auto id = IDGenerator::ulid(now);
+        std::string_view text(id.data(), id.size());
+        auto millis = duration_cast<milliseconds>(now.time_since_epoch()).count();
+
+        REQUIRE(text.find_first_not_of("0123456789ABCDEFGHJKMNPQRSTVWXYZ") == std::string_view::npos);
+        REQUIRE(IDGenerator::ulid_millis(text) >= millis);
+        REQUIRE(IDGenerator::ulid_millis("01ARZ3NDEKTSV4RRFFQ69G5FAV") == 1469922850259);
+        REQUIRE(IDGenerator::ulid_millis("not-a-ulid") == -1);
+
+        auto incident = IDGenerator::generate_incident_id();
+        REQUIRE(incident.size() == 31);
+        REQUIRE(IDGenerator::ulid_millis(std::string_view(incident).substr(5)) > 0);
+
+        // Legacy "inc_" + lowercase base36 ids all sort first, so _id $gt
+        // pagination from an old id still reaches new incidents
+        REQUIRE(std::string("inc_zzzzzzzzzzz") < incident);
+        REQUIRE(std::string("inc_t3k9x2abc") < incident);
+    }
+
+    SECTION("Lexicographic order is generation order") {
+        std::vector<std::string> ids;
+        auto start = system_clock::now();
+
+        // Same millisecond repeated, then advancing, then a clock step back
+        for (int i = 0; i < 1000; ++i) {
+            ids.push_back(IDGenerator::to_string(IDGenerator::ulid(start + milliseconds(i / 100))));
+        }
+        ids.push_back(IDGenerator::to_string(IDGenerator::ulid(start)));
+
+        REQUIRE(std::is_sorted(ids.begin(), ids.end()));
+        REQUIRE(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+
+        // Incident ids generated later still sort after earlier ones
+        auto first = IDGenerator::generate_incident_id();
+        auto second = IDGenerator::generate_incident_id();
+        REQUIRE(first < second);
+    }
+}
+
+
+TEST_CASE("IDGenerator throughput", "[.][benchmark][ids]") {
+    BENCHMARK("incident_id (array)") {
+        return IDGenerator::incident_id();
+    };
+
+    BENCHMARK("trace_id (array)") {
+        return IDGenerator::trace_id();
+    };
+
+    BENCHMARK("generate_incident_id") {
+        return IDGenerator::generate_incident_id();
+    };
+
+    BENCHMARK("generate_trace_id") {
+        return IDGenerator::generate_trace_id();
+    };
+
+    BENCHMARK("generate_cluster_id") {
+        return IDGenerator::generate_cluster_id(0x9f2a8b3c12345678ULL);
+    };
+}
@@ -0,0 +1,403 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/secret_redactor.hpp"
+#include "ingest/binary_ingest_server.hpp"
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+using namespace siem::ingest;
+
+namespace {
+
+HTTPIngestor::Config policy_config() {
+    HTTPIngestor::Config config;
+    config.hmac_secret = "agent-secret";
+    return config;
+}
+
+BinaryIngestServer::Config server_config() {
+    BinaryIngestServer::Config config;
+    config.port = 0;
+    config.credit = 4;
+    return config;
+}
+
+json make_batch(int first, int count) {
+    json batch = json::array();
+    for (int i = first; i < first + count; ++i) {
+        batch.push_back({{"source", "agent"}, {"host", "h1"}, {"message", "event " + std::to_string(i)}});
+    }
+    return batch;
+}
+
+} // namespace
+
+TEST_CASE("IngestProtocol frames and payloads round-trip", "[ingest_protocol]") {
+    std::string wire;
+    IngestProtocol::append_frame(wire, IngestProtocol::FrameType::Ack,
+        IngestProtocol::encode_ack({0x0102030405060708ULL, 7, 2, 1}));
+    IngestProtocol::append_frame(wire, IngestProtocol::FrameType::Error, "bye");
+
+    SECTION("Frames parse back one at a time and wait for missing bytes") {
+        REQUIRE_FALSE(IngestProtocol::next_frame(std::string_view(wire).substr(0, 3), 1024));
+        REQUIRE_FALSE(IngestProtocol::next_frame(std::string_view(wire).substr(0, 10), 1024));
+
+        auto first = IngestProtocol::next_frame(wire, 1024);
+        REQUIRE(first);
+        REQUIRE(first->type == IngestProtocol::FrameType::Ack);
+        REQUIRE(first->size == IngestProtocol::kHeaderBytes + 20);
+        auto ack = IngestProtocol::decode_ack(first->payload);
+        REQUIRE(ack.sequence == 0x0102030405060708ULL);
+        REQUIRE(ack.accepted == 7);
+        REQUIRE(ack.rejected == 2);
+        REQUIRE(ack.credit == 1);
+
+        auto second = IngestProtocol::next_frame(std::string_view(wire).substr(first->size), 1024);
+        REQUIRE(second);
+        REQUIRE(second->type == IngestProtocol::FrameType::Error);
+        REQUIRE(second->payload == "bye");
+    }
+
+    SECTION("Oversized lengths are rejected before the body arrives") {
+        REQUIRE_THROWS_AS(IngestProtocol::next_frame(wire, 8), std::length_error);
+    }
+
+    SECTION("MessagePack and CBOR carry the same events") {
+        json batch = make_batch(0, 3);
+        batch[1]["features"] = {{"bytes", 1234}, {"ratio", 0.5}, {"tags", {"a", "b"}}};
+        for (auto encoding : {IngestProtocol::Encoding::MessagePack, IngestProtocol::Encoding::Cbor}) {
+            auto payload = IngestProtocol::encode_events(batch, encoding);
+            REQUIRE(IngestProtocol::decode_events(payload, encoding) == batch);
+        }
+        REQUIRE_THROWS(IngestProtocol::decode_events("\xc1", IngestProtocol::Encoding::MessagePack));
+    }
+
+    SECTION("Decoding matches nlohmann's readers on random documents") {
+        std::mt19937 rng(7);
+        std::function<json(int)> random_value = [&](int depth) -> json {
+            switch (rng() % (depth > 3 ? 6 : 8)) {
+                case 0: return nullptr;
+                case 1: return rng() % 2 == 0;
+                case 2: return static_cast<int64_t>(rng()) - (int64_t{1} << 31) * static_cast<int64_t>(rng() % 3);
+                case 3: return static_cast<uint64_t>(rng()) << (rng() % 33);
+                case 4: return std::ldexp(static_cast<double>(rng()), static_cast<int>(rng() % 40) - 20);
+                case 5: return std::string(rng() % 300, static_cast<char>('a' + rng() % 26));
+                case 6: {
+                    json array = json::array();
+                    for (size_t i = rng() % 20; i > 0; --i) array.push_back(random_value(depth + 1));
+                    return array;
+                }
+                default: {
+                    json object = json::object();
+                    for (size_t i = rng() % 20; i > 0; --i) object["k" + std::to_string(rng() % 40)] = random_value(depth + 1);
+                    return object;
+                }
+            }
+        };
+
+        for (int i = 0; i < 300; ++i) {
+            json doc = random_value(0);
+            auto msgpack = json::to_msgpack(doc);
+            auto cbor = json::to_cbor(doc);
+            std::string_view msgpack_view(reinterpret_cast<const char*>(msgpack.data()), msgpack.size());
+            std::string_view cbor_view(reinterpret_cast<const char*>(cbor.data()), cbor.size());
+            REQUIRE(IngestProtocol::decode_events(msgpack_view, IngestProtocol::Encoding::MessagePack) ==
+                    json::from_msgpack(msgpack));
+            REQUIRE(IngestProtocol::decode_events(cbor_view, IngestProtocol::Encoding::Cbor) == json::from_cbor(cbor));
+        }
+
+        // Forms nlohmann never writes: indefinite lengths and half floats
+        using namespace std::string_literals;
+        std::string cbor = "\xbf\x63" "abc" "\x9f\x01\xf9\x3e\x00\x7f\x62" "de" "\x61" "f" "\xff\xff\xff"s;
+        std::vector<uint8_t> bytes(cbor.begin(), cbor.end());
+        REQUIRE(IngestProtocol::decode_events(cbor, IngestProtocol::Encoding::Cbor) == json::from_cbor(bytes));
+        REQUIRE(IngestProtocol::decode_events(cbor, IngestProtocol::Encoding::Cbor) ==
+                json{{"abc", {1, 1.5, "def"}}});
+
+        // Truncation, trailing bytes, non-string keys and runaway nesting
+        REQUIRE_THROWS(IngestProtocol::decode_events("\xda\x00\x10" "abc", IngestProtocol::Encoding::MessagePack));
+        REQUIRE_THROWS(IngestProtocol::decode_events("\x01\x02", IngestProtocol::Encoding::MessagePack));
+        REQUIRE_THROWS(IngestProtocol::decode_events("\x81\x01\x02", IngestProtocol::Encoding::MessagePack));
+        REQUIRE_THROWS(IngestProtocol::decode_events(std::string(10000, '\x91') + "\x01",
+                                                     IngestProtocol::Encoding::MessagePack));
+    }
+}
+
+TEST_CASE("HTTPIngestor applies ingest policy to decoded events", "[ingest_protocol]") {
+    auto config = policy_config();
+    config.rate_limit.burst = 2;
+    config.rate_limit.max_events_per_minute = 1;
+    HTTPIngestor ingestor(config);
+
+    json batch = make_batch(0, 3);
+    batch[0]["password"] = "hunter2";
+    batch.push_back(42);
+
+    std::vector<json> out;
+    auto stats = ingestor.ingest_events(std::move(batch), [&](json&& event) { out.push_back(std::move(event)); });
+    REQUIRE(stats.accepted == 2);
+    REQUIRE(stats.rate_limited == 1);
+    REQUIRE(stats.redacted == 1);
+    REQUIRE(out.size() == 2);
+    REQUIRE(out[0]["password"] == siem::core::SecretRedactor::kMarker);
+
+    // A body that breaks off part way still reports what was rate-limited
+    std::string body = make_batch(0, 2).dump();
+    body.pop_back();
+    HTTPIngestor::IngestStats partial;
+    REQUIRE_THROWS(ingestor.parse_ingest_request(body, ContentEncoding::Identity, [](json&&) {}, partial));
+    REQUIRE(partial.accepted == 0);
+    REQUIRE(partial.rate_limited == 2);
+
+    // The static HMAC matches what verify_signature expects
+    REQUIRE(ingestor.verify_signature("body", HTTPIngestor::compute_hmac("agent-secret", "body")));
+    REQUIRE_FALSE(ingestor.verify_signature("body", HTTPIngestor::compute_hmac("other", "body")));
+}
+
+TEST_CASE("BinaryIngestServer accepts authenticated sessions", "[ingest_protocol]") {
+    HTTPIngestor policy(policy_config());
+    auto config = server_config();
+    config.unix_path = (std::filesystem::temp_directory_path() /
+                        ("siem_ingest_test_" + std::to_string(::getpid()) + ".sock")).string();
+    BinaryIngestServer server(config, policy);
+
+    std::mutex mutex;
+    std::vector<json> received;
+    server.start([&](const std::vector<json>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.insert(received.end(), batch.begin(), batch.end());
+        return batch.size();
+    });
+
+    SECTION("MessagePack over TCP, more frames than credit") {
+        IngestClient client({"agent-secret", IngestProtocol::Encoding::MessagePack});
+        client.connect("127.0.0.1", server.port());
+        REQUIRE(client.credit() == 4);
+
+        for (int i = 0; i < 10; ++i) client.send(make_batch(i * 5, 5));
+        auto totals = client.flush();
+        REQUIRE(totals.frames == 10);
+        REQUIRE(totals.accepted == 50);
+        REQUIRE(totals.rejected == 0);
+        REQUIRE(client.credit() == 4);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(received.size() == 50);
+        REQUIRE(received[49]["message"] == "event 49");
+    }
+
+    SECTION("CBOR over the Unix socket") {
+        IngestClient client({"agent-secret", IngestProtocol::Encoding::Cbor});
+        client.connect_unix(config.unix_path);
+        client.send(make_batch(0, 3));
+        client.send(json{{"source", "agent"}, {"host", "h1"}, {"message", "single"}});
+        auto totals = client.flush();
+        REQUIRE(totals.accepted == 4);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(received.size() == 4);
+        REQUIRE(received[3]["message"] == "single");
+    }
+
+    SECTION("A wrong secret is refused") {
+        IngestClient client({"wrong-secret", IngestProtocol::Encoding::MessagePack});
+        REQUIRE_THROWS_WITH(client.connect("127.0.0.1", server.port()),
+                            "ingest session refused: authentication_failed");
+        REQUIRE(server.stats().auth_failures == 1);
+    }
+
+    SECTION("Events before authentication close the session") {
+        net::io_context ioc;
+        net::ip::tcp::socket socket(ioc);
+        socket.connect(net::ip::tcp::endpoint(net::ip::make_address("127.0.0.1"), server.port()));
+
+        std::string wire;
+        IngestProtocol::append_frame(wire, IngestProtocol::FrameType::Events,
+            IngestProtocol::encode_events(make_batch(0, 1), IngestProtocol::Encoding::MessagePack));
+        net::write(socket, net::buffer(wire));
+
+        // Challenge, then Error, then EOF
+        std::string reply;
+        boost::system::error_code ec;
+        char chunk[256];
+        while (!ec) {
+            size_t n = socket.read_some(net::buffer(chunk), ec);
+            reply.append(chunk, n);
+        }
+        auto challenge = IngestProtocol::next_frame(reply, 1024);
+        REQUIRE(challenge);
+        REQUIRE(challenge->type == IngestProtocol::FrameType::Challenge);
+        auto error = IngestProtocol::next_frame(std::string_view(reply).substr(challenge->size), 1024);
+        REQUIRE(error);
+        REQUIRE(error->type == IngestProtocol::FrameType::Error);
+        REQUIRE(error->payload == "expected_auth");
+        REQUIRE(server.stats().protocol_errors == 1);
+        REQUIRE(received.empty());
+    }
+
+    server.stop();
+    REQUIRE_FALSE(std::filesystem::exists(config.unix_path));
+}
+
+TEST_CASE("BinaryIngestServer reports rate-limited and unstored events", "[ingest_protocol]") {
+    auto config = policy_config();
+    config.rate_limit.burst = 5;
+    config.rate_limit.max_events_per_minute = 1;
+    HTTPIngestor policy(config);
+    BinaryIngestServer server(server_config(), policy);
+
+    // Pretend normalization drops one event per frame
+    server.start([](const std::vector<json>& batch) { return batch.size() - 1; });
+
+    IngestClient client({"agent-secret", IngestProtocol::Encoding::MessagePack});
+    client.connect("127.0.0.1", server.port());
+    client.send(make_batch(0, 4));
+    client.send(make_batch(4, 4));
+    auto totals = client.flush();
+    server.stop();
+
+    // Frame 1: 4 admitted, 3 stored; frame 2: 1 admitted (burst 5), 0 stored
+    REQUIRE(totals.accepted == 3);
+    REQUIRE(totals.rejected == 5);
+    REQUIRE(server.stats().frames == 2);
+    REQUIRE(server.stats().events == 3);
+    REQUIRE(server.stats().rejected == 5);
+}
+
+TEST_CASE("BinaryIngestServer closes without an Ack when delivery fails", "[ingest_protocol]") {
+    HTTPIngestor policy(policy_config());
+    BinaryIngestServer server(server_config(), policy);
+
+    // The second frame hits a full write-ahead log
+    std::mutex mutex;
+    std::vector<json> received;
+    bool refuse = true;
+    server.start([&](const std::vector<json>& batch) -> size_t {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (refuse && batch[0]["message"] == "event 3") throw std::runtime_error("write-ahead log is full");
+        received.insert(received.end(), batch.begin(), batch.end());
+        return batch.size();
+    });
+
+    IngestClient client({"agent-secret", IngestProtocol::Encoding::MessagePack});
+    client.connect("127.0.0.1", server.port());
+    for (int i = 0; i < 3; ++i) client.send(make_batch(i * 3, 3));
+    REQUIRE_THROWS_WITH(client.flush(), "ingest session closed: delivery_failed");
+
+    // Only the first frame was acknowledged; nothing after the failure ran
+    REQUIRE(client.totals().frames == 1);
+    REQUIRE(client.totals().rejected == 0);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(received.size() == 3);
+        refuse = false;
+    }
+
+    // The agent resends what was not acknowledged
+    IngestClient retry({"agent-secret", IngestProtocol::Encoding::MessagePack});
+    retry.connect("127.0.0.1", server.port());
+    for (int i = 1; i < 3; ++i) retry.send(make_batch(i * 3, 3));
+    REQUIRE(retry.flush().accepted == 6);
+    server.stop();
+
+    REQUIRE(received.size() == 9);
+    REQUIRE(server.stats().rejected == 0);
+}
+
+TEST_CASE("BinaryIngestServer delivers off the io thread", "[ingest_protocol]") {
+    HTTPIngestor policy(policy_config());
+    auto config = server_config();
+    config.delivery_threads = 2;
+    BinaryIngestServer server(config, policy);
+
+    // Frames from host "slow" block until released, like a full pipeline
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool released = false;
+    std::atomic<int> blocked{0};
+    server.start([&](const std::vector<json>& batch) {
+        if (batch[0]["host"] == "slow") {
+            blocked++;
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return released; });
+        }
+        return batch.size();
+    });
+
+    IngestClient slow({"agent-secret", IngestProtocol::Encoding::MessagePack});
+    slow.connect("127.0.0.1", server.port());
+    json batch = make_batch(0, 2);
+    for (auto& event : batch) event["host"] = "slow";
+    slow.send(batch);
+    slow.send(batch);
+    for (int i = 0; i < 500 && blocked.load() == 0; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(blocked.load() == 1);
+
+    // Another session is acknowledged while the first is stuck
+    IngestClient fast({"agent-secret", IngestProtocol::Encoding::MessagePack});
+    fast.connect("127.0.0.1", server.port());
+    fast.send(make_batch(0, 3));
+    REQUIRE(fast.flush().accepted == 3);
+    REQUIRE(blocked.load() == 1);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        released = true;
+    }
+    cv.notify_all();
+    auto totals = slow.flush();
+    REQUIRE(totals.frames == 2);
+    REQUIRE(totals.accepted == 4);
+    server.stop();
+    REQUIRE(server.stats().events == 7);
+}
+
+TEST_CASE("BinaryIngestServer only replaces a stale socket at unix_path", "[ingest_protocol]") {
+    HTTPIngestor policy(policy_config());
+    auto config = server_config();
+    config.tcp_enabled = false;
+    config.unix_path = (std::filesystem::temp_directory_path() /
+                        ("siem_ingest_path_" + std::to_string(::getpid()))).string();
+
+    SECTION("A regular file is left alone") {
+        { std::ofstream(config.unix_path) << "keep"; }
+        BinaryIngestServer server(config, policy);
+        REQUIRE_THROWS_AS(server.start(nullptr), std::runtime_error);
+        std::ifstream in(config.unix_path);
+        std::string content;
+        in >> content;
+        REQUIRE(content == "keep");
+    }
+
+    SECTION("A socket from an earlier run is replaced") {
+        // Bound and closed without unlinking, as after a crash
+        net::io_context ioc;
+        net::local::stream_protocol::acceptor stale(ioc, net::local::stream_protocol::endpoint(config.unix_path));
+        stale.close();
+        REQUIRE(std::filesystem::is_socket(std::filesystem::symlink_status(config.unix_path)));
+
+        BinaryIngestServer server(config, policy);
+        server.start(nullptr);
+        IngestClient client({"agent-secret", IngestProtocol::Encoding::MessagePack});
+        client.connect_unix(config.unix_path);
+        client.send(make_batch(0, 1));
+        // Nothing to deliver to, so the event is not claimed as accepted
+        auto totals = client.flush();
+        REQUIRE(totals.accepted == 0);
+        REQUIRE(totals.rejected == 1);
+        server.stop();
+    }
+
+    std::filesystem::remove(config.unix_path);
+}
@@ -0,0 +1,143 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/interner.hpp"
+#include "core/hash.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace siem::core;
+
+TEST_CASE("StringInterner hands out stable ids", "[interner]") {
+    StringInterner interner;
+
+    SECTION("Same string, same id") {
+        uint32_t a = interner.intern("10.0.0.7");
+        uint32_t b = interner.intern(std::string("10.0.0.7"));
+        uint32_t c = interner.intern("10.0.0.8");
+
+        REQUIRE(a == b);
+        REQUIRE(a != c);
+        REQUIRE(interner.view(a) == "10.0.0.7");
+        REQUIRE(interner.view(c) == "10.0.0.8");
+        REQUIRE(interner.content_hash(a) == Hash64::hash("10.0.0.7"));
+    }
+
+    SECTION("Empty string is id 0") {
+        REQUIRE(interner.intern("") == StringInterner::kEmptyId);
+        REQUIRE(interner.view(StringInterner::kEmptyId).empty());
+        REQUIRE(interner.size() == 0);
+    }
+
+    SECTION("Views stay valid as the interner grows") {
+        uint32_t first = interner.intern("edge-01");
+        std::string_view view = interner.view(first);
+
+        for (int i = 0; i < 20000; ++i) {
+            interner.intern("host-" + std::to_string(i));
+        }
+        interner.intern(std::string(100000, 'x'));
+
+        REQUIRE(view.data() == interner.view(first).data());
+        REQUIRE(interner.view(first) == "edge-01");
+        REQUIRE(interner.view(interner.intern("host-19999")) == "host-19999");
+        REQUIRE(interner.size() == 20002);
+        REQUIRE(interner.memory_bytes() > 100000);
+    }
+}
+
+TEST_CASE("StringInterner is safe under concurrent interning", "[interner]") {
+    StringInterner interner;
+    constexpr int kThreads = 4;
+    constexpr int kStrings = 5000;
+
+    std::vector<std::vector<uint32_t>> ids(kThreads, std::vector<uint32_t>(kStrings));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&interner, &ids, t]() {
+            for (int i = 0; i < kStrings; ++i) {
+                ids[t][i] = interner.intern("user-" + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (int t = 1; t < kThreads; ++t) {
+        REQUIRE(ids[t] == ids[0]);
+    }
+    REQUIRE(interner.size() == kStrings);
+    REQUIRE(interner.view(ids[0][42]) == "user-42");
+}
+
+TEST_CASE("StringInterner stops growing at max_strings", "[interner]") {
+    StringInterner interner(3);
+    uint32_t a = interner.intern("10.0.0.1");
+    interner.intern("10.0.0.2");
+    interner.intern("10.0.0.3");
+
+    // Full stays full: repeated attempts never hand out (or wrap onto) an id
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE_FALSE(interner.try_intern("10.0.1." + std::to_string(i)).has_value());
+    }
+    REQUIRE_THROWS_AS(interner.intern("10.0.0.4"), std::overflow_error);
+    REQUIRE(interner.size() == 3);
+
+    // Strings already in the table are still found
+    REQUIRE(interner.try_intern("10.0.0.1") == a);
+    REQUIRE(interner.intern("") == StringInterner::kEmptyId);
+}
+
+TEST_CASE("Symbol keeps strings the interner has no room for", "[interner]") {
+    auto& global = StringInterner::global();
+    size_t max_strings = global.max_strings();
+    Symbol known("fw");
+    global.set_max_strings(global.size());
+    {
+        Symbol a("198.51.100.77 not interned");
+        Symbol b(std::string("198.51.100.77 not interned"));
+        Symbol c("198.51.100.78 not interned");
+
+        REQUIRE_FALSE(a.interned());
+        REQUIRE(a.id() == Symbol::kUninternedId);
+        REQUIRE(a == b);
+        REQUIRE(a != c);
+        REQUIRE(a != known);
+        REQUIRE(Symbol::uninterned("fw") == known);
+        REQUIRE(std::hash<Symbol>{}(Symbol::uninterned("fw")) == std::hash<Symbol>{}(known));
+        REQUIRE(a == "198.51.100.77 not interned");
+        REQUIRE(a.content_hash() == Hash64::hash("198.51.100.77 not interned"));
+        REQUIRE(std::hash<Symbol>{}(a) == std::hash<Symbol>{}(b));
+
+        // Copies share the string; it lives as long as the last of them
+        Symbol copy = a;
+        Symbol moved = std::move(b);
+        a = c;
+        REQUIRE(copy.view() == "198.51.100.77 not interned");
+        REQUIRE(moved == copy);
+        REQUIRE(a == c);
+        REQUIRE(b.empty());
+
+        REQUIRE(Symbol("fw") == known);
+        REQUIRE(Symbol("fw").interned());
+    }
+    global.set_max_strings(max_strings);
+}
+
+TEST_CASE("Symbol compares by id", "[interner]") {
+    Symbol a("fw");
+    Symbol b(std::string("fw"));
+
+    REQUIRE(a == b);
+    REQUIRE(a == "fw");
+    REQUIRE(a != Symbol("ids"));
+    REQUIRE(Symbol().empty());
+    REQUIRE(Symbol("").empty());
+    REQUIRE(a.str() == "fw");
+    REQUIRE(std::hash<Symbol>{}(a) == a.content_hash());
+
+    // Uninterned copies still equal the interned symbol
+    Symbol copy = Symbol::uninterned("fw");
+    REQUIRE_FALSE(copy.interned());
+    REQUIRE(copy == a);
+    REQUIRE(std::hash<Symbol>{}(copy) == std::hash<Symbol>{}(a));
+    REQUIRE(Symbol::uninterned("").empty());
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include "core/event_normalizer.hpp"
 
+using namespace siem;
 using namespace siem::core;
 
 TEST_CASE("EventNormalizer normalizes events", "[normalizer]") {
@@ -21,11 +22,13 @@ TEST_CASE("EventNormalizer normalizes events", "[normalizer]") {
         
         REQUIRE(event.source == "fw");
         REQUIRE(event.host == "edge-01");
-        REQUIRE(event.features.contains("verb"));
-        REQUIRE(event.features["verb"] == "deny");
-        REQUIRE(event.features.contains("proto"));
-        REQUIRE(event.features["proto"] == "tcp");
-        REQUIRE(!event.fingerprint.empty());
+        REQUIRE(event.features.verb == storage::Verb::Deny);
+        REQUIRE(event.features.proto == storage::Proto::Tcp);
+        REQUIRE(event.features.outcome == storage::Outcome::Block);
+        REQUIRE(event.features.dport == 22);
+        REQUIRE(event.features.ip == "10.0.0.7");
+        REQUIRE(event.features.extra.is_null());
+        REQUIRE(event.fingerprint != 0);
     }
     
     SECTION("Secret redaction") {
@@ -38,7 +41,7 @@ TEST_CASE("EventNormalizer normalizes events", "[normalizer]") {
         
         auto event = normalizer.normalize(raw_event);
         // Password should not appear in features
-        REQUIRE_FALSE(event.features.contains("password"));
+        REQUIRE_FALSE(event.features.to_json().contains("password"));
     }
     
     SECTION("Fingerprint computation") {
@@ -60,6 +63,9 @@ TEST_CASE("EventNormalizer normalizes events", "[normalizer]") {
         auto event2 = normalizer.normalize(raw2);
         
         REQUIRE(event1.fingerprint == event2.fingerprint);
+        
+        raw2["object"]["dport"] = 23;
+        REQUIRE(normalizer.normalize(raw2).fingerprint != event1.fingerprint);
     }
 }
 
@@ -83,3 +89,50 @@ TEST_CASE("EventNormalizer extracts features", "[normalizer]") {
     REQUIRE(features["verb_deny"] == 1);
 }
 
+
+TEST_CASE("EventFeatures keeps unknown values in overflow", "[normalizer]") {
+    EventNormalizer normalizer;
+    
+    json raw_event = {
+        {"source", "app"},
+        {"verb", "rename"},
+        {"outcome", {{"code", 7}, {"token", "t0k"}}},
+        {"object", {{"proto", "tcp"}, {"dport", 70000}, {"sport", 5353}, {"user", "alice"}}},
+        {"entity", {{"ip", 7}, {"user", "bob"}}}
+    };
+    
+    auto event = normalizer.normalize(raw_event);
+    const auto& features = event.features;
+    
+    REQUIRE(features.verb == storage::Verb::Other);
+    REQUIRE(features.verb_name() == "rename");
+    REQUIRE(features.outcome == storage::Outcome::None);
+    REQUIRE_FALSE(features.dport.has_value());
+    REQUIRE(features.sport == 5353);
+    REQUIRE(features.user == "bob");
+    REQUIRE(features.ip.empty());
+    
+    json serialized = features.to_json();
+    REQUIRE(serialized["verb"] == "rename");
+    REQUIRE(serialized["dport"] == 70000);
+    REQUIRE(serialized["ip"] == 7);
+    REQUIRE(serialized["outcome"]["token"] == "***REDACTED***");
+    REQUIRE(serialized["proto"] == "tcp");
+    
+    REQUIRE(storage::EventFeatures::from_json(serialized) == features);
+}
+
+TEST_CASE("EventNormalizer chunk size keeps the pool busy", "[normalizer]") {
+    EventNormalizer::Config config;
+    config.parallel_min_batch = 512;
+    config.parallel_chunk = 256;
+
+    WorkerPool pool(4);
+    REQUIRE(EventNormalizer(config, pool).chunk_size() == 1024);
+
+    WorkerPool inline_pool(0);
+    REQUIRE(EventNormalizer(config, inline_pool).chunk_size() == 512);
+
+    config.parallel_min_batch = 0;
+    REQUIRE(EventNormalizer(config, pool).chunk_size() == 256);
+}
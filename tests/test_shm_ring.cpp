@@ -0,0 +1,305 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/shm_ingestor.hpp"
+#include "test_support.hpp"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+
+using namespace siem;
+using namespace siem::ingest;
+using namespace siem::test;
+
+namespace {
+
+std::string control_path(const char* name) {
+    return (std::filesystem::temp_directory_path() /
+            (std::string("siem_") + name + "_" + std::to_string(::getpid()) + ".sock")).string();
+}
+
+} // namespace
+
+TEST_CASE("ShmRing hands slots from producers to the consumer in order", "[shm]") {
+    auto ring = ShmRing::create(5);
+    REQUIRE(ring.capacity() == 8);
+
+    uint64_t position = 0;
+    uint64_t positions[8];
+    for (int i = 0; i < 8; ++i) {
+        ShmRecord* record = ring.try_claim(positions[i]);
+        REQUIRE(record);
+        record->dport = static_cast<uint16_t>(i);
+        if (i != 3) ring.commit(positions[i]);
+    }
+
+    SECTION("Full rings refuse claims and count them") {
+        REQUIRE(ring.try_claim(position) == nullptr);
+        REQUIRE(ring.full_count() == 1);
+    }
+
+    SECTION("The consumer stops at the first uncommitted slot") {
+        for (uint64_t i = 0; i < 3; ++i) {
+            const ShmRecord* record = ring.peek(i);
+            REQUIRE(record);
+            REQUIRE(record->dport == i);
+            ring.release(i);
+        }
+        REQUIRE(ring.peek(3) == nullptr);
+
+        ring.commit(positions[3]);
+        REQUIRE(ring.peek(3));
+
+        // Released slots come back on the next lap
+        REQUIRE(ring.try_claim(position));
+        REQUIRE(position == 8);
+        REQUIRE(position % ring.capacity() == 0);
+    }
+
+    SECTION("A second mapping of the memfd sees the same ring") {
+        auto attached = ShmRing::attach(::dup(ring.fd()));
+        REQUIRE(attached.capacity() == 8);
+        REQUIRE(attached.peek(0)->dport == 0);
+        attached.release(0);
+        REQUIRE(attached.try_claim(position));
+        REQUIRE(position == 8);
+    }
+
+    SECTION("Unknown layouts are rejected") {
+        REQUIRE_THROWS_AS(ShmRing::create(ShmRing::kMaxCapacity + 1), std::invalid_argument);
+        int fd = ::memfd_create("not-a-ring", MFD_CLOEXEC);
+        REQUIRE(::ftruncate(fd, 65536) == 0);
+        REQUIRE_THROWS_AS(ShmRing::attach(fd), std::runtime_error);
+    }
+}
+
+TEST_CASE("ShmIngestor maps records onto events", "[shm]") {
+    ShmRecord record;
+    record.ts_ms = 1762556401003;
+    ShmRecord::set(record.source, "ids");
+    ShmRecord::set(record.host, std::string(100, 'h'));
+    record.verb = static_cast<uint8_t>(storage::Verb::Scan);
+    record.outcome = 200;
+    record.proto = static_cast<uint8_t>(storage::Proto::Other);
+    record.flags = ShmRecord::kDport | ShmRecord::kBytes;
+    record.dport = 22;
+    record.sport = 4444;
+    record.bytes = 1ULL << 40;
+    ShmRecord::set(record.ip, "10.0.0.7");
+    ShmRecord::set(record.user, "alice");
+
+    storage::Event event;
+    ShmIngestor::to_event(record, event);
+    REQUIRE(event.ts == storage::timestamp_t(std::chrono::milliseconds(1762556401003)));
+    REQUIRE(event.source == "ids");
+    REQUIRE(event.host.view() == std::string(64, 'h'));
+    REQUIRE(event.features.verb == storage::Verb::Scan);
+    REQUIRE(event.features.outcome == storage::Outcome::None);
+    REQUIRE(event.features.proto == storage::Proto::None);
+    REQUIRE(event.features.dport == 22);
+    REQUIRE_FALSE(event.features.sport);
+    REQUIRE(event.features.bytes == (1ULL << 40));
+    REQUIRE_FALSE(event.features.packets);
+    REQUIRE(event.features.ip == "10.0.0.7");
+    REQUIRE(event.features.dst_ip.empty());
+    REQUIRE(event.features.user == "alice");
+
+    storage::Event bare;
+    ShmIngestor::to_event(ShmRecord{}, bare);
+    REQUIRE(bare.source.empty());
+    REQUIRE(bare.host == "unknown");
+    REQUIRE(bare.features.empty());
+}
+
+TEST_CASE("ShmIngestor serves producers over its control socket", "[shm]") {
+    ShmIngestor::Config config;
+    config.control_path = control_path("shm_ingest");
+    config.capacity = 64;
+    config.batch_size = 16;
+    ShmIngestor ingestor(config);
+
+    std::mutex mutex;
+    std::vector<storage::Event> events;
+    size_t largest_batch = 0;
+    ingestor.start([&](std::vector<storage::Event>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        largest_batch = std::max(largest_batch, batch.size());
+        events.insert(events.end(), batch.begin(), batch.end());
+    });
+
+    SECTION("Several producer threads; every record arrives once") {
+        ShmRingProducer shared(config.control_path);
+        REQUIRE(shared.capacity() == 64);
+
+        constexpr int kThreads = 4, kPerThread = 2000;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                // Half the threads attach on their own, half share one producer
+                std::unique_ptr<ShmRingProducer> own;
+                if (t % 2) own = std::make_unique<ShmRingProducer>(config.control_path);
+                ShmRingProducer& producer = own ? *own : shared;
+
+                for (int i = 0; i < kPerThread; ++i) {
+                    while (!producer.try_write([&](ShmRecord& record) {
+                        ShmRecord::set(record.host, "host-" + std::to_string(t));
+                        record.flags = ShmRecord::kBytes;
+                        record.bytes = static_cast<uint64_t>(i);
+                    })) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        REQUIRE(wait_for([&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            return events.size() >= kThreads * kPerThread;
+        }));
+        ingestor.stop();
+
+        REQUIRE(events.size() == kThreads * kPerThread);
+        REQUIRE(largest_batch <= 16);
+        std::set<std::pair<std::string, uint64_t>> seen;
+        std::map<std::string, uint64_t> next;
+        for (const auto& event : events) {
+            REQUIRE(event.source == "sensor");
+            seen.insert({event.host.str(), *event.features.bytes});
+            // Each thread's records keep their order
+            REQUIRE(*event.features.bytes == next[event.host.str()]++);
+        }
+        REQUIRE(seen.size() == kThreads * kPerThread);
+        REQUIRE(ingestor.stats().producers == 3);
+        REQUIRE(ingestor.stats().records == kThreads * kPerThread);
+    }
+
+    SECTION("An idle consumer is woken by the doorbell") {
+        ShmRingProducer producer(config.control_path);
+        for (int round = 0; round < 3; ++round) {
+            // Let the consumer go back to sleep before each record
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            REQUIRE(producer.try_write([&](ShmRecord& record) { ShmRecord::set(record.source, "edr"); }));
+            REQUIRE(wait_for([&] {
+                std::lock_guard<std::mutex> lock(mutex);
+                return events.size() == static_cast<size_t>(round + 1);
+            }));
+        }
+        REQUIRE(ingestor.stats().wakeups >= 3);
+        REQUIRE(events.back().source == "edr");
+    }
+
+    SECTION("A fill that throws does not stall the ring") {
+        ShmRingProducer producer(config.control_path);
+        REQUIRE_THROWS_AS(producer.try_write([](ShmRecord& record) {
+            ShmRecord::set(record.host, "half-written");
+            throw std::runtime_error("producer failed");
+        }), std::runtime_error);
+        REQUIRE(producer.try_write([&](ShmRecord& record) { ShmRecord::set(record.host, "after"); }));
+
+        REQUIRE(wait_for([&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            return !events.empty();
+        }));
+        ingestor.stop();
+        REQUIRE(events.size() == 1);
+        REQUIRE(events[0].host == "after");
+        REQUIRE(ingestor.stats().records == 1);
+    }
+
+    ingestor.stop();
+    REQUIRE_FALSE(std::filesystem::exists(config.control_path));
+    REQUIRE_THROWS_AS(ShmRingProducer(config.control_path), std::system_error);
+}
+
+TEST_CASE("ShmIngestor only hands the ring to allowed peers", "[shm]") {
+    ShmIngestor::Config config;
+    config.control_path = control_path("shm_ingest_peers");
+    config.capacity = 64;
+
+    SECTION("Another uid is refused") {
+        config.allowed_uids = {::geteuid() + 1};
+        ShmIngestor ingestor(config);
+        ingestor.start([](std::vector<storage::Event>&) {});
+        REQUIRE_THROWS_AS(ShmRingProducer(config.control_path), std::runtime_error);
+        REQUIRE(wait_for([&] { return ingestor.stats().rejected == 1; }));
+        REQUIRE(ingestor.stats().producers == 0);
+    }
+
+    SECTION("A listed gid is enough") {
+        config.allowed_uids = {::geteuid() + 1};
+        config.allowed_gids = {::getegid()};
+        ShmIngestor ingestor(config);
+        ingestor.start([](std::vector<storage::Event>&) {});
+        ShmRingProducer producer(config.control_path);
+        REQUIRE(wait_for([&] { return ingestor.stats().producers == 1; }));
+        REQUIRE(ingestor.stats().rejected == 0);
+    }
+}
+
+TEST_CASE("ShmIngestor refuses a control_path that is not a socket", "[shm]") {
+    ShmIngestor::Config config;
+    config.control_path = control_path("shm_ingest_file");
+    config.capacity = 64;
+    { std::ofstream(config.control_path) << "keep"; }
+
+    ShmIngestor ingestor(config);
+    REQUIRE_THROWS_AS(ingestor.start([](std::vector<storage::Event>&) {}), std::runtime_error);
+    REQUIRE(std::filesystem::is_regular_file(config.control_path));
+    REQUIRE(std::filesystem::file_size(config.control_path) == 4);
+    std::filesystem::remove(config.control_path);
+}
+
+TEST_CASE("ShmRingProducer closes the doorbell when the ring is unusable", "[shm]") {
+    auto path = control_path("shm_ingest_bad_ring");
+    std::filesystem::remove(path);
+    auto open_fds = [] {
+        return std::distance(std::filesystem::directory_iterator("/proc/self/fd"),
+                             std::filesystem::directory_iterator{});
+    };
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.data(), path.size());
+    int listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    REQUIRE(::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    REQUIRE(::listen(listener, 1) == 0);
+    auto before = open_fds();
+
+    // Hands out an empty memfd, which attach() rejects, and a real doorbell
+    std::thread server([listener] {
+        int conn = ::accept(listener, nullptr, nullptr);
+        int fds[2] = {::memfd_create("bad_ring", MFD_CLOEXEC), ::eventfd(0, EFD_CLOEXEC)};
+        char byte = 0;
+        iovec iov{&byte, 1};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(fds))];
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(fds));
+        std::memcpy(CMSG_DATA(c), fds, sizeof(fds));
+        ::sendmsg(conn, &msg, 0);
+        for (int fd : fds) ::close(fd);
+        ::close(conn);
+    });
+
+    REQUIRE_THROWS_AS(ShmRingProducer(path), std::runtime_error);
+    server.join();
+    REQUIRE(open_fds() == before);
+
+    ::close(listener);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,169 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/event_normalizer.hpp"
+#include "core/simd_normalizer.hpp"
+#include "core/timestamp.hpp"
+
+using namespace siem;
+using namespace siem::core;
+
+namespace {
+
+void require_equivalent(const storage::Event& expected, const storage::Event& actual) {
+    REQUIRE(actual.source == expected.source);
+    REQUIRE(actual.host == expected.host);
+    REQUIRE(actual.features == expected.features);
+    REQUIRE(actual.features.to_json().dump() == expected.features.to_json().dump());
+    REQUIRE(actual.fingerprint == expected.fingerprint);
+    REQUIRE(actual.trace_id.size() == expected.trace_id.size());
+}
+
+} // namespace
+
+TEST_CASE("SimdEventNormalizer normalizes events", "[simd_normalizer]") {
+    SimdEventNormalizer normalizer;
+
+    SECTION("Basic event normalization") {
+        auto event = normalizer.normalize(R"({
+            "ts": "2025-11-07T23:00:01Z", "source": "fw", "host": "edge-01",
+            "entity": {"ip": "10.0.0.7"}, "verb": "deny",
+            "object": {"proto": "tcp", "dport": 22}, "outcome": "block"
+        })");
+
+        REQUIRE(event.source == "fw");
+        REQUIRE(event.host == "edge-01");
+        REQUIRE(event.features.verb == storage::Verb::Deny);
+        REQUIRE(event.features.proto == storage::Proto::Tcp);
+        REQUIRE(event.fingerprint != 0);
+    }
+
+    SECTION("Secret redaction") {
+        auto event = normalizer.normalize(
+            R"({"source": "app", "host": "web-01", "password": "secret123"})");
+        REQUIRE_FALSE(event.features.to_json().contains("password"));
+    }
+
+    SECTION("Fingerprint computation") {
+        std::string raw = R"({"source": "fw", "host": "edge-01",
+            "entity": {"ip": "10.0.0.7"}, "object": {"proto": "tcp", "dport": 22}})";
+        REQUIRE(normalizer.normalize(raw).fingerprint == normalizer.normalize(raw).fingerprint);
+    }
+
+    SECTION("Malformed input throws") {
+        REQUIRE_THROWS(normalizer.normalize(R"({"source": "fw")"));
+        REQUIRE_THROWS(normalizer.normalize(R"({"source": "fw"} trailing)"));
+        REQUIRE_THROWS(normalizer.normalize(R"(["not", "an", "object"])"));
+    }
+}
+
+TEST_CASE("SimdEventNormalizer matches EventNormalizer", "[simd_normalizer]") {
+    EventNormalizer reference;
+    SimdEventNormalizer fast;
+
+    std::vector<std::string> corpus = {
+        R"({"ts":"2025-11-07T23:00:01Z","source":"fw","host":"edge-01","entity":{"ip":"10.0.0.7"},"verb":"deny","object":{"proto":"tcp","dport":22,"bytes":184},"outcome":"block"})",
+        R"({"source":"app","host":"web-02","entity":{"ip":"203.0.113.9","user":"bob"},"verb":"auth","object":{"user":"alice"},"outcome":"fail"})",
+        R"({"entity":{"user":"carol"},"object":{"user":"dave","sport":-1,"dport":443.0},"extra":{"deep":[1,2,{"x":null}]}})",
+        R"({"source":42,"host":null,"verb":{"password":"hunter2","nested":{"token":"t"}},"outcome":[1,"two"]})",
+        R"({"source":"fw","source":"ids","object":{"proto":"udp"},"object":"flat","entity":{"ip":"1.1.1.1"}})",
+        R"({"source":"esc\"aped","host":"héte","object":{"dport":18446744073709551615,"sport":1e3}})",
+        R"({"ts":"not a timestamp","source":"fw","host":"edge-01","object":{"dport":0}})",
+        R"({"ts":1762556401,"source":"fw"})",
+        R"({"ts":1762556401123,"source":"fw"})",
+        R"({"ts":1762556401.5,"ts":"2025-11-07T23:00:01.250+02:00","source":"fw"})",
+        R"({})",
+    };
+
+    for (const auto& raw : corpus) {
+        INFO(raw);
+        auto expected = reference.normalize(json::parse(raw));
+        auto actual = fast.normalize(raw);
+        require_equivalent(expected, actual);
+
+        auto parsed = json::parse(raw);
+        if (parsed.contains("ts") && TimestampParser::from_json(parsed["ts"])) {
+            REQUIRE(actual.ts == expected.ts);
+        }
+    }
+
+    SECTION("Array batches match normalize_batch") {
+        std::string body = "[";
+        for (size_t i = 0; i < corpus.size(); ++i) {
+            body += corpus[i] + ",";
+        }
+        body += R"(1, "skip", [{"source":"nested"}], {"entity":{"ip":7},"source":"bad-ip"}])";
+
+        std::vector<json> raw_events;
+        for (const auto& item : json::parse(body)) {
+            if (item.is_object()) raw_events.push_back(item);
+        }
+        auto expected = reference.normalize_batch(raw_events);
+
+        std::vector<storage::Event> actual;
+        size_t emitted = fast.normalize_array(body, [&actual](storage::Event&& e) {
+            actual.push_back(std::move(e));
+        });
+
+        REQUIRE(emitted == expected.size());
+        REQUIRE(actual.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            require_equivalent(expected[i], actual[i]);
+        }
+    }
+}
+
+TEST_CASE("SimdEventNormalizer applies the same profiles and redaction", "[simd_normalizer][field_plan]") {
+    EventNormalizer::Config config;
+    config.profiles["paloalto"] = {
+        {"ts", {"/receive_time"}},
+        {"host", {"/device_name", "/meta/hosts/1"}},
+        {"verb", {"/action"}},
+        {"ip", {"/src/addr", "/src"}},
+        {"user", {"/users/0/name"}},
+        {"rule", {"/rule"}},
+        {"session", {"/session"}},
+        {"session_id", {"/session/id"}},
+        {"origin", {"/source"}},
+    };
+    EventNormalizer reference(config);
+    SimdEventNormalizer fast(config);
+
+    std::vector<std::string> corpus = {
+        R"({"source":"paloalto","receive_time":"2025-11-07T23:00:01Z","device_name":"pa-01","action":"deny","src":"198.51.100.4","rule":"block-rdp","host":"ignored"})",
+        R"({"source":"paloalto","meta":{"hosts":["a","b","c"]},"src":{"addr":"10.0.0.1"},"users":[{"name":"alice"},{"name":"bob"}]})",
+        R"({"src":{"addr":"10.0.0.2"},"src":"10.0.0.3","source":"paloalto","meta":{"hosts":["only"]}})",
+        R"({"source":"paloalto","session":{"id":7,"api_key":"AKIA1234"},"rule":{"api_key":"k","name":"r"}})",
+        R"({"session":"flat","source":"paloalto","session":{"id":"s-1"},"receive_time":1762556401})",
+        R"({"source":"paloalto","users":{"0":{"name":"not an array"}},"meta":{"hosts":{"1":"nor this"}}})",
+        R"({"source":"fw","host":"edge-01","entity":{"ip":"10.0.0.7"},"action":"deny","src":"unused"})",
+    };
+
+    for (const auto& raw : corpus) {
+        INFO(raw);
+        auto expected = reference.normalize(json::parse(raw));
+        require_equivalent(expected, fast.normalize(raw));
+
+        // parse() leaves finishing to the reference normalizer
+        auto parsed = fast.parse(raw);
+        REQUIRE(parsed.trace_id.empty());
+        reference.finalize(parsed);
+        require_equivalent(expected, parsed);
+    }
+
+    SECTION("Documents are one object or an array of them") {
+        std::vector<storage::Event> events;
+        auto sink = [&events](storage::Event&& e) { events.push_back(std::move(e)); };
+        REQUIRE(fast.parse_document(corpus[0], sink) == 1);
+        std::vector<std::string> skipped;
+        auto on_skipped = [&skipped](std::string_view element, const char* reason) {
+            skipped.push_back(std::string(element) + " " + reason);
+        };
+        REQUIRE(fast.parse_document("[" + corpus[1] + ",7 ," + corpus[2] + ",[1]]", sink, on_skipped) == 2);
+        REQUIRE(skipped == std::vector<std::string>{"7 not_object", "[1] not_object"});
+        REQUIRE(events.size() == 3);
+        REQUIRE(events[0].host == "pa-01");
+        REQUIRE(events[1].host == "b");
+        REQUIRE(events[2].features.ip == "10.0.0.3");
+        REQUIRE_THROWS(fast.parse_document("[" + corpus[0], sink));
+        REQUIRE_THROWS(fast.parse_document("42", sink));
+    }
+}
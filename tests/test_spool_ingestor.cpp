@@ -0,0 +1,219 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/spool_ingestor.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+using namespace siem;
+using namespace siem::ingest;
+namespace fs = std::filesystem;
+
+TEST_CASE("SpoolIngestor ingests spooled files concurrently", "[spool]") {
+    auto dir = fs::temp_directory_path() / "siem_spool_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto write = [&dir](const std::string& name, const std::string& content) {
+        std::ofstream(dir / name, std::ios::binary) << content;
+    };
+
+    std::string ndjson;
+    for (int i = 3; i < 8; ++i) ndjson += R"({"seq":)" + std::to_string(i) + "}\n";
+    write("001.json", R"([{"seq":0},{"seq":1},{"seq":2}])");
+    write("002.ndjson", ndjson);
+    write("003.json", R"([{"seq":99},)");           // Malformed
+    write("004.json", R"({"seq":8})");
+    write("005.json.tmp", R"({"seq":100})");        // Still being written
+    write(".hidden", R"({"seq":101})");
+
+    SpoolIngestor::Config config;
+    config.dir = dir.string();
+    config.batch_size = 4;
+    core::WorkerPool pool(2);
+    SpoolIngestor spool(config, pool);
+
+    fs::create_directories(dir / "done");
+    fs::create_directories(dir / "failed");
+
+    std::vector<int> seen;
+    std::vector<size_t> batch_sizes;
+    auto callback = [&](const std::vector<json>& batch) {
+        batch_sizes.push_back(batch.size());
+        for (const auto& event : batch) seen.push_back(event["seq"].get<int>());
+    };
+
+    REQUIRE(spool.scan(callback) == 4);
+    REQUIRE(seen == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8});
+    REQUIRE(batch_sizes == std::vector<size_t>{4, 4, 1});
+
+    REQUIRE(fs::exists(dir / "done" / "001.json"));
+    REQUIRE(fs::exists(dir / "done" / "002.ndjson"));
+    REQUIRE(fs::exists(dir / "done" / "004.json"));
+    REQUIRE(fs::exists(dir / "failed" / "003.json"));
+    REQUIRE(fs::exists(dir / "005.json.tmp"));
+    REQUIRE_FALSE(fs::exists(dir / "001.json"));
+
+    auto stats = spool.stats();
+    REQUIRE(stats.files_done == 3);
+    REQUIRE(stats.files_failed == 1);
+    REQUIRE(stats.events == 9);
+    REQUIRE(stats.bytes > 0);
+
+    // Nothing left to pick up
+    REQUIRE(spool.scan(callback) == 0);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("SpoolIngestor bounds what it holds and never replaces finished files", "[spool]") {
+    auto dir = fs::temp_directory_path() / "siem_spool_window_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "done");
+    fs::create_directories(dir / "failed");
+    auto write = [&dir](const std::string& name, const std::string& content) {
+        std::ofstream(dir / name, std::ios::binary) << content;
+    };
+    auto read = [&dir](const std::string& name) {
+        std::ifstream in(dir / name, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    };
+
+    std::string large;
+    for (int i = 1; i < 6; ++i) large += R"({"seq":)" + std::to_string(i) + "}\n";
+    write("001.json", R"({"seq":0})");
+    write("002.ndjson", large);
+    write("003.json", R"({"seq":6})");
+    write("done/001.json", "earlier");
+    write("done/003.json", "earlier");
+    write("done/003.1.json", "earlier");
+
+    SpoolIngestor::Config config;
+    config.dir = dir.string();
+    config.batch_size = 2;
+    config.max_window_bytes = 16;                   // 002.ndjson alone is larger
+    core::WorkerPool pool(2);
+    SpoolIngestor spool(config, pool);
+
+    std::vector<int> seen;
+    std::vector<size_t> batch_sizes;
+    std::vector<bool> large_done;
+    auto callback = [&](const std::vector<json>& batch) {
+        batch_sizes.push_back(batch.size());
+        large_done.push_back(fs::exists(dir / "done" / "002.ndjson"));
+        for (const auto& event : batch) seen.push_back(event["seq"].get<int>());
+    };
+
+    REQUIRE(spool.scan(callback) == 3);
+    REQUIRE(seen == std::vector<int>{0, 1, 2, 3, 4, 5, 6});
+
+    // 001 is flushed before the large file streams through in batch_size
+    // batches; its tail shares the last batch with 003, and it is only
+    // finished once that batch has been accepted
+    REQUIRE(batch_sizes == std::vector<size_t>{1, 2, 2, 2});
+    REQUIRE(large_done == std::vector<bool>{false, false, false, false});
+
+    REQUIRE(read("done/001.json") == "earlier");
+    REQUIRE(read("done/001.1.json") == R"({"seq":0})");
+    REQUIRE(read("done/003.json") == "earlier");
+    REQUIRE(read("done/003.1.json") == "earlier");
+    REQUIRE(read("done/003.2.json") == R"({"seq":6})");
+    REQUIRE(fs::exists(dir / "done" / "002.ndjson"));
+    REQUIRE_FALSE(fs::exists(dir / "001.json"));
+    REQUIRE(spool.stats().files_done == 3);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("SpoolIngestor hands JSON to the simd normalizer as parsed events", "[spool][simd_normalizer]") {
+    auto dir = fs::temp_directory_path() / "siem_spool_simd_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    auto write = [&dir](const std::string& name, const std::string& content) {
+        std::ofstream(dir / name, std::ios::binary) << content;
+    };
+
+    write("001.json", R"([{"source":"fw","host":"a"},"stray",{"source":"fw","host":"b"}])");
+    write("002.ndjson", "{\"source\":\"fw\",\"host\":\"c\"}\r\n\nnot json\n[1]\n{\"host\":\"d\"}");
+    write("003.json", R"([{"host":"e"},)");         // Malformed
+
+    SpoolIngestor::Config config;
+    config.dir = dir.string();
+    config.format.simd = std::make_shared<const core::SimdEventNormalizer>();
+    std::mutex skipped_mutex;                       // Files are parsed on several threads
+    std::vector<std::string> skipped;
+    config.format.on_skipped = [&](std::string_view element, const char*) {
+        std::lock_guard<std::mutex> lock(skipped_mutex);
+        skipped.emplace_back(element);
+    };
+    core::WorkerPool pool(2);
+    SpoolIngestor spool(config, pool);
+    fs::create_directories(dir / "done");
+    fs::create_directories(dir / "failed");
+
+    size_t raw = 0;
+    std::vector<std::string> hosts;
+    auto callback = [&](const std::vector<json>& batch) { raw += batch.size(); };
+    auto parsed_callback = [&](std::vector<storage::Event>& batch) {
+        for (const auto& event : batch) {
+            REQUIRE(event.trace_id.empty());
+            hosts.emplace_back(event.host.view());
+        }
+    };
+
+    REQUIRE(spool.scan(callback, parsed_callback) == 3);
+    REQUIRE(raw == 0);
+    REQUIRE(hosts == std::vector<std::string>{"a", "b", "c", "d"});
+
+    // Non-object elements reach the dead-letter hook, as NDJSON lines do
+    std::sort(skipped.begin(), skipped.end());
+    REQUIRE(skipped == std::vector<std::string>{R"("stray")", "[1]", "not json"});
+    REQUIRE(fs::exists(dir / "done" / "002.ndjson"));
+    REQUIRE(fs::exists(dir / "failed" / "003.json"));
+    REQUIRE(spool.stats().events == 4);
+
+    // Without a parsed callback the same files stay raw JSON
+    write("004.json", R"({"source":"fw","host":"f"})");
+    REQUIRE(spool.scan(callback) == 1);
+    REQUIRE(raw == 1);
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("SpoolIngestor leaves a large file in the spool when delivery fails", "[spool]") {
+    auto dir = fs::temp_directory_path() / "siem_spool_delivery_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "done");
+    fs::create_directories(dir / "failed");
+
+    std::string large;
+    for (int i = 0; i < 5; ++i) large += R"({"seq":)" + std::to_string(i) + "}\n";
+    std::ofstream(dir / "001.ndjson", std::ios::binary) << large;
+
+    SpoolIngestor::Config config;
+    config.dir = dir.string();
+    config.batch_size = 2;
+    config.max_window_bytes = 16;                   // Streamed while reading
+    core::WorkerPool pool(2);
+    SpoolIngestor spool(config, pool);
+
+    // Backpressure from downstream, e.g. a full write-ahead log
+    bool refuse = true;
+    size_t delivered = 0;
+    auto callback = [&](const std::vector<json>& batch) {
+        if (refuse) throw std::runtime_error("write-ahead log is full");
+        delivered += batch.size();
+    };
+
+    REQUIRE_THROWS_AS(spool.scan(callback), std::runtime_error);
+    REQUIRE(fs::exists(dir / "001.ndjson"));
+    REQUIRE_FALSE(fs::exists(dir / "failed" / "001.ndjson"));
+    REQUIRE(spool.stats().files_failed == 0);
+
+    refuse = false;
+    REQUIRE(spool.scan(callback) == 1);
+    REQUIRE(delivered == 5);
+    REQUIRE(fs::exists(dir / "done" / "001.ndjson"));
+
+    fs::remove_all(dir);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "storage/schemas.hpp"
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Helpers shared by the test files
+ */
+namespace siem::test {
+
+/**
+ * Empty events whose trace ids count up from first
+ */
+inline std::vector<storage::Event> make_events(int first, int count) {
+    std::vector<storage::Event> events(count);
+    for (int i = 0; i < count; ++i) events[i].trace_id = std::to_string(first + i);
+    return events;
+}
+
+/**
+ * Poll done() for up to 5 s; whether it came true
+ */
+template <typename Predicate>
+bool wait_for(Predicate done) {
+    for (int i = 0; i < 500; ++i) {
+        if (done()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return done();
+}
+
+/**
+ * Empty path under the temp directory, unique to this process; not created
+ */
+inline std::filesystem::path fresh_dir(const char* name) {
+    auto dir = std::filesystem::temp_directory_path() /
+               (std::string("siem_test_") + name + "_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+} // namespace siem::test
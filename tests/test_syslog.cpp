@@ -0,0 +1,155 @@
+#include <catch2/catch_test_macros.hpp>
+#include "ingest/syslog_server.hpp"
+#include "core/event_normalizer.hpp"
+#include <boost/asio/write.hpp>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace siem::ingest;
+
+TEST_CASE("SyslogParser parses RFC 5424 and RFC 3164", "[syslog]") {
+    SyslogMessage m;
+
+    SECTION("RFC 5424 with structured data") {
+        std::string_view raw =
+            R"(<165>1 2025-11-07T23:00:01.003Z fw01.example.com sshd 4123 AUTH )"
+            R"([origin ip="203.0.113.5"][auth@32473 user="alice" reason="bad \"pw\" \]"] )"
+            "\xEF\xBB\xBF" "Failed password for alice";
+
+        REQUIRE(SyslogParser::parse(raw, m));
+        REQUIRE(m.format == SyslogMessage::Format::Rfc5424);
+        REQUIRE(m.facility == 20);
+        REQUIRE(m.severity == 5);
+        REQUIRE(m.timestamp == "2025-11-07T23:00:01.003Z");
+        REQUIRE(m.hostname == "fw01.example.com");
+        REQUIRE(m.app_name == "sshd");
+        REQUIRE(m.procid == "4123");
+        REQUIRE(m.msgid == "AUTH");
+        REQUIRE(m.msg == "Failed password for alice");
+
+        auto event = SyslogParser::to_event(m, "syslog");
+        REQUIRE(event["host"] == "fw01.example.com");
+        REQUIRE(event["ts"] == "2025-11-07T23:00:01.003Z");
+        REQUIRE(event["entity"]["ip"] == "203.0.113.5");
+        REQUIRE(event["sd"]["auth@32473"]["user"] == "alice");
+        REQUIRE(event["sd"]["auth@32473"]["reason"] == "bad \"pw\" ]");
+        REQUIRE(event["syslog"]["app"] == "sshd");
+    }
+
+    SECTION("RFC 5424 nil values and no message") {
+        REQUIRE(SyslogParser::parse("<14>1 - - - - - -", m));
+        REQUIRE(m.timestamp.empty());
+        REQUIRE(m.hostname.empty());
+        REQUIRE(m.structured_data.empty());
+        REQUIRE(m.msg.empty());
+
+        auto event = SyslogParser::to_event(m, "syslog", "10.0.0.9");
+        REQUIRE(event["host"] == "10.0.0.9");
+        REQUIRE_FALSE(event.contains("ts"));
+    }
+
+    SECTION("Malformed RFC 5424") {
+        REQUIRE_FALSE(SyslogParser::parse("<14>1 2025-11-07T23:00:01Z host", m));
+        REQUIRE_FALSE(SyslogParser::parse(R"(<14>1 - h a p m [id k="v" msg)", m));
+        REQUIRE_FALSE(SyslogParser::parse("", m));
+    }
+
+    SECTION("RFC 3164 with tag and pid") {
+        REQUIRE(SyslogParser::parse("<34>Nov  7 23:00:01 edge-01 su[231]: 'su root' failed on /dev/pts/8\n", m));
+        REQUIRE(m.format == SyslogMessage::Format::Rfc3164);
+        REQUIRE(m.facility == 4);
+        REQUIRE(m.severity == 2);
+        REQUIRE(m.timestamp == "Nov  7 23:00:01");
+        REQUIRE(m.hostname == "edge-01");
+        REQUIRE(m.app_name == "su");
+        REQUIRE(m.procid == "231");
+        REQUIRE(m.msg == "'su root' failed on /dev/pts/8");
+    }
+
+    SECTION("RFC 3164 without header parts") {
+        REQUIRE(SyslogParser::parse("<13>kernel: eth0 link up", m));
+        REQUIRE(m.hostname.empty());
+        REQUIRE(m.app_name == "kernel");
+        REQUIRE(m.msg == "eth0 link up");
+
+        REQUIRE(SyslogParser::parse("no pri at all", m));
+        REQUIRE(m.facility == 1);
+        REQUIRE(m.severity == 5);
+        REQUIRE(m.msg == "no pri at all");
+    }
+
+    SECTION("BSD timestamps pick the nearest past year") {
+        int64_t nov_2025 = 1762556401000;  // 2025-11-07T23:00:01Z
+        REQUIRE(SyslogParser::bsd_timestamp_ms("Nov  7 23:00:01", nov_2025) == nov_2025);
+
+        int64_t jan_2026 = 1767312000000;  // 2026-01-02T00:00:00Z
+        REQUIRE(SyslogParser::bsd_timestamp_ms("Dec 31 23:59:59", jan_2026) == 1767225599000);
+        REQUIRE_FALSE(SyslogParser::bsd_timestamp_ms("Foo  7 23:00:01", jan_2026).has_value());
+    }
+}
+
+TEST_CASE("SyslogParser repairs Latin-1 RFC 3164 lines", "[syslog]") {
+    // "café-01" and "Müller" in Latin-1: \xE9 and \xFC are not UTF-8
+    SyslogMessage m;
+    REQUIRE(SyslogParser::parse("<34>Nov  7 23:00:01 caf\xE9-01 login[7]: failed for M\xFCller", m));
+
+    auto raw = SyslogParser::to_event(m, "syslog", "10.0.0.9");
+    REQUIRE(raw["host"] == "caf\xEF\xBF\xBD-01");
+    REQUIRE(raw["message"] == "failed for M\xEF\xBF\xBDller");
+
+    siem::core::EventNormalizer normalizer;
+    auto event = normalizer.normalize(raw);
+    REQUIRE(event.host == "caf\xEF\xBF\xBD-01");
+    REQUIRE_NOTHROW(event.to_json().dump());
+}
+
+TEST_CASE("SyslogServer receives UDP and framed TCP messages", "[syslog]") {
+    SyslogServer::Config config;
+    config.bind_address = "127.0.0.1";
+    config.udp_port = 0;
+    config.tcp_port = 0;
+    config.flush_ms = 10;
+    SyslogServer server(config);
+
+    std::mutex mutex;
+    std::vector<json> events;
+    server.start([&](const std::vector<json>& batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        events.insert(events.end(), batch.begin(), batch.end());
+    });
+
+    net::io_context ioc;
+    udp::socket udp_client(ioc, udp::v4());
+    udp::endpoint udp_target(net::ip::make_address("127.0.0.1"), server.udp_port());
+    for (int i = 0; i < 3; ++i) {
+        std::string msg = "<13>1 - host-" + std::to_string(i) + " app - - - udp " + std::to_string(i);
+        udp_client.send_to(net::buffer(msg), udp_target);
+    }
+
+    tcp::socket tcp_client(ioc);
+    tcp_client.connect(tcp::endpoint(net::ip::make_address("127.0.0.1"), server.tcp_port()));
+    std::string framed = "<13>1 - tcp-host app - - - first";
+    std::string stream = std::to_string(framed.size()) + " " + framed +
+                         "<13>Nov  7 23:00:01 lf-host app: second\n";
+    // Split mid-frame to exercise reassembly
+    net::write(tcp_client, net::buffer(stream.substr(0, 10)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    net::write(tcp_client, net::buffer(stream.substr(10)));
+
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (events.size() >= 5) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    server.stop();
+
+    REQUIRE(events.size() == 5);
+    std::set<std::string> hosts;
+    for (const auto& event : events) hosts.insert(event["host"].get<std::string>());
+    REQUIRE(hosts == std::set<std::string>{"host-0", "host-1", "host-2", "tcp-host", "lf-host"});
+    REQUIRE(server.stats().received == 5);
+    REQUIRE(server.stats().malformed == 0);
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/timestamp.hpp"
+
+using namespace siem;
+using namespace siem::core;
+
+namespace {
+
+int64_t epoch_ms(const std::optional<storage::timestamp_t>& ts) {
+    REQUIRE(ts.has_value());
+    return std::chrono::duration_cast<std::chrono::milliseconds>(ts->time_since_epoch()).count();
+}
+
+} // namespace
+
+TEST_CASE("TimestampParser parses RFC 3339", "[timestamp]") {
+    // 2025-11-07T23:00:01Z
+    const int64_t base = 1762556401000LL;
+
+    REQUIRE(epoch_ms(TimestampParser::parse("2025-11-07T23:00:01Z")) == base);
+    REQUIRE(epoch_ms(TimestampParser::parse("2025-11-07T23:00:01")) == base);
+    REQUIRE(epoch_ms(TimestampParser::parse("2025-11-07 23:00:01z")) == base);
+    REQUIRE(epoch_ms(TimestampParser::parse("1970-01-01T00:00:00Z")) == 0);
+
+    SECTION("Fractional seconds keep millisecond precision") {
+        REQUIRE(epoch_ms(TimestampParser::parse("2025-11-07T23:00:01.5Z")) == base + 500);
+        REQUIRE(epoch_ms(TimestampParser::parse("2025-11-07T23:00:01.123Z")) == base + 123);
+        REQUIRE(epoch_ms(TimestampParser::parse("2025-11-07T23:00:01.123999999Z")) == base + 123);
+    }
+
+    SECTION("Offsets are applied") {
+        REQUIRE(epoch_ms(TimestampParser::parse("2025-11-08T01:00:01+02:00")) == base);
+        REQUIRE(epoch_ms(TimestampParser::parse("2025-11-07T18:00:01-0500")) == base);
+    }
+
+    SECTION("Invalid timestamps are rejected") {
+        REQUIRE_FALSE(TimestampParser::parse(""));
+        REQUIRE_FALSE(TimestampParser::parse("not a timestamp"));
+        REQUIRE_FALSE(TimestampParser::parse("2025-02-30T00:00:00Z"));
+        REQUIRE_FALSE(TimestampParser::parse("2025-11-07T24:00:00Z"));
+        REQUIRE_FALSE(TimestampParser::parse("2025-11-07T23:00:01."));
+        REQUIRE_FALSE(TimestampParser::parse("2025-11-07T23:00:01Zjunk"));
+        REQUIRE_FALSE(TimestampParser::parse("2025-11-07T23:00:01+2"));
+    }
+}
+
+TEST_CASE("TimestampParser parses epoch values", "[timestamp]") {
+    REQUIRE(epoch_ms(TimestampParser::from_epoch(int64_t{1762556401})) == 1762556401000LL);
+    REQUIRE(epoch_ms(TimestampParser::from_epoch(int64_t{1762556401123})) == 1762556401123LL);
+    REQUIRE(epoch_ms(TimestampParser::from_epoch(1762556401.25)) == 1762556401250LL);
+    REQUIRE(epoch_ms(TimestampParser::parse("1762556401")) == 1762556401000LL);
+    REQUIRE(epoch_ms(TimestampParser::parse("1762556401.5")) == 1762556401500LL);
+
+    SECTION("JSON values") {
+        REQUIRE(epoch_ms(TimestampParser::from_json(json(1762556401))) == 1762556401000LL);
+        REQUIRE(epoch_ms(TimestampParser::from_json(json(1762556401123ULL))) == 1762556401123LL);
+        REQUIRE(epoch_ms(TimestampParser::from_json(json("2025-11-07T23:00:01Z"))) == 1762556401000LL);
+        REQUIRE_FALSE(TimestampParser::from_json(json(nullptr)));
+        REQUIRE_FALSE(TimestampParser::from_json(json::object()));
+    }
+
+    SECTION("Out of range values are rejected") {
+        REQUIRE_FALSE(TimestampParser::from_epoch(std::numeric_limits<uint64_t>::max()));
+        REQUIRE_FALSE(TimestampParser::from_epoch(1e300));
+        REQUIRE_FALSE(TimestampParser::from_epoch(std::numeric_limits<double>::quiet_NaN()));
+    }
+
+    SECTION("Non-numeric text is rejected without reading past the view") {
+        // Not NUL-terminated after the first three bytes
+        std::string text = "nanosecond";
+        REQUIRE_FALSE(TimestampParser::parse(std::string_view(text).substr(0, 3)));
+        for (const char* value : {"inf", "-inf", "nan", "not a timestamp", "1.5x"}) {
+            REQUIRE_FALSE(TimestampParser::parse(value));
+        }
+        REQUIRE(epoch_ms(TimestampParser::parse("1.7625564015e9")) == 1762556401500LL);
+    }
+}
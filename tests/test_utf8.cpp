@@ -0,0 +1,41 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/utf8.hpp"
+
+using namespace siem::core;
+
+TEST_CASE("Utf8 checks and repairs text", "[utf8]") {
+    SECTION("Valid text is left alone") {
+        REQUIRE(Utf8::valid(""));
+        REQUIRE(Utf8::valid("edge-01"));
+        REQUIRE(Utf8::valid("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x94\x92"));
+        REQUIRE(Utf8::repair("caf\xC3\xA9") == "caf\xC3\xA9");
+    }
+
+    SECTION("Invalid sequences are rejected") {
+        REQUIRE_FALSE(Utf8::valid("caf\xE9"));              // Latin-1
+        REQUIRE_FALSE(Utf8::valid("\xC0\xAF"));             // Overlong '/'
+        REQUIRE_FALSE(Utf8::valid("\xE0\x80\xAF"));         // Overlong '/'
+        REQUIRE_FALSE(Utf8::valid("\xED\xA0\x80"));         // Surrogate
+        REQUIRE_FALSE(Utf8::valid("\xF4\x90\x80\x80"));     // Past U+10FFFF
+        REQUIRE_FALSE(Utf8::valid("\xE2\x82"));             // Truncated
+        REQUIRE(Utf8::valid_prefix("ab\xFF" "cd") == 2);
+    }
+
+    SECTION("Each invalid byte becomes U+FFFD") {
+        REQUIRE(Utf8::repair("caf\xE9") == "caf\xEF\xBF\xBD");
+        REQUIRE(Utf8::repair("\xE2\x82x") == "\xEF\xBF\xBD\xEF\xBF\xBDx");
+        REQUIRE(Utf8::repair("a\xFF\xC3\xA9") == "a\xEF\xBF\xBD\xC3\xA9");
+    }
+
+    SECTION("JSON values are repaired in place, keys included") {
+        json value = {{"host", "caf\xE9"}, {"tags", {"ok", "M\xFCller"}}, {"n", 7}};
+        value["k\xE9y"] = "v";
+        Utf8::repair(value);
+
+        REQUIRE(value["host"] == "caf\xEF\xBF\xBD");
+        REQUIRE(value["tags"][1] == "M\xEF\xBF\xBDller");
+        REQUIRE(value["n"] == 7);
+        REQUIRE(value["k\xEF\xBF\xBDy"] == "v");
+        REQUIRE_NOTHROW(value.dump());
+    }
+}
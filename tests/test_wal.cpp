@@ -0,0 +1,315 @@
+#include <catch2/catch_test_macros.hpp>
+#include "storage/wal.hpp"
+#include "test_support.hpp"
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unistd.h>
+
+using namespace siem;
+using namespace siem::storage;
+namespace fs = std::filesystem;
+using test::fresh_dir;
+using test::wait_for;
+
+namespace {
+
+std::vector<Event> make_events(int first, int count) {
+    std::vector<Event> events(count);
+    for (int i = 0; i < count; ++i) {
+        auto& event = events[i];
+        event.ts = timestamp_t(std::chrono::milliseconds(1762556401003 + first + i));
+        event.source = Symbol("fw");
+        event.host = Symbol("edge-01");
+        event.trace_id = "trace-" + std::to_string(first + i);
+        event.fingerprint = static_cast<uint64_t>(first + i);
+        event.features.set_string("verb", "deny");
+        event.features.set("dport", 22);
+    }
+    return events;
+}
+
+std::vector<fs::path> segment_files(const fs::path& dir) {
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.path().extension() == ".log") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+/**
+ * Replay sink collecting trace ids
+ */
+struct Collector {
+    std::mutex mutex;
+    std::vector<std::string> traces;
+
+    WriteAheadLog::ReplaySink sink() {
+        return [this](std::vector<Event>& events) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& event : events) traces.push_back(event.trace_id);
+        };
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return traces.size();
+    }
+};
+
+} // namespace
+
+TEST_CASE("WAL records keep every event field", "[wal]") {
+    std::vector<Event> events = make_events(0, 2);
+    events[0].ts = timestamp_t(std::chrono::nanoseconds(1762556401003123456));
+    events[0].features.set_string("verb", "reboot");            // Other, text kept in extra
+    events[0].features.set("bytes", 1ULL << 40);
+    events[0].features.set_string("ip", "10.0.0.7");
+    events[0].features.set("note", json{{"nested", {1, 2}}});
+    events[0].cluster_id = "c1";
+    events[1].features = EventFeatures{};
+    events[1].incident_id = "inc_1";
+
+    std::string payload;
+    WriteAheadLog::encode_events(events, payload);
+    auto decoded = WriteAheadLog::decode_events(payload);
+
+    REQUIRE(decoded.size() == 2);
+    for (size_t i = 0; i < 2; ++i) {
+        REQUIRE(decoded[i].ts == events[i].ts);
+        REQUIRE(decoded[i].source == events[i].source);
+        REQUIRE(decoded[i].host == events[i].host);
+        REQUIRE(decoded[i].trace_id == events[i].trace_id);
+        REQUIRE(decoded[i].fingerprint == events[i].fingerprint);
+        REQUIRE(decoded[i].features == events[i].features);
+        REQUIRE(decoded[i].cluster_id == events[i].cluster_id);
+        REQUIRE(decoded[i].incident_id == events[i].incident_id);
+    }
+    REQUIRE(decoded[0].features.verb_name() == "reboot");
+
+    REQUIRE_THROWS_AS(WriteAheadLog::decode_events(payload.substr(0, payload.size() - 1)), std::runtime_error);
+    REQUIRE_THROWS_AS(WriteAheadLog::decode_events(payload + "x"), std::runtime_error);
+    REQUIRE_THROWS_AS(WriteAheadLog::decode_events("\xff\xff\xff\x0f"), std::runtime_error);
+}
+
+TEST_CASE("WAL replays durable records into the sink", "[wal]") {
+    auto dir = fresh_dir("replay");
+    WriteAheadLog::Config config;
+    config.dir = dir.string();
+    config.segment_bytes = 4096;
+    config.replay_batch = 50;
+    config.retry_initial_ms = 10;
+
+    SECTION("Appends are durable before replay starts and replayed in order") {
+        WriteAheadLog wal(config);
+        for (int i = 0; i < 40; ++i) {
+            uint64_t lsn = wal.append(make_events(i * 10, 10));
+            REQUIRE(lsn == static_cast<uint64_t>(i + 1));
+            REQUIRE(wal.durable_lsn() >= lsn);
+        }
+        REQUIRE(segment_files(dir).size() > 1);
+
+        Collector collector;
+        wal.start(collector.sink());
+        REQUIRE(wait_for([&] { return wal.acked_lsn() == 40; }));
+        wal.stop();
+
+        REQUIRE(collector.traces.size() == 400);
+        for (int i = 0; i < 400; ++i) REQUIRE(collector.traces[i] == "trace-" + std::to_string(i));
+
+        // Only the segment being written survives
+        REQUIRE(segment_files(dir).size() == 1);
+        REQUIRE(wal.stats().pending_bytes == 0);
+        REQUIRE(wal.stats().replayed_events == 400);
+    }
+
+    SECTION("Acknowledged records are not replayed after a restart") {
+        {
+            WriteAheadLog wal(config);
+            for (int i = 0; i < 5; ++i) wal.append(make_events(i * 10, 10));
+            Collector collector;
+            wal.start(collector.sink());
+            REQUIRE(wait_for([&] { return wal.acked_lsn() == 5; }));
+        }
+        {
+            WriteAheadLog wal(config);
+            REQUIRE(wal.written_lsn() == 5);
+            REQUIRE(wal.append(make_events(50, 10)) == 6);
+            Collector collector;
+            wal.start(collector.sink());
+            REQUIRE(wait_for([&] { return wal.acked_lsn() == 6; }));
+            wal.stop();
+            REQUIRE(collector.traces.size() == 10);
+            REQUIRE(collector.traces.front() == "trace-50");
+        }
+    }
+
+    SECTION("A failing sink gets the same batch again") {
+        WriteAheadLog wal(config);
+        wal.append(make_events(0, 10));
+        wal.append(make_events(10, 10));
+
+        int failures = 2;
+        Collector collector;
+        wal.start([&](std::vector<Event>& events) {
+            if (failures > 0) {
+                failures--;
+                throw std::runtime_error("storage unavailable");
+            }
+            std::lock_guard<std::mutex> lock(collector.mutex);
+            for (const auto& event : events) collector.traces.push_back(event.trace_id);
+        });
+        REQUIRE(wait_for([&] { return wal.acked_lsn() == 2; }));
+        wal.stop();
+
+        REQUIRE(wal.stats().replay_failures == 2);
+        REQUIRE(collector.traces.size() == 20);
+        REQUIRE(collector.traces.front() == "trace-0");
+    }
+
+    SECTION("Deferred acknowledgements move the checkpoint past a complete prefix") {
+        config.replay_batch = 10;           // One record per batch
+        config.max_inflight = 2;
+        WriteAheadLog wal(config);
+        for (int i = 0; i < 3; ++i) wal.append(make_events(i * 10, 10));
+
+        std::mutex mutex;
+        std::vector<uint64_t> handed_out;
+        auto handed = [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            return handed_out;
+        };
+        wal.start_deferred([&](std::vector<Event>& events, uint64_t lsn) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (events.size() == 10) handed_out.push_back(lsn);
+        });
+
+        // Two outstanding at most
+        REQUIRE(wait_for([&] { return handed().size() == 2; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(handed() == std::vector<uint64_t>{1, 2});
+
+        wal.acknowledge(2);
+        REQUIRE(wal.acked_lsn() == 0);
+        wal.acknowledge(1);
+        REQUIRE(wal.acked_lsn() == 2);
+        REQUIRE(wait_for([&] { return handed().size() == 3; }));
+
+        // Unacknowledged at stop, so handed out again on the next start
+        wal.stop();
+        wal.acknowledge(42);
+        REQUIRE(wal.acked_lsn() == 2);
+        wal.start_deferred([&](std::vector<Event>&, uint64_t lsn) {
+            std::lock_guard<std::mutex> lock(mutex);
+            handed_out.push_back(lsn);
+            wal.acknowledge(lsn);
+        });
+        REQUIRE(wait_for([&] { return wal.acked_lsn() == 3; }));
+        wal.stop();
+        REQUIRE(handed() == std::vector<uint64_t>{1, 2, 3, 3});
+        REQUIRE(wal.stats().pending_bytes == 0);
+    }
+
+    SECTION("Concurrent appenders share syncs and lose nothing") {
+        WriteAheadLog wal(config);
+        Collector collector;
+        wal.start(collector.sink());
+
+        constexpr int kThreads = 4, kPerThread = 100;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < kPerThread; ++i) wal.append(make_events((t * kPerThread + i) * 2, 2));
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        REQUIRE(wait_for([&] { return collector.size() == kThreads * kPerThread * 2; }));
+        wal.stop();
+
+        std::set<std::string> unique(collector.traces.begin(), collector.traces.end());
+        REQUIRE(unique.size() == kThreads * kPerThread * 2);
+        auto stats = wal.stats();
+        REQUIRE(stats.appended_records == kThreads * kPerThread);
+        REQUIRE(stats.syncs >= 1);
+        REQUIRE(stats.syncs <= stats.appended_records);
+    }
+
+    SECTION("A full log refuses appends") {
+        config.max_bytes = 2048;
+        WriteAheadLog wal(config);
+        REQUIRE_THROWS_AS([&] {
+            for (int i = 0; i < 100; ++i) wal.append(make_events(i, 10));
+        }(), std::runtime_error);
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("WAL recovers from torn and corrupt records", "[wal]") {
+    auto dir = fresh_dir("recover");
+    WriteAheadLog::Config config;
+    config.dir = dir.string();
+    config.retry_initial_ms = 10;
+
+    {
+        WriteAheadLog wal(config);
+        for (int i = 0; i < 3; ++i) wal.append(make_events(i * 10, 10));
+    }
+
+    SECTION("A torn tail is cut off and its LSN reused") {
+        auto segment = segment_files(dir).back();
+        auto size = fs::file_size(segment);
+        {
+            std::ofstream out(segment, std::ios::binary | std::ios::app);
+            out << std::string("\x40\x00\x00\x00garbage", 11);
+        }
+
+        WriteAheadLog wal(config);
+        REQUIRE(fs::file_size(segment) == size);
+        REQUIRE(wal.written_lsn() == 3);
+        REQUIRE(wal.append(make_events(30, 10)) == 4);
+
+        Collector collector;
+        wal.start(collector.sink());
+        REQUIRE(wait_for([&] { return wal.acked_lsn() == 4; }));
+        wal.stop();
+        REQUIRE(collector.traces.size() == 40);
+        REQUIRE(wal.stats().corrupt_records == 0);
+    }
+
+    SECTION("A corrupt record in a sealed segment skips the rest of it") {
+        // Seal the first segment by forcing the next append into a new one
+        config.segment_bytes = fs::file_size(segment_files(dir).front());
+        auto first = segment_files(dir).front();
+        {
+            WriteAheadLog wal(config);
+            wal.append(make_events(30, 10));
+        }
+        REQUIRE(segment_files(dir).size() == 2);
+
+        // Flip a payload byte in record 2 of the first segment
+        {
+            std::fstream file(first, std::ios::binary | std::ios::in | std::ios::out);
+            auto record = fs::file_size(first) / 3;
+            file.seekp(static_cast<std::streamoff>(record + 20));
+            file.put('\x7f');
+        }
+
+        WriteAheadLog wal(config);
+        Collector collector;
+        wal.start(collector.sink());
+        REQUIRE(wait_for([&] { return wal.acked_lsn() == 4; }));
+        wal.stop();
+
+        // Record 1, then record 4 from the next segment
+        REQUIRE(collector.traces.size() == 20);
+        REQUIRE(collector.traces[10] == "trace-30");
+        REQUIRE(wal.stats().corrupt_records == 1);
+    }
+
+    fs::remove_all(dir);
+}
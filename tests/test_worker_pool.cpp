@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+#include "core/worker_pool.hpp"
+#include "core/event_normalizer.hpp"
+#include <atomic>
+#include <stdexcept>
+
+using namespace siem;
+using namespace siem::core;
+
+TEST_CASE("WorkerPool runs every chunk exactly once", "[worker_pool]") {
+    WorkerPool pool(3);
+
+    SECTION("Chunks cover the range") {
+        std::vector<std::atomic<int>> hits(1003);
+        pool.parallel_for(hits.size(), 10, [&hits](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) hits[i]++;
+        });
+
+        for (const auto& hit : hits) {
+            REQUIRE(hit.load() == 1);
+        }
+    }
+
+    SECTION("Exceptions reach the caller") {
+        REQUIRE_THROWS_AS(pool.parallel_for(100, 1, [](size_t begin, size_t) {
+            if (begin == 57) throw std::runtime_error("boom");
+        }), std::runtime_error);
+    }
+
+    SECTION("Nested loops do not deadlock") {
+        std::atomic<size_t> total{0};
+        pool.parallel_for(8, 1, [&](size_t, size_t) {
+            pool.parallel_for(100, 10, [&](size_t begin, size_t end) { total += end - begin; });
+        });
+        REQUIRE(total.load() == 800);
+    }
+
+    SECTION("Zero workers run inline") {
+        WorkerPool inline_pool(0);
+        size_t calls = 0;
+        inline_pool.parallel_for(100, 10, [&calls](size_t begin, size_t end) {
+            REQUIRE(begin == 0);
+            REQUIRE(end == 100);
+            calls++;
+        });
+        REQUIRE(calls == 1);
+    }
+}
+
+TEST_CASE("Parallel normalize_batch preserves order", "[worker_pool][normalizer]") {
+    WorkerPool pool(3);
+    EventNormalizer::Config config;
+    config.parallel_min_batch = 64;
+    config.parallel_chunk = 7;
+    EventNormalizer parallel(config, pool);
+    EventNormalizer sequential(EventNormalizer::Config{0, 256});
+
+    std::vector<json> raw;
+    for (int i = 0; i < 1000; ++i) {
+        raw.push_back({
+            {"source", "fw"},
+            {"host", "edge-" + std::to_string(i)},
+            {"entity", {{"ip", "10.0.0." + std::to_string(i % 256)}}},
+            {"object", {{"dport", i % 1024}}}
+        });
+    }
+
+    auto expected = sequential.normalize_batch(raw);
+    auto actual = parallel.normalize_batch(raw);
+
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        REQUIRE(actual[i].host == expected[i].host);
+        REQUIRE(actual[i].fingerprint == expected[i].fingerprint);
+        REQUIRE(actual[i].features == expected[i].features);
+    }
+}